@@ -20,12 +20,15 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef CAN_DEBUG_TOOLS_CAN_TOOLS_H
 #define CAN_DEBUG_TOOLS_CAN_TOOLS_H
 
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <string>
 #include <memory>
 #include <thread>
 #include <vector>
 
+#include "common/util/bus_capture.hpp"
 #include "mcp_can_rpi/mcp_can_rpi.h"
 
 namespace can_debug_tools
@@ -53,8 +56,13 @@ public:
 
     void startDump(double check_data_freq = 0.1);
 
+    bool startCapture(const std::string &file_path);
+    uint32_t stopCapture();
+    int replay(const std::vector<common::util::CaptureRecord> &records, bool realtime, uint32_t &nb_sent);
+
 private:
     void controlLoop();
+    void captureLoop();
 
     std::string dumpData();
     uint8_t read(unsigned long *id, uint8_t *len, std::array<uint8_t, MAX_MESSAGE_LENGTH> &buf);
@@ -66,6 +74,10 @@ private:
     bool _control_loop_ok{true};
     int _check_data_delay_ms{100};
 
+    common::util::BusCaptureWriter _capture_writer;
+    std::thread _capture_thread;
+    std::atomic<bool> _capture_ok{false};
+
 };
 
 }  // namespace can_debug_tools
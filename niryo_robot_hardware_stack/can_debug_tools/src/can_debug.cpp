@@ -35,6 +35,7 @@
 
 // niryo
 #include "can_debug_tools/can_tools.hpp"
+#include "common/util/bus_capture.hpp"
 
 namespace po = boost::program_options;
 
@@ -65,7 +66,9 @@ int handleUserInput(int argc, char **argv)
         po::options_description description("Options");
         description.add_options()("help,h", "Print help message")("channel,c", po::value<int>()->default_value(0), "Spi Channel")(
             "baudrate,b", po::value<int>()->default_value(1000000), "Baud rate")("gpio,g", po::value<int>()->default_value(25), "gpio can interrupt")(
-            "freq,f", po::value<double>()->default_value(100.0), "data check frequency in Hz (must be > 0)")("dump", "Dump any data from bus");
+            "freq,f", po::value<double>()->default_value(100.0), "data check frequency in Hz (must be > 0)")("dump", "Dump any data from bus")(
+            "capture", po::value<std::string>(), "Record all the frames of the bus until Enter is pressed (arg: file)")(
+            "replay", po::value<std::string>(), "Send again on the bus the frames of a capture (arg: file)")("realtime", "Keep the timing of the capture (for replay only)");
 
         po::variables_map vars;
         po::store(po::parse_command_line(argc, argv, description), vars);
@@ -110,6 +113,46 @@ int handleUserInput(int argc, char **argv)
                 std::cout << description << "\n";
                 return -1;
             }
+
+            if (vars.count("capture"))  // capture frames
+            {
+                std::string file_path = vars["capture"].as<std::string>();
+                if (!canTools.startCapture(file_path))
+                {
+                    std::cout << "Failed to create capture file " << file_path << std::endl;
+                    return -1;
+                }
+
+                auto start = std::chrono::steady_clock::now();
+                printf("--> Capturing CAN bus in %s\n", file_path.c_str());
+                std::cout << "Press Enter to Exit" << std::endl;
+                std::cin.get();
+
+                uint32_t nb_records = canTools.stopCapture();
+                double duration_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                printf("%u frames captured in %.1f s (%.0f frames/s)\n", nb_records, duration_s, nb_records / duration_s);
+                return 0;
+            }
+
+            if (vars.count("replay"))  // replay frames
+            {
+                std::string file_path = vars["replay"].as<std::string>();
+                common::util::BusCaptureReader reader;
+                std::vector<common::util::CaptureRecord> records;
+                if (!reader.open(file_path) || common::model::EBusProtocol::CAN != reader.getProtocol() || !reader.readAll(records))
+                {
+                    std::cout << "Failed to read a CAN capture from " << file_path << std::endl;
+                    return -1;
+                }
+
+                auto start = std::chrono::steady_clock::now();
+                uint32_t nb_sent = 0;
+                int ret = canTools.replay(records, vars.count("realtime") > 0, nb_sent);
+                double duration_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+                printf("%u / %d frames sent in %.1f ms\n", nb_sent, static_cast<int>(records.size()), duration_ms);
+                return (CAN_OK == ret) ? 0 : -1;
+            }
         }
         return -1;
     }
@@ -17,6 +17,8 @@
     along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
+#include <chrono>
 #include <iomanip>
 #include <iostream>
 #include <memory>
@@ -42,6 +44,8 @@ CanTools::~CanTools()
 
     if (_control_loop_thread.joinable())
         _control_loop_thread.join();
+
+    stopCapture();
 }
 
 /**
@@ -112,6 +116,96 @@ void CanTools::startDump(double check_data_freq)
     _control_loop_thread = std::thread(&CanTools::controlLoop, this);
 }
 
+/**
+ * @brief CanTools::startCapture : record every frame received, with its timestamp, in a capture file
+ * @param file_path
+ * @return
+ */
+bool CanTools::startCapture(const std::string &file_path)
+{
+    if (_capture_ok || !_capture_writer.open(file_path, common::model::EBusProtocol::CAN))
+        return false;
+
+    _capture_ok = true;
+    _capture_thread = std::thread(&CanTools::captureLoop, this);
+
+    return true;
+}
+
+/**
+ * @brief CanTools::stopCapture
+ * @return number of frames captured
+ */
+uint32_t CanTools::stopCapture()
+{
+    _capture_ok = false;
+    if (_capture_thread.joinable())
+        _capture_thread.join();
+
+    _capture_writer.close();
+    return _capture_writer.getRecordCount();
+}
+
+/**
+ * @brief CanTools::captureLoop : unlike the dump, the interrupt line is polled continuously
+ * and all the pending frames are read at once, so that no frame is lost at full bus load
+ */
+void CanTools::captureLoop()
+{
+    INT32U rxId{};
+    uint8_t len{};
+    std::array<uint8_t, MAX_MESSAGE_LENGTH> rxBuf{};
+
+    while (_capture_ok)
+    {
+        if (!_mcp_can->canReadData())
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            continue;
+        }
+
+        while (_mcp_can->canReadData() && CAN_OK == _mcp_can->readMsgBuf(&rxId, &len, rxBuf.data()))
+        {
+            size_t length = (len > MAX_MESSAGE_LENGTH) ? MAX_MESSAGE_LENGTH : len;
+            _capture_writer.record(common::util::CaptureRecord::RX, static_cast<uint32_t>(rxId), rxBuf.data(), length);
+        }
+    }
+}
+
+/**
+ * @brief CanTools::replay : send again the frames of a capture on the bus
+ * @param records
+ * @param realtime : keep the delays between the frames of the capture
+ * @param nb_sent
+ * @return
+ */
+int CanTools::replay(const std::vector<common::util::CaptureRecord> &records, bool realtime, uint32_t &nb_sent)
+{
+    int ret = CAN_OK;
+    nb_sent = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (auto const &record : records)
+    {
+        if (record.flags & common::util::CaptureRecord::ERROR)
+            continue;
+
+        if (realtime)
+            std::this_thread::sleep_until(start + std::chrono::microseconds(record.timestamp_us - records.front().timestamp_us));
+
+        std::array<uint8_t, MAX_MESSAGE_LENGTH> txBuf{};
+        auto len = static_cast<uint8_t>(std::min(record.data.size(), txBuf.size()));
+        std::copy(record.data.begin(), record.data.begin() + len, txBuf.begin());
+
+        if (CAN_OK == _mcp_can->sendMsgBuf(record.id, len, txBuf.data()))
+            nb_sent++;
+        else
+            ret = CAN_FAILTX;
+    }
+
+    return ret;
+}
+
 /**
  * @brief can_debug_tools::CanTools::controlLoop
  */
@@ -20,6 +20,7 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #ifndef CAN_DRIVER_CORE_H
 #define CAN_DRIVER_CORE_H
 
+#include <chrono>
 #include <cstdint>
 #include <memory>
 #include <ros/ros.h>
@@ -31,6 +32,9 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #include <vector>
 
 #include "common/model/hardware_type_enum.hpp"
+#include "common/util/goal_filter.hpp"
+#include "common/util/joint_command_buffer.hpp"
+#include "common/util/latency_histogram.hpp"
 #include "common/util/i_driver_core.hpp"
 #include "common/util/i_interface_core.hpp"
 #include "can_driver/can_manager.hpp"
@@ -74,7 +78,8 @@ class CanInterfaceCore : public common::util::IDriverCore, public common::util::
         void clearSingleCommandQueue();
         void clearConveyorCommandQueue();
 
-        void setTrajectoryControllerCommands(std::vector<std::pair<uint8_t, int32_t> >&& cmd);
+        void initTrajectoryControllerCommands(const std::vector<uint8_t>& id_list);
+        void setTrajectoryControllerCommands(const std::vector<int32_t>& goals, common::util::JointCommandBuffer<int32_t>::Clock::time_point sample_time);
 
         void addSyncCommandToQueue(std::unique_ptr<common::model::ISynchronizeMotorCmd>&& cmd) override;
 
@@ -107,6 +112,9 @@ class CanInterfaceCore : public common::util::IDriverCore, public common::util::
         common::model::EBusProtocol getBusProtocol() const override;
 
         std::vector<uint8_t> getRemovedMotorList() const override;
+
+        bool isSingleQueueFree() const;
+
     private:
         void initParameters(ros::NodeHandle &nh) override;
         void startServices(ros::NodeHandle &nh) override;
@@ -116,6 +124,7 @@ class CanInterfaceCore : public common::util::IDriverCore, public common::util::
         void resetHardwareControlLoopRates() override;
         void controlLoop() override;
         void _executeCommand() override;
+        void recordCommandLatency(std::chrono::steady_clock::time_point write_time);
 
         int motorCmdReport(const common::model::JointState &jState, common::model::EHardwareType motor_type);
 
@@ -141,7 +150,13 @@ class CanInterfaceCore : public common::util::IDriverCore, public common::util::
 
         std::unique_ptr<CanManager> _can_manager;
 
-        std::vector<std::pair<uint8_t, int32_t> > _joint_trajectory_cmd;
+        // one goal per joint, in the order given to initTrajectoryControllerCommands
+        common::util::JointCommandBuffer<int32_t> _joint_trajectory_cmd;
+        // only the goals that changed are sent on the bus
+        common::util::GoalFilter<int32_t> _joint_goal_filter;
+        std::vector<uint8_t> _joint_goal_mask;
+        // delay between the reception of the joint positions and the write of the goals computed from them
+        common::util::LatencyHistogram _command_latency;
 
         // can cmds
         std::queue<std::unique_ptr<common::model::AbstractCanSingleMotorCmd>> _stepper_single_cmds;
@@ -160,6 +175,16 @@ bool CanInterfaceCore::isConnectionOk() const
     return _can_manager->isConnectionOk();
 }
 
+/**
+ * @brief CanInterfaceCore::isSingleQueueFree
+ * @return true if all the single commands for steppers have been sent
+ */
+inline
+bool CanInterfaceCore::isSingleQueueFree() const
+{
+    return _stepper_single_cmds.empty();
+}
+
 /**
  * @brief CanInterfaceCore::getBusProtocol
  * @return
@@ -21,6 +21,7 @@
 #define CAN_DRIVER_H
 
 // std
+#include <chrono>
 #include <cstdint>
 #include <memory>
 #include <functional>
@@ -46,6 +47,7 @@
 #include "can_driver/fake_can_data.hpp"
 
 #include "abstract_can_driver.hpp"
+#include "abstract_stepper_driver.hpp"
 #include "ros/node_handle.h"
 
 
@@ -87,7 +89,8 @@ public:
     int changeId(common::model::EHardwareType motor_type, uint8_t old_id, uint8_t new_id);
 
     int writeSingleCommand(std::unique_ptr<common::model::AbstractCanSingleMotorCmd>&& cmd);
-    void executeJointTrajectoryCmd(std::vector<std::pair<uint8_t, int32_t> > cmd_vec);
+    void setJointTrajectoryLayout(const std::vector<uint8_t>& id_list);
+    std::chrono::steady_clock::time_point executeJointTrajectoryCmd(const std::vector<int32_t>& goals, std::vector<uint8_t>& mask);
 
     // read status
     void readStatus();
@@ -133,6 +136,12 @@ private:
     // map of drivers for a given hardware type (xl, stepper, end effector)
     std::map<common::model::EHardwareType, std::shared_ptr<can_driver::AbstractCanDriver> > _driver_map;
 
+    // ids of the joints for each slot of the trajectory goals, and their driver
+    std::vector<uint8_t> _joint_trajectory_ids;
+    std::vector<std::shared_ptr<can_driver::AbstractStepperDriver> > _joint_trajectory_drivers;
+    // the drivers are looked up again when a component is added or removed
+    bool _joint_trajectory_layout_changed{true};
+
     std::string _debug_error_message;
 
     // for hardware control
@@ -104,16 +104,29 @@ void CanInterfaceCore::initParameters(ros::NodeHandle &nh)
 {
     _control_loop_frequency = 0.0;
     double write_frequency = 1.0;
+    int goal_deadband = 0;
+    double goal_keep_alive = 1.0;
 
     nh.getParam("can_hardware_control_loop_frequency", _control_loop_frequency);
 
     nh.getParam("can_hw_write_frequency", write_frequency);
 
+    nh.getParam("can_hw_goal_deadband", goal_deadband);
+
+    nh.getParam("can_hw_goal_keep_alive", goal_keep_alive);
+
     ROS_DEBUG("CanInterfaceCore::initParameters - can_hardware_control_loop_frequency : %f", _control_loop_frequency);
 
     ROS_DEBUG("CanInterfaceCore::initParameters - can_hw_write_frequency : %f", write_frequency);
 
+    ROS_DEBUG("CanInterfaceCore::initParameters - can_hw_goal_deadband : %d", goal_deadband);
+
+    ROS_DEBUG("CanInterfaceCore::initParameters - can_hw_goal_keep_alive : %f", goal_keep_alive);
+
     _delta_time_write = 1.0 / write_frequency;
+
+    _joint_goal_filter.setDeadband(goal_deadband);
+    _joint_goal_filter.setKeepAlive(goal_keep_alive);
 }
 
 /**
@@ -321,7 +334,7 @@ int CanInterfaceCore::launchMotorsReport()
 
         for (auto const &res : results)
         {
-            ROS_INFO("%d \t| %s \t| %d", std::get<0>(res), HardwareTypeEnum(std::get<1>(res)).toString().c_str(), std::get<2>(res));
+            ROS_INFO("%d \t| %s \t| %d", std::get<0>(res), HardwareTypeEnum(std::get<1>(res)).toString(), std::get<2>(res));
         }
     }
     else
@@ -396,6 +409,7 @@ void CanInterfaceCore::controlLoop()
         // Do not readStatus if connection is down or not be established yet
         if (!_can_manager->isConnectionOk())
         {
+            _joint_goal_filter.reset();
             _can_manager->scanAndCheck();
             control_loop_rate.sleep();
         }
@@ -430,10 +444,13 @@ void CanInterfaceCore::controlLoop()
  */
 void CanInterfaceCore::_executeCommand()
 {
-    if (!_joint_trajectory_cmd.empty())
+    // an idle robot sends the same goals again and again : only the ones that changed are sent
+    const std::vector<int32_t> *goals = _joint_trajectory_cmd.read();
+    if (goals && _joint_goal_filter.filter(*goals, _joint_goal_mask))
     {
-        _can_manager->executeJointTrajectoryCmd(_joint_trajectory_cmd);
-        _joint_trajectory_cmd.clear();
+        recordCommandLatency(_can_manager->executeJointTrajectoryCmd(*goals, _joint_goal_mask));
+        // only the goals sent are recorded, the others are sent again at the next cycle
+        _joint_goal_filter.commit(*goals, _joint_goal_mask);
     }
 
     if (!_stepper_single_cmds.empty())
@@ -441,6 +458,9 @@ void CanInterfaceCore::_executeCommand()
         // as we use a queue, we don't need a mutex
         _can_manager->writeSingleCommand(std::move(_stepper_single_cmds.front()));
         _stepper_single_cmds.pop();
+
+        // torque, calibration... can change the goal of the motors, the next goals are all sent
+        _joint_goal_filter.reset();
     }
     if (!_conveyor_cmds.empty())
     {
@@ -554,10 +574,42 @@ void CanInterfaceCore::clearConveyorCommandQueue()
 }
 
 /**
- * @brief CanInterfaceCore::setTrajectoryControllerCommands
- * @param cmd
+ * @brief CanInterfaceCore::recordCommandLatency : delay between the reception of the joint positions and the write of the goals computed from them
+ * @param write_time : epoch if no goal has been written
+ */
+void CanInterfaceCore::recordCommandLatency(std::chrono::steady_clock::time_point write_time)
+{
+    auto sample_time = _joint_trajectory_cmd.getStamp();
+    if (std::chrono::steady_clock::time_point() == write_time || std::chrono::steady_clock::time_point() == sample_time)
+        return;
+
+    _command_latency.record(write_time - sample_time);
+    ROS_DEBUG_THROTTLE(10.0, "CanInterfaceCore::recordCommandLatency - joint position to goal latency : %s", _command_latency.str().c_str());
+}
+
+/**
+ * @brief CanInterfaceCore::initTrajectoryControllerCommands : allocate the trajectory commands, one slot per joint
+ * @param id_list : ids of the joints, in the order of the goals given to setTrajectoryControllerCommands
  */
-void CanInterfaceCore::setTrajectoryControllerCommands(std::vector<std::pair<uint8_t, int32_t>> &&cmd) { _joint_trajectory_cmd = cmd; }  // NOLINT
+void CanInterfaceCore::initTrajectoryControllerCommands(const std::vector<uint8_t> &id_list)
+{
+    lock_guard<mutex> lck(_control_loop_mutex);
+
+    _joint_trajectory_cmd.init(id_list.size());
+    _joint_goal_filter.resize(id_list.size());
+    _joint_goal_mask.assign(id_list.size(), 0);
+    _can_manager->setJointTrajectoryLayout(id_list);
+}
+
+/**
+ * @brief CanInterfaceCore::setTrajectoryControllerCommands : called at each cycle of the controller, does not allocate nor wait for the bus
+ * @param goals : one goal per joint, in the order given to initTrajectoryControllerCommands
+ * @param sample_time : time at which the joint positions the goals are computed from have been received
+ */
+void CanInterfaceCore::setTrajectoryControllerCommands(const std::vector<int32_t> &goals, common::util::JointCommandBuffer<int32_t>::Clock::time_point sample_time)
+{
+    _joint_trajectory_cmd.write(goals, sample_time);
+}
 
 /**
  * @brief CanInterfaceCore::addSingleCommandToQueue
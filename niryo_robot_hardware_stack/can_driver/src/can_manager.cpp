@@ -201,6 +201,7 @@ int CanManager::addHardwareComponent(std::shared_ptr<common::model::AbstractHard
     }
 
     addHardwareDriver(hardware_type);
+    _joint_trajectory_layout_changed = true;
 
     result = niryo_robot_msgs::CommandStatus::SUCCESS;
 
@@ -221,6 +222,7 @@ void CanManager::removeHardwareComponent(uint8_t id)
     }
 
     _removed_motor_id_list.erase(std::remove(_removed_motor_id_list.begin(), _removed_motor_id_list.end(), id), _removed_motor_id_list.end());
+    _joint_trajectory_layout_changed = true;
 }
 
 // ****************
@@ -284,6 +286,7 @@ void CanManager::readStatus()
 
             if (CAN_OK == driver->readData(motor_id, control_byte, rxBuf, error_message))
             {
+                auto sample_time = common::model::AbstractMotorState::Clock::now();
                 if (_state_map.count(motor_id) && _state_map.at(motor_id))
                 {
                     auto stepperState = std::dynamic_pointer_cast<StepperMotorState>(_state_map.at(motor_id));
@@ -293,7 +296,7 @@ void CanManager::readStatus()
                     switch (control_byte)
                     {
                     case AbstractStepperDriver::CAN_DATA_POSITION:
-                        stepperState->setPosition(driver->interpretPositionStatus(rxBuf));
+                        stepperState->setPosition(driver->interpretPositionStatus(rxBuf), sample_time);
                         break;
                     case AbstractStepperDriver::CAN_DATA_DIAGNOSTICS:
                         stepperState->setTemperature(driver->interpretTemperatureStatus(rxBuf));
@@ -585,29 +588,64 @@ int CanManager::writeSingleCommand(std::unique_ptr<common::model::AbstractCanSin
     return result;
 }
 
+/**
+ * @brief CanManager::setJointTrajectoryLayout
+ * @param id_list : ids of the joints, in the order of the goals given to executeJointTrajectoryCmd
+ */
+void CanManager::setJointTrajectoryLayout(const std::vector<uint8_t> &id_list)
+{
+    _joint_trajectory_ids = id_list;
+    _joint_trajectory_layout_changed = true;
+}
+
 /**
  * @brief CanManager::executeJointTrajectoryCmd
- * @param cmd_vec : need to be passed by copy, so that we ensure the data will not change in this method
+ * @param goals : one goal per joint, in the order given to setJointTrajectoryLayout
+ * @param mask : goals to send, reset to 0 for the goals which could not be sent
+ * @return time at which the last goal has been sent on the bus, epoch if none
  */
-void CanManager::executeJointTrajectoryCmd(std::vector<std::pair<uint8_t, int32_t>> cmd_vec)
+std::chrono::steady_clock::time_point CanManager::executeJointTrajectoryCmd(const std::vector<int32_t> &goals, std::vector<uint8_t> &mask)
 {
-    for (auto const &it : _driver_map)
+    std::chrono::steady_clock::time_point write_time;
+
+    if (_joint_trajectory_layout_changed)
     {
-        auto driver = std::dynamic_pointer_cast<AbstractStepperDriver>(it.second);
+        _joint_trajectory_drivers.assign(_joint_trajectory_ids.size(), nullptr);
+        for (size_t slot = 0; slot < _joint_trajectory_ids.size(); ++slot)
+        {
+            auto state = _state_map.find(_joint_trajectory_ids.at(slot));
+            if (state != _state_map.end() && state->second && _driver_map.count(state->second->getHardwareType()))
+                _joint_trajectory_drivers.at(slot) = std::dynamic_pointer_cast<AbstractStepperDriver>(_driver_map.at(state->second->getHardwareType()));
+        }
+        _joint_trajectory_layout_changed = false;
+    }
+
+    for (size_t slot = 0; slot < _joint_trajectory_drivers.size() && slot < goals.size() && slot < mask.size(); ++slot)
+    {
+        auto const &driver = _joint_trajectory_drivers[slot];
+        if (!mask[slot])
+            continue;
 
-        for (auto const &cmd : cmd_vec)
+        if (!driver)
         {
-            if (_state_map.count(cmd.first) && it.first == _state_map.at(cmd.first)->getHardwareType())
-            {
-                int err = driver->sendPositionCommand(cmd.first, cmd.second);
-                if (err != CAN_OK)
-                {
-                    ROS_WARN("CanManager::executeJointTrajectoryCmd - Failed to write position");
-                    _debug_error_message = "CanManager - Failed to write position";
-                }
-            }
+            mask[slot] = 0;
+            continue;
+        }
+
+        int err = driver->sendPositionCommand(_joint_trajectory_ids[slot], goals[slot]);
+        if (err != CAN_OK)
+        {
+            ROS_WARN("CanManager::executeJointTrajectoryCmd - Failed to write position");
+            _debug_error_message = "CanManager - Failed to write position";
+            mask[slot] = 0;
+        }
+        else
+        {
+            write_time = std::chrono::steady_clock::now();
         }
     }
+
+    return write_time;
 }
 
 // ******************
@@ -0,0 +1,6 @@
+# trace logs on hot paths (control loop, bus read/write), see common/util/log_defs.hpp.
+# Included by common and by each package depending on it. Set to OFF to remove them at compile time
+set(HW_TRACE ON CACHE BOOL "Enable trace logs on hot paths")
+if (HW_TRACE)
+    add_definitions(-DHW_TRACE_ENABLED)
+endif()
@@ -20,9 +20,12 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #ifndef ABSTRACT_ENUM_H
 #define ABSTRACT_ENUM_H
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
 #include <string>
 #include <vector>
-#include <map>
 #include <algorithm>    // std::sort
 
 namespace common
@@ -30,8 +33,115 @@ namespace common
 namespace model
 {
 
+/**
+ * @brief The EnumEntry struct : one value of an enum and its string representation
+ */
+template <typename E>
+struct EnumEntry
+{
+    E value;
+    const char* name;
+};
+
+/**
+ * @brief The EnumTable struct : compile time table of the string representations of an enum
+ * Each specialization of AbstractEnum provides it through a static constexpr table() method
+ */
+template <typename E, std::size_t N>
+struct EnumTable
+{
+    EnumEntry<E> entries[N];
+};
+
+/**
+ * @brief The EnumIndex struct : lookup tables built at compile time from an EnumTable
+ * by_value gives the position in the EnumTable of each underlying value of the enum (N if not in the table)
+ * by_name gives the positions in the EnumTable, sorted by name
+ */
+template <std::size_t N, std::size_t M>
+struct EnumIndex
+{
+    uint8_t by_value[M];
+    uint8_t by_name[N];
+};
+
+namespace enum_detail
+{
+
+/**
+ * @brief compare : strcmp usable in constant expressions
+ */
+constexpr int compare(const char* a, const char* b)
+{
+    while (*a && *a == *b)
+    {
+        ++a;
+        ++b;
+    }
+    return static_cast<unsigned char>(*a) - static_cast<unsigned char>(*b);
+}
+
+/**
+ * @brief maxValue
+ * @return the greatest underlying value of the table. Not a constant expression if
+ * an entry is left empty or has a negative value, so that such tables fail to compile
+ */
+template <typename E, std::size_t N>
+constexpr std::size_t maxValue(const EnumTable<E, N>& table)
+{
+    std::size_t max_value = 0;
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        if (!table.entries[i].name || static_cast<long>(table.entries[i].value) < 0)
+            throw std::logic_error("AbstractEnum - invalid enum table entry");
+
+        if (static_cast<std::size_t>(table.entries[i].value) > max_value)
+            max_value = static_cast<std::size_t>(table.entries[i].value);
+    }
+    return max_value;
+}
+
+/**
+ * @brief makeIndex
+ * @return the lookup tables of the given table. Not a constant expression if
+ * a value or a name is duplicated, so that such tables fail to compile
+ */
+template <std::size_t M, typename E, std::size_t N>
+constexpr EnumIndex<N, M> makeIndex(const EnumTable<E, N>& table)
+{
+    EnumIndex<N, M> index{};
+
+    for (std::size_t v = 0; v < M; ++v)
+        index.by_value[v] = static_cast<uint8_t>(N);
+
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        std::size_t v = static_cast<std::size_t>(table.entries[i].value);
+        if (index.by_value[v] != N)
+            throw std::logic_error("AbstractEnum - duplicated enum value");
+        index.by_value[v] = static_cast<uint8_t>(i);
+
+        // insertion sort on names
+        std::size_t j = i;
+        while (j > 0 && compare(table.entries[index.by_name[j - 1]].name, table.entries[i].name) > 0)
+        {
+            index.by_name[j] = index.by_name[j - 1];
+            --j;
+        }
+        if (j > 0 && 0 == compare(table.entries[index.by_name[j - 1]].name, table.entries[i].name))
+            throw std::logic_error("AbstractEnum - duplicated enum name");
+        index.by_name[j] = static_cast<uint8_t>(i);
+    }
+    return index;
+}
+
+}  // namespace enum_detail
+
 /**
  * @brief The AbstractEnum class
+ * The string representations are stored in a constexpr EnumTable given by C::table().
+ * toString is a direct array access and fromString a binary search on the names.
+ * Lookup tables are computed at compile time, nothing is built at startup
  */
 template <class C, typename E>
 class AbstractEnum
@@ -40,7 +150,7 @@ public:
 
     operator E () const { return _enum; }
 
-    const std::string& toString() const;
+    const char* toString() const;
 
     std::vector<std::string> values(bool sort=false) const;
 
@@ -60,18 +170,36 @@ private:
     void fromString(const char* str);
 
     // use curiously recurring template pattern  (CRTP)
-    static std::map<E, std::string> initialize()
-    { return C::initialize(); }
+    // defined out of the class as C is not complete yet here
+    struct Lookup;
 
     E _enum;
-    static std::map<E, std::string> _map;
 };
 
 /**
- * @brief AbstractEnum<C, E>::_map
+ * @brief The AbstractEnum<C, E>::Lookup struct
  */
 template <class C, typename E>
-std::map<E, std::string> AbstractEnum<C, E>::_map = initialize();
+struct AbstractEnum<C, E>::Lookup
+{
+    static constexpr std::size_t range = enum_detail::maxValue(C::table()) + 1;
+
+    using table_type = decltype(C::table());
+    using index_type = decltype(enum_detail::makeIndex<range>(C::table()));
+
+    static constexpr table_type table = C::table();
+    static constexpr index_type index = enum_detail::makeIndex<range>(C::table());
+
+    static constexpr std::size_t size = sizeof(index.by_name);
+
+    static_assert(size < UINT8_MAX, "AbstractEnum - enum table too big");
+};
+
+template <class C, typename E>
+constexpr typename AbstractEnum<C, E>::Lookup::table_type AbstractEnum<C, E>::Lookup::table;
+
+template <class C, typename E>
+constexpr typename AbstractEnum<C, E>::Lookup::index_type AbstractEnum<C, E>::Lookup::index;
 
 /**
  * @brief AbstractEnum<C, E>::fromString
@@ -83,16 +211,16 @@ void AbstractEnum<C, E >::fromString(const char* const str)
     _enum = static_cast< E >( 0 ); //
     if (str)
     {
-        typename std::map<E, std::string>::const_iterator iter = _map.begin();
-        for (; iter != _map.end(); ++iter)
-        {
-            if (iter->second == str)
-            {
-                _enum = iter->first;
-                break;
-            }
-        }
-        if (iter == _map.end()) throw std::out_of_range("");
+        const uint8_t* first = Lookup::index.by_name;
+        const uint8_t* last = Lookup::index.by_name + Lookup::size;
+
+        const uint8_t* it = std::lower_bound(first, last, str,
+                                             [](uint8_t i, const char* s) { return std::strcmp(Lookup::table.entries[i].name, s) < 0; });
+
+        if (it == last || 0 != std::strcmp(Lookup::table.entries[*it].name, str))
+            throw std::out_of_range("");
+
+        _enum = Lookup::table.entries[*it].value;
     }
 }
 
@@ -101,30 +229,32 @@ void AbstractEnum<C, E >::fromString(const char* const str)
  * @return
  */
 template <class C, typename E>
-const std::string&
+const char*
 AbstractEnum<C, E >::toString() const
 {
-    typename std::map<E, std::string>::const_iterator iter = _map.find(_enum);
-    if (iter == _map.end())
+    std::size_t value = static_cast<std::size_t>(_enum);
+    if (value >= Lookup::range || Lookup::index.by_value[value] >= Lookup::size)
         throw std::out_of_range("");
-    return iter->second;
+
+    return Lookup::table.entries[Lookup::index.by_value[value]].name;
 }
 
 /**
  * @brief AbstractEnum<C, E>::values
  * @param sort
- * @return
+ * @return values in increasing enum order, or sorted by name if sort is true
  */
 template <class C, typename E>
 std::vector<std::string>
 AbstractEnum<C, E >::values(bool sort) const
 {
     std::vector<std::string> values;
-    for (typename std::map<E, std::string>::const_iterator iter = _map.begin();
-         iter != _map.end();
-         ++iter)
+    values.reserve(Lookup::size);
+
+    for (std::size_t v = 0; v < Lookup::range; ++v)
     {
-        values.push_back(iter->second);
+        if (Lookup::index.by_value[v] < Lookup::size)
+            values.emplace_back(Lookup::table.entries[Lookup::index.by_value[v]].name);
     }
     if (sort) std::sort(values.begin(), values.end());
 
@@ -135,4 +265,3 @@ AbstractEnum<C, E >::values(bool sort) const
 } // common
 
 #endif // ABSTRACT_ENUM_H
-
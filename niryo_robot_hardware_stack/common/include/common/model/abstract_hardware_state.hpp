@@ -57,7 +57,7 @@ public:
     uint8_t getTemperature() const;
     double getVoltage() const;
     uint32_t getHardwareError() const;
-    std::string getHardwareErrorMessage() const;
+    const std::string &getHardwareErrorMessage() const;
 
     // setters
     void setFirmwareVersion(const std::string &firmware_version);
@@ -187,7 +187,7 @@ uint32_t AbstractHardwareState::getHardwareError() const
  * @return
  */
 inline
-std::string AbstractHardwareState::getHardwareErrorMessage() const
+const std::string &AbstractHardwareState::getHardwareErrorMessage() const
 {
     return _hw_error_message;
 }
@@ -21,6 +21,7 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #define ABSTRACT_MOTOR_STATE_H
 
 #include "abstract_hardware_state.hpp"
+#include <chrono>
 #include <string>
 
 #include "common/model/hardware_type_enum.hpp"
@@ -37,6 +38,9 @@ namespace model
  */
 class AbstractMotorState : public AbstractHardwareState
 {
+public:
+    using Clock = std::chrono::steady_clock;
+
 public:
     AbstractMotorState();
     AbstractMotorState(EHardwareType type, EComponentType component_type,
@@ -48,9 +52,11 @@ public:
     int getPosition() const;
     int getVelocity() const;
     int getTorque() const;
+    Clock::time_point getPositionTime() const;
 
     // setters
     void setPosition(int pos);
+    void setPosition(int pos, Clock::time_point sample_time);
     void setVelocity(int vel);
     void setTorque(int torque);
 
@@ -69,6 +75,8 @@ protected:
     int _position{0};
     int _velocity{0};
     int _torque{0};
+    // monotonic time at which the position arrived from the bus
+    Clock::time_point _position_time;
 
 protected:
     // see https://github.com/isocpp/CppCoreGuidelines/blob/master/CppCoreGuidelines.md#c67-a-polymorphic-class-should-suppress-public-copymove
@@ -109,6 +117,16 @@ int AbstractMotorState::getTorque() const
     return _torque;
 }
 
+/**
+ * @brief AbstractMotorState::getPositionTime
+ * @return time at which the position has been received, epoch if never received
+ */
+inline
+AbstractMotorState::Clock::time_point AbstractMotorState::getPositionTime() const
+{
+    return _position_time;
+}
+
 /**
  * @brief AbstractMotorState::isStepper
  * @return
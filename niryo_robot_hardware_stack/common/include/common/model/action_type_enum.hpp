@@ -20,7 +20,6 @@
 #ifndef ACTION_TYPE_ENUM_H
 #define ACTION_TYPE_ENUM_H
 
-#include <map>
 #include <string>
 
 #include "common/common_defs.hpp"
@@ -53,7 +52,16 @@ public:
 
 private:
     friend class AbstractEnum<ActionTypeEnum, EActionType>;
-    static std::map<EActionType, std::string> initialize();
+    static constexpr EnumTable<EActionType, 5> table()
+    {
+        return {{
+            {EActionType::HANDLE_HELD_ACTION, "handle held action"},
+            {EActionType::LONG_PUSH_ACTION, "long push action"},
+            {EActionType::SINGLE_PUSH_ACTION, "single push action"},
+            {EActionType::DOUBLE_PUSH_ACTION, "double push action"},
+            {EActionType::NO_ACTION, "no action"}
+        }};
+    }
 };
 
 } // model
@@ -20,7 +20,6 @@
 #ifndef BUS_PROTOCOL_ENUM_H
 #define BUS_PROTOCOL_ENUM_H
 
-#include <map>
 #include <string>
 
 #include "common/common_defs.hpp"
@@ -51,7 +50,14 @@ public:
 
 private:
     friend class AbstractEnum<BusProtocolEnum, EBusProtocol>;
-    static std::map<EBusProtocol, std::string> initialize();
+    static constexpr EnumTable<EBusProtocol, 3> table()
+    {
+        return {{
+            {EBusProtocol::TTL, "ttl"},
+            {EBusProtocol::CAN, "can"},
+            {EBusProtocol::UNKNOWN, "unknown"}
+        }};
+    }
 };
 
 } // model
@@ -20,7 +20,6 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #ifndef BUTTON_TYPE_ENUM_H
 #define BUTTON_TYPE_ENUM_H
 
-#include <map>
 #include <string>
 
 #include "common/common_defs.hpp"
@@ -51,7 +50,15 @@ public:
 
 private:
     friend class AbstractEnum<ButtonTypeEnum, EButtonType>;
-    static std::map<EButtonType, std::string> initialize();
+    static constexpr EnumTable<EButtonType, 4> table()
+    {
+        return {{
+            {EButtonType::FREE_DRIVE_BUTTON, "free_drive"},
+            {EButtonType::SAVE_POSITION_BUTTON, "save_position"},
+            {EButtonType::CUSTOM_BUTTON, "custom"},
+            {EButtonType::UNKNOWN, "unknown"}
+        }};
+    }
 };
 
 } // model
@@ -20,7 +20,6 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #ifndef COMPONENT_TYPE_ENUM_H
 #define COMPONENT_TYPE_ENUM_H
 
-#include <map>
 #include <string>
 
 #include "common/common_defs.hpp"
@@ -53,7 +52,16 @@ public:
 
 private:
     friend class AbstractEnum<ComponentTypeEnum, EComponentType>;
-    static std::map<EComponentType, std::string> initialize();
+    static constexpr EnumTable<EComponentType, 5> table()
+    {
+        return {{
+            {EComponentType::TOOL, "tool"},
+            {EComponentType::CONVEYOR, "conveyor"},
+            {EComponentType::JOINT, "joint"},
+            {EComponentType::END_EFFECTOR, "end effector"},
+            {EComponentType::UNKNOWN, "unknown"}
+        }};
+    }
 };
 
 } // model
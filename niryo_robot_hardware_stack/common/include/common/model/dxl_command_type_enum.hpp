@@ -20,7 +20,6 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #ifndef DXL_COMMAND_TYPE_ENUM_H
 #define DXL_COMMAND_TYPE_ENUM_H
 
-#include <map>
 #include <string>
 
 #include "common/common_defs.hpp"
@@ -63,7 +62,25 @@ namespace common
 
         private:
             friend class AbstractEnum<DxlCommandTypeEnum, EDxlCommandType>;
-            static std::map<EDxlCommandType, std::string> initialize();
+            static constexpr EnumTable<EDxlCommandType, 14> table()
+            {
+                return {{
+                    {EDxlCommandType::CMD_TYPE_POSITION, "position"},
+                    {EDxlCommandType::CMD_TYPE_VELOCITY, "velocity"},
+                    {EDxlCommandType::CMD_TYPE_EFFORT, "effort"},
+                    {EDxlCommandType::CMD_TYPE_TORQUE, "torque"},
+                    {EDxlCommandType::CMD_TYPE_PING, "ping"},
+                    {EDxlCommandType::CMD_TYPE_LEARNING_MODE, "learning mode"},
+                    {EDxlCommandType::CMD_TYPE_PID, "PID"},
+                    {EDxlCommandType::CMD_TYPE_CONTROL_MODE, "Control Mode"},
+                    {EDxlCommandType::CMD_TYPE_LED_STATE, "Led State"},
+                    {EDxlCommandType::CMD_TYPE_PROFILE, "Velocity and Acceleration profile"},
+                    {EDxlCommandType::CMD_TYPE_STARTUP, "Startup Configuration"},
+                    {EDxlCommandType::CMD_TYPE_TEMPERATURE_LIMIT, "Temperature limit"},
+                    {EDxlCommandType::CMD_TYPE_SHUTDOWN, "Shutdown when error occurs"},
+                    {EDxlCommandType::CMD_TYPE_UNKNOWN, "unknown type"}
+                }};
+            }
         };
 
     } // model
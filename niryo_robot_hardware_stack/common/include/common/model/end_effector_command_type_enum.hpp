@@ -20,7 +20,6 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #ifndef END_EFFECTOR_COMMAND_TYPE_ENUM_H
 #define END_EFFECTOR_COMMAND_TYPE_ENUM_H
 
-#include <map>
 #include <string>
 
 #include "common/common_defs.hpp"
@@ -51,7 +50,15 @@ public:
 
 private:
     friend class AbstractEnum<EndEffectorCommandTypeEnum, EEndEffectorCommandType>;
-    static std::map<EEndEffectorCommandType, std::string> initialize();
+    static constexpr EnumTable<EEndEffectorCommandType, 4> table()
+    {
+        return {{
+            {EEndEffectorCommandType::CMD_TYPE_DIGITAL_OUTPUT, "digit input cmd"},
+            {EEndEffectorCommandType::CMD_TYPE_PING, "ping"},
+            {EEndEffectorCommandType::CMD_TYPE_SET_COLLISION_THRESH, "set collision threshold cmd"},
+            {EEndEffectorCommandType::CMD_TYPE_UNKNOWN, "unknown type"}
+        }};
+    }
 };
 
 } // model
@@ -20,7 +20,6 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #ifndef HARDWARE_TYPE_ENUM_H
 #define HARDWARE_TYPE_ENUM_H
 
-#include <map>
 #include <string>
 
 #include "common/common_defs.hpp"
@@ -59,7 +58,22 @@ public:
 
 private:
     friend class AbstractEnum<HardwareTypeEnum, EHardwareType>;
-    static std::map<EHardwareType, std::string> initialize();
+    static constexpr EnumTable<EHardwareType, 11> table()
+    {
+        return {{
+            {EHardwareType::STEPPER, "stepper"},
+            {EHardwareType::XL430, "xl430"},
+            {EHardwareType::XL320, "xl320"},
+            {EHardwareType::XL330, "xl330"},
+            {EHardwareType::XC430, "xc430"},
+            {EHardwareType::XM430, "xm430"},
+            {EHardwareType::FAKE_DXL_MOTOR, "fakeDxl"},
+            {EHardwareType::FAKE_STEPPER_MOTOR, "fakeStepper"},
+            {EHardwareType::END_EFFECTOR, "end_effector"},
+            {EHardwareType::FAKE_END_EFFECTOR, "fake_end_effector"},
+            {EHardwareType::UNKNOWN, "unknown"}
+        }};
+    }
 
 
 };
@@ -54,7 +54,7 @@ public:
     void setLimitPositionMax(double max_position);
     void setLimitPositionMin(double min_position);
 
-    std::string getName() const;
+    const std::string &getName() const;
     int8_t getDirection() const;
     double getOffsetPosition() const;
     double getHomePosition() const;
@@ -105,7 +105,7 @@ protected:
  * @return
  */
 inline
-std::string JointState::getName() const
+const std::string &JointState::getName() const
 {
     return _name;
 }
@@ -211,12 +211,12 @@ std::string DxlSingleCmd::str() const
     ss << DxlCommandTypeEnum(_type).toString() << " ";
 
     ss << "Motor id: "
-       << std::to_string(_id) << " "
+       << static_cast<int>(_id) << " "
        << "; param: ";
 
     for(auto const &p : _param_list)
     {
-        ss << std::to_string(p) << " ";
+        ss << p << " ";
     }
 
     return ss.str();
@@ -252,11 +252,11 @@ std::string StepperTtlSingleCmd::str() const
     ss << StepperCommandTypeEnum(_type).toString() << " ";
 
     ss << "Motor id: ";
-        ss << std::to_string(_id) << " ";
+        ss << static_cast<int>(_id) << " ";
 
     ss << "Params: ";
     for (auto param : getParams())
-        ss << std::to_string(static_cast<uint32_t>(param)) << " ";
+        ss << param << " ";
 
     return ss.str();
 }
@@ -291,11 +291,11 @@ std::string StepperSingleCmd::str() const
     ss << StepperCommandTypeEnum(_type).toString() << " ";
 
     ss << "Motor id: ";
-        ss << std::to_string(_id) << " ";
+        ss << static_cast<int>(_id) << " ";
 
     ss << "Params: ";
     for (int32_t param : getParams())
-        ss << std::to_string(static_cast<int32_t>(param)) << " ";
+        ss << param << " ";
 
     return ss.str();
 }
@@ -347,12 +347,12 @@ std::string EndEffectorSingleCmd::str() const
     ss << EndEffectorCommandTypeEnum(_type).toString() << " ";
 
     ss << "End Effector id: ";
-        ss << std::to_string(_id) << " ";
+        ss << static_cast<int>(_id) << " ";
 
     if(!_param_list.empty())
     {
         ss << "; param: ";
-        ss << std::to_string(getParam());
+        ss << getParam();
     }
 
     return ss.str();
@@ -20,7 +20,6 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #ifndef STEPPER_CALIBRATION_STATUS_ENUM_H
 #define STEPPER_CALIBRATION_STATUS_ENUM_H
 
-#include <map>
 #include <string>
 
 #include "common/common_defs.hpp"
@@ -55,7 +54,18 @@ public:
 
 private:
     friend class AbstractEnum<StepperCalibrationStatusEnum, EStepperCalibrationStatus>;
-    static std::map<EStepperCalibrationStatus, std::string> initialize();
+    static constexpr EnumTable<EStepperCalibrationStatus, 7> table()
+    {
+        return {{
+            {EStepperCalibrationStatus::UNINITIALIZED, "uninitialized"},
+            {EStepperCalibrationStatus::OK, "ok"},
+            {EStepperCalibrationStatus::TIMEOUT, "timeout"},
+            {EStepperCalibrationStatus::BAD_PARAM, "bad parameter"},
+            {EStepperCalibrationStatus::FAIL, "fail"},
+            {EStepperCalibrationStatus::WAITING_USER_INPUT, "waiting user input"},
+            {EStepperCalibrationStatus::IN_PROGRESS, "in progress"}
+        }};
+    }
 };
 
 } // model
@@ -20,7 +20,6 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #ifndef STEPPER_COMMAND_TYPE_ENUM_H
 #define STEPPER_COMMAND_TYPE_ENUM_H
 
-#include <map>
 #include <string>
 
 #include "common/common_defs.hpp"
@@ -69,7 +68,31 @@ namespace common
 
         private:
             friend class AbstractEnum<StepperCommandTypeEnum, EStepperCommandType>;
-            static std::map<EStepperCommandType, std::string> initialize();
+            static constexpr EnumTable<EStepperCommandType, 20> table()
+            {
+                return {{
+                    {EStepperCommandType::CMD_TYPE_NONE, "none"},
+                    {EStepperCommandType::CMD_TYPE_POSITION, "position"},
+                    {EStepperCommandType::CMD_TYPE_VELOCITY, "velocity"},
+                    {EStepperCommandType::CMD_TYPE_EFFORT, "effort"},
+                    {EStepperCommandType::CMD_TYPE_TORQUE, "torque"},
+                    {EStepperCommandType::CMD_TYPE_SYNCHRONIZE, "synchronize"},
+                    {EStepperCommandType::CMD_TYPE_RELATIVE_MOVE, "relative move"},
+                    {EStepperCommandType::CMD_TYPE_MAX_EFFORT, "max effort"},
+                    {EStepperCommandType::CMD_TYPE_MICRO_STEPS, "micro steps"},
+                    {EStepperCommandType::CMD_TYPE_POSITION_OFFSET, "position offset"},
+                    {EStepperCommandType::CMD_TYPE_CALIBRATION, "calibration"},
+                    {EStepperCommandType::CMD_TYPE_CONVEYOR, "conveyor"},
+                    {EStepperCommandType::CMD_TYPE_UPDATE_CONVEYOR, "update conveyor"},
+                    {EStepperCommandType::CMD_TYPE_LEARNING_MODE, "learning mode"},
+                    {EStepperCommandType::CMD_TYPE_PING, "ping"},
+                    {EStepperCommandType::CMD_TYPE_CALIBRATION_SETUP, "calibration setup"},
+                    {EStepperCommandType::CMD_TYPE_VELOCITY_PROFILE, "velocity profile"},
+                    {EStepperCommandType::CMD_TYPE_READ_HOMING_ABS_POSITION, "homing abs read position"},
+                    {EStepperCommandType::CMD_TYPE_WRITE_HOMING_ABS_POSITION, "homing abs write position"},
+                    {EStepperCommandType::CMD_TYPE_UNKNOWN, "unknown type"}
+                }};
+            }
         };
 
     } // model
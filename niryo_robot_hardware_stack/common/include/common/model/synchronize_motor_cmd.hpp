@@ -208,7 +208,7 @@ std::string DxlSyncCmd::str() const
         for (auto const& param : _motor_params_map)
         {
             ss << HardwareTypeEnum(param.first).toString() << " => ";
-            MotorParam p = param.second;
+            const MotorParam& p = param.second;
             for (size_t i = 0; i < p.motors_id.size() && i < p.params.size(); ++i)
                 ss << "(" << static_cast<int>(p.motors_id.at(i)) << ", " << p.params.at(i) << ")" << ",";
         }
@@ -253,7 +253,7 @@ std::string StepperTtlSyncCmd::str() const
         for (auto const& param : _motor_params_map)
         {
             ss << HardwareTypeEnum(param.first).toString() << " => ";
-            MotorParam p = param.second;
+            const MotorParam& p = param.second;
             for (size_t i = 0; i < p.motors_id.size() && i < p.params.size(); ++i)
                 ss << "(" << static_cast<int>(p.motors_id.at(i)) << ", " << p.params.at(i) << ")" << ",";
         }
@@ -300,7 +300,7 @@ std::string StepperSyncCmd::str() const
         for (auto const& param : _motor_params_map)
         {
             ss << HardwareTypeEnum(param.first).toString() << " => ";
-            MotorParam p = param.second;
+            const MotorParam& p = param.second;
             for (size_t i = 0; i < p.motors_id.size() && i < p.params.size(); ++i)
                 ss << "(" << static_cast<int>(p.motors_id.at(i)) << ", " << p.params.at(i) << ")" << ",";
         }
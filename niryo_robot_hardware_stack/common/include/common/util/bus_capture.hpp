@@ -0,0 +1,201 @@
+/*
+bus_capture.hpp
+Copyright (C) 2020 Niryo
+All rights reserved.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BUS_CAPTURE_H
+#define BUS_CAPTURE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/model/bus_protocol_enum.hpp"
+
+namespace common
+{
+namespace util
+{
+
+/**
+ * @brief The CaptureRecord struct : one packet (TTL) or frame (CAN) seen on a bus
+ */
+struct CaptureRecord
+{
+    static constexpr uint8_t TX = 0x01;      // instruction packet, sent by the master
+    static constexpr uint8_t RX = 0x02;      // status packet or frame received from a device
+    static constexpr uint8_t ERROR = 0x80;   // bytes that could not be decoded
+
+    uint64_t timestamp_us{0};  // since the start of the capture
+    uint8_t flags{0};
+    uint32_t id{0};            // device id (TTL) or frame id (CAN)
+    std::vector<uint8_t> data;
+};
+
+/**
+ * @brief The BusCaptureWriter class streams the records of a capture session into a binary file.
+ *
+ * File layout, all values in little endian:
+ *  - header : magic "NCAP" (4 bytes), version (uint16), bus protocol (uint8), reserved (uint8), start time in us since epoch (uint64)
+ *  - records : timestamp in us (uint64), flags (uint8), id (uint32), length (uint16), raw bytes
+ *  - index : one entry every INDEX_INTERVAL records : record number (uint32), offset in file (uint64)
+ *  - footer : offset of the index (uint64), number of records (uint32), magic "NIDX" (4 bytes)
+ *
+ * The records are buffered in memory and written by blocks, the index and footer are written by close().
+ * A capture interrupted before close() can still be read, the index is then rebuilt by the reader.
+ */
+class BusCaptureWriter
+{
+public:
+    BusCaptureWriter() = default;
+    ~BusCaptureWriter();
+
+    BusCaptureWriter(const BusCaptureWriter &) = delete;
+    BusCaptureWriter(BusCaptureWriter &&) = delete;
+    BusCaptureWriter &operator=(BusCaptureWriter &&) = delete;
+    BusCaptureWriter &operator=(const BusCaptureWriter &) = delete;
+
+    bool open(const std::string &file_path, model::EBusProtocol protocol);
+    bool close();
+
+    void record(uint8_t flags, uint32_t id, const uint8_t *data, size_t length);
+    void write(const CaptureRecord &record);
+
+    bool isOpen() const;
+    uint32_t getRecordCount() const;
+
+    static constexpr uint16_t VERSION = 1;
+    static constexpr uint32_t INDEX_INTERVAL = 1024;
+
+private:
+    bool flush();
+
+private:
+    std::ofstream _file;
+    std::vector<uint8_t> _buffer;
+    std::vector<std::pair<uint32_t, uint64_t>> _index;
+
+    std::chrono::steady_clock::time_point _start_time;
+    uint64_t _offset{0};
+    uint32_t _record_count{0};
+
+    static constexpr size_t FLUSH_SIZE = 64 * 1024;
+};
+
+/**
+ * @brief The BusCaptureReader class reads back a capture written by BusCaptureWriter
+ */
+class BusCaptureReader
+{
+public:
+    BusCaptureReader() = default;
+
+    bool open(const std::string &file_path);
+
+    bool next(CaptureRecord &record);
+    bool seek(uint32_t record_number);
+    bool readAll(std::vector<CaptureRecord> &records);
+
+    model::EBusProtocol getProtocol() const;
+    uint64_t getStartTime() const;
+    uint32_t getRecordCount() const;
+    bool isComplete() const;
+
+private:
+    bool readRecord(CaptureRecord &record);
+    bool rebuildIndex();
+
+private:
+    std::ifstream _file;
+    std::vector<std::pair<uint32_t, uint64_t>> _index;
+
+    model::EBusProtocol _protocol{model::EBusProtocol::UNKNOWN};
+    uint64_t _start_time_us{0};
+    uint64_t _end_offset{0};
+    uint32_t _record_count{0};
+    uint32_t _next_record{0};
+    bool _complete{false};
+};
+
+/**
+ * @brief BusCaptureWriter::isOpen
+ * @return
+ */
+inline
+bool BusCaptureWriter::isOpen() const
+{
+    return _file.is_open();
+}
+
+/**
+ * @brief BusCaptureWriter::getRecordCount
+ * @return
+ */
+inline
+uint32_t BusCaptureWriter::getRecordCount() const
+{
+    return _record_count;
+}
+
+/**
+ * @brief BusCaptureReader::getProtocol
+ * @return
+ */
+inline
+model::EBusProtocol BusCaptureReader::getProtocol() const
+{
+    return _protocol;
+}
+
+/**
+ * @brief BusCaptureReader::getStartTime
+ * @return start of the capture, in us since epoch
+ */
+inline
+uint64_t BusCaptureReader::getStartTime() const
+{
+    return _start_time_us;
+}
+
+/**
+ * @brief BusCaptureReader::getRecordCount
+ * @return
+ */
+inline
+uint32_t BusCaptureReader::getRecordCount() const
+{
+    return _record_count;
+}
+
+/**
+ * @brief BusCaptureReader::isComplete
+ * @return false if the capture was interrupted before its index was written
+ */
+inline
+bool BusCaptureReader::isComplete() const
+{
+    return _complete;
+}
+
+} // namespace util
+} // namespace common
+
+#endif // BUS_CAPTURE_H
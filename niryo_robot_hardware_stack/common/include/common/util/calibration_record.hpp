@@ -0,0 +1,130 @@
+/*
+calibration_record.hpp
+Copyright (C) 2020 Niryo
+All rights reserved.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#ifndef CALIBRATION_RECORD_H
+#define CALIBRATION_RECORD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace common
+{
+namespace util
+{
+
+/**
+ * @brief The CalibrationRecord class holds the calibration data of the steppers
+ * (sensor offsets and homing absolute positions) and persists them in a binary file.
+ *
+ * File layout, all values in little endian:
+ *  - header : magic "NCAL" (4 bytes), version (uint16), number of entries (uint16), timestamp in ms (uint64)
+ *  - one entry per motor : id (uint8), flags (uint8), sensor offset (int32), homing abs position (int32)
+ *  - CRC32 of all the previous bytes (uint32)
+ *
+ * The file is written in a temporary file, synced on disk and renamed over the previous one,
+ * so that a power cut during the write keeps the previous record valid.
+ */
+class CalibrationRecord
+{
+public:
+    struct Entry
+    {
+        uint8_t id{0};
+        uint8_t flags{0};
+        int32_t sensor_offset{0};
+        int32_t homing_abs_position{0};
+    };
+
+    static constexpr uint8_t HAS_SENSOR_OFFSET = 0x01;
+    static constexpr uint8_t HAS_HOMING_ABS_POSITION = 0x02;
+
+    static constexpr uint16_t VERSION = 1;
+
+public:
+    CalibrationRecord() = default;
+
+    void clear();
+
+    void setSensorOffset(uint8_t id, int32_t sensor_offset);
+    void setHomingAbsPosition(uint8_t id, int32_t homing_abs_position);
+    void setTimestamp(uint64_t timestamp_ms);
+
+    bool getSensorOffset(uint8_t id, int32_t &sensor_offset) const;
+    bool getHomingAbsPosition(uint8_t id, int32_t &homing_abs_position) const;
+    uint64_t getTimestamp() const;
+    const std::vector<Entry> &getEntries() const;
+    bool empty() const;
+
+    std::vector<uint8_t> serialize() const;
+    bool deserialize(const std::vector<uint8_t> &buffer);
+
+    bool save(const std::string &file_path) const;
+    bool load(const std::string &file_path);
+
+    static uint32_t crc32(const uint8_t *data, size_t size);
+
+private:
+    Entry &getOrCreateEntry(uint8_t id);
+    const Entry *findEntry(uint8_t id) const;
+
+private:
+    std::vector<Entry> _entries;
+    uint64_t _timestamp_ms{0};
+
+    static constexpr size_t HEADER_SIZE = 16;
+    static constexpr size_t ENTRY_SIZE = 10;
+    static constexpr size_t CRC_SIZE = 4;
+};
+
+/**
+ * @brief CalibrationRecord::getTimestamp
+ * @return date of the calibration, in ms since epoch
+ */
+inline
+uint64_t CalibrationRecord::getTimestamp() const
+{
+    return _timestamp_ms;
+}
+
+/**
+ * @brief CalibrationRecord::getEntries
+ * @return
+ */
+inline
+const std::vector<CalibrationRecord::Entry> &CalibrationRecord::getEntries() const
+{
+    return _entries;
+}
+
+/**
+ * @brief CalibrationRecord::empty
+ * @return
+ */
+inline
+bool CalibrationRecord::empty() const
+{
+    return _entries.empty();
+}
+
+} // namespace util
+} // namespace common
+
+#endif // CALIBRATION_RECORD_H
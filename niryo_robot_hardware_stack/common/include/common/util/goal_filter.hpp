@@ -0,0 +1,185 @@
+/*
+goal_filter.hpp
+Copyright (C) 2020 Niryo
+All rights reserved.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GOAL_FILTER_H
+#define GOAL_FILTER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+namespace common
+{
+namespace util
+{
+
+/**
+ * @brief The GoalFilter class keeps track of the last goal written to each motor,
+ * to send on the bus only the goals that changed. The goals are given one slot per motor,
+ * in the same order at each call. A goal is only recorded once commit() confirms it has been written,
+ * so a goal that failed to be written is sent again at the next call.
+ * A goal is written again if it moved by more than the deadband (in motor units)
+ * or if it has not been written for keep_alive seconds.
+ * A keep alive <= 0 disables the filter (all the goals are written).
+ */
+template <typename T>
+class GoalFilter
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+public:
+    GoalFilter(int64_t deadband = 0, double keep_alive = 1.0);
+
+    void setDeadband(int64_t deadband);
+    void setKeepAlive(double keep_alive);
+
+    void resize(size_t nb_slots);
+
+    size_t filter(const std::vector<T> &goals, std::vector<uint8_t> &mask, Clock::time_point now = Clock::now());
+    void commit(const std::vector<T> &goals, const std::vector<uint8_t> &mask, Clock::time_point now = Clock::now());
+
+    void reset();
+
+private:
+    struct Goal
+    {
+        T value{};
+        Clock::time_point time;
+        bool written{false};
+    };
+
+    std::vector<Goal> _last_goals;
+
+    int64_t _deadband{0};
+    Clock::duration _keep_alive;
+    bool _enabled{true};
+};
+
+/**
+ * @brief GoalFilter<T>::GoalFilter
+ * @param deadband
+ * @param keep_alive
+ */
+template <typename T>
+GoalFilter<T>::GoalFilter(int64_t deadband, double keep_alive)
+{
+    setDeadband(deadband);
+    setKeepAlive(keep_alive);
+}
+
+/**
+ * @brief GoalFilter<T>::setDeadband
+ * @param deadband : smallest change of goal written on the bus, in motor units
+ */
+template <typename T>
+void GoalFilter<T>::setDeadband(int64_t deadband)
+{
+    _deadband = std::max<int64_t>(deadband, 0);
+}
+
+/**
+ * @brief GoalFilter<T>::setKeepAlive
+ * @param keep_alive : delay after which an unchanged goal is written again, in seconds
+ */
+template <typename T>
+void GoalFilter<T>::setKeepAlive(double keep_alive)
+{
+    _enabled = keep_alive > 0.0;
+    _keep_alive = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(keep_alive));
+    reset();
+}
+
+/**
+ * @brief GoalFilter<T>::resize : allocate one slot per motor. All the next goals will be written
+ * @param nb_slots
+ */
+template <typename T>
+void GoalFilter<T>::resize(size_t nb_slots)
+{
+    _last_goals.assign(nb_slots, Goal{});
+}
+
+/**
+ * @brief GoalFilter<T>::filter : flag the goals that need to be written
+ * @param goals : one goal per slot
+ * @param mask : set to 1 for the goals to write, 0 for the others. Sized as the goals
+ * @param now
+ * @return number of goals to write
+ */
+template <typename T>
+size_t GoalFilter<T>::filter(const std::vector<T> &goals, std::vector<uint8_t> &mask, Clock::time_point now)
+{
+    if (_last_goals.size() != goals.size())
+        resize(goals.size());
+    mask.resize(goals.size());
+
+    size_t nb_goals = 0;
+    for (size_t slot = 0; slot < goals.size(); ++slot)
+    {
+        Goal &last = _last_goals[slot];
+        if (_enabled && last.written && now - last.time < _keep_alive &&
+            std::abs(static_cast<int64_t>(goals[slot]) - static_cast<int64_t>(last.value)) <= _deadband)
+        {
+            mask[slot] = 0;
+            continue;
+        }
+
+        mask[slot] = 1;
+        nb_goals++;
+    }
+
+    return nb_goals;
+}
+
+/**
+ * @brief GoalFilter<T>::commit : record the goals actually written
+ * @param goals : the goals given to filter
+ * @param mask : set to 1 for the goals written
+ * @param now
+ */
+template <typename T>
+void GoalFilter<T>::commit(const std::vector<T> &goals, const std::vector<uint8_t> &mask, Clock::time_point now)
+{
+    if (_last_goals.size() != goals.size())
+        resize(goals.size());
+
+    for (size_t slot = 0; slot < goals.size() && slot < mask.size(); ++slot)
+    {
+        if (mask[slot])
+            _last_goals[slot] = {goals[slot], now, true};
+    }
+}
+
+/**
+ * @brief GoalFilter<T>::reset : the next goals will all be written
+ */
+template <typename T>
+void GoalFilter<T>::reset()
+{
+    for (auto &last : _last_goals)
+        last.written = false;
+}
+
+} // namespace util
+} // namespace common
+
+#endif // GOAL_FILTER_H
@@ -0,0 +1,152 @@
+/*
+joint_command_buffer.hpp
+Copyright (C) 2020 Niryo
+All rights reserved.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef JOINT_COMMAND_BUFFER_H
+#define JOINT_COMMAND_BUFFER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace common
+{
+namespace util
+{
+
+/**
+ * @brief The JointCommandBuffer class hands the joint goals of the controller thread over to a bus thread.
+ * The goals are stored in one slot per joint, the order of the slots being fixed at init.
+ * The buffers are allocated once at init : the controller fills the back buffer and publishes it by swapping
+ * it with the middle one, the bus thread takes the newest goals by swapping the middle buffer with the front one.
+ * Each side only touches its own buffer, so neither of them waits nor allocates.
+ * Each set of goals carries the time of the joint states it has been computed from.
+ */
+template <typename T>
+class JointCommandBuffer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+public:
+    JointCommandBuffer() = default;
+
+    void init(size_t nb_slots);
+
+    // controller side
+    void write(const std::vector<T> &goals, Clock::time_point stamp = Clock::time_point());
+
+    // bus side
+    const std::vector<T> *read();
+    void clear();
+    Clock::time_point getStamp() const;
+
+    size_t size() const;
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0x03;
+    static constexpr uint8_t NEW_DATA = 0x04;
+
+    std::array<std::vector<T>, 3> _buffers;
+    std::array<Clock::time_point, 3> _stamps;
+
+    uint8_t _back{0};
+    uint8_t _front{1};
+    std::atomic<uint8_t> _middle{2};
+};
+
+/**
+ * @brief JointCommandBuffer<T>::init : allocate the buffers. Must not be called while the buffer is read or written
+ * @param nb_slots : number of joints
+ */
+template <typename T>
+void JointCommandBuffer<T>::init(size_t nb_slots)
+{
+    for (auto &buffer : _buffers)
+        buffer.assign(nb_slots, T{});
+    _stamps.fill(Clock::time_point());
+
+    _back = 0;
+    _front = 1;
+    _middle.store(2);
+}
+
+/**
+ * @brief JointCommandBuffer<T>::write : publish a new set of goals, replacing the one not read yet if any
+ * @param goals : one goal per slot
+ * @param stamp : time of the joint states the goals have been computed from
+ */
+template <typename T>
+void JointCommandBuffer<T>::write(const std::vector<T> &goals, Clock::time_point stamp)
+{
+    // same size as the slots, the capacity is reused
+    _buffers.at(_back).assign(goals.begin(), goals.end());
+    _stamps.at(_back) = stamp;
+    _back = static_cast<uint8_t>(_middle.exchange(static_cast<uint8_t>(_back | NEW_DATA)) & INDEX_MASK);
+}
+
+/**
+ * @brief JointCommandBuffer<T>::read
+ * @return the newest goals, or nullptr if no goals have been written since the last read.
+ * The goals stay valid until the next read or clear
+ */
+template <typename T>
+const std::vector<T> *JointCommandBuffer<T>::read()
+{
+    if (!(_middle.load() & NEW_DATA))
+        return nullptr;
+
+    _front = static_cast<uint8_t>(_middle.exchange(_front) & INDEX_MASK);
+    return &_buffers.at(_front);
+}
+
+/**
+ * @brief JointCommandBuffer<T>::clear : drop the goals not read yet
+ */
+template <typename T>
+void JointCommandBuffer<T>::clear()
+{
+    read();
+}
+
+/**
+ * @brief JointCommandBuffer<T>::getStamp
+ * @return stamp of the goals returned by the last read
+ */
+template <typename T>
+typename JointCommandBuffer<T>::Clock::time_point JointCommandBuffer<T>::getStamp() const
+{
+    return _stamps.at(_front);
+}
+
+/**
+ * @brief JointCommandBuffer<T>::size
+ * @return
+ */
+template <typename T>
+size_t JointCommandBuffer<T>::size() const
+{
+    return _buffers.at(_front).size();
+}
+
+} // namespace util
+} // namespace common
+
+#endif // JOINT_COMMAND_BUFFER_H
@@ -0,0 +1,90 @@
+/*
+latency_histogram.hpp
+Copyright (C) 2020 Niryo
+All rights reserved.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace common
+{
+namespace util
+{
+
+/**
+ * @brief The LatencyHistogram class counts latencies in buckets of fixed width, allocated once.
+ * The latencies above the last bucket are counted in an overflow bucket.
+ * Percentiles are given with the resolution of a bucket.
+ */
+class LatencyHistogram
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+public:
+    LatencyHistogram(uint32_t bucket_width_us = 250, size_t nb_buckets = 200);
+
+    void record(Clock::duration latency);
+    void reset();
+
+    uint64_t getCount() const;
+    uint64_t getMaxUs() const;
+    double getMeanUs() const;
+    uint64_t getPercentileUs(double percentile) const;
+
+    std::string str() const;
+
+private:
+    uint32_t _bucket_width_us;
+    // last bucket is the overflow
+    std::vector<uint64_t> _buckets;
+
+    uint64_t _count{0};
+    uint64_t _sum_us{0};
+    uint64_t _max_us{0};
+};
+
+/**
+ * @brief LatencyHistogram::getCount
+ * @return
+ */
+inline
+uint64_t LatencyHistogram::getCount() const
+{
+    return _count;
+}
+
+/**
+ * @brief LatencyHistogram::getMaxUs
+ * @return
+ */
+inline
+uint64_t LatencyHistogram::getMaxUs() const
+{
+    return _max_us;
+}
+
+} // namespace util
+} // namespace common
+
+#endif // LATENCY_HISTOGRAM_H
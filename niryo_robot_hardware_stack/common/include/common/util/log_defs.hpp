@@ -0,0 +1,74 @@
+/*
+log_defs.hpp
+Copyright (C) 2020 Niryo
+All rights reserved.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#ifndef LOG_DEFS_H
+#define LOG_DEFS_H
+
+// std
+#include <sstream>
+#include <string>
+#include <vector>
+
+// ros
+#include <ros/console.h>
+
+/**
+ * Trace points for the hot paths of the hardware stack (control loops, bus read/write).
+ *
+ * As for the ROS_DEBUG macros they wrap, the arguments are only evaluated if the debug level
+ * is enabled for the logger, so expensive formatting (cmd->str(), listToString...)
+ * must be done inside the macro arguments and never before.
+ *
+ * They are removed at compile time (arguments included) when HW_TRACE_ENABLED is not defined,
+ * see the HW_TRACE cmake option declared by common for all the packages using it.
+ */
+#ifdef HW_TRACE_ENABLED
+#define HW_TRACE(...) ROS_DEBUG(__VA_ARGS__)
+#define HW_TRACE_COND(cond, ...) ROS_DEBUG_COND(cond, __VA_ARGS__)
+#define HW_TRACE_THROTTLE(period, ...) ROS_DEBUG_THROTTLE(period, __VA_ARGS__)
+#else
+#define HW_TRACE(...) do {} while (false)
+#define HW_TRACE_COND(cond, ...) do {} while (false)
+#define HW_TRACE_THROTTLE(period, ...) do {} while (false)
+#endif
+
+namespace common
+{
+namespace util
+{
+
+/**
+ * @brief listToString : formats a list of values as "v1 v2 v3". To be called only inside log macros arguments
+ * @param list
+ * @return
+ */
+template <typename T>
+std::string listToString(const std::vector<T>& list)
+{
+    std::ostringstream ss;
+    for (auto const& v : list)
+        ss << +v << " ";
+
+    return ss.str();
+}
+
+} // util
+} // common
+
+#endif // LOG_DEFS_H
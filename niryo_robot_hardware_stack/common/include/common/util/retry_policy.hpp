@@ -0,0 +1,103 @@
+/*
+retry_policy.hpp
+Copyright (C) 2020 Niryo
+All rights reserved.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#ifndef RETRY_POLICY_H
+#define RETRY_POLICY_H
+
+#include <chrono>
+#include <cstdint>
+
+namespace common
+{
+namespace util
+{
+
+/**
+ * @brief The RetryPolicy class decides what to do after a failed attempt of a command.
+ * The wait between two attempts doubles from the first backoff up to the max backoff, and is never
+ * taken if it would end after the deadline given by the caller : the command is then left for a later call
+ * (the next cycle of a control loop for instance), its attempts being counted until it succeeds or gives up.
+ */
+class RetryPolicy
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief The Budget struct : attempts and waits allowed for a class of commands
+     */
+    struct Budget
+    {
+        // attempts over all the calls, the first one included
+        uint32_t max_attempts;
+        uint32_t first_backoff_us;
+        uint32_t max_backoff_us;
+    };
+
+    /**
+     * @brief The EDecision enum : what to do after a failed attempt
+     */
+    enum class EDecision
+    {
+        RETRY,
+        RETRY_LATER,
+        GIVE_UP
+    };
+
+public:
+    explicit RetryPolicy(const Budget &budget);
+
+    EDecision onFailure(Clock::time_point deadline = Clock::time_point::max());
+    void reset();
+
+    uint32_t getAttempts() const;
+    const Budget &getBudget() const;
+
+private:
+    uint32_t getBackoffUs() const;
+
+private:
+    Budget _budget;
+    uint32_t _attempts{0};
+};
+
+/**
+ * @brief RetryPolicy::getAttempts
+ * @return failed attempts since the last reset
+ */
+inline
+uint32_t RetryPolicy::getAttempts() const
+{
+    return _attempts;
+}
+
+/**
+ * @brief RetryPolicy::getBudget
+ * @return
+ */
+inline
+const RetryPolicy::Budget &RetryPolicy::getBudget() const
+{
+    return _budget;
+}
+
+} // namespace util
+} // namespace common
+
+#endif // RETRY_POLICY_H
@@ -0,0 +1,204 @@
+/*
+trajectory_segmenter.hpp
+Copyright (C) 2020 Niryo
+All rights reserved.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TRAJECTORY_SEGMENTER_H
+#define TRAJECTORY_SEGMENTER_H
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace common
+{
+namespace util
+{
+
+/**
+ * @brief The TrajectorySegmenter class cuts the goals given by the controller at each cycle into segments
+ * of a fixed duration, to be executed by the motors themselves : at the end of a segment, each motor is given
+ * the goal the controller reached and the time it took, instead of one goal per cycle.
+ * The motion is delayed by one segment, but no longer depends on the bus keeping up with the controller.
+ * The goals are given one slot per motor, in the same order at each call, and only the enabled slots are cut.
+ * A duration <= 0 disables the segments.
+ */
+template <typename T>
+class TrajectorySegmenter
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+public:
+    TrajectorySegmenter(double duration = 0.0);
+
+    void setDuration(double duration);
+    bool isEnabled() const;
+
+    void setSlots(const std::vector<uint8_t> &enabled_slots);
+    const std::vector<uint8_t> &getSlots() const;
+
+    bool update(const std::vector<T> &goals, Clock::time_point now = Clock::now());
+
+    const std::vector<T> &getStartGoals() const;
+    const std::vector<T> &getEndGoals() const;
+    double getElapsed() const;
+
+    void reset();
+
+private:
+    std::vector<uint8_t> _slots;
+
+    std::vector<T> _start_goals;
+    std::vector<T> _end_goals;
+
+    Clock::duration _duration{};
+    Clock::time_point _segment_start;
+    double _elapsed{0.0};
+    bool _started{false};
+};
+
+/**
+ * @brief TrajectorySegmenter<T>::TrajectorySegmenter
+ * @param duration
+ */
+template <typename T>
+TrajectorySegmenter<T>::TrajectorySegmenter(double duration)
+{
+    setDuration(duration);
+}
+
+/**
+ * @brief TrajectorySegmenter<T>::setDuration
+ * @param duration : time between two segments, in seconds
+ */
+template <typename T>
+void TrajectorySegmenter<T>::setDuration(double duration)
+{
+    _duration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(duration > 0.0 ? duration : 0.0));
+    reset();
+}
+
+/**
+ * @brief TrajectorySegmenter<T>::isEnabled
+ * @return
+ */
+template <typename T>
+bool TrajectorySegmenter<T>::isEnabled() const
+{
+    return _duration > Clock::duration::zero();
+}
+
+/**
+ * @brief TrajectorySegmenter<T>::setSlots : allocate one slot per motor. The next segment starts from the next goals
+ * @param enabled_slots : 1 for the motors executing the segments, 0 for the others
+ */
+template <typename T>
+void TrajectorySegmenter<T>::setSlots(const std::vector<uint8_t> &enabled_slots)
+{
+    _slots = enabled_slots;
+    _start_goals.assign(_slots.size(), T{});
+    _end_goals.assign(_slots.size(), T{});
+    reset();
+}
+
+/**
+ * @brief TrajectorySegmenter<T>::getSlots
+ * @return
+ */
+template <typename T>
+const std::vector<uint8_t> &TrajectorySegmenter<T>::getSlots() const
+{
+    return _slots;
+}
+
+/**
+ * @brief TrajectorySegmenter<T>::update : close the current segment if its duration has elapsed
+ * @param goals : one goal per slot
+ * @param now
+ * @return true if a segment has been closed, its goals being given by getStartGoals and getEndGoals
+ */
+template <typename T>
+bool TrajectorySegmenter<T>::update(const std::vector<T> &goals, Clock::time_point now)
+{
+    if (!isEnabled() || goals.size() != _slots.size())
+        return false;
+
+    if (!_started)
+    {
+        // the first segment starts from these goals
+        _end_goals.assign(goals.begin(), goals.end());
+        _segment_start = now;
+        _started = true;
+        return false;
+    }
+
+    if (now - _segment_start < _duration)
+        return false;
+
+    // the end of the previous segment is the start of this one, the buffers are only swapped
+    _start_goals.swap(_end_goals);
+    _end_goals.assign(goals.begin(), goals.end());
+    _elapsed = std::chrono::duration<double>(now - _segment_start).count();
+    _segment_start = now;
+
+    return true;
+}
+
+/**
+ * @brief TrajectorySegmenter<T>::getStartGoals
+ * @return goals at the start of the last segment closed
+ */
+template <typename T>
+const std::vector<T> &TrajectorySegmenter<T>::getStartGoals() const
+{
+    return _start_goals;
+}
+
+/**
+ * @brief TrajectorySegmenter<T>::getEndGoals
+ * @return goals at the end of the last segment closed
+ */
+template <typename T>
+const std::vector<T> &TrajectorySegmenter<T>::getEndGoals() const
+{
+    return _end_goals;
+}
+
+/**
+ * @brief TrajectorySegmenter<T>::getElapsed
+ * @return duration of the last segment closed, in seconds. At least the configured duration
+ */
+template <typename T>
+double TrajectorySegmenter<T>::getElapsed() const
+{
+    return _elapsed;
+}
+
+/**
+ * @brief TrajectorySegmenter<T>::reset : the next segment starts from the next goals
+ */
+template <typename T>
+void TrajectorySegmenter<T>::reset()
+{
+    _started = false;
+}
+
+} // namespace util
+} // namespace common
+
+#endif // TRAJECTORY_SEGMENTER_H
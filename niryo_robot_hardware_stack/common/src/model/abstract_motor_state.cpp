@@ -53,6 +53,7 @@ void AbstractMotorState::reset()
 {
     AbstractHardwareState::reset();
     _position = 0;
+    _position_time = Clock::time_point();
 }
 
 /**
@@ -81,6 +82,17 @@ string AbstractMotorState::str() const
  */
 void AbstractMotorState::setPosition(int pos) { _position = pos; }
 
+/**
+ * @brief AbstractMotorState::setPosition
+ * @param pos
+ * @param sample_time : time at which the position arrived from the bus
+ */
+void AbstractMotorState::setPosition(int pos, Clock::time_point sample_time)
+{
+    _position = pos;
+    _position_time = sample_time;
+}
+
 /**
  * @brief AbstractMotorState::setVelocity
  * @param vel
@@ -18,7 +18,6 @@
 */
 
 #include "common/model/action_type_enum.hpp"
-#include <map>
 #include <string>
 
 namespace common
@@ -38,22 +37,5 @@ ActionTypeEnum::ActionTypeEnum(EActionType e) : AbstractEnum<ActionTypeEnum, EAc
  */
 ActionTypeEnum::ActionTypeEnum(const char *const str) : AbstractEnum<ActionTypeEnum, EActionType>(str) {}
 
-/**
- * @brief ActionTypeEnum::initialize
- * @return
- */
-std::map<EActionType, std::string> ActionTypeEnum::initialize()
-{
-    std::map<EActionType, std::string> m;
-
-    m[EActionType::HANDLE_HELD_ACTION] = "handle held action";
-    m[EActionType::LONG_PUSH_ACTION] = "long push action";
-    m[EActionType::SINGLE_PUSH_ACTION] = "single push action";
-    m[EActionType::DOUBLE_PUSH_ACTION] = "double push action";
-    m[EActionType::NO_ACTION] = "no action";
-
-    return m;
-}
-
 }  // namespace model
 }  // namespace common
@@ -18,7 +18,6 @@
 */
 
 #include "common/model/bus_protocol_enum.hpp"
-#include <map>
 #include <string>
 
 namespace common
@@ -38,20 +37,5 @@ BusProtocolEnum::BusProtocolEnum(EBusProtocol e) : AbstractEnum<BusProtocolEnum,
  */
 BusProtocolEnum::BusProtocolEnum(const char *const str) : AbstractEnum<BusProtocolEnum, EBusProtocol>(str) {}
 
-/**
- * @brief BusProtocolEnum::initialize
- * @return
- */
-std::map<EBusProtocol, std::string> BusProtocolEnum::initialize()
-{
-    std::map<EBusProtocol, std::string> m;
-
-    m[EBusProtocol::TTL] = "ttl";
-    m[EBusProtocol::CAN] = "can";
-    m[EBusProtocol::UNKNOWN] = "unknown";
-
-    return m;
-}
-
 }  // namespace model
 }  // namespace common
@@ -18,7 +18,6 @@
 */
 
 #include "common/model/button_type_enum.hpp"
-#include <map>
 #include <string>
 
 namespace common
@@ -38,21 +37,5 @@ ButtonTypeEnum::ButtonTypeEnum(EButtonType e) : AbstractEnum<ButtonTypeEnum, EBu
  */
 ButtonTypeEnum::ButtonTypeEnum(const char *const str) : AbstractEnum<ButtonTypeEnum, EButtonType>(str) {}
 
-/**
- * @brief ButtonTypeEnum::initialize
- * @return
- */
-std::map<EButtonType, std::string> ButtonTypeEnum::initialize()
-{
-    std::map<EButtonType, std::string> m;
-
-    m[EButtonType::FREE_DRIVE_BUTTON] = "free_drive";
-    m[EButtonType::SAVE_POSITION_BUTTON] = "save_position";
-    m[EButtonType::CUSTOM_BUTTON] = "custom";
-    m[EButtonType::UNKNOWN] = "unknown";
-
-    return m;
-}
-
 }  // namespace model
 }  // namespace common
@@ -18,7 +18,6 @@
 */
 
 #include "common/model/component_type_enum.hpp"
-#include <map>
 #include <string>
 
 namespace common
@@ -38,22 +37,5 @@ ComponentTypeEnum::ComponentTypeEnum(EComponentType e) : AbstractEnum<ComponentT
  */
 ComponentTypeEnum::ComponentTypeEnum(const char *const str) : AbstractEnum<ComponentTypeEnum, EComponentType>(str) {}
 
-/**
- * @brief ComponentTypeEnum::initialize
- * @return
- */
-std::map<EComponentType, std::string> ComponentTypeEnum::initialize()
-{
-    std::map<EComponentType, std::string> m;
-
-    m[EComponentType::TOOL] = "tool";
-    m[EComponentType::CONVEYOR] = "conveyor";
-    m[EComponentType::JOINT] = "joint";
-    m[EComponentType::END_EFFECTOR] = "end effector";
-    m[EComponentType::UNKNOWN] = "unknown";
-
-    return m;
-}
-
 }  // namespace model
 }  // namespace common
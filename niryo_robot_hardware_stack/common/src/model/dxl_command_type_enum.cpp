@@ -19,7 +19,6 @@
 
 #include "common/model/dxl_command_type_enum.hpp"
 
-#include <map>
 #include <string>
 
 namespace common
@@ -39,31 +38,5 @@ DxlCommandTypeEnum::DxlCommandTypeEnum(EDxlCommandType e) : AbstractEnum<DxlComm
  */
 DxlCommandTypeEnum::DxlCommandTypeEnum(const char *const str) : AbstractEnum<DxlCommandTypeEnum, EDxlCommandType>(str) {}
 
-/**
- * @brief DxlCommandTypeEnum::initialize
- * @return
- */
-std::map<EDxlCommandType, std::string> DxlCommandTypeEnum::initialize()
-{
-    std::map<EDxlCommandType, std::string> m;
-
-    m[EDxlCommandType::CMD_TYPE_POSITION] = "position";
-    m[EDxlCommandType::CMD_TYPE_VELOCITY] = "velocity";
-    m[EDxlCommandType::CMD_TYPE_EFFORT] = "effort";
-    m[EDxlCommandType::CMD_TYPE_TORQUE] = "torque";
-    m[EDxlCommandType::CMD_TYPE_PING] = "ping";
-    m[EDxlCommandType::CMD_TYPE_LEARNING_MODE] = "learning mode";
-    m[EDxlCommandType::CMD_TYPE_PID] = "PID";
-    m[EDxlCommandType::CMD_TYPE_CONTROL_MODE] = "Control Mode";
-    m[EDxlCommandType::CMD_TYPE_LED_STATE] = "Led State";
-    m[EDxlCommandType::CMD_TYPE_PROFILE] = "Velocity and Acceleration profile";
-    m[EDxlCommandType::CMD_TYPE_STARTUP] = "Startup Configuration";
-    m[EDxlCommandType::CMD_TYPE_TEMPERATURE_LIMIT] = "Temperature limit";
-    m[EDxlCommandType::CMD_TYPE_SHUTDOWN] = "Shutdown when error occurs";
-    m[EDxlCommandType::CMD_TYPE_UNKNOWN] = "unknown type";
-
-    return m;
-}
-
 }  // namespace model
 }  // namespace common
@@ -19,7 +19,6 @@
 
 #include "common/model/end_effector_command_type_enum.hpp"
 
-#include <map>
 #include <string>
 
 namespace common
@@ -39,21 +38,5 @@ EndEffectorCommandTypeEnum::EndEffectorCommandTypeEnum(EEndEffectorCommandType e
  */
 EndEffectorCommandTypeEnum::EndEffectorCommandTypeEnum(const char *const str) : AbstractEnum<EndEffectorCommandTypeEnum, EEndEffectorCommandType>(str) {}
 
-/**
- * @brief EndEffectorCommandTypeEnum::initialize
- * @return
- */
-std::map<EEndEffectorCommandType, std::string> EndEffectorCommandTypeEnum::initialize()
-{
-    std::map<EEndEffectorCommandType, std::string> m;
-
-    m[EEndEffectorCommandType::CMD_TYPE_DIGITAL_OUTPUT] = "digit input cmd";
-    m[EEndEffectorCommandType::CMD_TYPE_PING] = "ping";
-    m[EEndEffectorCommandType::CMD_TYPE_SET_COLLISION_THRESH] = "set collision threshold cmd";
-    m[EEndEffectorCommandType::CMD_TYPE_UNKNOWN] = "unknown type";
-
-    return m;
-}
-
 }  // namespace model
 }  // namespace common
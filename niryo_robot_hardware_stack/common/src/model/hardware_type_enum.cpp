@@ -18,7 +18,6 @@
 */
 
 #include "common/model/hardware_type_enum.hpp"
-#include <map>
 #include <string>
 
 namespace common
@@ -38,28 +37,5 @@ HardwareTypeEnum::HardwareTypeEnum(EHardwareType e) : AbstractEnum<HardwareTypeE
  */
 HardwareTypeEnum::HardwareTypeEnum(const char *const str) : AbstractEnum<HardwareTypeEnum, EHardwareType>(str) {}
 
-/**
- * @brief HardwareTypeEnum::initialize
- * @return
- */
-std::map<EHardwareType, std::string> HardwareTypeEnum::initialize()
-{
-    std::map<EHardwareType, std::string> m;
-
-    m[EHardwareType::STEPPER] = "stepper";
-    m[EHardwareType::XL430] = "xl430";
-    m[EHardwareType::XL320] = "xl320";
-    m[EHardwareType::XL330] = "xl330";
-    m[EHardwareType::XC430] = "xc430";
-    m[EHardwareType::XM430] = "xm430";
-    m[EHardwareType::FAKE_DXL_MOTOR] = "fakeDxl";
-    m[EHardwareType::FAKE_STEPPER_MOTOR] = "fakeStepper";
-    m[EHardwareType::END_EFFECTOR] = "end_effector";
-    m[EHardwareType::FAKE_END_EFFECTOR] = "fake_end_effector";
-    m[EHardwareType::UNKNOWN] = "unknown";
-
-    return m;
-}
-
 }  // namespace model
 }  // namespace common
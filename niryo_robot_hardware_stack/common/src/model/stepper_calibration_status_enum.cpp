@@ -19,7 +19,6 @@
 
 #include "common/model/stepper_calibration_status_enum.hpp"
 
-#include <map>
 #include <string>
 
 namespace common
@@ -39,24 +38,5 @@ StepperCalibrationStatusEnum::StepperCalibrationStatusEnum(EStepperCalibrationSt
  */
 StepperCalibrationStatusEnum::StepperCalibrationStatusEnum(const char *const str) : AbstractEnum<StepperCalibrationStatusEnum, EStepperCalibrationStatus>(str) {}
 
-/**
- * @brief StepperCalibrationStatusEnum::initialize
- * @return
- */
-std::map<EStepperCalibrationStatus, std::string> StepperCalibrationStatusEnum::initialize()
-{
-    std::map<EStepperCalibrationStatus, std::string> m;
-
-    m[EStepperCalibrationStatus::UNINITIALIZED] = "uninitialized";
-    m[EStepperCalibrationStatus::OK] = "ok";
-    m[EStepperCalibrationStatus::TIMEOUT] = "timeout";
-    m[EStepperCalibrationStatus::BAD_PARAM] = "bad parameter";
-    m[EStepperCalibrationStatus::FAIL] = "fail";
-    m[EStepperCalibrationStatus::WAITING_USER_INPUT] = "waiting user input";
-    m[EStepperCalibrationStatus::IN_PROGRESS] = "in progress";
-
-    return m;
-}
-
 }  // namespace model
 }  // namespace common
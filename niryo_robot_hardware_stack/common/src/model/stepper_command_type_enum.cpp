@@ -19,7 +19,6 @@
 
 #include "common/model/stepper_command_type_enum.hpp"
 
-#include <map>
 #include <string>
 
 namespace common
@@ -39,37 +38,5 @@ StepperCommandTypeEnum::StepperCommandTypeEnum(EStepperCommandType e) : Abstract
  */
 StepperCommandTypeEnum::StepperCommandTypeEnum(const char *const str) : AbstractEnum<StepperCommandTypeEnum, EStepperCommandType>(str) {}
 
-/**
- * @brief StepperCommandTypeEnum::initialize
- * @return
- */
-std::map<EStepperCommandType, std::string> StepperCommandTypeEnum::initialize()
-{
-    std::map<EStepperCommandType, std::string> m;
-
-    m[EStepperCommandType::CMD_TYPE_NONE] = "none";
-    m[EStepperCommandType::CMD_TYPE_POSITION] = "position";
-    m[EStepperCommandType::CMD_TYPE_VELOCITY] = "velocity";
-    m[EStepperCommandType::CMD_TYPE_EFFORT] = "effort";
-    m[EStepperCommandType::CMD_TYPE_TORQUE] = "torque";
-    m[EStepperCommandType::CMD_TYPE_SYNCHRONIZE] = "synchronize";
-    m[EStepperCommandType::CMD_TYPE_RELATIVE_MOVE] = "relative move";
-    m[EStepperCommandType::CMD_TYPE_MAX_EFFORT] = "max effort";
-    m[EStepperCommandType::CMD_TYPE_MICRO_STEPS] = "micro steps";
-    m[EStepperCommandType::CMD_TYPE_POSITION_OFFSET] = "position offset";
-    m[EStepperCommandType::CMD_TYPE_CALIBRATION] = "calibration";
-    m[EStepperCommandType::CMD_TYPE_CONVEYOR] = "conveyor";
-    m[EStepperCommandType::CMD_TYPE_UPDATE_CONVEYOR] = "update conveyor";
-    m[EStepperCommandType::CMD_TYPE_LEARNING_MODE] = "learning mode";
-    m[EStepperCommandType::CMD_TYPE_PING] = "ping";
-    m[EStepperCommandType::CMD_TYPE_CALIBRATION_SETUP] = "calibration setup";
-    m[EStepperCommandType::CMD_TYPE_VELOCITY_PROFILE] = "velocity profile";
-    m[EStepperCommandType::CMD_TYPE_READ_HOMING_ABS_POSITION] = "homing abs read position";
-    m[EStepperCommandType::CMD_TYPE_WRITE_HOMING_ABS_POSITION] = "homing abs write position";
-    m[EStepperCommandType::CMD_TYPE_UNKNOWN] = "unknown type";
-
-    return m;
-}
-
 }  // namespace model
 }  // namespace common
@@ -0,0 +1,401 @@
+/*
+bus_capture.cpp
+Copyright (C) 2020 Niryo
+All rights reserved.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "common/util/bus_capture.hpp"
+
+// std
+#include <algorithm>
+#include <array>
+#include <type_traits>
+
+namespace common
+{
+namespace util
+{
+
+// definitions needed when the constants are bound to references
+constexpr uint8_t CaptureRecord::TX;
+constexpr uint8_t CaptureRecord::RX;
+constexpr uint8_t CaptureRecord::ERROR;
+constexpr uint16_t BusCaptureWriter::VERSION;
+constexpr uint32_t BusCaptureWriter::INDEX_INTERVAL;
+constexpr size_t BusCaptureWriter::FLUSH_SIZE;
+
+namespace
+{
+constexpr std::array<uint8_t, 4> MAGIC{{'N', 'C', 'A', 'P'}};
+constexpr std::array<uint8_t, 4> INDEX_MAGIC{{'N', 'I', 'D', 'X'}};
+
+constexpr size_t HEADER_SIZE = 16;
+constexpr size_t RECORD_HEADER_SIZE = 15;
+constexpr size_t INDEX_ENTRY_SIZE = 12;
+constexpr size_t FOOTER_SIZE = 16;
+
+template <typename T>
+void writeLE(std::vector<uint8_t> &buffer, T value)
+{
+    auto v = static_cast<typename std::make_unsigned<T>::type>(value);
+    for (size_t i = 0; i < sizeof(T); ++i)
+        buffer.emplace_back(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+template <typename T>
+T readLE(const uint8_t *data)
+{
+    typename std::make_unsigned<T>::type v = 0;
+    for (size_t i = 0; i < sizeof(T); ++i)
+        v |= static_cast<typename std::make_unsigned<T>::type>(data[i]) << (8 * i);
+    return static_cast<T>(v);
+}
+
+/**
+ * @brief readBytes : read exactly size bytes from the file
+ */
+bool readBytes(std::ifstream &file, uint8_t *data, size_t size)
+{
+    file.read(reinterpret_cast<char *>(data), static_cast<std::streamsize>(size));
+    return static_cast<size_t>(file.gcount()) == size;
+}
+}  // namespace
+
+/**
+ * @brief BusCaptureWriter::~BusCaptureWriter
+ */
+BusCaptureWriter::~BusCaptureWriter()
+{
+    close();
+}
+
+/**
+ * @brief BusCaptureWriter::open : create the file and write the header. The timestamps of the records start here
+ * @param file_path
+ * @param protocol
+ * @return
+ */
+bool BusCaptureWriter::open(const std::string &file_path, model::EBusProtocol protocol)
+{
+    close();
+
+    _file.open(file_path, std::ios::binary | std::ios::trunc);
+    if (!_file.is_open())
+        return false;
+
+    _buffer.clear();
+    _buffer.reserve(FLUSH_SIZE + RECORD_HEADER_SIZE + UINT16_MAX);
+    _index.clear();
+    _record_count = 0;
+
+    auto now_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    _start_time = std::chrono::steady_clock::now();
+
+    _buffer.insert(_buffer.end(), MAGIC.begin(), MAGIC.end());
+    writeLE<uint16_t>(_buffer, VERSION);
+    writeLE<uint8_t>(_buffer, static_cast<uint8_t>(protocol));
+    writeLE<uint8_t>(_buffer, 0);
+    writeLE<uint64_t>(_buffer, static_cast<uint64_t>(now_us));
+    _offset = _buffer.size();
+
+    return flush();
+}
+
+/**
+ * @brief BusCaptureWriter::close : write the remaining records, the index and the footer
+ * @return
+ */
+bool BusCaptureWriter::close()
+{
+    if (!_file.is_open())
+        return false;
+
+    uint64_t index_offset = _offset;
+    for (auto const &entry : _index)
+    {
+        writeLE<uint32_t>(_buffer, entry.first);
+        writeLE<uint64_t>(_buffer, entry.second);
+    }
+
+    writeLE<uint64_t>(_buffer, index_offset);
+    writeLE<uint32_t>(_buffer, _record_count);
+    _buffer.insert(_buffer.end(), INDEX_MAGIC.begin(), INDEX_MAGIC.end());
+
+    bool res = flush();
+    _file.close();
+
+    return res;
+}
+
+/**
+ * @brief BusCaptureWriter::record : add a record timestamped now
+ * @param flags
+ * @param id
+ * @param data
+ * @param length
+ */
+void BusCaptureWriter::record(uint8_t flags, uint32_t id, const uint8_t *data, size_t length)
+{
+    if (!_file.is_open())
+        return;
+
+    auto timestamp_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _start_time).count();
+    length = std::min(length, static_cast<size_t>(UINT16_MAX));
+
+    if (0 == _record_count % INDEX_INTERVAL)
+        _index.emplace_back(_record_count, _offset);
+
+    writeLE<uint64_t>(_buffer, static_cast<uint64_t>(timestamp_us));
+    writeLE<uint8_t>(_buffer, flags);
+    writeLE<uint32_t>(_buffer, id);
+    writeLE<uint16_t>(_buffer, static_cast<uint16_t>(length));
+    _buffer.insert(_buffer.end(), data, data + length);
+
+    _offset += RECORD_HEADER_SIZE + length;
+    _record_count++;
+
+    if (_buffer.size() >= FLUSH_SIZE)
+        flush();
+}
+
+/**
+ * @brief BusCaptureWriter::write : add a record keeping its timestamp (used to convert or filter captures)
+ * @param record
+ */
+void BusCaptureWriter::write(const CaptureRecord &record)
+{
+    if (!_file.is_open())
+        return;
+
+    size_t length = std::min(record.data.size(), static_cast<size_t>(UINT16_MAX));
+
+    if (0 == _record_count % INDEX_INTERVAL)
+        _index.emplace_back(_record_count, _offset);
+
+    writeLE<uint64_t>(_buffer, record.timestamp_us);
+    writeLE<uint8_t>(_buffer, record.flags);
+    writeLE<uint32_t>(_buffer, record.id);
+    writeLE<uint16_t>(_buffer, static_cast<uint16_t>(length));
+    _buffer.insert(_buffer.end(), record.data.begin(), record.data.begin() + static_cast<std::ptrdiff_t>(length));
+
+    _offset += RECORD_HEADER_SIZE + length;
+    _record_count++;
+
+    if (_buffer.size() >= FLUSH_SIZE)
+        flush();
+}
+
+/**
+ * @brief BusCaptureWriter::flush
+ * @return
+ */
+bool BusCaptureWriter::flush()
+{
+    _file.write(reinterpret_cast<const char *>(_buffer.data()), static_cast<std::streamsize>(_buffer.size()));
+    _buffer.clear();
+    _file.flush();
+
+    return _file.good();
+}
+
+/**
+ * @brief BusCaptureReader::open : read the header and the index
+ * @param file_path
+ * @return false if the file is not a capture
+ */
+bool BusCaptureReader::open(const std::string &file_path)
+{
+    if (_file.is_open())
+        _file.close();
+
+    _file.open(file_path, std::ios::binary);
+    if (!_file.is_open())
+        return false;
+
+    std::array<uint8_t, HEADER_SIZE> header{};
+    if (!readBytes(_file, header.data(), header.size()) || !std::equal(MAGIC.begin(), MAGIC.end(), header.begin()) ||
+        BusCaptureWriter::VERSION != readLE<uint16_t>(&header[4]))
+        return false;
+
+    _protocol = static_cast<model::EBusProtocol>(header[6]);
+    _start_time_us = readLE<uint64_t>(&header[8]);
+
+    _file.seekg(0, std::ios::end);
+    auto file_size = static_cast<uint64_t>(_file.tellg());
+
+    // read the footer
+    std::array<uint8_t, FOOTER_SIZE> footer{};
+    _complete = false;
+    if (file_size >= HEADER_SIZE + FOOTER_SIZE)
+    {
+        _file.seekg(static_cast<std::streamoff>(file_size - FOOTER_SIZE));
+        _complete = readBytes(_file, footer.data(), footer.size()) && std::equal(INDEX_MAGIC.begin(), INDEX_MAGIC.end(), footer.begin() + 12);
+    }
+
+    if (_complete)
+    {
+        _end_offset = readLE<uint64_t>(&footer[0]);
+        _record_count = readLE<uint32_t>(&footer[8]);
+
+        uint64_t index_size = file_size - FOOTER_SIZE - _end_offset;
+        _complete = _end_offset >= HEADER_SIZE && _end_offset <= file_size - FOOTER_SIZE && 0 == index_size % INDEX_ENTRY_SIZE;
+
+        if (_complete)
+        {
+            std::vector<uint8_t> index(index_size);
+            _file.seekg(static_cast<std::streamoff>(_end_offset));
+            _complete = readBytes(_file, index.data(), index.size());
+
+            _index.clear();
+            for (size_t i = 0; _complete && i < index.size(); i += INDEX_ENTRY_SIZE)
+                _index.emplace_back(readLE<uint32_t>(&index[i]), readLE<uint64_t>(&index[i + 4]));
+        }
+    }
+
+    // interrupted capture : the records go up to the end of the file
+    if (!_complete)
+    {
+        _end_offset = file_size;
+        if (!rebuildIndex())
+            return false;
+    }
+
+    return seek(0);
+}
+
+/**
+ * @brief BusCaptureReader::next
+ * @param record
+ * @return false at the end of the capture
+ */
+bool BusCaptureReader::next(CaptureRecord &record)
+{
+    if (_next_record >= _record_count || !readRecord(record))
+        return false;
+
+    _next_record++;
+    return true;
+}
+
+/**
+ * @brief BusCaptureReader::seek : go to the given record, using the index to skip the beginning of the file
+ * @param record_number
+ * @return
+ */
+bool BusCaptureReader::seek(uint32_t record_number)
+{
+    if (record_number > _record_count)
+        return false;
+
+    auto it = std::upper_bound(_index.begin(), _index.end(), record_number,
+                               [](uint32_t number, const std::pair<uint32_t, uint64_t> &entry) { return number < entry.first; });
+
+    _file.clear();
+    if (it == _index.begin())
+    {
+        _file.seekg(static_cast<std::streamoff>(HEADER_SIZE));
+        _next_record = 0;
+    }
+    else
+    {
+        --it;
+        _file.seekg(static_cast<std::streamoff>(it->second));
+        _next_record = it->first;
+    }
+
+    CaptureRecord record;
+    while (_next_record < record_number)
+    {
+        if (!next(record))
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief BusCaptureReader::readAll : read all the records from the start of the capture
+ * @param records
+ * @return
+ */
+bool BusCaptureReader::readAll(std::vector<CaptureRecord> &records)
+{
+    if (!seek(0))
+        return false;
+
+    records.clear();
+    records.reserve(_record_count);
+
+    CaptureRecord record;
+    while (next(record))
+        records.emplace_back(std::move(record));
+
+    return records.size() == _record_count;
+}
+
+/**
+ * @brief BusCaptureReader::readRecord
+ * @param record
+ * @return
+ */
+bool BusCaptureReader::readRecord(CaptureRecord &record)
+{
+    std::array<uint8_t, RECORD_HEADER_SIZE> header{};
+    if (static_cast<uint64_t>(_file.tellg()) + RECORD_HEADER_SIZE > _end_offset || !readBytes(_file, header.data(), header.size()))
+        return false;
+
+    record.timestamp_us = readLE<uint64_t>(&header[0]);
+    record.flags = header[8];
+    record.id = readLE<uint32_t>(&header[9]);
+
+    auto length = readLE<uint16_t>(&header[13]);
+    if (static_cast<uint64_t>(_file.tellg()) + length > _end_offset)
+        return false;
+
+    record.data.resize(length);
+    return readBytes(_file, record.data.data(), length);
+}
+
+/**
+ * @brief BusCaptureReader::rebuildIndex : go through all the records of an interrupted capture.
+ * The last record is dropped if it has not been fully written
+ * @return
+ */
+bool BusCaptureReader::rebuildIndex()
+{
+    _index.clear();
+    _record_count = 0;
+
+    _file.clear();
+    _file.seekg(static_cast<std::streamoff>(HEADER_SIZE));
+
+    uint64_t offset = HEADER_SIZE;
+    CaptureRecord record;
+    while (readRecord(record))
+    {
+        if (0 == _record_count % BusCaptureWriter::INDEX_INTERVAL)
+            _index.emplace_back(_record_count, offset);
+
+        offset += RECORD_HEADER_SIZE + record.data.size();
+        _record_count++;
+    }
+
+    _end_offset = offset;
+    return true;
+}
+
+} // namespace util
+} // namespace common
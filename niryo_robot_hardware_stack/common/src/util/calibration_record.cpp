@@ -0,0 +1,352 @@
+/*
+calibration_record.cpp
+Copyright (C) 2020 Niryo
+All rights reserved.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#include "common/util/calibration_record.hpp"
+
+// c
+#include <fcntl.h>
+#include <unistd.h>
+
+// std
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <type_traits>
+#include <utility>
+
+namespace common
+{
+namespace util
+{
+
+namespace
+{
+constexpr std::array<uint8_t, 4> MAGIC{{'N', 'C', 'A', 'L'}};
+
+/**
+ * @brief crc32 lookup table (polynomial 0xEDB88320), computed at compile time
+ */
+struct Crc32Table
+{
+    uint32_t values[256];
+};
+
+constexpr Crc32Table makeCrc32Table()
+{
+    Crc32Table table{};
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        uint32_t c = i;
+        for (int k = 0; k < 8; ++k)
+            c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+        table.values[i] = c;
+    }
+    return table;
+}
+
+constexpr Crc32Table CRC32_TABLE = makeCrc32Table();
+
+template <typename T>
+void writeLE(std::vector<uint8_t> &buffer, T value)
+{
+    auto v = static_cast<typename std::make_unsigned<T>::type>(value);
+    for (size_t i = 0; i < sizeof(T); ++i)
+        buffer.emplace_back(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+template <typename T>
+T readLE(const uint8_t *data)
+{
+    typename std::make_unsigned<T>::type v = 0;
+    for (size_t i = 0; i < sizeof(T); ++i)
+        v |= static_cast<typename std::make_unsigned<T>::type>(data[i]) << (8 * i);
+    return static_cast<T>(v);
+}
+
+/**
+ * @brief writeAll : write the whole buffer, retrying on partial writes
+ */
+bool writeAll(int fd, const std::vector<uint8_t> &buffer)
+{
+    size_t written = 0;
+    while (written < buffer.size())
+    {
+        ssize_t res = ::write(fd, buffer.data() + written, buffer.size() - written);
+        if (res <= 0)
+            return false;
+        written += static_cast<size_t>(res);
+    }
+    return true;
+}
+}  // namespace
+
+/**
+ * @brief CalibrationRecord::clear
+ */
+void CalibrationRecord::clear()
+{
+    _entries.clear();
+    _timestamp_ms = 0;
+}
+
+/**
+ * @brief CalibrationRecord::setSensorOffset
+ * @param id
+ * @param sensor_offset
+ */
+void CalibrationRecord::setSensorOffset(uint8_t id, int32_t sensor_offset)
+{
+    Entry &entry = getOrCreateEntry(id);
+    entry.sensor_offset = sensor_offset;
+    entry.flags |= HAS_SENSOR_OFFSET;
+}
+
+/**
+ * @brief CalibrationRecord::setHomingAbsPosition
+ * @param id
+ * @param homing_abs_position
+ */
+void CalibrationRecord::setHomingAbsPosition(uint8_t id, int32_t homing_abs_position)
+{
+    Entry &entry = getOrCreateEntry(id);
+    entry.homing_abs_position = homing_abs_position;
+    entry.flags |= HAS_HOMING_ABS_POSITION;
+}
+
+/**
+ * @brief CalibrationRecord::setTimestamp
+ * @param timestamp_ms
+ */
+void CalibrationRecord::setTimestamp(uint64_t timestamp_ms)
+{
+    _timestamp_ms = timestamp_ms;
+}
+
+/**
+ * @brief CalibrationRecord::getSensorOffset
+ * @param id
+ * @param sensor_offset
+ * @return false if no sensor offset is recorded for this motor
+ */
+bool CalibrationRecord::getSensorOffset(uint8_t id, int32_t &sensor_offset) const
+{
+    const Entry *entry = findEntry(id);
+    if (!entry || !(entry->flags & HAS_SENSOR_OFFSET))
+        return false;
+
+    sensor_offset = entry->sensor_offset;
+    return true;
+}
+
+/**
+ * @brief CalibrationRecord::getHomingAbsPosition
+ * @param id
+ * @param homing_abs_position
+ * @return false if no homing abs position is recorded for this motor
+ */
+bool CalibrationRecord::getHomingAbsPosition(uint8_t id, int32_t &homing_abs_position) const
+{
+    const Entry *entry = findEntry(id);
+    if (!entry || !(entry->flags & HAS_HOMING_ABS_POSITION))
+        return false;
+
+    homing_abs_position = entry->homing_abs_position;
+    return true;
+}
+
+/**
+ * @brief CalibrationRecord::serialize
+ * @return the binary record, crc included
+ */
+std::vector<uint8_t> CalibrationRecord::serialize() const
+{
+    std::vector<uint8_t> buffer;
+    buffer.reserve(HEADER_SIZE + _entries.size() * ENTRY_SIZE + CRC_SIZE);
+
+    buffer.insert(buffer.end(), MAGIC.begin(), MAGIC.end());
+    writeLE<uint16_t>(buffer, VERSION);
+    writeLE<uint16_t>(buffer, static_cast<uint16_t>(_entries.size()));
+    writeLE<uint64_t>(buffer, _timestamp_ms);
+
+    for (auto const &entry : _entries)
+    {
+        buffer.emplace_back(entry.id);
+        buffer.emplace_back(entry.flags);
+        writeLE<int32_t>(buffer, entry.sensor_offset);
+        writeLE<int32_t>(buffer, entry.homing_abs_position);
+    }
+
+    writeLE<uint32_t>(buffer, crc32(buffer.data(), buffer.size()));
+
+    return buffer;
+}
+
+/**
+ * @brief CalibrationRecord::deserialize
+ * @param buffer
+ * @return false if the buffer is not a valid record. The record is left unchanged in this case
+ */
+bool CalibrationRecord::deserialize(const std::vector<uint8_t> &buffer)
+{
+    if (buffer.size() < HEADER_SIZE + CRC_SIZE || !std::equal(MAGIC.begin(), MAGIC.end(), buffer.begin()))
+        return false;
+
+    const uint8_t *data = buffer.data();
+
+    uint16_t version = readLE<uint16_t>(data + 4);
+    uint16_t count = readLE<uint16_t>(data + 6);
+
+    if (VERSION != version || buffer.size() != HEADER_SIZE + count * ENTRY_SIZE + CRC_SIZE)
+        return false;
+
+    size_t crc_pos = buffer.size() - CRC_SIZE;
+    if (readLE<uint32_t>(data + crc_pos) != crc32(data, crc_pos))
+        return false;
+
+    std::vector<Entry> entries(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const uint8_t *e = data + HEADER_SIZE + i * ENTRY_SIZE;
+        entries[i].id = e[0];
+        entries[i].flags = e[1];
+        entries[i].sensor_offset = readLE<int32_t>(e + 2);
+        entries[i].homing_abs_position = readLE<int32_t>(e + 6);
+    }
+
+    _entries = std::move(entries);
+    _timestamp_ms = readLE<uint64_t>(data + 8);
+
+    return true;
+}
+
+/**
+ * @brief CalibrationRecord::save : atomic write of the record (temporary file + fsync + rename)
+ * @param file_path
+ * @return
+ */
+bool CalibrationRecord::save(const std::string &file_path) const
+{
+    std::vector<uint8_t> buffer = serialize();
+    std::string tmp_path = file_path + ".tmp";
+
+    int fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return false;
+
+    bool res = writeAll(fd, buffer) && (0 == ::fsync(fd));
+    res = (0 == ::close(fd)) && res;
+
+    if (res)
+        res = (0 == std::rename(tmp_path.c_str(), file_path.c_str()));
+
+    if (!res)
+    {
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+
+    // sync the directory too, for the rename to be persistent
+    size_t found = file_path.find_last_of('/');
+    std::string folder_name = (std::string::npos != found) ? file_path.substr(0, found + 1) : ".";
+    int dir_fd = ::open(folder_name.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dir_fd >= 0)
+    {
+        ::fsync(dir_fd);
+        ::close(dir_fd);
+    }
+
+    return true;
+}
+
+/**
+ * @brief CalibrationRecord::load : reads the whole file at once and checks it
+ * @param file_path
+ * @return false if the file does not exist or is corrupted
+ */
+bool CalibrationRecord::load(const std::string &file_path)
+{
+    int fd = ::open(file_path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    // a record has at most one entry per id (0 to 255), one more byte to detect a file too long
+    std::vector<uint8_t> buffer(HEADER_SIZE + 256 * ENTRY_SIZE + CRC_SIZE + 1);
+    ssize_t size = ::read(fd, buffer.data(), buffer.size());
+    ::close(fd);
+
+    if (size <= 0)
+        return false;
+
+    buffer.resize(static_cast<size_t>(size));
+    return deserialize(buffer);
+}
+
+/**
+ * @brief CalibrationRecord::crc32
+ * @param data
+ * @param size
+ * @return standard CRC-32 (as zlib) of the data
+ */
+uint32_t CalibrationRecord::crc32(const uint8_t *data, size_t size)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i)
+        crc = CRC32_TABLE.values[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+
+    return crc ^ 0xFFFFFFFFu;
+}
+
+/**
+ * @brief CalibrationRecord::getOrCreateEntry
+ * @param id
+ * @return
+ */
+CalibrationRecord::Entry &CalibrationRecord::getOrCreateEntry(uint8_t id)
+{
+    for (auto &entry : _entries)
+    {
+        if (entry.id == id)
+            return entry;
+    }
+
+    Entry entry;
+    entry.id = id;
+    _entries.emplace_back(entry);
+
+    return _entries.back();
+}
+
+/**
+ * @brief CalibrationRecord::findEntry
+ * @param id
+ * @return nullptr if there is no entry for this motor
+ */
+const CalibrationRecord::Entry *CalibrationRecord::findEntry(uint8_t id) const
+{
+    for (auto const &entry : _entries)
+    {
+        if (entry.id == id)
+            return &entry;
+    }
+
+    return nullptr;
+}
+
+} // namespace util
+} // namespace common
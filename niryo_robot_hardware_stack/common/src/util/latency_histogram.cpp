@@ -0,0 +1,116 @@
+/*
+latency_histogram.cpp
+Copyright (C) 2020 Niryo
+All rights reserved.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#include "common/util/latency_histogram.hpp"
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace common
+{
+namespace util
+{
+
+/**
+ * @brief LatencyHistogram::LatencyHistogram
+ * @param bucket_width_us
+ * @param nb_buckets : number of buckets before the overflow one
+ */
+LatencyHistogram::LatencyHistogram(uint32_t bucket_width_us, size_t nb_buckets) : _bucket_width_us(std::max<uint32_t>(bucket_width_us, 1)), _buckets(nb_buckets + 1, 0) {}
+
+/**
+ * @brief LatencyHistogram::record
+ * @param latency : negative latencies are counted as null
+ */
+void LatencyHistogram::record(Clock::duration latency)
+{
+    auto latency_us = static_cast<uint64_t>(std::max<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(latency).count(), 0));
+
+    size_t bucket = std::min(static_cast<size_t>(latency_us / _bucket_width_us), _buckets.size() - 1);
+    _buckets[bucket]++;
+
+    _count++;
+    _sum_us += latency_us;
+    _max_us = std::max(_max_us, latency_us);
+}
+
+/**
+ * @brief LatencyHistogram::reset
+ */
+void LatencyHistogram::reset()
+{
+    std::fill(_buckets.begin(), _buckets.end(), 0);
+    _count = 0;
+    _sum_us = 0;
+    _max_us = 0;
+}
+
+/**
+ * @brief LatencyHistogram::getMeanUs
+ * @return
+ */
+double LatencyHistogram::getMeanUs() const { return _count ? static_cast<double>(_sum_us) / static_cast<double>(_count) : 0.0; }
+
+/**
+ * @brief LatencyHistogram::getPercentileUs
+ * @param percentile : between 0 and 100
+ * @return upper bound of the bucket holding the percentile, the max latency if it is the overflow bucket
+ */
+uint64_t LatencyHistogram::getPercentileUs(double percentile) const
+{
+    if (!_count)
+        return 0;
+
+    auto rank = static_cast<uint64_t>(std::ceil(std::min(std::max(percentile, 0.0), 100.0) / 100.0 * static_cast<double>(_count)));
+    rank = std::max<uint64_t>(rank, 1);
+
+    uint64_t nb_latencies = 0;
+    for (size_t bucket = 0; bucket + 1 < _buckets.size(); ++bucket)
+    {
+        nb_latencies += _buckets[bucket];
+        if (nb_latencies >= rank)
+            return std::min(static_cast<uint64_t>(bucket + 1) * _bucket_width_us, _max_us);
+    }
+
+    return _max_us;
+}
+
+/**
+ * @brief LatencyHistogram::str
+ * @return
+ */
+std::string LatencyHistogram::str() const
+{
+    std::ostringstream ss;
+
+    ss << std::fixed << std::setprecision(2);
+    ss << "count: " << _count;
+    ss << ", mean: " << getMeanUs() / 1000.0 << " ms";
+    ss << ", p50: " << static_cast<double>(getPercentileUs(50.0)) / 1000.0 << " ms";
+    ss << ", p99: " << static_cast<double>(getPercentileUs(99.0)) / 1000.0 << " ms";
+    ss << ", max: " << static_cast<double>(_max_us) / 1000.0 << " ms";
+
+    return ss.str();
+}
+
+} // namespace util
+} // namespace common
@@ -0,0 +1,77 @@
+/*
+retry_policy.cpp
+Copyright (C) 2020 Niryo
+All rights reserved.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#include "common/util/retry_policy.hpp"
+
+// std
+#include <algorithm>
+#include <thread>
+
+namespace common
+{
+namespace util
+{
+
+/**
+ * @brief RetryPolicy::RetryPolicy
+ * @param budget
+ */
+RetryPolicy::RetryPolicy(const Budget &budget) : _budget(budget) {}
+
+/**
+ * @brief RetryPolicy::onFailure : count a failed attempt and wait before the next one if there is time for it
+ * @param deadline : time after which the caller must not be blocked
+ * @return RETRY once the backoff has elapsed, RETRY_LATER without waiting if the backoff would end after the deadline,
+ * GIVE_UP if the budget is spent. The attempts are reset when giving up
+ */
+RetryPolicy::EDecision RetryPolicy::onFailure(Clock::time_point deadline)
+{
+    _attempts++;
+    if (_attempts >= _budget.max_attempts)
+    {
+        reset();
+        return EDecision::GIVE_UP;
+    }
+
+    auto backoff = std::chrono::microseconds(getBackoffUs());
+    if (deadline != Clock::time_point::max() && Clock::now() + backoff >= deadline)
+        return EDecision::RETRY_LATER;
+
+    std::this_thread::sleep_for(backoff);
+    return EDecision::RETRY;
+}
+
+/**
+ * @brief RetryPolicy::reset : to be called once the command succeeded
+ */
+void RetryPolicy::reset() { _attempts = 0; }
+
+/**
+ * @brief RetryPolicy::getBackoffUs
+ * @return wait before the next attempt, doubled at each failure
+ */
+uint32_t RetryPolicy::getBackoffUs() const
+{
+    // no overflow : the shift is bounded, and the result is capped by the max backoff
+    uint64_t backoff_us = static_cast<uint64_t>(_budget.first_backoff_us) << std::min<uint32_t>(_attempts - 1, 31);
+    return static_cast<uint32_t>(std::min<uint64_t>(backoff_us, _budget.max_backoff_us));
+}
+
+} // namespace util
+} // namespace common
@@ -18,10 +18,28 @@
 #include "common/model/dxl_motor_state.hpp"
 #include "common/model/single_motor_cmd.hpp"
 #include "common/model/stepper_motor_state.hpp"
-
+#include "common/util/bus_capture.hpp"
+#include "common/util/calibration_record.hpp"
+#include "common/util/goal_filter.hpp"
+#include "common/util/joint_command_buffer.hpp"
+#include "common/util/latency_histogram.hpp"
+#include "common/util/retry_policy.hpp"
+#include "common/util/trajectory_segmenter.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <tuple>
+#include <unistd.h>
+#include <vector>
 
 // Bring in gtest
 #include <gtest/gtest.h>
@@ -304,6 +322,440 @@ TEST(CommonTestSuite, testCreationStepperCmd)
     ASSERT_NE(cmd.getId(), static_cast<uint8_t>(1));
     ASSERT_EQ(cmd.getParam(), static_cast<uint8_t>(5));
 }
+
+TEST(CommonTestSuite, testEnumStringConversion)
+{
+    for (const auto &type : {EHardwareType::STEPPER, EHardwareType::XL430, EHardwareType::XL320, EHardwareType::XL330, EHardwareType::XC430,
+                             EHardwareType::XM430, EHardwareType::FAKE_DXL_MOTOR, EHardwareType::FAKE_STEPPER_MOTOR, EHardwareType::FAKE_END_EFFECTOR,
+                             EHardwareType::END_EFFECTOR, EHardwareType::UNKNOWN})
+    {
+        EXPECT_EQ(type, static_cast<EHardwareType>(HardwareTypeEnum(HardwareTypeEnum(type).toString())));
+    }
+
+    EXPECT_STREQ(HardwareTypeEnum(EHardwareType::XL320).toString(), "xl320");
+    EXPECT_EQ(HardwareTypeEnum().values().size(), 11u);
+    EXPECT_EQ(HardwareTypeEnum().values(true).front(), "end_effector");
+
+    EXPECT_THROW(HardwareTypeEnum("not_a_motor"), std::out_of_range);
+    EXPECT_THROW(HardwareTypeEnum(static_cast<EHardwareType>(7)).toString(), std::out_of_range);
+    EXPECT_THROW(HardwareTypeEnum(static_cast<EHardwareType>(250)).toString(), std::out_of_range);
+}
+
+TEST(CommonTestSuite, testCalibrationRecordSerialization)
+{
+    common::util::CalibrationRecord record;
+    record.setTimestamp(1634567890123ull);
+    record.setSensorOffset(2, 1234);
+    record.setSensorOffset(3, -56);
+    record.setHomingAbsPosition(2, 4095);
+
+    std::vector<uint8_t> buffer = record.serialize();
+    EXPECT_EQ(buffer.size(), 16u + 2u * 10u + 4u);
+
+    common::util::CalibrationRecord read_record;
+    ASSERT_TRUE(read_record.deserialize(buffer));
+    EXPECT_EQ(read_record.getTimestamp(), 1634567890123ull);
+    EXPECT_EQ(read_record.getEntries().size(), 2u);
+
+    int32_t value = 0;
+    EXPECT_TRUE(read_record.getSensorOffset(2, value));
+    EXPECT_EQ(value, 1234);
+    EXPECT_TRUE(read_record.getSensorOffset(3, value));
+    EXPECT_EQ(value, -56);
+    EXPECT_TRUE(read_record.getHomingAbsPosition(2, value));
+    EXPECT_EQ(value, 4095);
+    EXPECT_FALSE(read_record.getHomingAbsPosition(3, value));
+    EXPECT_FALSE(read_record.getSensorOffset(4, value));
+
+    // reference value of the standard crc32
+    const std::string check = "123456789";
+    EXPECT_EQ(common::util::CalibrationRecord::crc32(reinterpret_cast<const uint8_t *>(check.data()), check.size()), 0xCBF43926u);
+}
+
+TEST(CommonTestSuite, testCalibrationRecordCorruption)
+{
+    common::util::CalibrationRecord record;
+    record.setSensorOffset(2, 1234);
+    std::vector<uint8_t> buffer = record.serialize();
+
+    common::util::CalibrationRecord read_record;
+    read_record.setSensorOffset(5, 42);
+
+    // any flipped bit is detected and leaves the record unchanged
+    for (size_t i = 0; i < buffer.size(); ++i)
+    {
+        std::vector<uint8_t> corrupted = buffer;
+        corrupted[i] ^= 0x10;
+        EXPECT_FALSE(read_record.deserialize(corrupted));
+    }
+
+    EXPECT_FALSE(read_record.deserialize(std::vector<uint8_t>(buffer.begin(), buffer.end() - 1)));
+    EXPECT_FALSE(read_record.deserialize(std::vector<uint8_t>()));
+
+    int32_t value = 0;
+    EXPECT_TRUE(read_record.getSensorOffset(5, value));
+    EXPECT_EQ(value, 42);
+}
+
+TEST(CommonTestSuite, testCalibrationRecordFile)
+{
+    char path_template[] = "/tmp/calibration_record_XXXXXX";
+    int fd = mkstemp(path_template);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    std::string file_path(path_template);
+
+    common::util::CalibrationRecord record;
+    record.setTimestamp(12);
+    record.setSensorOffset(2, 100);
+    record.setHomingAbsPosition(3, -200);
+    ASSERT_TRUE(record.save(file_path));
+
+    common::util::CalibrationRecord read_record;
+    ASSERT_TRUE(read_record.load(file_path));
+    EXPECT_EQ(read_record.getTimestamp(), 12u);
+    EXPECT_EQ(read_record.serialize(), record.serialize());
+
+    std::remove(file_path.c_str());
+    EXPECT_FALSE(read_record.load(file_path));
+}
+
+TEST(CommonTestSuite, testCalibrationRecordFullFile)
+{
+    char path_template[] = "/tmp/calibration_record_XXXXXX";
+    int fd = mkstemp(path_template);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    std::string file_path(path_template);
+
+    // one entry for each possible id
+    common::util::CalibrationRecord record;
+    for (int id = 0; id <= 255; ++id)
+        record.setSensorOffset(static_cast<uint8_t>(id), id * 10);
+    ASSERT_TRUE(record.save(file_path));
+
+    common::util::CalibrationRecord read_record;
+    ASSERT_TRUE(read_record.load(file_path));
+    EXPECT_EQ(read_record.getEntries().size(), 256u);
+
+    int32_t value = 0;
+    EXPECT_TRUE(read_record.getSensorOffset(255, value));
+    EXPECT_EQ(value, 2550);
+
+    std::remove(file_path.c_str());
+}
+
+TEST(CommonTestSuite, testBusCapture)
+{
+    char path_template[] = "/tmp/bus_capture_XXXXXX";
+    int fd = mkstemp(path_template);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    std::string file_path(path_template);
+
+    const uint32_t nb_records = 3 * common::util::BusCaptureWriter::INDEX_INTERVAL + 10;
+
+    common::util::BusCaptureWriter writer;
+    ASSERT_TRUE(writer.open(file_path, common::model::EBusProtocol::TTL));
+    for (uint32_t i = 0; i < nb_records; ++i)
+    {
+        common::util::CaptureRecord record;
+        record.timestamp_us = 10 * i;
+        record.flags = (i % 2) ? common::util::CaptureRecord::RX : common::util::CaptureRecord::TX;
+        record.id = i % 7;
+        record.data.assign(i % 20, static_cast<uint8_t>(i));
+        writer.write(record);
+    }
+    EXPECT_EQ(writer.getRecordCount(), nb_records);
+    ASSERT_TRUE(writer.close());
+
+    common::util::BusCaptureReader reader;
+    ASSERT_TRUE(reader.open(file_path));
+    EXPECT_TRUE(reader.isComplete());
+    EXPECT_EQ(reader.getProtocol(), common::model::EBusProtocol::TTL);
+    EXPECT_EQ(reader.getRecordCount(), nb_records);
+
+    std::vector<common::util::CaptureRecord> records;
+    ASSERT_TRUE(reader.readAll(records));
+    ASSERT_EQ(records.size(), nb_records);
+    EXPECT_EQ(records.at(5).timestamp_us, 50u);
+    EXPECT_EQ(records.at(5).flags, common::util::CaptureRecord::RX);
+    EXPECT_EQ(records.at(5).id, 5u);
+    EXPECT_EQ(records.at(5).data, std::vector<uint8_t>(5, 5));
+
+    // seek through the index
+    common::util::CaptureRecord record;
+    uint32_t target = 2 * common::util::BusCaptureWriter::INDEX_INTERVAL + 3;
+    ASSERT_TRUE(reader.seek(target));
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record.timestamp_us, 10u * target);
+    EXPECT_EQ(record.data.size(), target % 20);
+
+    ASSERT_TRUE(reader.seek(nb_records));
+    EXPECT_FALSE(reader.next(record));
+
+    std::remove(file_path.c_str());
+    EXPECT_FALSE(reader.open(file_path));
+}
+
+TEST(CommonTestSuite, testBusCaptureInterrupted)
+{
+    char path_template[] = "/tmp/bus_capture_XXXXXX";
+    int fd = mkstemp(path_template);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    std::string file_path(path_template);
+
+    {
+        common::util::BusCaptureWriter writer;
+        ASSERT_TRUE(writer.open(file_path, common::model::EBusProtocol::CAN));
+        std::vector<uint8_t> frame{1, 2, 3, 4, 5, 6, 7, 8};
+        for (int i = 0; i < 100; ++i)
+            writer.record(common::util::CaptureRecord::RX, 0x10, frame.data(), frame.size());
+        ASSERT_TRUE(writer.close());
+    }
+
+    // drop the index and a part of the last record, as if the capture had been killed
+    std::ifstream in(file_path, std::ios::binary);
+    std::vector<char> content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    content.resize(16 + 99 * 23 + 10);
+    std::ofstream out(file_path, std::ios::binary | std::ios::trunc);
+    out.write(content.data(), static_cast<std::streamsize>(content.size()));
+    out.close();
+
+    common::util::BusCaptureReader reader;
+    ASSERT_TRUE(reader.open(file_path));
+    EXPECT_FALSE(reader.isComplete());
+    EXPECT_EQ(reader.getProtocol(), common::model::EBusProtocol::CAN);
+    EXPECT_EQ(reader.getRecordCount(), 99u);
+
+    std::vector<common::util::CaptureRecord> records;
+    ASSERT_TRUE(reader.readAll(records));
+    EXPECT_EQ(records.back().id, 0x10u);
+    EXPECT_EQ(records.back().data.size(), 8u);
+
+    std::remove(file_path.c_str());
+}
+
+TEST(CommonTestSuite, testGoalFilter)
+{
+    using Clock = common::util::GoalFilter<uint32_t>::Clock;
+    auto now = Clock::now();
+
+    common::util::GoalFilter<uint32_t> filter(5, 1.0);
+    filter.resize(3);
+    std::vector<uint8_t> mask(3);
+
+    // first goals are always written
+    std::vector<uint32_t> goals{1000, 2000, 3000};
+    EXPECT_EQ(filter.filter(goals, mask, now), 3u);
+    EXPECT_EQ(mask, std::vector<uint8_t>({1, 1, 1}));
+    filter.commit(goals, mask, now);
+
+    // unchanged or within the deadband : skipped
+    goals = {1000, 2005, 3006};
+    EXPECT_EQ(filter.filter(goals, mask, now + std::chrono::milliseconds(10)), 1u);
+    EXPECT_EQ(mask, std::vector<uint8_t>({0, 0, 1}));
+    filter.commit(goals, mask, now + std::chrono::milliseconds(10));
+
+    // the deadband is measured from the last written goal
+    goals = {1000, 2006, 3006};
+    EXPECT_EQ(filter.filter(goals, mask, now + std::chrono::milliseconds(20)), 1u);
+    EXPECT_EQ(mask, std::vector<uint8_t>({0, 1, 0}));
+    filter.commit(goals, mask, now + std::chrono::milliseconds(20));
+
+    // keep alive
+    EXPECT_EQ(filter.filter(goals, mask, now + std::chrono::milliseconds(1005)), 1u);
+    EXPECT_EQ(mask, std::vector<uint8_t>({1, 0, 0}));
+    filter.commit(goals, mask, now + std::chrono::milliseconds(1005));
+
+    // a goal not committed (failed write) is written again
+    goals = {1000, 2100, 3100};
+    EXPECT_EQ(filter.filter(goals, mask, now + std::chrono::milliseconds(1010)), 2u);
+    mask = {0, 1, 0};
+    filter.commit(goals, mask, now + std::chrono::milliseconds(1010));
+    EXPECT_EQ(filter.filter(goals, mask, now + std::chrono::milliseconds(1015)), 1u);
+    EXPECT_EQ(mask, std::vector<uint8_t>({0, 0, 1}));
+    filter.commit(goals, mask, now + std::chrono::milliseconds(1015));
+
+    // reset : everything is written again
+    filter.reset();
+    EXPECT_EQ(filter.filter(goals, mask, now + std::chrono::milliseconds(1020)), 3u);
+
+    // disabled filter
+    filter.setKeepAlive(0.0);
+    EXPECT_EQ(filter.filter(goals, mask, now + std::chrono::milliseconds(1030)), 3u);
+    filter.commit(goals, mask, now + std::chrono::milliseconds(1030));
+    EXPECT_EQ(filter.filter(goals, mask, now + std::chrono::milliseconds(1040)), 3u);
+
+    // signed positions
+    common::util::GoalFilter<int32_t> can_filter(0, 1.0);
+    std::vector<int32_t> can_goals{-10};
+    EXPECT_EQ(can_filter.filter(can_goals, mask, now), 1u);
+    EXPECT_EQ(mask.size(), 1u);
+    can_filter.commit(can_goals, mask, now);
+    EXPECT_EQ(can_filter.filter(can_goals, mask, now), 0u);
+    can_goals = {-11};
+    EXPECT_EQ(can_filter.filter(can_goals, mask, now), 1u);
+}
+
+TEST(CommonTestSuite, testTrajectorySegmenter)
+{
+    using Clock = common::util::TrajectorySegmenter<uint32_t>::Clock;
+    auto now = Clock::now();
+
+    // disabled by default
+    common::util::TrajectorySegmenter<uint32_t> segmenter;
+    segmenter.setSlots({1, 1, 0});
+    EXPECT_FALSE(segmenter.isEnabled());
+    EXPECT_FALSE(segmenter.update({1000, 2000, 3000}, now));
+
+    segmenter.setDuration(0.1);
+    EXPECT_TRUE(segmenter.isEnabled());
+
+    // the first goals start the segment
+    EXPECT_FALSE(segmenter.update({1000, 2000, 3000}, now));
+    EXPECT_FALSE(segmenter.update({1010, 2000, 3010}, now + std::chrono::milliseconds(50)));
+
+    // closed once the duration elapsed, from the first goals to the last ones
+    EXPECT_TRUE(segmenter.update({1020, 2000, 3020}, now + std::chrono::milliseconds(110)));
+    EXPECT_EQ(segmenter.getStartGoals(), std::vector<uint32_t>({1000, 2000, 3000}));
+    EXPECT_EQ(segmenter.getEndGoals(), std::vector<uint32_t>({1020, 2000, 3020}));
+    EXPECT_NEAR(segmenter.getElapsed(), 0.11, 1e-6);
+
+    // the next segment starts at the end of the previous one
+    EXPECT_FALSE(segmenter.update({1030, 2010, 3030}, now + std::chrono::milliseconds(150)));
+    EXPECT_TRUE(segmenter.update({1030, 2020, 3030}, now + std::chrono::milliseconds(210)));
+    EXPECT_EQ(segmenter.getStartGoals(), std::vector<uint32_t>({1020, 2000, 3020}));
+    EXPECT_EQ(segmenter.getEndGoals(), std::vector<uint32_t>({1030, 2020, 3030}));
+
+    // idle : closed without moving slot
+    EXPECT_TRUE(segmenter.update({1030, 2020, 3030}, now + std::chrono::milliseconds(310)));
+    EXPECT_EQ(segmenter.getStartGoals(), segmenter.getEndGoals());
+
+    // reset : the next goals start a new segment
+    segmenter.reset();
+    EXPECT_FALSE(segmenter.update({5000, 2020, 3030}, now + std::chrono::milliseconds(420)));
+    EXPECT_TRUE(segmenter.update({5000, 2020, 3030}, now + std::chrono::milliseconds(520)));
+    EXPECT_EQ(segmenter.getStartGoals(), std::vector<uint32_t>({5000, 2020, 3030}));
+
+    // goals not matching the slots are ignored
+    EXPECT_FALSE(segmenter.update({5000, 2020}, now + std::chrono::milliseconds(700)));
+}
+
+TEST(CommonTestSuite, testJointCommandBuffer)
+{
+    common::util::JointCommandBuffer<uint32_t> buffer;
+    buffer.init(3);
+    EXPECT_EQ(buffer.size(), 3u);
+
+    // nothing written yet
+    EXPECT_EQ(buffer.read(), nullptr);
+
+    std::vector<uint32_t> goals{1, 2, 3};
+    auto stamp = common::util::JointCommandBuffer<uint32_t>::Clock::now();
+    buffer.write(goals, stamp);
+    auto read_goals = buffer.read();
+    ASSERT_NE(read_goals, nullptr);
+    EXPECT_EQ(*read_goals, goals);
+    EXPECT_EQ(buffer.getStamp(), stamp);
+
+    // goals are read only once
+    EXPECT_EQ(buffer.read(), nullptr);
+
+    // only the newest goals are read
+    buffer.write({4, 5, 6});
+    buffer.write({7, 8, 9});
+    read_goals = buffer.read();
+    ASSERT_NE(read_goals, nullptr);
+    EXPECT_EQ(*read_goals, std::vector<uint32_t>({7, 8, 9}));
+
+    // the buffers are not reallocated
+    const uint32_t *data = read_goals->data();
+    std::array<const uint32_t *, 3> allocated{};
+    for (auto &ptr : allocated)
+    {
+        buffer.write(goals);
+        ptr = buffer.read()->data();
+    }
+    EXPECT_NE(std::find(allocated.begin(), allocated.end(), data), allocated.end());
+
+    // clear drops the goals not read
+    buffer.write(goals);
+    buffer.clear();
+    EXPECT_EQ(buffer.read(), nullptr);
+
+    // a reader thread always sees complete sets of goals
+    std::atomic<bool> done{false};
+    std::atomic<bool> torn{false};
+    std::thread reader([&]() {
+        while (!done)
+        {
+            auto current = buffer.read();
+            if (current && !std::all_of(current->begin(), current->end(), [&](uint32_t g) { return g == current->front(); }))
+                torn = true;
+        }
+    });
+    for (uint32_t i = 0; i < 100000; ++i)
+        buffer.write({i, i, i});
+    done = true;
+    reader.join();
+    EXPECT_FALSE(torn);
+}
+TEST(CommonTestSuite, testLatencyHistogram)
+{
+    common::util::LatencyHistogram histogram(1000, 10);
+    EXPECT_EQ(histogram.getPercentileUs(50.0), 0u);
+
+    // 90 latencies of 0.5 ms, 9 of 2.5 ms and one overflow
+    for (int i = 0; i < 90; ++i)
+        histogram.record(std::chrono::microseconds(500));
+    for (int i = 0; i < 9; ++i)
+        histogram.record(std::chrono::microseconds(2500));
+    histogram.record(std::chrono::milliseconds(42));
+
+    EXPECT_EQ(histogram.getCount(), 100u);
+    EXPECT_EQ(histogram.getMaxUs(), 42000u);
+    EXPECT_DOUBLE_EQ(histogram.getMeanUs(), (90 * 500 + 9 * 2500 + 42000) / 100.0);
+    EXPECT_EQ(histogram.getPercentileUs(50.0), 1000u);
+    EXPECT_EQ(histogram.getPercentileUs(95.0), 3000u);
+    EXPECT_EQ(histogram.getPercentileUs(99.0), 3000u);
+    EXPECT_EQ(histogram.getPercentileUs(100.0), 42000u);
+
+    // negative latencies are null
+    histogram.reset();
+    histogram.record(std::chrono::microseconds(-10));
+    EXPECT_EQ(histogram.getCount(), 1u);
+    EXPECT_EQ(histogram.getMaxUs(), 0u);
+    EXPECT_EQ(histogram.getPercentileUs(50.0), 0u);
+}
+TEST(CommonTestSuite, testRetryPolicy)
+{
+    using common::util::RetryPolicy;
+    RetryPolicy retry({3, 100, 150});
+
+    // the waits are taken, then the command gives up and the policy is ready for the next one
+    auto start = RetryPolicy::Clock::now();
+    EXPECT_EQ(retry.onFailure(), RetryPolicy::EDecision::RETRY);
+    EXPECT_EQ(retry.onFailure(), RetryPolicy::EDecision::RETRY);
+    EXPECT_GE(RetryPolicy::Clock::now() - start, std::chrono::microseconds(100 + 150));
+    EXPECT_EQ(retry.getAttempts(), 2u);
+    EXPECT_EQ(retry.onFailure(), RetryPolicy::EDecision::GIVE_UP);
+    EXPECT_EQ(retry.getAttempts(), 0u);
+
+    // a wait ending after the deadline is not taken, the attempts are kept for the next call
+    auto deadline = RetryPolicy::Clock::now() + std::chrono::microseconds(50);
+    EXPECT_EQ(retry.onFailure(deadline), RetryPolicy::EDecision::RETRY_LATER);
+    EXPECT_EQ(retry.getAttempts(), 1u);
+    EXPECT_EQ(retry.onFailure(RetryPolicy::Clock::now()), RetryPolicy::EDecision::RETRY_LATER);
+    EXPECT_EQ(retry.onFailure(), RetryPolicy::EDecision::GIVE_UP);
+
+    // a success resets the attempts
+    EXPECT_EQ(retry.onFailure(), RetryPolicy::EDecision::RETRY);
+    retry.reset();
+    EXPECT_EQ(retry.getAttempts(), 0u);
+}
 }  // namespace
 
 // Run all the tests that were declared with TEST()
@@ -42,6 +42,12 @@ class WINDECLSPEC GroupSyncRead
     std::vector<uint8_t> id_list_;
     std::map<uint8_t, uint8_t *> data_list_;   // <id, data>
     std::map<uint8_t, uint8_t *> error_list_;  // <id, error>
+    std::map<uint8_t, bool> available_list_;  // <id, received by the last rxPacket>
+
+    // buffers of PacketHandler::syncReadRx, in the order of id_list_
+    std::vector<uint8_t> rx_data_;
+    std::vector<uint8_t> rx_error_;
+    std::vector<uint8_t> rx_received_;
 
     bool last_result_;
     bool is_param_changed_;
@@ -111,6 +117,7 @@ class WINDECLSPEC GroupSyncRead
 
     ////////////////////////////////////////////////////////////////////////////////
     /// @brief The function that receives the packet which might be come from the Dynamixel
+    /// @description The data of the Dynamixels which answered stay available even if the others did not (see GroupSyncRead::isAvailable)
     /// @return COMM_NOT_AVAILABLE
     /// @return   when the list for Sync Read is empty
     /// @return   when the protocol1.0 has been used
@@ -139,6 +146,7 @@ class WINDECLSPEC GroupSyncRead
     /// @param data_length Length of the data for read
     /// @return false
     /// @return   when there are no data available
+    /// @return   when the status packet of the ID has not been received
     /// @return   when the protocol1.0 has been used
     /// @return or true
     ////////////////////////////////////////////////////////////////////////////////
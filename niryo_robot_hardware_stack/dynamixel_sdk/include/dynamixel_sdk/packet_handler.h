@@ -130,6 +130,34 @@ class WINDECLSPEC PacketHandler
     ////////////////////////////////////////////////////////////////////////////////
     virtual int txPacket(PortHandler *port, uint8_t *txpacket) = 0;
 
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that makes the final bytes of a packet (txpacket), to be sent several times with txPreparedPacket
+    /// @description The function adds the header, the byte stuffing and the checksum to txpacket.
+    /// @description By default, prepared packets are not available.
+    /// @param txpacket packet with its id, length, instruction and parameters, large enough for the stuffing
+    /// @return 0
+    /// @return   when txpacket is out of range described by TXPACKET_MAX_LEN or not available
+    /// @return or the length of the prepared packet
+    ////////////////////////////////////////////////////////////////////////////////
+    virtual uint16_t prepareTxPacket(uint8_t * /*txpacket*/) { return 0; }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that transmits a packet made by prepareTxPacket via PortHandler port
+    /// @description The function clears the port buffer by PortHandler::clearPort() function,
+    /// @description then transmits txpacket by PortHandler::writePort() function, without building it again.
+    /// @param port PortHandler instance
+    /// @param txpacket packet made by prepareTxPacket
+    /// @param length length returned by prepareTxPacket
+    /// @return COMM_PORT_BUSY
+    /// @return   when the port is already in use
+    /// @return COMM_TX_FAIL
+    /// @return   when written packet is shorter than expected
+    /// @return COMM_NOT_AVAILABLE
+    /// @return   when prepared packets are not available
+    /// @return or COMM_SUCCESS
+    ////////////////////////////////////////////////////////////////////////////////
+    virtual int txPreparedPacket(PortHandler * /*port*/, const uint8_t * /*txpacket*/, uint16_t /*length*/) { return COMM_NOT_AVAILABLE; }
+
     ////////////////////////////////////////////////////////////////////////////////
     /// @brief The function that receives packet (rxpacket) during designated time via PortHandler port
     /// @description The function repeatedly tries to receive rxpacket by PortHandler::readPort() function.
@@ -548,7 +576,32 @@ class WINDECLSPEC PacketHandler
     /// @return communication results which come from PacketHandler::txPacket()
     ////////////////////////////////////////////////////////////////////////////////
     virtual int syncReadTx(PortHandler *port, uint16_t start_address, uint16_t data_length, uint8_t *param, uint16_t param_length) = 0;
-    // SyncReadRx   -> GroupSyncRead class
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that receives the status packets of a Sync Read instruction via PortHandler port
+    /// @description The function parses the status packets as they arrive, in any order,
+    /// @description drops the corrupted ones and keeps the data of the valid ones.
+    /// @description By default, the function is not available and GroupSyncRead reads the status packets one by one.
+    /// @param port PortHandler instance
+    /// @param data_length Length of the data for Sync Read
+    /// @param id_list Dynamixel IDs the status packets are expected from
+    /// @param id_count Number of IDs
+    /// @param data Data of each ID, data_length bytes per ID, in the order of id_list
+    /// @param error Dynamixel hardware error of each ID
+    /// @param received Set to 1 for each ID whose status packet has been received, 0 otherwise
+    /// @return COMM_NOT_AVAILABLE
+    /// @return   when the function is not available
+    /// @return COMM_RX_TIMEOUT
+    /// @return   when nothing has been received
+    /// @return COMM_RX_CORRUPT
+    /// @return   when some status packets are missing or corrupted
+    /// @return or COMM_SUCCESS
+    ////////////////////////////////////////////////////////////////////////////////
+    virtual int syncReadRx(PortHandler * /*port*/, uint16_t /*data_length*/, const uint8_t * /*id_list*/, uint16_t /*id_count*/, uint8_t * /*data*/, uint8_t * /*error*/,
+                           uint8_t * /*received*/)
+    {
+        return COMM_NOT_AVAILABLE;
+    }
     // SyncReadTxRx -> GroupSyncRead class
 
     ////////////////////////////////////////////////////////////////////////////////
@@ -172,6 +172,15 @@ class WINDECLSPEC PortHandler
     ////////////////////////////////////////////////////////////////////////////////
     virtual void setPacketTimeout(double msec) = 0;
 
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that sets and starts stopwatch for watching the timeout of several status packets
+    /// @description The function sets the stopwatch for nb_status status packets of packet_length bytes in total, answered one after the other
+    /// @description (sync read, bulk read). By default, the number of status packets is not taken into account.
+    /// @param packet_length Length of all the packets expected to be received
+    /// @param nb_status Number of status packets expected
+    ////////////////////////////////////////////////////////////////////////////////
+    virtual void setStatusPacketsTimeout(uint16_t packet_length, uint16_t /*nb_status*/) { setPacketTimeout(packet_length); }
+
     ////////////////////////////////////////////////////////////////////////////////
     /// @brief The function that checks whether packet timeout is occurred
     /// @description The function checks whether current time is passed by the time of packet timeout from the time set by PortHandlerLinux::setPacketTimeout().
@@ -22,6 +22,8 @@
 #ifndef DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_LINUX_PORTHANDLERLINUX_H_
 #define DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_LINUX_PORTHANDLERLINUX_H_
 
+#include <string>
+
 #include "port_handler.h"
 #include "serial/serial.h"
 
@@ -33,17 +35,50 @@ namespace dynamixel
 ////////////////////////////////////////////////////////////////////////////////
 class PortHandlerLinux : public PortHandler
 {
+  public:
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief How the half-duplex direction of the bus is switched back to reception after a write
+    ////////////////////////////////////////////////////////////////////////////////
+    enum DirectionControl
+    {
+        DIRECTION_GPIO_SLEEP = 0,  ///< direction GPIO dropped after sleeping the theoretical transmission time
+        DIRECTION_GPIO_DRAIN,      ///< direction GPIO dropped as soon as the UART reports its transmitter empty
+        DIRECTION_RS485            ///< direction driven on RTS by the kernel RS-485 mode of the UART driver
+    };
+
   private:
     serial::Serial serial_;
-    double packet_start_time_ms_;
-    double packet_timeout_ms_;
+    double packet_start_time_us_;
+    double packet_timeout_us_;
+
+    DirectionControl direction_control_;
+    // transmission time of the last write not waited for, the reception starts after it
+    double tx_pending_us_;
+
+    // kernel latency settings applied at opening (serial::low_latency_t)
+    uint32_t low_latency_settings_;
+
+    // status packets being timed to adapt the timeout margin
+    bool rx_sampling_;
+    uint16_t rx_expected_length_;
+    uint16_t rx_expected_status_;
+    uint32_t rx_length_;
+
+    // latency of a status packet not explained by its transmission time (return delay, driver, scheduling), smoothed
+    double status_latency_us_;
+    double status_latency_var_us_;
 
-    double getCurrentTimeMs();
+    double getCurrentTimeUs();
     double getTimeSinceStart();
 
+    void startPacketTimeout(uint16_t packet_length, uint16_t nb_status);
+    void sampleStatusLatency(double elapsed_us);
+
     void gpioHigh();
     void gpioLow();
 
+    bool applyDirectionControl();
+
   public:
     ////////////////////////////////////////////////////////////////////////////////
     /// @brief The function that initializes instance of PortHandler and gets port_name
@@ -159,11 +194,60 @@ class PortHandlerLinux : public PortHandler
     ////////////////////////////////////////////////////////////////////////////////
     void setPacketTimeout(double msec);
 
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that sets and starts stopwatch for watching the timeout of several status packets
+    /// @description The timeout is the transmission time of the packets, plus a latency margin per status packet
+    /// @description learnt from the status packets received.
+    /// @param packet_length Length of all the packets expected to be received
+    /// @param nb_status Number of status packets expected
+    ////////////////////////////////////////////////////////////////////////////////
+    void setStatusPacketsTimeout(uint16_t packet_length, uint16_t nb_status);
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that returns the latency margin currently added per status packet
+    /// @return Latency margin in microseconds
+    ////////////////////////////////////////////////////////////////////////////////
+    double getStatusLatencyMarginUs() const;
+
     ////////////////////////////////////////////////////////////////////////////////
     /// @brief The function that checks whether packet timeout is occurred
     /// @description The function checks whether current time is passed by the time of packet timeout from the time set by PortHandlerLinux::setPacketTimeout().
     ////////////////////////////////////////////////////////////////////////////////
     bool isPacketTimeout();
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that selects how the half-duplex direction is switched
+    /// @description The function applies the direction control right away if the port is open, at opening otherwise.
+    /// @description If the UART driver does not support the RS-485 mode, the direction GPIO is drained instead.
+    /// @param direction_control Direction control
+    /// @return false
+    /// @return   when the direction control requested is not supported
+    /// @return or true
+    ////////////////////////////////////////////////////////////////////////////////
+    bool setDirectionControl(DirectionControl direction_control);
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that returns the direction control in use
+    /// @return Direction control
+    ////////////////////////////////////////////////////////////////////////////////
+    DirectionControl getDirectionControl() const;
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that returns the kernel latency settings of the real-time bus profile applied at opening
+    /// @description The profile is applied by PortHandlerLinux::openPort(), with the settings supported by the driver of the port.
+    /// @return Combination of serial::low_latency_t
+    ////////////////////////////////////////////////////////////////////////////////
+    uint32_t getLowLatencySettings() const;
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that converts a direction control name ("gpio_sleep", "gpio_drain", "rs485")
+    /// @param name Name of the direction control
+    /// @param direction_control Direction control found
+    /// @return false
+    /// @return   when the name is unknown
+    /// @return or true
+    ////////////////////////////////////////////////////////////////////////////////
+    static bool parseDirectionControl(const std::string &name, DirectionControl &direction_control);
 };
 
 }  // namespace dynamixel
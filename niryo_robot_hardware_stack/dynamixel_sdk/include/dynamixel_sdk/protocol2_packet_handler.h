@@ -87,6 +87,29 @@ class WINDECLSPEC Protocol2PacketHandler : public PacketHandler
     ////////////////////////////////////////////////////////////////////////////////
     int txPacket(PortHandler *port, uint8_t *txpacket);
 
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that makes the final bytes of a packet (txpacket), to be sent several times with txPreparedPacket
+    /// @description The function adds the header, the byte stuffing and the CRC to txpacket, as Protocol2PacketHandler::txPacket() does.
+    /// @param txpacket packet with its id, length, instruction and parameters, large enough for the stuffing
+    /// @return 0
+    /// @return   when txpacket is out of range described by TXPACKET_MAX_LEN
+    /// @return or the length of the prepared packet
+    ////////////////////////////////////////////////////////////////////////////////
+    uint16_t prepareTxPacket(uint8_t *txpacket);
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that transmits a packet made by Protocol2PacketHandler::prepareTxPacket() via PortHandler port
+    /// @param port PortHandler instance
+    /// @param txpacket packet made by prepareTxPacket
+    /// @param length length returned by prepareTxPacket
+    /// @return COMM_PORT_BUSY
+    /// @return   when the port is already in use
+    /// @return COMM_TX_FAIL
+    /// @return   when written packet is shorter than expected
+    /// @return or COMM_SUCCESS
+    ////////////////////////////////////////////////////////////////////////////////
+    int txPreparedPacket(PortHandler *port, const uint8_t *txpacket, uint16_t length);
+
     ////////////////////////////////////////////////////////////////////////////////
     /// @brief The function that receives packet (rxpacket) during designated time via PortHandler port
     /// @description The function repeatedly tries to receive rxpacket by PortHandler::readPort() function.
@@ -506,7 +529,26 @@ class WINDECLSPEC Protocol2PacketHandler : public PacketHandler
     /// @return communication results which come from Protocol2PacketHandler::txPacket()
     ////////////////////////////////////////////////////////////////////////////////
     int syncReadTx(PortHandler *port, uint16_t start_address, uint16_t data_length, uint8_t *param, uint16_t param_length);
-    // SyncReadRx   -> GroupSyncRead class
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief The function that receives the status packets of a Sync Read instruction via PortHandler port
+    /// @description The function reads the concatenated status packets into one buffer and parses them in place as they arrive.
+    /// @description A packet with a wrong CRC only drops its own header, the parsing resumes on the next header found.
+    /// @description The buffer is only compacted when it is full.
+    /// @param port PortHandler instance
+    /// @param data_length Length of the data for Sync Read
+    /// @param id_list Dynamixel IDs the status packets are expected from
+    /// @param id_count Number of IDs
+    /// @param data Data of each ID, data_length bytes per ID, in the order of id_list
+    /// @param error Dynamixel hardware error of each ID
+    /// @param received Set to 1 for each ID whose status packet has been received, 0 otherwise
+    /// @return COMM_RX_TIMEOUT
+    /// @return   when nothing has been received
+    /// @return COMM_RX_CORRUPT
+    /// @return   when some status packets are missing or corrupted
+    /// @return or COMM_SUCCESS
+    ////////////////////////////////////////////////////////////////////////////////
+    int syncReadRx(PortHandler *port, uint16_t data_length, const uint8_t *id_list, uint16_t id_count, uint8_t *data, uint8_t *error, uint8_t *received);
     // SyncReadTxRx -> GroupSyncRead class
 
     ////////////////////////////////////////////////////////////////////////////////
@@ -17,6 +17,7 @@
 /* Author: zerom, Ryu Woon Jung (Leon) */
 
 #include <algorithm>
+#include <string.h>
 
 #if defined(__linux__)
 #include "dynamixel_sdk/group_sync_read.h"
@@ -64,6 +65,7 @@ bool GroupSyncRead::addParam(uint8_t id)
     id_list_.push_back(id);
     data_list_[id] = new uint8_t[data_length_];
     error_list_[id] = new uint8_t[1];
+    available_list_[id] = false;
 
     is_param_changed_ = true;
     return true;
@@ -82,6 +84,7 @@ void GroupSyncRead::removeParam(uint8_t id)
     delete[] error_list_[id];
     data_list_.erase(id);
     error_list_.erase(id);
+    available_list_.erase(id);
 
     is_param_changed_ = true;
 }
@@ -99,6 +102,7 @@ void GroupSyncRead::clearParam()
     id_list_.clear();
     data_list_.clear();
     error_list_.clear();
+    available_list_.clear();
     if (param_ != 0)
         delete[] param_;
     param_ = 0;
@@ -128,6 +132,33 @@ int GroupSyncRead::rxPacket()
     if (cnt == 0)
         return COMM_NOT_AVAILABLE;
 
+    for (int i = 0; i < cnt; i++)
+        available_list_[id_list_[i]] = false;
+
+    rx_data_.resize(cnt * data_length_);
+    rx_error_.resize(cnt);
+    rx_received_.resize(cnt);
+
+    // all the status packets are parsed together, a missing or corrupted one does not drop the others
+    result = ph_->syncReadRx(port_, data_length_, id_list_.data(), (uint16_t)cnt, rx_data_.data(), rx_error_.data(), rx_received_.data());
+    if (result != COMM_NOT_AVAILABLE)
+    {
+        for (int i = 0; i < cnt; i++)
+        {
+            if (rx_received_[i])
+            {
+                uint8_t id = id_list_[i];
+
+                memcpy(data_list_[id], &rx_data_[i * data_length_], data_length_);
+                error_list_[id][0] = rx_error_[i];
+                available_list_[id] = true;
+                last_result_ = true;
+            }
+        }
+
+        return result;
+    }
+
     for (int i = 0; i < cnt; i++)
     {
         uint8_t id = id_list_[i];
@@ -135,10 +166,10 @@ int GroupSyncRead::rxPacket()
         result = ph_->readRx(port_, id, data_length_, data_list_[id], error_list_[id]);
         if (result != COMM_SUCCESS)
             return result;
-    }
 
-    if (result == COMM_SUCCESS)
+        available_list_[id] = true;
         last_result_ = true;
+    }
 
     return result;
 }
@@ -159,7 +190,7 @@ int GroupSyncRead::txRxPacket()
 
 bool GroupSyncRead::isAvailable(uint8_t id, uint16_t address, uint16_t data_length)
 {
-    if (ph_->getProtocolVersion() == 1.0 || last_result_ == false || data_list_.find(id) == data_list_.end())
+    if (ph_->getProtocolVersion() == 1.0 || last_result_ == false || data_list_.find(id) == data_list_.end() || available_list_[id] == false)
         return false;
 
     if (address < start_address_ || start_address_ + data_length_ - data_length < address)
@@ -31,37 +31,25 @@
 #include <string.h>
 #include <time.h>
 
+#include <algorithm>
+#include <cmath>
+
 #if defined __arm__ || defined __aarch64__
 #include <wiringPi.h>
 #endif
 
 #include "dynamixel_sdk/port_handler_linux.h"
 
-#define LATENCY_TIMER                                                                                                                                                              \
-    5  // msec (USB latency timer)
-       // You should adjust the latency timer value. From the version Ubuntu 16.04.2, the default latency timer of the usb serial is '16 msec'.
-       // When you are going to use sync / bulk read, the latency timer should be loosen.
-       // the lower latency timer value, the faster communication speed.
-
-// Note:
-// You can check its value by:
-// $ cat /sys/bus/usb-serial/devices/ttyUSB0/latency_timer
-//
-// If you think that the communication is too slow, type following after plugging the usb in to change the latency timer
-//
-// Method 1. Type following (you should do this everytime when the usb once was plugged out or the connection was dropped)
-// $ echo 1 | sudo tee /sys/bus/usb-serial/devices/ttyUSB0/latency_timer
-// $ cat /sys/bus/usb-serial/devices/ttyUSB0/latency_timer
-//
-// Method 2. If you want to set it as be done automatically, and don't want to do above everytime, make rules file in /etc/udev/rules.d/. For example,
-// $ echo ACTION==\"add\", SUBSYSTEM==\"usb-serial\", DRIVER==\"ftdi_sio\", ATTR{latency_timer}=\"1\" > 99-dynamixelsdk-usb.rules
-// $ sudo cp ./99-dynamixelsdk-usb.rules /etc/udev/rules.d/
-// $ sudo udevadm control --reload-rules
-// $ sudo udevadm trigger --action=add
-// $ cat /sys/bus/usb-serial/devices/ttyUSB0/latency_timer
-//
-// or if you have another good idea that can be an alternatives,
-// please give us advice via github issue https://github.com/ROBOTIS-GIT/DynamixelSDK/issues
+// Timeout of the status packets: transmission time of the expected bytes, plus a latency margin per status packet.
+// The latency of each status packet received is measured, and the margin is its smoothed mean plus four times
+// its smoothed deviation (as a TCP retransmission timeout), so that it follows the actual return delay of the
+// devices and the latency of the UART without false timeouts.
+#define STATUS_LATENCY_INIT_US 2000.0      // first estimate of the latency, before any status is received
+#define STATUS_LATENCY_VAR_INIT_US 2500.0  // first estimate of its deviation, giving the 12 ms of the fixed timeout
+#define STATUS_LATENCY_GAIN 0.125
+#define STATUS_LATENCY_VAR_GAIN 0.25
+#define STATUS_MARGIN_MIN_US 1000.0   // the margin of a transaction never goes below (scheduling of the reading thread)
+#define STATUS_MARGIN_MAX_US 12000.0  // nor above, per status packet
 
 #define GPIO_HALF_DUPLEX_DIRECTION 17
 
@@ -80,7 +68,9 @@
 
 using namespace dynamixel;
 
-PortHandlerLinux::PortHandlerLinux(const char *port_name) : packet_start_time_ms_(0.0), packet_timeout_ms_(0.0)
+PortHandlerLinux::PortHandlerLinux(const char *port_name)
+    : packet_start_time_us_(0.0), packet_timeout_us_(0.0), direction_control_(DIRECTION_GPIO_SLEEP), tx_pending_us_(0.0), low_latency_settings_(serial::low_latency_none), rx_sampling_(false), rx_expected_length_(0),
+      rx_expected_status_(0), rx_length_(0), status_latency_us_(STATUS_LATENCY_INIT_US), status_latency_var_us_(STATUS_LATENCY_VAR_INIT_US)
 {
     is_using_ = false;
     setPortName(port_name);
@@ -110,6 +100,18 @@ void PortHandlerLinux::gpioLow()
 bool PortHandlerLinux::openPort()
 {
 #if !defined(NIRYO_NED2) && (defined(__arm__) || defined(__aarch64__))
+    // in RS-485 mode, the pin is muxed on the UART RTS by the device tree and must not be taken as a GPIO
+    if (DIRECTION_RS485 == direction_control_)
+    {
+        serial_.open();
+        if (serial_.isOpen() && applyDirectionControl())
+        {
+            low_latency_settings_ = serial_.setLowLatency();
+            return true;
+        }
+        serial_.close();
+    }
+
     int res = wiringPiSetupGpio();
 
     if (res != 0)
@@ -124,6 +126,11 @@ bool PortHandlerLinux::openPort()
 #endif
 
     serial_.open();
+    if (serial_.isOpen())
+    {
+        applyDirectionControl();
+        low_latency_settings_ = serial_.setLowLatency();
+    }
     return serial_.isOpen();
 }
 
@@ -140,62 +147,191 @@ const char *PortHandlerLinux::getPortName() { return serial_.getPort().c_str();
 bool PortHandlerLinux::setBaudRate(const int baudrate)
 {
     serial_.setBaudrate(baudrate);
-    return serial_.getBaudrate() == baudrate;
+    // the port may have been reconfigured, the RS-485 mode is set again
+    if (serial_.isOpen() && DIRECTION_RS485 == direction_control_)
+        applyDirectionControl();
+    return static_cast<int>(serial_.getBaudrate()) == baudrate;
 }
 
 int PortHandlerLinux::getBaudRate() { return serial_.getBaudrate(); }
 
 int PortHandlerLinux::getBytesAvailable() { return serial_.available(); }
 
-int PortHandlerLinux::readPort(uint8_t *packet, int length) { return serial_.read(packet, length); }
+int PortHandlerLinux::readPort(uint8_t *packet, int length)
+{
+    int nb_read = serial_.read(packet, length);
+
+    if (rx_sampling_ && nb_read > 0)
+    {
+        rx_length_ += nb_read;
+        if (rx_length_ >= rx_expected_length_)
+        {
+            rx_sampling_ = false;
+            sampleStatusLatency(getTimeSinceStart());
+        }
+    }
+
+    return nb_read;
+}
 
 int PortHandlerLinux::writePort(uint8_t *packet, int length)
 {
-    gpioHigh();
-    size_t written = serial_.write(packet, length);
-    serial_.waitByteTimes(written);
-    gpioLow();
+    size_t written = 0;
+
+    switch (direction_control_)
+    {
+    case DIRECTION_RS485:
+        // the driver drops RTS after the last stop bit, the status is buffered by the kernel meanwhile
+        written = serial_.write(packet, length);
+        tx_pending_us_ = static_cast<double>(serial_.getByteTimeNs()) * written / 1000.0;
+        break;
+    case DIRECTION_GPIO_DRAIN:
+        // sleep until the last byte is in the shift register, then poll the transmitter until it is empty
+        gpioHigh();
+        written = serial_.write(packet, length);
+        if (written > 1)
+            serial_.waitByteTimes(written - 1);
+        serial_.waitTransmitted(serial_.getByteTimeNs() * 4);
+        gpioLow();
+        break;
+    case DIRECTION_GPIO_SLEEP:
+    default:
+        gpioHigh();
+        written = serial_.write(packet, length);
+        serial_.waitByteTimes(written);
+        gpioLow();
+        break;
+    }
+
     return written;
 }
 
-void PortHandlerLinux::setPacketTimeout(uint16_t packet_length)
-{
-    packet_start_time_ms_ = getCurrentTimeMs();
-    uint32_t byte_time_ms = serial_.getByteTimeNs() / 1000000;
-    packet_timeout_ms_ = (byte_time_ms * (double)packet_length) + (LATENCY_TIMER * 2.0) + 2.0;
-}
+void PortHandlerLinux::setPacketTimeout(uint16_t packet_length) { startPacketTimeout(packet_length, 1); }
 
 void PortHandlerLinux::setPacketTimeout(double msec)
 {
-    packet_start_time_ms_ = getCurrentTimeMs();
-    packet_timeout_ms_ = msec;
+    // explicit timeout (broadcast ping), not sampled
+    rx_sampling_ = false;
+    packet_start_time_us_ = getCurrentTimeUs() + tx_pending_us_;
+    packet_timeout_us_ = msec * 1000.0;
+    tx_pending_us_ = 0.0;
 }
 
+void PortHandlerLinux::setStatusPacketsTimeout(uint16_t packet_length, uint16_t nb_status) { startPacketTimeout(packet_length, std::max<uint16_t>(nb_status, 1)); }
+
 bool PortHandlerLinux::isPacketTimeout()
 {
-    if (getTimeSinceStart() > packet_timeout_ms_)
+    double elapsed_us = getTimeSinceStart();
+    if (elapsed_us > packet_timeout_us_)
     {
-        packet_timeout_ms_ = 0;
+        // a single status cut by the timeout means the margin is too short, a status never started is lost.
+        // With several status, the missing one may be lost after the others were received
+        if (rx_sampling_ && rx_length_ > 0 && 1 == rx_expected_status_)
+            sampleStatusLatency(elapsed_us);
+
+        rx_sampling_ = false;
+        packet_timeout_us_ = 0;
         return true;
     }
     return false;
 }
 
-double PortHandlerLinux::getCurrentTimeMs()
+double PortHandlerLinux::getStatusLatencyMarginUs() const { return std::min(status_latency_us_ + 4.0 * status_latency_var_us_, STATUS_MARGIN_MAX_US); }
+
+bool PortHandlerLinux::setDirectionControl(DirectionControl direction_control)
+{
+    direction_control_ = direction_control;
+
+    if (!serial_.isOpen())
+        return true;
+
+    return applyDirectionControl();
+}
+
+PortHandlerLinux::DirectionControl PortHandlerLinux::getDirectionControl() const { return direction_control_; }
+
+uint32_t PortHandlerLinux::getLowLatencySettings() const { return low_latency_settings_; }
+
+bool PortHandlerLinux::parseDirectionControl(const std::string &name, DirectionControl &direction_control)
+{
+    if ("gpio_sleep" == name)
+        direction_control = DIRECTION_GPIO_SLEEP;
+    else if ("gpio_drain" == name)
+        direction_control = DIRECTION_GPIO_DRAIN;
+    else if ("rs485" == name)
+        direction_control = DIRECTION_RS485;
+    else
+        return false;
+
+    return true;
+}
+
+/**
+ * @brief PortHandlerLinux::applyDirectionControl
+ * @return false if the RS-485 mode is not supported by the driver, the GPIO is drained instead
+ */
+bool PortHandlerLinux::applyDirectionControl()
+{
+    tx_pending_us_ = 0.0;
+
+    if (DIRECTION_RS485 != direction_control_)
+    {
+        serial_.setRS485(false);
+        return true;
+    }
+
+    if (serial_.setRS485(true))
+        return true;
+
+    direction_control_ = DIRECTION_GPIO_DRAIN;
+    return false;
+}
+
+/**
+ * @brief PortHandlerLinux::startPacketTimeout
+ * @param packet_length : bytes expected
+ * @param nb_status : status packets expected, each one with its own latency
+ */
+void PortHandlerLinux::startPacketTimeout(uint16_t packet_length, uint16_t nb_status)
+{
+    // the reception starts once the instruction is sent
+    packet_start_time_us_ = getCurrentTimeUs() + tx_pending_us_;
+    tx_pending_us_ = 0.0;
+
+    double byte_time_us = static_cast<double>(serial_.getByteTimeNs()) / 1000.0;
+    double margin_us = std::max(nb_status * getStatusLatencyMarginUs(), STATUS_MARGIN_MIN_US);
+    packet_timeout_us_ = byte_time_us * packet_length + margin_us;
+
+    rx_sampling_ = true;
+    rx_expected_length_ = packet_length;
+    rx_expected_status_ = nb_status;
+    rx_length_ = 0;
+}
+
+/**
+ * @brief PortHandlerLinux::sampleStatusLatency : update the latency estimate with the status packets just received
+ * @param elapsed_us : time from the end of the instruction to the last byte received
+ */
+void PortHandlerLinux::sampleStatusLatency(double elapsed_us)
+{
+    double byte_time_us = static_cast<double>(serial_.getByteTimeNs()) / 1000.0;
+    double latency_us = std::max(elapsed_us - byte_time_us * rx_length_, 0.0) / rx_expected_status_;
+
+    status_latency_var_us_ += STATUS_LATENCY_VAR_GAIN * (std::abs(latency_us - status_latency_us_) - status_latency_var_us_);
+    status_latency_us_ += STATUS_LATENCY_GAIN * (latency_us - status_latency_us_);
+}
+
+double PortHandlerLinux::getCurrentTimeUs()
 {
     struct timespec tv;
     clock_gettime(CLOCK_MONOTONIC, &tv);
-    return ((double)tv.tv_sec * 1000.0 + (double)tv.tv_nsec * 0.001 * 0.001);
+    return ((double)tv.tv_sec * 1000000.0 + (double)tv.tv_nsec * 0.001);
 }
 
 double PortHandlerLinux::getTimeSinceStart()
 {
-    double time = getCurrentTimeMs() - packet_start_time_ms_;
-
-    if (time < 0.0)
-        packet_start_time_ms_ = getCurrentTimeMs();
-
-    return time;
+    // negative while the instruction is still being sent
+    return getCurrentTimeUs() - packet_start_time_us_;
 }
 
 #endif
@@ -62,6 +62,28 @@
 
 using namespace dynamixel;
 
+// index of the first packet header (FF FF FD, not followed by the stuffing byte FD) in packet,
+// or length - 3 if there is none, to keep the bytes which may start a header
+static uint16_t findHeader(const uint8_t *packet, uint16_t length)
+{
+    if (length < 4)
+        return 0;
+
+    const uint8_t *ptr = packet;
+    const uint8_t *end = packet + length - 3;
+    while (ptr < end)
+    {
+        ptr = (const uint8_t *)memchr(ptr, 0xFF, end - ptr);
+        if (ptr == NULL)
+            break;
+        if (ptr[1] == 0xFF && ptr[2] == 0xFD && ptr[3] != 0xFD)
+            return (uint16_t)(ptr - packet);
+        ptr++;
+    }
+
+    return length - 3;
+}
+
 Protocol2PacketHandler *Protocol2PacketHandler::unique_instance_ = new Protocol2PacketHandler();
 
 Protocol2PacketHandler::Protocol2PacketHandler() {}
@@ -238,12 +260,19 @@ void Protocol2PacketHandler::removeStuffing(uint8_t *packet)
 
 int Protocol2PacketHandler::txPacket(PortHandler *port, uint8_t *txpacket)
 {
-    uint16_t total_packet_length = 0;
-    uint16_t written_packet_length = 0;
-
     if (port->is_using_)
         return COMM_PORT_BUSY;
-    port->is_using_ = true;
+
+    uint16_t total_packet_length = prepareTxPacket(txpacket);
+    if (0 == total_packet_length)
+        return COMM_TX_ERROR;
+
+    return txPreparedPacket(port, txpacket, total_packet_length);
+}
+
+uint16_t Protocol2PacketHandler::prepareTxPacket(uint8_t *txpacket)
+{
+    uint16_t total_packet_length = 0;
 
     // byte stuffing for header
     addStuffing(txpacket);
@@ -252,10 +281,7 @@ int Protocol2PacketHandler::txPacket(PortHandler *port, uint8_t *txpacket)
     total_packet_length = DXL_MAKEWORD(txpacket[PKT_LENGTH_L], txpacket[PKT_LENGTH_H]) + 7;
     // 7: HEADER0 HEADER1 HEADER2 RESERVED ID LENGTH_L LENGTH_H
     if (total_packet_length > TXPACKET_MAX_LEN)
-    {
-        port->is_using_ = false;
-        return COMM_TX_ERROR;
-    }
+        return 0;
 
     // make packet header
     txpacket[PKT_HEADER0] = 0xFF;
@@ -268,10 +294,21 @@ int Protocol2PacketHandler::txPacket(PortHandler *port, uint8_t *txpacket)
     txpacket[total_packet_length - 2] = DXL_LOBYTE(crc);
     txpacket[total_packet_length - 1] = DXL_HIBYTE(crc);
 
-    // tx packet
+    return total_packet_length;
+}
+
+int Protocol2PacketHandler::txPreparedPacket(PortHandler *port, const uint8_t *txpacket, uint16_t length)
+{
+    uint16_t written_packet_length = 0;
+
+    if (port->is_using_)
+        return COMM_PORT_BUSY;
+    port->is_using_ = true;
+
+    // tx packet, writePort does not modify it
     port->clearPort();
-    written_packet_length = port->writePort(txpacket, total_packet_length);
-    if (total_packet_length != written_packet_length)
+    written_packet_length = port->writePort(const_cast<uint8_t *>(txpacket), length);
+    if (length != written_packet_length)
     {
         port->is_using_ = false;
         return COMM_TX_FAIL;
@@ -292,25 +329,18 @@ int Protocol2PacketHandler::rxPacket(PortHandler *port, uint8_t *rxpacket)
         rx_length += port->readPort(&rxpacket[rx_length], wait_length - rx_length);
         if (rx_length >= wait_length)
         {
-            uint16_t idx = 0;
-
             // find packet header
-            for (idx = 0; idx < (rx_length - 3); idx++)
-            {
-                if ((rxpacket[idx] == 0xFF) && (rxpacket[idx + 1] == 0xFF) && (rxpacket[idx + 2] == 0xFD) && (rxpacket[idx + 3] != 0xFD))
-                    break;
-            }
+            uint16_t idx = findHeader(rxpacket, rx_length);
 
             if (idx == 0)  // found at the beginning of the packet
             {
                 if (rxpacket[PKT_RESERVED] != 0x00 || rxpacket[PKT_ID] > 0xFC || DXL_MAKEWORD(rxpacket[PKT_LENGTH_L], rxpacket[PKT_LENGTH_H]) > RXPACKET_MAX_LEN ||
                     rxpacket[PKT_INSTRUCTION] != 0x55)
                 {
-                    // remove the first byte in the packet
-                    for (uint16_t s = 0; s < rx_length - 1; s++)
-                        rxpacket[s] = rxpacket[1 + s];
-                    // memcpy(&rxpacket[0], &rxpacket[idx], rx_length - idx);
-                    rx_length -= 1;
+                    // remove the bytes before the next packet header in one move
+                    idx = 1 + findHeader(&rxpacket[1], rx_length - 1);
+                    memmove(&rxpacket[0], &rxpacket[idx], rx_length - idx);
+                    rx_length -= idx;
                     continue;
                 }
 
@@ -357,9 +387,7 @@ int Protocol2PacketHandler::rxPacket(PortHandler *port, uint8_t *rxpacket)
             else
             {
                 // remove unnecessary packets
-                for (uint16_t s = 0; s < rx_length - idx; s++)
-                    rxpacket[s] = rxpacket[idx + s];
-                // memcpy(&rxpacket[0], &rxpacket[idx], rx_length - idx);
+                memmove(&rxpacket[0], &rxpacket[idx], rx_length - idx);
                 rx_length -= idx;
             }
         }
@@ -518,36 +546,30 @@ int Protocol2PacketHandler::broadcastPing(PortHandler *port, std::vector<uint8_t
     if (rx_length == 0)
         return COMM_RX_TIMEOUT;
 
+    // parse in place, the start of the unparsed bytes moves forward
+    uint16_t offset = 0;
     while (1)
     {
-        if (rx_length < STATUS_LENGTH)
+        if (rx_length - offset < STATUS_LENGTH)
             return COMM_RX_CORRUPT;
 
-        uint16_t idx = 0;
-
         // find packet header
-        for (idx = 0; idx < (rx_length - 2); idx++)
-        {
-            if (rxpacket[idx] == 0xFF && rxpacket[idx + 1] == 0xFF && rxpacket[idx + 2] == 0xFD)
-                break;
-        }
+        uint16_t idx = findHeader(&rxpacket[offset], rx_length - offset);
 
         if (idx == 0)  // found at the beginning of the packet
         {
             // verify CRC16
-            uint16_t crc = DXL_MAKEWORD(rxpacket[STATUS_LENGTH - 2], rxpacket[STATUS_LENGTH - 1]);
+            uint16_t crc = DXL_MAKEWORD(rxpacket[offset + STATUS_LENGTH - 2], rxpacket[offset + STATUS_LENGTH - 1]);
 
-            if (updateCRC(0, rxpacket, STATUS_LENGTH - 2) == crc)
+            if (updateCRC(0, &rxpacket[offset], STATUS_LENGTH - 2) == crc)
             {
                 result = COMM_SUCCESS;
 
-                id_list.push_back(rxpacket[PKT_ID]);
+                id_list.push_back(rxpacket[offset + PKT_ID]);
 
-                for (uint16_t s = 0; s < rx_length - STATUS_LENGTH; s++)
-                    rxpacket[s] = rxpacket[STATUS_LENGTH + s];
-                rx_length -= STATUS_LENGTH;
+                offset += STATUS_LENGTH;
 
-                if (rx_length == 0)
+                if (offset == rx_length)
                     return result;
             }
             else
@@ -555,17 +577,13 @@ int Protocol2PacketHandler::broadcastPing(PortHandler *port, std::vector<uint8_t
                 result = COMM_RX_CORRUPT;
 
                 // remove header (0xFF 0xFF 0xFD)
-                for (uint16_t s = 0; s < rx_length - 3; s++)
-                    rxpacket[s] = rxpacket[3 + s];
-                rx_length -= 3;
+                offset += 3;
             }
         }
         else
         {
             // remove unnecessary packets
-            for (uint16_t s = 0; s < rx_length - idx; s++)
-                rxpacket[s] = rxpacket[idx + s];
-            rx_length -= idx;
+            offset += idx;
         }
     }
 
@@ -955,12 +973,113 @@ int Protocol2PacketHandler::syncReadTx(PortHandler *port, uint16_t start_address
 
     result = txPacket(port, txpacket);
     if (result == COMM_SUCCESS)
-        port->setPacketTimeout((uint16_t)((11 + data_length) * param_length));
+        port->setStatusPacketsTimeout((uint16_t)((11 + data_length) * param_length), param_length);
 
     free(txpacket);
     return result;
 }
 
+int Protocol2PacketHandler::syncReadRx(PortHandler *port, uint16_t data_length, const uint8_t *id_list, uint16_t id_count, uint8_t *data, uint8_t *error, uint8_t *received)
+{
+    const uint16_t MIN_STATUS_LENGTH = 11;  // HEADER0 HEADER1 HEADER2 RESERVED ID LENGTH_L LENGTH_H INST ERROR CRC16_L CRC16_H
+
+    uint8_t rxpacket[RXPACKET_MAX_LEN];
+    uint16_t rx_length = 0;
+    // start of the bytes not parsed yet
+    uint16_t start = 0;
+    uint16_t nb_received = 0;
+
+    memset(received, 0, id_count);
+
+    while (nb_received < id_count)
+    {
+        // compact the buffer only when it is full
+        if (rx_length == RXPACKET_MAX_LEN)
+        {
+            if (start == 0)
+                break;
+            memmove(&rxpacket[0], &rxpacket[start], rx_length - start);
+            rx_length -= start;
+            start = 0;
+        }
+
+        rx_length += port->readPort(&rxpacket[rx_length], RXPACKET_MAX_LEN - rx_length);
+
+        // parse all the complete status packets
+        while (rx_length - start >= MIN_STATUS_LENGTH)
+        {
+            start += findHeader(&rxpacket[start], rx_length - start);
+            if (rx_length - start < MIN_STATUS_LENGTH)
+                break;
+
+            uint8_t *packet = &rxpacket[start];
+            uint16_t packet_length = DXL_MAKEWORD(packet[PKT_LENGTH_L], packet[PKT_LENGTH_H]) + PKT_LENGTH_H + 1;
+
+            if (packet[PKT_HEADER0] != 0xFF || packet[PKT_HEADER1] != 0xFF || packet[PKT_HEADER2] != 0xFD || packet[PKT_RESERVED] != 0x00 ||
+                packet[PKT_ID] > 0xFC || packet_length > RXPACKET_MAX_LEN || packet[PKT_INSTRUCTION] != 0x55)
+            {
+                // not a packet header, resume on the next byte
+                start++;
+                continue;
+            }
+
+            if (rx_length - start < packet_length)
+                break;
+
+            // verify CRC16
+            uint16_t crc = DXL_MAKEWORD(packet[packet_length - 2], packet[packet_length - 1]);
+            if (updateCRC(0, packet, packet_length - 2) != crc)
+            {
+                // drop the header only, the next packet may start inside this one
+                start += 3;
+                continue;
+            }
+
+            start += packet_length;
+            removeStuffing(packet);
+
+            if (DXL_MAKEWORD(packet[PKT_LENGTH_L], packet[PKT_LENGTH_H]) < data_length + 4)  // INST ERROR DATA CRC16_L CRC16_H
+                continue;
+
+            for (uint16_t i = 0; i < id_count; i++)
+            {
+                if (id_list[i] == packet[PKT_ID] && !received[i])
+                {
+                    memcpy(&data[i * data_length], &packet[PKT_PARAMETER0 + 1], data_length);
+                    if (error != 0)
+                        error[i] = packet[PKT_ERROR];
+                    received[i] = 1;
+                    nb_received++;
+                    break;
+                }
+            }
+        }
+
+        if (nb_received == id_count)
+            break;
+
+        // check timeout
+        if (port->isPacketTimeout() == true)
+            break;
+
+#if defined(__linux__) || defined(__APPLE__)
+        usleep(0);
+#elif defined(_WIN32) || defined(_WIN64)
+        Sleep(0);
+#endif
+    }
+    port->is_using_ = false;
+
+    if (nb_received == id_count)
+        return COMM_SUCCESS;
+
+    // Flush data received but not read and clear Port (trying to avoid data block motors)
+    port->flushInput();
+    port->clearPort();
+
+    return (rx_length == 0) ? COMM_RX_TIMEOUT : COMM_RX_CORRUPT;
+}
+
 int Protocol2PacketHandler::syncWriteTxOnly(PortHandler *port, uint16_t start_address, uint16_t data_length, uint8_t *param, uint16_t param_length)
 {
     int result = COMM_TX_FAIL;
@@ -1016,7 +1135,7 @@ int Protocol2PacketHandler::bulkReadTx(PortHandler *port, uint8_t *param, uint16
         int wait_length = 0;
         for (uint16_t i = 0; i < param_length; i += 5)
             wait_length += DXL_MAKEWORD(param[i + 3], param[i + 4]) + 10;
-        port->setPacketTimeout((uint16_t)wait_length);
+        port->setStatusPacketsTimeout((uint16_t)wait_length, (uint16_t)(param_length / 5));
     }
 
     free(txpacket);
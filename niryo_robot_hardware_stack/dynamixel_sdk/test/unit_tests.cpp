@@ -0,0 +1,266 @@
+/*
+    unit_tests.cpp
+    Copyright (C) 2020 Niryo
+    All rights reserved.
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+// Bring in my package's API, which is what I'm testing
+#include "dynamixel_sdk/port_handler.h"
+#include "dynamixel_sdk/protocol2_packet_handler.h"
+
+#include <algorithm>
+#include <deque>
+#include <string>
+#include <vector>
+
+// Bring in gtest
+#include <gtest/gtest.h>
+
+namespace
+{
+
+/**
+ * @brief The FakePortHandler class replays a byte stream, a few bytes at each read.
+ * The timeout expires once the whole stream has been read
+ */
+class FakePortHandler : public dynamixel::PortHandler
+{
+  public:
+    explicit FakePortHandler(size_t chunk_size) : _chunk_size(chunk_size) { is_using_ = false; }
+
+    void setStream(const std::vector<uint8_t> &stream) { _stream.assign(stream.begin(), stream.end()); }
+
+    void gpioHigh() override {}
+    void gpioLow() override {}
+    bool openPort() override { return true; }
+    void closePort() override {}
+    void clearPort() override { _stream.clear(); }
+    void flushInput() override { _stream.clear(); }
+    void setPortName(const char *port_name) override { _port_name = port_name; }
+    const char *getPortName() override { return _port_name.c_str(); }
+    bool setBaudRate(const int baudrate) override
+    {
+        _baudrate = baudrate;
+        return true;
+    }
+    int getBaudRate() override { return _baudrate; }
+    int getBytesAvailable() override { return static_cast<int>(_stream.size()); }
+
+    int readPort(uint8_t *packet, int length) override
+    {
+        size_t nb_bytes = std::min({_chunk_size, _stream.size(), static_cast<size_t>(length)});
+        std::copy(_stream.begin(), _stream.begin() + static_cast<long>(nb_bytes), packet);
+        _stream.erase(_stream.begin(), _stream.begin() + static_cast<long>(nb_bytes));
+        return static_cast<int>(nb_bytes);
+    }
+
+    int writePort(uint8_t * /*packet*/, int length) override { return length; }
+    void setPacketTimeout(uint16_t /*packet_length*/) override {}
+    void setPacketTimeout(double /*msec*/) override {}
+    bool isPacketTimeout() override { return _stream.empty(); }
+
+  private:
+    std::deque<uint8_t> _stream;
+    size_t _chunk_size;
+    std::string _port_name{"fake"};
+    int _baudrate{DEFAULT_BAUDRATE_};
+};
+
+/**
+ * @brief The Protocol2SyncReadTestSuite class feeds the status packets of a sync read to Protocol2PacketHandler::syncReadRx
+ */
+class Protocol2SyncReadTestSuite : public ::testing::Test
+{
+  protected:
+    static constexpr uint16_t DATA_LENGTH = 4;
+
+    // crc of the protocol 2.0
+    static uint16_t crc16(const std::vector<uint8_t> &data)
+    {
+        uint16_t crc = 0;
+        for (auto byte : data)
+        {
+            crc ^= static_cast<uint16_t>(byte << 8);
+            for (int bit = 0; bit < 8; ++bit)
+                crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x8005) : static_cast<uint16_t>(crc << 1);
+        }
+        return crc;
+    }
+
+    static std::vector<uint8_t> status(uint8_t id, uint32_t value, uint8_t error = 0)
+    {
+        std::vector<uint8_t> packet{0xFF, 0xFF, 0xFD, 0x00, id, 4 + DATA_LENGTH, 0x00, 0x55, error};
+        for (uint16_t i = 0; i < DATA_LENGTH; ++i)
+            packet.emplace_back(static_cast<uint8_t>(value >> (8 * i)));
+
+        uint16_t crc = crc16(packet);
+        packet.emplace_back(DXL_LOBYTE(crc));
+        packet.emplace_back(DXL_HIBYTE(crc));
+        return packet;
+    }
+
+    static void append(std::vector<uint8_t> &stream, const std::vector<uint8_t> &bytes) { stream.insert(stream.end(), bytes.begin(), bytes.end()); }
+
+    int syncReadRx(FakePortHandler &port)
+    {
+        port.is_using_ = true;
+        return dynamixel::Protocol2PacketHandler::getInstance()->syncReadRx(&port, DATA_LENGTH, ids.data(), static_cast<uint16_t>(ids.size()), data.data(),
+                                                                            error.data(), received.data());
+    }
+
+    uint32_t getValue(size_t index) const
+    {
+        return DXL_MAKEDWORD(DXL_MAKEWORD(data[index * DATA_LENGTH], data[index * DATA_LENGTH + 1]),
+                             DXL_MAKEWORD(data[index * DATA_LENGTH + 2], data[index * DATA_LENGTH + 3]));
+    }
+
+    std::vector<uint8_t> ids{2, 3, 4};
+    std::vector<uint8_t> data = std::vector<uint8_t>(ids.size() * DATA_LENGTH, 0);
+    std::vector<uint8_t> error = std::vector<uint8_t>(ids.size(), 0);
+    std::vector<uint8_t> received = std::vector<uint8_t>(ids.size(), 0);
+};
+
+// Test the status packets are read whatever the way the bytes are received, and given to their id
+TEST_F(Protocol2SyncReadTestSuite, allRepliesTest)
+{
+    for (size_t chunk_size : {1u, 5u, 1024u})
+    {
+        FakePortHandler port(chunk_size);
+
+        std::vector<uint8_t> stream;
+        append(stream, status(4, 4000));
+        append(stream, status(2, 2000, 0x80));
+        append(stream, status(3, 3000));
+        port.setStream(stream);
+
+        EXPECT_EQ(syncReadRx(port), COMM_SUCCESS) << "chunk size " << chunk_size;
+        EXPECT_EQ(received, std::vector<uint8_t>({1, 1, 1}));
+        EXPECT_EQ(getValue(0), 2000u);
+        EXPECT_EQ(getValue(1), 3000u);
+        EXPECT_EQ(getValue(2), 4000u);
+        EXPECT_EQ(error, std::vector<uint8_t>({0x80, 0, 0}));
+        EXPECT_FALSE(port.is_using_);
+    }
+}
+
+// Test the parser resynchronizes on the next header after some garbage, including bytes looking like a header
+TEST_F(Protocol2SyncReadTestSuite, garbageResyncTest)
+{
+    FakePortHandler port(3);
+
+    std::vector<uint8_t> stream{0x00, 0x12, 0xFF, 0xFF, 0x42};
+    append(stream, status(2, 2000));
+    append(stream, {0xFF, 0xFF, 0xFD, 0xFD, 0xFF});
+    append(stream, status(3, 3000));
+    // header of a packet which is not a status packet
+    append(stream, {0xFF, 0xFF, 0xFD, 0x00, 0x01, 0x07, 0x00, 0x02, 0x84, 0x00, 0x04});
+    append(stream, status(4, 4000));
+    port.setStream(stream);
+
+    EXPECT_EQ(syncReadRx(port), COMM_SUCCESS);
+    EXPECT_EQ(received, std::vector<uint8_t>({1, 1, 1}));
+    EXPECT_EQ(getValue(0), 2000u);
+    EXPECT_EQ(getValue(1), 3000u);
+    EXPECT_EQ(getValue(2), 4000u);
+}
+
+// Test the ids answering before a truncated status packet keep their data
+TEST_F(Protocol2SyncReadTestSuite, truncatedReplyTest)
+{
+    FakePortHandler port(4);
+
+    std::vector<uint8_t> stream;
+    append(stream, status(2, 2000));
+    append(stream, status(3, 3000));
+    auto last = status(4, 4000);
+    append(stream, std::vector<uint8_t>(last.begin(), last.begin() + 9));
+    port.setStream(stream);
+
+    EXPECT_EQ(syncReadRx(port), COMM_RX_CORRUPT);
+    EXPECT_EQ(received, std::vector<uint8_t>({1, 1, 0}));
+    EXPECT_EQ(getValue(0), 2000u);
+    EXPECT_EQ(getValue(1), 3000u);
+    EXPECT_FALSE(port.is_using_);
+}
+
+// Test a status packet with a bad crc is dropped, without losing the next ones
+TEST_F(Protocol2SyncReadTestSuite, badCrcTest)
+{
+    FakePortHandler port(2);
+
+    std::vector<uint8_t> stream;
+    append(stream, status(2, 2000));
+    auto corrupted = status(3, 3000);
+    corrupted[10] ^= 0x01;
+    append(stream, corrupted);
+    append(stream, status(4, 4000));
+    port.setStream(stream);
+
+    EXPECT_EQ(syncReadRx(port), COMM_RX_CORRUPT);
+    EXPECT_EQ(received, std::vector<uint8_t>({1, 0, 1}));
+    EXPECT_EQ(getValue(0), 2000u);
+    EXPECT_EQ(getValue(2), 4000u);
+}
+
+// Test a missing id does not prevent reading the ids answering after it
+TEST_F(Protocol2SyncReadTestSuite, missingIdTest)
+{
+    FakePortHandler port(1024);
+
+    std::vector<uint8_t> stream;
+    append(stream, status(2, 2000));
+    append(stream, status(4, 4000));
+    port.setStream(stream);
+
+    EXPECT_EQ(syncReadRx(port), COMM_RX_CORRUPT);
+    EXPECT_EQ(received, std::vector<uint8_t>({1, 0, 1}));
+    EXPECT_EQ(getValue(0), 2000u);
+    EXPECT_EQ(getValue(2), 4000u);
+}
+
+// Test an id not requested and an id answering twice are not counted
+TEST_F(Protocol2SyncReadTestSuite, unexpectedIdTest)
+{
+    FakePortHandler port(7);
+
+    std::vector<uint8_t> stream;
+    append(stream, status(2, 2000));
+    append(stream, status(9, 9000));
+    append(stream, status(2, 2222));
+    append(stream, status(3, 3000));
+    port.setStream(stream);
+
+    EXPECT_EQ(syncReadRx(port), COMM_RX_CORRUPT);
+    EXPECT_EQ(received, std::vector<uint8_t>({1, 1, 0}));
+    EXPECT_EQ(getValue(0), 2000u);
+    EXPECT_EQ(getValue(1), 3000u);
+}
+
+// Test nothing received is a timeout
+TEST_F(Protocol2SyncReadTestSuite, noReplyTest)
+{
+    FakePortHandler port(1024);
+
+    EXPECT_EQ(syncReadRx(port), COMM_RX_TIMEOUT);
+    EXPECT_EQ(received, std::vector<uint8_t>({0, 0, 0}));
+    EXPECT_FALSE(port.is_using_);
+}
+}  // namespace
+
+// Run all the tests that were declared with TEST()
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+
+    return RUN_ALL_TESTS();
+}
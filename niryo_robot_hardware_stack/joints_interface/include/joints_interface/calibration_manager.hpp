@@ -25,9 +25,13 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #include <string>
 #include <vector>
 #include <thread>
+#include <map>
+#include <mutex>
+#include <functional>
 
 #include "common/model/joint_state.hpp"
 #include "common/model/bus_protocol_enum.hpp"
+#include "common/util/calibration_record.hpp"
 
 #include "ttl_driver/ttl_interface_core.hpp"
 #include "can_driver/can_interface_core.hpp"
@@ -37,6 +41,16 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 namespace joints_interface
 {
 
+    /**
+     * @brief The CalibrationManager class runs the calibration of the steppers as a state machine.
+     *
+     * startCalibration() only checks the preconditions and sends the first commands, the calibration
+     * is then advanced by update(), called at each cycle of the joints control loop. Each step ends
+     * as soon as its condition is met on the hardware (queues of commands processed, homing status
+     * reported by the steppers, joints at their target and stopped) instead of after a fixed delay.
+     * The current step is published on the calibration progress topic and a running calibration
+     * can be stopped with cancelCalibration().
+     */
     class CalibrationManager
     {
 
@@ -56,15 +70,55 @@ namespace joints_interface
         CalibrationManager &operator=(const CalibrationManager &) = delete;
 
         int startCalibration(int mode, std::string &result_message);
+        bool cancelCalibration();
+        bool update();
 
+        bool isRunning() const;
         common::model::EStepperCalibrationStatus getCalibrationStatus() const;
 
+    private:
+        /**
+         * @brief steps of the calibration state machine
+         */
+        enum class ECalibrationStep
+        {
+            IDLE,
+            WARNING,
+            TORQUE_ON,
+            MOVE_BEFORE_CALIBRATION,
+            WRITE_HOMING_ABS_POSITION,
+            SEND_CALIBRATION,
+            WAIT_HOMING,
+            RESET_VELOCITY_PROFILES,
+            MOVE_TO_HOME,
+            MANUAL_OFFSETS
+        };
+
+        /**
+         * @brief a joint expected to reach a given motor position and stop
+         */
+        struct MotionTarget
+        {
+            std::shared_ptr<common::model::JointState> state;
+            int target{0};
+            int last_position{0};
+            ros::Time last_sample_time;
+            bool stopped{false};
+        };
+
     private:
         void initParameters(ros::NodeHandle &nh);
-        void initCalibrationParams(ros::NodeHandle &nh);
 
-        common::model::EStepperCalibrationStatus autoCalibration();
-        common::model::EStepperCalibrationStatus manualCalibration();
+        // state machine
+        void setStep(ECalibrationStep step);
+        bool stepTimedOut(double timeout) const;
+        bool isTtlQueueFree() const;
+        bool isMotionDone();
+        void addMotionTarget(const std::shared_ptr<common::model::JointState> &state, int target);
+        void onHomingDone(common::model::EStepperCalibrationStatus status);
+        void finish(common::model::EStepperCalibrationStatus status);
+
+        static const char *stepName(ECalibrationStep step);
 
         // tests
         bool canProcessManualCalibration(std::string &result_message);
@@ -78,11 +132,17 @@ namespace joints_interface
         void moveRobotBeforeCalibration();
         void moveSteppersToHome();
         void sendCalibrationToSteppers();
+        void sendManualCalibrationOffsets(const std::vector<int> &motor_id_list, const std::vector<int> &steps_list);
         void activateTorque(bool activated);
         bool writeHomingAbsPosition();
         bool readHomingAbsPosition();
 
         // file operations
+        static std::string expandHomePath(const std::string &path);
+        void loadCalibrationRecord();
+        bool saveCalibrationRecord();
+        static bool readLegacyFile(const std::string &file_name, const std::function<void(uint8_t, int32_t)> &setter);
+
         bool saveCalibrationOffsetsToFile(const std::vector<int> &motor_id_list, const std::vector<int> &steps_list);
         bool readCalibrationOffsetsFromFile(std::vector<int> &motor_id_list, std::vector<int> &steps_list);
         bool saveHomingAbsPositionToFile();
@@ -105,16 +165,52 @@ namespace joints_interface
         std::vector<std::shared_ptr<common::model::JointState>> _joint_states_list;
         std::map<uint8_t, CalibrationConfig> _calibration_params_map;
 
+        ros::Publisher _calibration_progress_publisher;
+
+        // protects the state machine, accessed by the services and the control loop
+        mutable std::mutex _calibration_mutex;
+
+        ECalibrationStep _step{ECalibrationStep::IDLE};
+        ros::Time _step_start_time;
+        ros::Time _calibration_start_time;
+        std::vector<MotionTarget> _motion_targets;
+
         int _calibration_timeout{0};
         bool _simulation_mode{false};
 
+        double _warning_duration{2.0};
+        double _move_timeout{5.0};
+        double _position_tolerance{0.05};
+        double _velocity_tolerance{0.02};
+
+        // calibration saved on disk, loaded once at startup
+        common::util::CalibrationRecord _calibration_record;
+
+        std::string _calibration_record_file_name;
+        // legacy text files, only read to migrate an old calibration
         std::string _calibration_file_name;
         std::string _homing_offset_file_name;
         std::string _hardware_version;
 
         static constexpr int AUTO_CALIBRATION = 1;
         static constexpr int MANUAL_CALIBRATION = 2;
+
+        static constexpr double HOMING_TIMEOUT = 30.0;
+        // time given to the steps without their own timeout, on top of the ones of the other steps
+        static constexpr double CALIBRATION_END_MARGIN = 10.0;
+        // period used to estimate the velocity of a joint from its position
+        static constexpr double VELOCITY_SAMPLE_PERIOD = 0.1;
     };
 
+    /**
+     * @brief CalibrationManager::isRunning
+     * @return true if a calibration is being processed by the state machine
+     */
+    inline bool CalibrationManager::isRunning() const
+    {
+        std::lock_guard<std::mutex> lck(_calibration_mutex);
+        return ECalibrationStep::IDLE != _step;
+    }
+
 } // JointsInterface
 #endif
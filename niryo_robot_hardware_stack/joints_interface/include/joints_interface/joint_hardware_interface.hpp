@@ -50,6 +50,8 @@ class JointHardwareInterface : public hardware_interface::RobotHW
                                std::shared_ptr<can_driver::CanInterfaceCore> can_interface);
 
         int calibrateJoints(int mode, std::string &result_message);
+        bool cancelCalibration();
+        bool updateCalibration();
         void setNeedCalibration();
         void activateLearningMode(bool activated);
         void synchronizeMotors(bool synchronize);
@@ -62,11 +64,15 @@ class JointHardwareInterface : public hardware_interface::RobotHW
         bool rebootAll(bool torque_on);
 
         const std::vector<std::shared_ptr<common::model::JointState> >& getJointsState() const;
+        ros::Time getSampleStamp() const;
 
         // RobotHW interface
     public:
         bool init(ros::NodeHandle& rootnh, ros::NodeHandle &robot_hwnh) override;
         int initHardware(const std::shared_ptr<common::model::JointState>& motor_state, bool torque_on);
+        int initTtlHardware(const std::vector<std::shared_ptr<common::model::JointState> > &joint_list, bool torque_on);
+        int configureTtlHardware(const std::vector<std::shared_ptr<common::model::JointState> > &joint_list, bool torque_on);
+        void initTrajectoryCommands();
 
         void read(const ros::Time &/*time*/, const ros::Duration &/*period*/) override;
         void write(const ros::Time &/*time*/, const ros::Duration &/*period*/) override;
@@ -93,6 +99,15 @@ class JointHardwareInterface : public hardware_interface::RobotHW
 
         std::vector<std::shared_ptr<common::model::JointState> > _joint_state_list;
         std::string _hardware_version;
+
+        // joints of each bus, in the order of their goals, and the goals written at each cycle
+        std::vector<std::shared_ptr<common::model::JointState> > _ttl_trajectory_joints;
+        std::vector<uint32_t> _ttl_trajectory_goals;
+        std::vector<std::shared_ptr<common::model::JointState> > _can_trajectory_joints;
+        std::vector<int32_t> _can_trajectory_goals;
+
+        // time of the oldest joint position used by the last read
+        common::model::AbstractMotorState::Clock::time_point _sample_time;
 };
 
 /**
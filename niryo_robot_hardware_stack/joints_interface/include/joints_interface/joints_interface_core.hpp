@@ -86,10 +86,12 @@ class JointsInterfaceCore : common::util::IInterfaceCore
         void startSubscribers(ros::NodeHandle& nh) override;
 
         void rosControlLoop();
+        void onCalibrationDone();
         void resetController();
 
         bool _callbackResetController(niryo_robot_msgs::Trigger::Request &req, niryo_robot_msgs::Trigger::Response &res);
         bool _callbackCalibrateMotors(niryo_robot_msgs::SetInt::Request &req, niryo_robot_msgs::SetInt::Response &res);
+        bool _callbackCancelCalibration(niryo_robot_msgs::Trigger::Request &req, niryo_robot_msgs::Trigger::Response &res);
         bool _callbackRequestNewCalibration(niryo_robot_msgs::Trigger::Request &req, niryo_robot_msgs::Trigger::Response &res);
         bool _callbackActivateLearningMode(niryo_robot_msgs::SetBool::Request &req, niryo_robot_msgs::SetBool::Response &res);
 
@@ -121,6 +123,7 @@ class JointsInterfaceCore : common::util::IInterfaceCore
 
         ros::ServiceServer _reset_controller_server; // workaround to compensate missed steps
         ros::ServiceServer _calibrate_motors_server;
+        ros::ServiceServer _cancel_calibration_server;
         ros::ServiceServer _request_new_calibration_server;
         ros::ServiceServer _activate_learning_mode_server;
 
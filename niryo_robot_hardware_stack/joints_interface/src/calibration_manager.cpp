@@ -18,6 +18,8 @@
 */
 
 // std
+#include <cmath>
+#include <cstdlib>
 #include <fstream>
 #include <functional>
 #include <map>
@@ -30,6 +32,7 @@
 
 // ros
 #include <ros/console.h>
+#include <std_msgs/String.h>
 
 // niryo
 #include "common/model/dxl_command_type_enum.hpp"
@@ -83,6 +86,9 @@ CalibrationManager::CalibrationManager(ros::NodeHandle &nh, std::vector<std::sha
     assert(_stepper_bus_interface);
 
     initParameters(nh);
+    loadCalibrationRecord();
+
+    _calibration_progress_publisher = nh.advertise<std_msgs::String>("/niryo_robot/joints_interface/calibration_progress", 10, true);
 
     ROS_INFO("Calibration Interface - Calibration interface started");
 }
@@ -97,13 +103,24 @@ void CalibrationManager::initParameters(ros::NodeHandle &nh)
 
     nh.getParam("calibration_file", _calibration_file_name);
     nh.getParam("homing_offset_file", _homing_offset_file_name);
+    nh.getParam("calibration_record_file", _calibration_record_file_name);
+
+    // the files are opened directly, nothing else expands "~"
+    _calibration_file_name = expandHomePath(_calibration_file_name);
+    _homing_offset_file_name = expandHomePath(_homing_offset_file_name);
+    _calibration_record_file_name = expandHomePath(_calibration_record_file_name);
     nh.getParam("/niryo_robot_hardware_interface/hardware_version", _hardware_version);
     nh.getParam("simulation_mode", _simulation_mode);
 
+    nh.getParam("calibration_warning_duration", _warning_duration);
+    nh.getParam("calibration_move_timeout", _move_timeout);
+    nh.getParam("calibration_position_tolerance", _position_tolerance);
+    nh.getParam("calibration_velocity_tolerance", _velocity_tolerance);
+
     ROS_DEBUG("Calibration Interface::initParameters - hardware_version %s", _hardware_version.c_str());
     ROS_DEBUG("Calibration Interface::initParameters - Calibration timeout %d", _calibration_timeout);
 
-    ROS_DEBUG("Calibration Interface::initParameters - Calibration file name %s", _calibration_file_name.c_str());
+    ROS_DEBUG("Calibration Interface::initParameters - Calibration record file name %s", _calibration_record_file_name.c_str());
     ROS_DEBUG("Calibration Interface::initParameters - Simulation mode %s", _simulation_mode ? "True" : "False");
 
     // get steppers specific params
@@ -179,10 +196,10 @@ void CalibrationManager::initParameters(ros::NodeHandle &nh)
 }
 
 /**
- * @brief CalibrationManager::startCalibration
+ * @brief CalibrationManager::startCalibration : checks the preconditions and starts the calibration state machine
  * @param mode
  * @param result_message
- * @return
+ * @return SUCCESS if the calibration has been started, it is then processed by update()
  */
 int CalibrationManager::startCalibration(int mode, std::string &result_message)
 {
@@ -190,35 +207,40 @@ int CalibrationManager::startCalibration(int mode, std::string &result_message)
     int res = niryo_robot_msgs::CommandStatus::CALIBRATION_NOT_DONE;
     result_message.clear();
 
+    std::lock_guard<std::mutex> lck(_calibration_mutex);
+
+    if (ECalibrationStep::IDLE != _step)
+    {
+        result_message = "Calibration Interface - Calibration already in process";
+    }
     // if ttl connection is ok AND (can not present OR can connection ok)
-    if ((_ttl_interface && _ttl_interface->isConnectionOk()) && (_stepper_bus_interface && _stepper_bus_interface->isConnectionOk()))
+    else if ((_ttl_interface && _ttl_interface->isConnectionOk()) && (_stepper_bus_interface && _stepper_bus_interface->isConnectionOk()))
     {
         if (AUTO_CALIBRATION == mode)  // auto
         {
-            if (EStepperCalibrationStatus::OK == autoCalibration())
-            {
-                result_message = "Calibration Interface - Calibration done";
-                res = niryo_robot_msgs::CommandStatus::SUCCESS;
-            }
-            else
-                result_message = "Calibration Interface - auto calibration failed";
+            // 0. Init velocity profile, then wait for the user to be warned before moving the robot
+            initVelocityProfiles();
+            _calibration_start_time = ros::Time::now();
+            setStep(ECalibrationStep::WARNING);
+
+            result_message = "Calibration Interface - Calibration started";
+            res = niryo_robot_msgs::CommandStatus::SUCCESS;
         }
         else if (MANUAL_CALIBRATION == mode)  // manuel
         {
             if (_hardware_version == "one")
             {
-                if (canProcessManualCalibration(result_message))
+                std::vector<int> motor_id_list;
+                std::vector<int> steps_list;
+
+                if (canProcessManualCalibration(result_message) && readCalibrationOffsetsFromFile(motor_id_list, steps_list))
                 {
-                    if (EStepperCalibrationStatus::OK == manualCalibration())
-                    {
-                        result_message = "Calibration Interface - Calibration done";
-                        res = niryo_robot_msgs::CommandStatus::SUCCESS;
-                    }
-                    else
-                    {
-                        res = niryo_robot_msgs::CommandStatus::FAILURE;
-                        result_message = "Calibration Interface - manual calibration failed";
-                    }
+                    sendManualCalibrationOffsets(motor_id_list, steps_list);
+                    _calibration_start_time = ros::Time::now();
+                    setStep(ECalibrationStep::MANUAL_OFFSETS);
+
+                    result_message = "Calibration Interface - Calibration started";
+                    res = niryo_robot_msgs::CommandStatus::SUCCESS;
                 }
             }
             else
@@ -243,15 +265,168 @@ int CalibrationManager::startCalibration(int mode, std::string &result_message)
     return res;
 }
 
+/**
+ * @brief CalibrationManager::cancelCalibration : stops a running calibration.
+ * The steppers are set back to "calibration needed"
+ * @return true if a calibration was running
+ */
+bool CalibrationManager::cancelCalibration()
+{
+    std::lock_guard<std::mutex> lck(_calibration_mutex);
+
+    if (ECalibrationStep::IDLE == _step)
+        return false;
+
+    ROS_WARN("CalibrationManager::cancelCalibration - Calibration cancelled during step %s", stepName(_step));
+
+    _stepper_bus_interface->resetCalibration();
+    resetVelocityProfiles();
+    finish(EStepperCalibrationStatus::FAIL);
+
+    return true;
+}
+
+/**
+ * @brief CalibrationManager::update : advances the calibration state machine, to be called at each
+ * cycle of the control loop. Never blocks. A calibration stuck in a step is cancelled with a timeout status
+ * @return true while a calibration is in progress
+ */
+bool CalibrationManager::update()
+{
+    std::lock_guard<std::mutex> lck(_calibration_mutex);
+
+    // a calibration lasting longer than the sum of the timeouts of its steps is stuck
+    double max_duration = _warning_duration + 2 * _move_timeout + HOMING_TIMEOUT + CALIBRATION_END_MARGIN;
+    if (ECalibrationStep::IDLE != _step && (ros::Time::now() - _calibration_start_time).toSec() > max_duration)
+    {
+        ROS_ERROR("CalibrationManager::update - Calibration stuck during step %s, cancelling it", stepName(_step));
+
+        _stepper_bus_interface->resetCalibration();
+        resetVelocityProfiles();
+        finish(EStepperCalibrationStatus::TIMEOUT);
+    }
+
+    switch (_step)
+    {
+        case ECalibrationStep::IDLE:
+            break;
+        case ECalibrationStep::WARNING:
+            // the light and sound of the calibration warn the user before the robot moves
+            if (isTtlQueueFree() && stepTimedOut(_warning_duration))
+            {
+                activateTorque(true);
+                setStep(ECalibrationStep::TORQUE_ON);
+            }
+            break;
+        case ECalibrationStep::TORQUE_ON:
+            if (isTtlQueueFree())
+            {
+                // 1. Place robot in position
+                moveRobotBeforeCalibration();
+                setStep(ECalibrationStep::MOVE_BEFORE_CALIBRATION);
+            }
+            break;
+        case ECalibrationStep::MOVE_BEFORE_CALIBRATION:
+        {
+            bool motion_done = isTtlQueueFree() && isMotionDone();
+            if (motion_done || stepTimedOut(_move_timeout))
+            {
+                ROS_WARN_COND(!motion_done, "CalibrationManager::update - joints did not reach their position before calibration");
+
+                if ("ned2" == _hardware_version && readHomingAbsPositionFromFile())
+                {
+                    writeHomingAbsPosition();
+                    setStep(ECalibrationStep::WRITE_HOMING_ABS_POSITION);
+                }
+                else
+                {
+                    // 2. Send calibration cmd 1 + 2 + 3 (from can or ttl depending of which interface is instanciated)
+                    sendCalibrationToSteppers();
+                    setStep(ECalibrationStep::SEND_CALIBRATION);
+                }
+            }
+            break;
+        }
+        case ECalibrationStep::WRITE_HOMING_ABS_POSITION:
+            if (isTtlQueueFree())
+            {
+                sendCalibrationToSteppers();
+                setStep(ECalibrationStep::SEND_CALIBRATION);
+            }
+            break;
+        case ECalibrationStep::SEND_CALIBRATION:
+            if (isTtlQueueFree() && (!_can_interface || _can_interface->isSingleQueueFree()))
+                setStep(ECalibrationStep::WAIT_HOMING);
+            break;
+        case ECalibrationStep::WAIT_HOMING:
+        {
+            // 3. wait for calibration status to change
+            EStepperCalibrationStatus status = _stepper_bus_interface->getCalibrationStatus();
+
+            if (EStepperCalibrationStatus::IN_PROGRESS != status)
+            {
+                onHomingDone(status);
+            }
+            else if (stepTimedOut(HOMING_TIMEOUT))
+            {
+                _stepper_bus_interface->resetCalibration();
+                ROS_ERROR("CalibrationManager::update - calibration timeout, please try again");
+                finish(EStepperCalibrationStatus::TIMEOUT);
+            }
+            break;
+        }
+        case ECalibrationStep::RESET_VELOCITY_PROFILES:
+            if (isTtlQueueFree())
+            {
+                // 7. Move steppers to home
+                moveSteppersToHome();
+                setStep(ECalibrationStep::MOVE_TO_HOME);
+            }
+            break;
+        case ECalibrationStep::MOVE_TO_HOME:
+        {
+            bool motion_done = isTtlQueueFree() && isMotionDone();
+            if (motion_done || stepTimedOut(_move_timeout))
+            {
+                ROS_WARN_COND(!motion_done, "CalibrationManager::update - steppers did not reach their home position");
+
+                // 8. Write homing_abs_position to file
+                if ("ned2" == _hardware_version)
+                {
+                    readHomingAbsPosition();
+                    ROS_DEBUG("CalibrationManager::update - readHomingAbsPosition");
+
+                    saveHomingAbsPositionToFile();
+                    ROS_DEBUG("CalibrationManager::update - saveHomingAbsPositionToFile");
+                }
+
+                finish(EStepperCalibrationStatus::OK);
+            }
+            break;
+        }
+        case ECalibrationStep::MANUAL_OFFSETS:
+            if (!_can_interface || _can_interface->isSingleQueueFree())
+            {
+                _stepper_bus_interface->setCalibrationStatus(EStepperCalibrationStatus::OK);
+                setStep(ECalibrationStep::IDLE);
+            }
+            break;
+    }
+
+    return ECalibrationStep::IDLE != _step;
+}
+
 /**
  * @brief CalibrationManager::getCalibrationStatus
- * @return
+ * @return IN_PROGRESS as long as the state machine runs, the status of the steppers otherwise
  */
 EStepperCalibrationStatus CalibrationManager::getCalibrationStatus() const
 {
     EStepperCalibrationStatus status{EStepperCalibrationStatus::FAIL};
 
-    if (_stepper_bus_interface)
+    if (isRunning())
+        status = EStepperCalibrationStatus::IN_PROGRESS;
+    else if (_stepper_bus_interface)
         status = _stepper_bus_interface->getCalibrationStatus();
 
     return status;
@@ -344,52 +519,99 @@ bool CalibrationManager::canProcessManualCalibration(std::string &result_message
     return res;
 }
 
+//**********************
+//  State machine
+//*********************
+
 /**
- * @brief CalibrationManager::autoCalibration
- * @return
+ * @brief CalibrationManager::setStep
+ * @param step
  */
-EStepperCalibrationStatus CalibrationManager::autoCalibration()
+void CalibrationManager::setStep(ECalibrationStep step)
 {
-    // 0. Init velocity profile
-    initVelocityProfiles();
-    ROS_DEBUG("CalibrationManager::autoCalibration - initVelocityProfiles");
+    ROS_DEBUG("CalibrationManager::setStep - %s -> %s", stepName(_step), stepName(step));
 
-    // 1. Place robot in position
-    moveRobotBeforeCalibration();
-    ROS_DEBUG("CalibrationManager::autoCalibration - moveRobotBeforeCalibration");
+    _step = step;
+    _step_start_time = ros::Time::now();
 
-    if ("ned2" == _hardware_version && readHomingAbsPositionFromFile())
-    {
-        writeHomingAbsPosition();
-        ROS_DEBUG("CalibrationManager::autoCalibration - writeHomingAbsPosition");
-    }
+    std_msgs::String msg;
+    msg.data = stepName(step);
+    _calibration_progress_publisher.publish(msg);
+}
+
+/**
+ * @brief CalibrationManager::stepTimedOut
+ * @param timeout
+ * @return true if the current step started more than timeout seconds ago
+ */
+bool CalibrationManager::stepTimedOut(double timeout) const
+{
+    return (ros::Time::now() - _step_start_time).toSec() >= timeout;
+}
+
+/**
+ * @brief CalibrationManager::isTtlQueueFree
+ * @return true if all the commands sent to the ttl bus have been processed
+ */
+bool CalibrationManager::isTtlQueueFree() const
+{
+    return _ttl_interface->isSingleQueueFree() && _ttl_interface->isSyncQueueFree();
+}
 
-    // 2. Send calibration cmd 1 + 2 + 3 (from can or ttl depending of which interface is instanciated)
-    sendCalibrationToSteppers();
-    ROS_DEBUG("CalibrationManager::autoCalibration - sendCalibrationToSteppers");
+/**
+ * @brief CalibrationManager::addMotionTarget
+ * @param state
+ * @param target : motor position the joint is expected to reach
+ */
+void CalibrationManager::addMotionTarget(const std::shared_ptr<JointState> &state, int target)
+{
+    MotionTarget motion;
+    motion.state = state;
+    motion.target = target;
+    motion.last_position = state->getPosition();
+    motion.last_sample_time = ros::Time::now();
 
-    double timeout = 0.0;
-    // 3. wait for calibration status to change
+    _motion_targets.emplace_back(motion);
+}
 
-    // get calibration result final
-    EStepperCalibrationStatus final_status = EStepperCalibrationStatus::IN_PROGRESS;
+/**
+ * @brief CalibrationManager::isMotionDone
+ * @return true if all the joints of the current motion are at their target and stopped
+ *
+ * The velocity of each joint is estimated from the positions read by the bus control loops,
+ * sampled every VELOCITY_SAMPLE_PERIOD
+ */
+bool CalibrationManager::isMotionDone()
+{
+    ros::Time now = ros::Time::now();
+    bool done = true;
 
-    while (EStepperCalibrationStatus::IN_PROGRESS == final_status)
+    for (auto &motion : _motion_targets)
     {
-        ros::Duration(0.2).sleep();
-        timeout += 0.2;
-        if (timeout >= 30.0)
+        int position = motion.state->getPosition();
+
+        double dt = (now - motion.last_sample_time).toSec();
+        if (dt >= VELOCITY_SAMPLE_PERIOD)
         {
-            _stepper_bus_interface->resetCalibration();
-            ROS_ERROR("CalibrationManager::autoCalibration - calibration timeout, please try again");
-            return common::model::EStepperCalibrationStatus::TIMEOUT;
+            double velocity = std::fabs(motion.state->to_rad_pos(position) - motion.state->to_rad_pos(motion.last_position)) / dt;
+            motion.stopped = (velocity <= _velocity_tolerance);
+            motion.last_position = position;
+            motion.last_sample_time = now;
         }
-        final_status = getCalibrationStatus();
-        ROS_DEBUG("CalibrationManager::autoCalibration - calibration status, %s", common::model::StepperCalibrationStatusEnum(final_status).toString().c_str());
+
+        double error = std::fabs(motion.state->to_rad_pos(position) - motion.state->to_rad_pos(motion.target));
+        done = done && motion.stopped && (error <= _position_tolerance);
     }
 
-    ros::Duration(0.5).sleep();
+    return done;
+}
 
+/**
+ * @brief CalibrationManager::onHomingDone : retrieves the calibration results and moves the steppers to home
+ * @param status
+ */
+void CalibrationManager::onHomingDone(EStepperCalibrationStatus status)
+{
     // 4. retrieve values for the calibration
     std::vector<int> sensor_offset_results;
     std::vector<int> sensor_offset_ids;
@@ -399,125 +621,81 @@ EStepperCalibrationStatus CalibrationManager::autoCalibration()
         if (jState && jState->isStepper())
         {
             uint8_t motor_id = jState->getId();
+            int calibration_result = _stepper_bus_interface->getCalibrationResult(motor_id);
 
-            if (_stepper_bus_interface)
-            {
-                int calibration_result = _stepper_bus_interface->getCalibrationResult(motor_id);
-
-                sensor_offset_results.emplace_back(calibration_result);
-                sensor_offset_ids.emplace_back(motor_id);
+            sensor_offset_results.emplace_back(calibration_result);
+            sensor_offset_ids.emplace_back(motor_id);
 
-                ROS_INFO("CalibrationManager::autoCalibration - Motor %d, calibration cmd result %d ", motor_id, calibration_result);
-            }
+            ROS_INFO("CalibrationManager::onHomingDone - Motor %d, calibration cmd result %d ", motor_id, calibration_result);
         }
     }
 
-    if (EStepperCalibrationStatus::OK == final_status)
+    if (EStepperCalibrationStatus::OK == status)
     {
-        ROS_INFO("CalibrationManager::autoCalibration -  Calibration successfull, going back home");
+        ROS_INFO("CalibrationManager::onHomingDone -  Calibration successfull, going back home");
 
         // 5. put back velocity profiles to normal
         resetVelocityProfiles();
-        ROS_DEBUG("CalibrationManager::autoCalibration - resetVelocityProfiles");
-
-        // 6. Move steppers to home
-        moveSteppersToHome();
-        ROS_DEBUG("CalibrationManager::autoCalibration - moveSteppersToHome");
 
-        ros::Duration(("ned2" == _hardware_version) ? 3.5 : 4).sleep();
-
-        // 7. Write sensor_offset_steps to file
+        // 6. Write sensor_offset_steps to file
         saveCalibrationOffsetsToFile(sensor_offset_ids, sensor_offset_results);
 
-        // 8. Write homing_abs_position to file
-        if ("ned2" == _hardware_version)
-        {
-            std::vector<uint8_t> homing_abs_position_ids;
-            std::vector<int32_t> homing_abs_position_results;
-
-            readHomingAbsPosition();
-            ROS_DEBUG("CalibrationManager::autoCalibration - readHomingAbsPosition");
-
-            saveHomingAbsPositionToFile();
-            ROS_DEBUG("CalibrationManager::autoCalibration - saveHomingAbsPositionToFile");
-        }
+        setStep(ECalibrationStep::RESET_VELOCITY_PROFILES);
     }
     else
     {
-        ROS_ERROR("CalibrationManager::autoCalibration -  An error occurred while calibrating stepper motors");
+        ROS_ERROR("CalibrationManager::onHomingDone -  An error occurred while calibrating stepper motors");
+        finish(status);
     }
+}
 
-    // 8 - activate torque for ned2, disactivate for ned1
+/**
+ * @brief CalibrationManager::finish : ends the calibration
+ * @param status
+ */
+void CalibrationManager::finish(EStepperCalibrationStatus status)
+{
+    // activate torque for ned2, disactivate for ned1
     activateTorque("ned2" == _hardware_version);
 
-    return final_status;
+    _motion_targets.clear();
+    setStep(ECalibrationStep::IDLE);
+
+    ROS_INFO("CalibrationManager::finish - Calibration ended with status %s", common::model::StepperCalibrationStatusEnum(status).toString());
 }
 
 /**
- * @brief CalibrationManager::manualCalibration
- * @return
- *
- * only for niryo one
+ * @brief CalibrationManager::stepName
+ * @param step
+ * @return name of the step, as published on the progress topic
  */
-EStepperCalibrationStatus CalibrationManager::manualCalibration()
+const char *CalibrationManager::stepName(ECalibrationStep step)
 {
-    EStepperCalibrationStatus status = EStepperCalibrationStatus::FAIL;
-
-    if (_stepper_bus_interface)
+    switch (step)
     {
-        std::vector<int> motor_id_list;
-        std::vector<int> steps_list;
-
-        if (readCalibrationOffsetsFromFile(motor_id_list, steps_list))
-        {
-            // 0. Torque ON for motor 2
-            auto state = std::dynamic_pointer_cast<common::model::StepperMotorState>(_joint_states_list.at(1));
-            if (state)
-            {
-                int steps_per_rev = state->stepsPerRev();
-
-                for (size_t i = 0; i < motor_id_list.size(); i++)
-                {
-                    int offset_to_send = 0;
-                    int motor_id = motor_id_list.at(i);
-                    int sensor_offset_steps = steps_list.at(i);
-
-                    if (motor_id == _joint_states_list.at(0)->getId())
-                    {
-                        offset_to_send = sensor_offset_steps - _joint_states_list.at(0)->to_motor_pos(_joint_states_list.at(0)->getLimitPositionMax()) % steps_per_rev;
-                        if (offset_to_send < 0)
-                            offset_to_send += steps_per_rev;
-
-                        StepperSingleCmd stepper_cmd(EStepperCommandType::CMD_TYPE_POSITION_OFFSET, _joint_states_list.at(0)->getId(), {offset_to_send, offset_to_send});
-                        _stepper_bus_interface->addSingleCommandToQueue(std::make_unique<StepperSingleCmd>(stepper_cmd));
-                    }
-                    else if (motor_id == _joint_states_list.at(1)->getId())
-                    {
-                        offset_to_send = sensor_offset_steps - _joint_states_list.at(1)->to_motor_pos(_joint_states_list.at(1)->getLimitPositionMax()) % steps_per_rev;
-                        // offset_to_send %= steps_per_rev;
-                        if (offset_to_send < 0)
-                            offset_to_send += steps_per_rev;
-
-                        StepperSingleCmd stepper_cmd(EStepperCommandType::CMD_TYPE_POSITION_OFFSET, _joint_states_list.at(1)->getId(), {offset_to_send, offset_to_send});
-                        _stepper_bus_interface->addSingleCommandToQueue(std::make_unique<StepperSingleCmd>(stepper_cmd));
-                    }
-                    else if (motor_id == _joint_states_list.at(2)->getId())
-                    {
-                        offset_to_send = sensor_offset_steps - _joint_states_list.at(2)->to_motor_pos(_joint_states_list.at(2)->getLimitPositionMin());
-
-                        StepperSingleCmd stepper_cmd(EStepperCommandType::CMD_TYPE_POSITION_OFFSET, _joint_states_list.at(2)->getId(), {offset_to_send, sensor_offset_steps});
-                        _stepper_bus_interface->addSingleCommandToQueue(std::make_unique<StepperSingleCmd>(stepper_cmd));
-                    }
-                }
-
-                ros::Duration(1.0).sleep();
-                status = EStepperCalibrationStatus::OK;
-                _stepper_bus_interface->setCalibrationStatus(EStepperCalibrationStatus::OK);
-            }
-        }  // if (state)
-    }      // if (getMotorsCalibrationOffsets(motor_id_list, steps_list))
+        case ECalibrationStep::IDLE:
+            return "idle";
+        case ECalibrationStep::WARNING:
+            return "warning";
+        case ECalibrationStep::TORQUE_ON:
+            return "torque_on";
+        case ECalibrationStep::MOVE_BEFORE_CALIBRATION:
+            return "move_before_calibration";
+        case ECalibrationStep::WRITE_HOMING_ABS_POSITION:
+            return "write_homing_abs_position";
+        case ECalibrationStep::SEND_CALIBRATION:
+            return "send_calibration";
+        case ECalibrationStep::WAIT_HOMING:
+            return "wait_homing";
+        case ECalibrationStep::RESET_VELOCITY_PROFILES:
+            return "reset_velocity_profiles";
+        case ECalibrationStep::MOVE_TO_HOME:
+            return "move_to_home";
+        case ECalibrationStep::MANUAL_OFFSETS:
+            return "manual_offsets";
+    }
 
-    return status;
+    return "unknown";
 }
 
 //**********************
@@ -553,8 +731,6 @@ void CalibrationManager::setTorqueStepperMotor(const std::shared_ptr<JointState>
  */
 void CalibrationManager::initVelocityProfiles()
 {
-    _ttl_interface->waitSyncQueueFree();
-
     if ("ned2" == _hardware_version)
     {
         for (auto param : _calibration_params_map)
@@ -564,8 +740,6 @@ void CalibrationManager::initVelocityProfiles()
             _ttl_interface->addSingleCommandToQueue(std::make_unique<StepperTtlSingleCmd>(cmd_profile));
         }
     }
-
-    _ttl_interface->waitSingleQueueFree();
 }
 
 /**
@@ -573,8 +747,6 @@ void CalibrationManager::initVelocityProfiles()
  */
 void CalibrationManager::resetVelocityProfiles()
 {
-    _ttl_interface->waitSyncQueueFree();
-
     if ("ned2" == _hardware_version)
     {
         for (auto const &jState : _joint_states_list)
@@ -590,20 +762,16 @@ void CalibrationManager::resetVelocityProfiles()
                 }
             }
         }
-
-        _ttl_interface->waitSingleQueueFree();
     }
 }
 
 /**
  * @brief CalibrationManager::moveRobotBeforeCalibration
+ * torque must have been activated for all motors
  */
 void CalibrationManager::moveRobotBeforeCalibration()
 {
-    // 0. activate torque for all motors
-    activateTorque(true);
-
-    _ttl_interface->waitSyncQueueFree();
+    _motion_targets.clear();
 
     // 1. Relative Move Motor 2 (can only)
     if (_can_interface && _joint_states_list.at(1)->isStepper() && common::model::EBusProtocol::CAN == _joint_states_list.at(1)->getBusProtocol())
@@ -613,6 +781,7 @@ void CalibrationManager::moveRobotBeforeCalibration()
         int delay = 1000;
 
         _can_interface->addSingleCommandToQueue(std::make_unique<StepperSingleCmd>(StepperSingleCmd(EStepperCommandType::CMD_TYPE_RELATIVE_MOVE, motor_id, {steps, delay})));
+        addMotionTarget(_joint_states_list.at(1), _joint_states_list.at(1)->getPosition() + steps);
     }
 
     // 2. Relative Move Motor 3
@@ -626,17 +795,17 @@ void CalibrationManager::moveRobotBeforeCalibration()
             int delay = 1000;
 
             _can_interface->addSingleCommandToQueue(std::make_unique<StepperSingleCmd>(StepperSingleCmd(EStepperCommandType::CMD_TYPE_RELATIVE_MOVE, motor_id, {steps, delay})));
+            addMotionTarget(_joint_states_list.at(2), _joint_states_list.at(2)->getPosition() + steps);
         }
         else if (EBusProtocol::TTL == _joint_states_list.at(2)->getBusProtocol())
         {
             auto steps = static_cast<uint32_t>(_joint_states_list.at(2)->getPosition() + 10 * _joint_states_list.at(2)->getDirection());
 
             _ttl_interface->addSingleCommandToQueue(std::make_unique<StepperTtlSingleCmd>(StepperTtlSingleCmd(EStepperCommandType::CMD_TYPE_POSITION, motor_id, {steps})));
+            addMotionTarget(_joint_states_list.at(2), static_cast<int>(steps));
         }
     }
 
-    _ttl_interface->waitSingleQueueFree();
-
     // 3. Move All Dynamixel to Home Position
     if (_ttl_interface)
     {
@@ -647,15 +816,14 @@ void CalibrationManager::moveRobotBeforeCalibration()
         {
             if (jState && jState->isDynamixel())
             {
-                dynamixel_cmd.addMotorParam(jState->getHardwareType(), jState->getId(), static_cast<uint32_t>(jState->to_motor_pos(jState->getHomePosition())));
+                int home = jState->to_motor_pos(jState->getHomePosition());
+                dynamixel_cmd.addMotorParam(jState->getHardwareType(), jState->getId(), static_cast<uint32_t>(home));
+                addMotionTarget(jState, home);
             }
         }
 
         _ttl_interface->addSyncCommandToQueue(std::make_unique<DxlSyncCmd>(dynamixel_cmd));
     }
-
-    // Wait a little bit for all dxl go to home before calibration
-    _ttl_interface->waitSyncQueueFree();
 }
 
 /**
@@ -667,6 +835,8 @@ void CalibrationManager::moveSteppersToHome()
     // 2. move all steppers to Home Position
     StepperTtlSyncCmd stepper_ttl_cmd(EStepperCommandType::CMD_TYPE_POSITION);
 
+    _motion_targets.clear();
+
     for (auto const &jState : _joint_states_list)
     {
         if (jState && jState->isStepper())
@@ -697,6 +867,9 @@ void CalibrationManager::moveSteppersToHome()
                 steps = jState->to_motor_pos(jState->getHomePosition());
                 stepper_ttl_cmd.addMotorParam(jState->getHardwareType(), motor_id, static_cast<uint32_t>(steps));
             }
+
+            // relative moves of CAN steppers also end at home, the position being reset by the calibration
+            addMotionTarget(jState, jState->to_motor_pos(jState->getHomePosition()));
         }
     }
 
@@ -757,8 +930,55 @@ void CalibrationManager::sendCalibrationToSteppers()
             }
         }
     }
+}
+
+/**
+ * @brief CalibrationManager::sendManualCalibrationOffsets
+ * @param motor_id_list
+ * @param steps_list
+ *
+ * only for niryo one
+ */
+void CalibrationManager::sendManualCalibrationOffsets(const std::vector<int> &motor_id_list, const std::vector<int> &steps_list)
+{
+    auto state = std::dynamic_pointer_cast<common::model::StepperMotorState>(_joint_states_list.at(1));
+    if (state)
+    {
+        int steps_per_rev = state->stepsPerRev();
+
+        for (size_t i = 0; i < motor_id_list.size() && i < steps_list.size(); i++)
+        {
+            int offset_to_send = 0;
+            int motor_id = motor_id_list.at(i);
+            int sensor_offset_steps = steps_list.at(i);
+
+            if (motor_id == _joint_states_list.at(0)->getId())
+            {
+                offset_to_send = sensor_offset_steps - _joint_states_list.at(0)->to_motor_pos(_joint_states_list.at(0)->getLimitPositionMax()) % steps_per_rev;
+                if (offset_to_send < 0)
+                    offset_to_send += steps_per_rev;
+
+                StepperSingleCmd stepper_cmd(EStepperCommandType::CMD_TYPE_POSITION_OFFSET, _joint_states_list.at(0)->getId(), {offset_to_send, offset_to_send});
+                _stepper_bus_interface->addSingleCommandToQueue(std::make_unique<StepperSingleCmd>(stepper_cmd));
+            }
+            else if (motor_id == _joint_states_list.at(1)->getId())
+            {
+                offset_to_send = sensor_offset_steps - _joint_states_list.at(1)->to_motor_pos(_joint_states_list.at(1)->getLimitPositionMax()) % steps_per_rev;
+                if (offset_to_send < 0)
+                    offset_to_send += steps_per_rev;
 
-    _ttl_interface->waitSingleQueueFree();
+                StepperSingleCmd stepper_cmd(EStepperCommandType::CMD_TYPE_POSITION_OFFSET, _joint_states_list.at(1)->getId(), {offset_to_send, offset_to_send});
+                _stepper_bus_interface->addSingleCommandToQueue(std::make_unique<StepperSingleCmd>(stepper_cmd));
+            }
+            else if (motor_id == _joint_states_list.at(2)->getId())
+            {
+                offset_to_send = sensor_offset_steps - _joint_states_list.at(2)->to_motor_pos(_joint_states_list.at(2)->getLimitPositionMin());
+
+                StepperSingleCmd stepper_cmd(EStepperCommandType::CMD_TYPE_POSITION_OFFSET, _joint_states_list.at(2)->getId(), {offset_to_send, sensor_offset_steps});
+                _stepper_bus_interface->addSingleCommandToQueue(std::make_unique<StepperSingleCmd>(stepper_cmd));
+            }
+        }
+    }
 }
 
 /**
@@ -767,8 +987,6 @@ void CalibrationManager::sendCalibrationToSteppers()
  */
 void CalibrationManager::activateTorque(bool activated)
 {
-    _ttl_interface->waitSingleQueueFree();
-
     ROS_DEBUG("CalibrationManager::activateTorque - activate learning mode");
 
     DxlSyncCmd dxl_cmd(EDxlCommandType::CMD_TYPE_TORQUE);
@@ -816,8 +1034,6 @@ bool CalibrationManager::writeHomingAbsPosition()
 {
     if (_ttl_interface)
     {
-        _ttl_interface->waitSingleQueueFree();
-
         // CMD_TYPE_READ_HOMING_ABS_POSITION cmd
         StepperSyncCmd stepper_cmd(EStepperCommandType::CMD_TYPE_WRITE_HOMING_ABS_POSITION);
 
@@ -832,9 +1048,6 @@ bool CalibrationManager::writeHomingAbsPosition()
         }
 
         _ttl_interface->addSyncCommandToQueue(std::make_unique<StepperSyncCmd>(stepper_cmd));
-
-        // Wait for all stepper commands are executed
-        _ttl_interface->waitSyncQueueFree();
         return true;
     }
     return false;
@@ -847,7 +1060,6 @@ bool CalibrationManager::writeHomingAbsPosition()
  */
 bool CalibrationManager::readHomingAbsPosition()
 {
-    _ttl_interface->waitSyncQueueFree();
     return _ttl_interface->readHomingAbsPosition();
 }
 
@@ -856,232 +1068,212 @@ bool CalibrationManager::readHomingAbsPosition()
 //********************
 
 /**
- * @brief CalibrationManager::saveCalibrationOffsetsToFile
- * @param motor_id_list
- * @param steps_list
+ * @brief CalibrationManager::loadCalibrationRecord : reads the calibration record once at startup.
+ * If there is no valid record, the calibration is migrated from the legacy text files if they exist
+ */
+void CalibrationManager::loadCalibrationRecord()
+{
+    if (_calibration_record.load(_calibration_record_file_name))
+    {
+        ROS_INFO("CalibrationManager::loadCalibrationRecord - Calibration record loaded (%lu motors)", _calibration_record.getEntries().size());
+        return;
+    }
+
+    _calibration_record.clear();
+
+    ROS_WARN("CalibrationManager::loadCalibrationRecord - No valid calibration record in %s, looking for legacy calibration files",
+             _calibration_record_file_name.c_str());
+
+    bool migrated = readLegacyFile(_calibration_file_name, [this](uint8_t id, int32_t value) { _calibration_record.setSensorOffset(id, value); });
+    migrated = readLegacyFile(_homing_offset_file_name, [this](uint8_t id, int32_t value) { _calibration_record.setHomingAbsPosition(id, value); }) || migrated;
+
+    if (migrated && saveCalibrationRecord())
+        ROS_INFO("CalibrationManager::loadCalibrationRecord - Legacy calibration files migrated to %s", _calibration_record_file_name.c_str());
+}
+
+/**
+ * @brief CalibrationManager::expandHomePath
+ * @param path
+ * @return the path with a leading "~" replaced by $HOME
+ */
+std::string CalibrationManager::expandHomePath(const std::string &path)
+{
+    if (path.empty() || '~' != path.front() || (path.size() > 1 && '/' != path[1]))
+        return path;
+
+    const char *home = std::getenv("HOME");
+    if (!home)
+    {
+        ROS_WARN("CalibrationManager::expandHomePath - HOME not set, unable to expand %s", path.c_str());
+        return path;
+    }
+
+    return std::string(home) + path.substr(1);
+}
+
+/**
+ * @brief CalibrationManager::saveCalibrationRecord : atomic write of the calibration record
  * @return
  */
-bool CalibrationManager::saveCalibrationOffsetsToFile(const std::vector<int> &motor_id_list, const std::vector<int> &steps_list)
+bool CalibrationManager::saveCalibrationRecord()
 {
-    bool res = false;
-    if (motor_id_list.size() == steps_list.size())
+    size_t found = _calibration_record_file_name.find_last_of('/');
+    std::string folder_name = _calibration_record_file_name.substr(0, found);
+
+    // Create dir if not exist
+    boost::system::error_code returned_error;
+    boost::filesystem::create_directories(boost::filesystem::path(folder_name), returned_error);
+
+    if (returned_error)
     {
-        size_t found = _calibration_file_name.find_last_of('/');
-        std::string folder_name = _calibration_file_name.substr(0, found);
+        ROS_WARN("CalibrationManager::saveCalibrationRecord - Could not create directory : %s", folder_name.c_str());
+        return false;
+    }
 
-        boost::filesystem::path filepath(_calibration_file_name);
-        boost::filesystem::path directory(folder_name);
+    _calibration_record.setTimestamp(static_cast<uint64_t>(ros::Time::now().toSec() * 1000.0));
 
-        // Create dir if not exist
-        boost::system::error_code returned_error;
-        boost::filesystem::create_directories(directory, returned_error);
+    if (!_calibration_record.save(_calibration_record_file_name))
+    {
+        ROS_WARN("CalibrationManager::saveCalibrationRecord - Unable to write file : %s", _calibration_record_file_name.c_str());
+        return false;
+    }
 
-        if (!returned_error)
-        {
-            // Create text to write
-            std::string text_to_write;
-            for (size_t i = 0; i < motor_id_list.size(); i++)
-            {
-                text_to_write += std::to_string(motor_id_list.at(i));
-                text_to_write += ":";
-                text_to_write += std::to_string(steps_list.at(i));
-                if (i < motor_id_list.size() - 1)
-                {
-                    text_to_write += "\n";
-                }
-            }
+    return true;
+}
 
-            // Write to file
-            std::ofstream offset_file(_calibration_file_name.c_str());
-            if (offset_file.is_open())
-            {
-                ROS_DEBUG("CalibrationManager::set_motors_calibration_offsets - Writing calibration offsets to file : \n%s", text_to_write.c_str());
+/**
+ * @brief CalibrationManager::readLegacyFile : parses a legacy "id:value" text calibration file
+ * @param file_name
+ * @param setter called for each valid line
+ * @return true if the file has been read
+ */
+bool CalibrationManager::readLegacyFile(const std::string &file_name, const std::function<void(uint8_t, int32_t)> &setter)
+{
+    if (file_name.empty())
+        return false;
 
-                offset_file << text_to_write.c_str();
-                offset_file.close();
+    std::ifstream legacy_file(file_name.c_str());
+    if (!legacy_file.is_open())
+        return false;
 
-                res = true;
-            }
-            else
-            {
-                ROS_WARN("CalibrationManager::set_motors_calibration_offsets - Unable to open file : %s", _calibration_file_name.c_str());
-            }
+    std::string current_line;
+    while (getline(legacy_file, current_line))
+    {
+        try
+        {
+            size_t index = current_line.find(':');
+            setter(static_cast<uint8_t>(stoi(current_line.substr(0, index))), stoi(current_line.erase(0, index + 1)));
         }
-        else
+        catch (...)
         {
-            ROS_WARN("CalibrationManager::set_motors_calibration_offsets - Could not create directory : %s", folder_name.c_str());
+            ROS_ERROR("CalibrationManager::readLegacyFile - Exception caught during file reading of %s", file_name.c_str());
         }
     }
-    else
+
+    return true;
+}
+
+/**
+ * @brief CalibrationManager::saveCalibrationOffsetsToFile
+ * @param motor_id_list
+ * @param steps_list
+ * @return
+ */
+bool CalibrationManager::saveCalibrationOffsetsToFile(const std::vector<int> &motor_id_list, const std::vector<int> &steps_list)
+{
+    if (motor_id_list.size() != steps_list.size())
     {
-        ROS_ERROR("CalibrationManager::set_motors_calibration_offsets - Corrupted command"
+        ROS_ERROR("CalibrationManager::saveCalibrationOffsetsToFile - Corrupted command"
                   ": motors id list and params list size mismatch");
+        return false;
     }
 
-    return res;
+    for (size_t i = 0; i < motor_id_list.size(); i++)
+        _calibration_record.setSensorOffset(static_cast<uint8_t>(motor_id_list.at(i)), steps_list.at(i));
+
+    return saveCalibrationRecord();
 }
 
 /**
- * @brief CalibrationManager::readCalibrationOffsetsFromFile
+ * @brief CalibrationManager::readCalibrationOffsetsFromFile : gives the sensor offsets of the calibration record loaded at startup
  * @param motor_id_list
  * @param steps_list
- * @return
+ * @return false if no sensor offset is recorded
  */
 bool CalibrationManager::readCalibrationOffsetsFromFile(std::vector<int> &motor_id_list, std::vector<int> &steps_list)
 {
-    bool res = false;
-
-    std::vector<std::string> lines;
-    std::string current_line;
-
     motor_id_list.clear();
     steps_list.clear();
 
-    std::ifstream offset_file(_calibration_file_name.c_str());
-
-    if (offset_file.is_open())
+    for (auto const &entry : _calibration_record.getEntries())
     {
-        // read all lines
-        while (getline(offset_file, current_line))
+        if (entry.flags & common::util::CalibrationRecord::HAS_SENSOR_OFFSET)
         {
-            try
-            {
-                size_t index = current_line.find(':');
-                motor_id_list.emplace_back(stoi(current_line.substr(0, index)));
-                steps_list.emplace_back(stoi(current_line.erase(0, index + 1)));
-            }
-            catch (...)
-            {
-                ROS_ERROR("CalibrationManager::getMotorsCalibrationOffsets - Exception caught during file reading");
-            }
+            motor_id_list.emplace_back(entry.id);
+            steps_list.emplace_back(entry.sensor_offset);
         }
-
-        offset_file.close();
-        res = true;
     }
-    else
+
+    if (motor_id_list.empty())
     {
-        ROS_WARN("Motor Offset - Unable to open file : %s", _calibration_file_name.c_str());
+        ROS_WARN("CalibrationManager::readCalibrationOffsetsFromFile - No calibration offsets recorded in %s", _calibration_record_file_name.c_str());
+        return false;
     }
 
-    return res;
+    return true;
 }
 
 /**
  * @brief CalibrationManager::saveHomingAbsPositionToFile
- * @param abs_position
  * @return
  */
 bool CalibrationManager::saveHomingAbsPositionToFile()
 {
-    bool res = false;
-
-    size_t found = _homing_offset_file_name.find_last_of('/');
-    std::string folder_name = _homing_offset_file_name.substr(0, found);
-
-    boost::filesystem::path filepath(_homing_offset_file_name);
-    boost::filesystem::path directory(folder_name);
-
-    // Create dir if not exist
-    boost::system::error_code returned_error;
-    boost::filesystem::create_directories(directory, returned_error);
-
-    if (!returned_error)
+    for (const auto &jState : _joint_states_list)
     {
-        // Create text to write
-        std::string text_to_write;
-        for (const auto &jState : _joint_states_list)
-        {
-            if (jState && jState->isStepper())
-            {
-                auto state = std::dynamic_pointer_cast<common::model::StepperMotorState>(jState);
-                text_to_write += std::to_string(state->getId());
-                text_to_write += ":";
-                text_to_write += std::to_string(state->getHomingAbsPosition());
-                text_to_write += "\n";
-            }
-        }
-        text_to_write.pop_back();
-
-        // Write to file
-        std::ofstream offset_file(_homing_offset_file_name.c_str());
-        if (offset_file.is_open())
-        {
-            ROS_DEBUG("CalibrationManager::saveHomingAbsPositionToFile - Writing homing offset to file : \n%s", text_to_write.c_str());
-
-            offset_file << text_to_write.c_str();
-            offset_file.close();
-
-            res = true;
-        }
-        else
+        if (jState && jState->isStepper())
         {
-            ROS_WARN("CalibrationManager::saveHomingAbsPositionToFile - Unable to open file : %s", _calibration_file_name.c_str());
+            auto state = std::dynamic_pointer_cast<common::model::StepperMotorState>(jState);
+            _calibration_record.setHomingAbsPosition(state->getId(), state->getHomingAbsPosition());
         }
     }
-    else
-    {
-        ROS_WARN("CalibrationManager::saveHomingAbsPosition - Could not create directory : %s", folder_name.c_str());
-    }
 
-    return res;
+    return saveCalibrationRecord();
 }
 
 /**
- * @brief CalibrationManager::readHomingAbsPosition
- * @param abs_position
- * @return
+ * @brief CalibrationManager::readHomingAbsPositionFromFile : applies the homing abs positions of the calibration record to the steppers states
+ * @return false if a stepper has no homing abs position recorded
  */
 bool CalibrationManager::readHomingAbsPositionFromFile()
 {
-    bool res = false;
-
-    std::string current_line;
-
     std::map<uint8_t, int32_t> id_homing_map;
 
-    std::ifstream offset_file(_homing_offset_file_name.c_str());
-
-    if (offset_file.is_open())
+    for (auto const &jState : _joint_states_list)
     {
-        // read all lines
-        while (getline(offset_file, current_line))
+        if (jState && jState->isStepper())
         {
-            try
-            {
-                size_t index = current_line.find(':');
-                uint8_t id = stoi(current_line.substr(0, index));
-                int32_t homing_pos = stoi(current_line.erase(0, index + 1));
-                id_homing_map[id] = homing_pos;
-                ROS_DEBUG("read SD card values: id: %d, homing: %d", id, homing_pos);
-            }
-            catch (...)
+            int32_t homing_pos = 0;
+            if (!_calibration_record.getHomingAbsPosition(jState->getId(), homing_pos))
             {
-                ROS_ERROR("CalibrationManager::readHomingAbsPosition - Exception caught during file reading");
+                ROS_WARN("CalibrationManager::readHomingAbsPositionFromFile - No homing absolute position recorded for motor %d", jState->getId());
+                return false;
             }
+            id_homing_map[jState->getId()] = homing_pos;
         }
+    }
 
-        if (id_homing_map.size() == _calibration_params_map.size())
+    for (auto const &jState : _joint_states_list)
+    {
+        if (jState && jState->isStepper())
         {
-            for (auto const &jState : _joint_states_list)
-            {
-                if (jState && jState->isStepper())
-                {
-                    auto state = std::dynamic_pointer_cast<common::model::StepperMotorState>(jState);
-                    state->setHomingAbsPosition(id_homing_map[state->getId()]);
-                    ROS_DEBUG("CalibrationManager::readHomingAbsPositionFromFile - id: %d, homing_pos: %u", state->getId(), state->getHomingAbsPosition());
-                }
-            }
-            res = true;
+            auto state = std::dynamic_pointer_cast<common::model::StepperMotorState>(jState);
+            state->setHomingAbsPosition(id_homing_map[state->getId()]);
+            ROS_DEBUG("CalibrationManager::readHomingAbsPositionFromFile - id: %d, homing_pos: %u", state->getId(), state->getHomingAbsPosition());
         }
-
-        offset_file.close();
     }
-    else
-    {
-        ROS_WARN("Homing absolute position - Unable to open file : %s", _homing_offset_file_name.c_str());
-    }
-    return res;
+
+    return true;
 }
 
 }  // namespace joints_interface
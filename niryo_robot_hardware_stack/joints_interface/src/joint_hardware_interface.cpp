@@ -20,6 +20,8 @@
 #include "joints_interface/joint_hardware_interface.hpp"
 
 // c++
+#include <algorithm>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <typeinfo>
@@ -32,6 +34,7 @@
 #include "common/model/hardware_type_enum.hpp"
 #include "common/model/single_motor_cmd.hpp"
 #include "common/model/synchronize_motor_cmd.hpp"
+#include "common/util/log_defs.hpp"
 #include "common/util/util_defs.hpp"
 
 using ::std::dynamic_pointer_cast;
@@ -57,6 +60,12 @@ using ::common::model::StepperTtlSyncCmd;
 namespace joints_interface
 {
 
+namespace
+{
+// a joint position older than this does not describe the current state of the robot
+constexpr std::chrono::milliseconds MAX_SAMPLE_AGE{500};
+}  // namespace
+
 /**
  * @brief JointHardwareInterface::JointHardwareInterface
  * @param rootnh
@@ -104,6 +113,9 @@ bool JointHardwareInterface::init(ros::NodeHandle & /*rootnh*/, ros::NodeHandle
     int currentIdStepper = 1;
     int currentIdDxl = 1;
 
+    // ttl joints are added and initialized together once all of them are known
+    std::vector<std::shared_ptr<common::model::JointState>> ttl_joint_list;
+
     for (size_t j = 0; j < nb_joints; j++)
     {
         int joint_id_config = 0;
@@ -131,44 +143,49 @@ bool JointHardwareInterface::init(ros::NodeHandle & /*rootnh*/, ros::NodeHandle
                 _joint_state_list.emplace_back(stepperState);
                 _map_stepper_name[stepperState->getId()] = stepperState->getName();
 
-                int result = niryo_robot_msgs::CommandStatus::TTL_READ_ERROR;
-
-                // Try 3 times
-                for (int tries = 0; tries < 3; tries++)
+                if (EBusProtocol::TTL == eBusProto)
                 {
-                    if (EBusProtocol::CAN == eBusProto)
-                        result = _can_interface->addJoint(stepperState);
-                    else if (EBusProtocol::TTL == eBusProto)
-                        result = _ttl_interface->addJoint(stepperState);
+                    ttl_joint_list.emplace_back(stepperState);
+                }
+                else
+                {
+                    int result = niryo_robot_msgs::CommandStatus::TTL_READ_ERROR;
 
-                    // on success, we initialize the joint and go out of loop
-                    if (niryo_robot_msgs::CommandStatus::SUCCESS == result)
+                    // Try 3 times
+                    for (int tries = 0; tries < 3; tries++)
                     {
-                        result = initHardware(stepperState, torque_status);
+                        if (EBusProtocol::CAN == eBusProto)
+                            result = _can_interface->addJoint(stepperState);
+
+                        // on success, we initialize the joint and go out of loop
                         if (niryo_robot_msgs::CommandStatus::SUCCESS == result)
                         {
-                            ROS_INFO("JointHardwareInterface::init - add stepper joint success");
-                            break;
+                            result = initHardware(stepperState, torque_status);
+                            if (niryo_robot_msgs::CommandStatus::SUCCESS == result)
+                            {
+                                ROS_INFO("JointHardwareInterface::init - add stepper joint success");
+                                break;
+                            }
+
+                            ROS_WARN("JointHardwareInterface::init - "
+                                     "initialize stepper joint failure, return : %d. Retrying (%d)...",
+                                     result, tries);
+                        }
+                        else
+                        {
+                            ROS_WARN("JointHardwareInterface::init - "
+                                     "add stepper joint failure, return : %d. Retrying (%d)...",
+                                     result, tries);
                         }
-
-                        ROS_WARN("JointHardwareInterface::init - "
-                                 "initialize stepper joint failure, return : %d. Retrying (%d)...",
-                                 result, tries);
                     }
-                    else
+
+                    if (niryo_robot_msgs::CommandStatus::SUCCESS != result)
                     {
-                        ROS_WARN("JointHardwareInterface::init - "
-                                 "add stepper joint failure, return : %d. Retrying (%d)...",
-                                 result, tries);
+                        ROS_ERROR("JointHardwareInterface::init - Fail to add joint, return : %d", result);
+                        stepperState->setConnectionStatus(false);
+                        ros::Duration(0.05).sleep();
                     }
                 }
-
-                if (niryo_robot_msgs::CommandStatus::SUCCESS != result)
-                {
-                    ROS_ERROR("JointHardwareInterface::init - Fail to add joint, return : %d", result);
-                    stepperState->setConnectionStatus(false);
-                    ros::Duration(0.05).sleep();
-                }
             }
             else
             {
@@ -189,43 +206,14 @@ bool JointHardwareInterface::init(ros::NodeHandle & /*rootnh*/, ros::NodeHandle
                 _joint_state_list.emplace_back(dxlState);
                 _map_dxl_name[dxlState->getId()] = dxlState->getName();
 
-                int result = niryo_robot_msgs::CommandStatus::TTL_READ_ERROR;
-
-                // Try 3 times
-                for (int tries = 0; tries < 3; tries++)
+                if (EBusProtocol::TTL == eBusProto)
                 {
-                    if (EBusProtocol::CAN == eBusProto)
-                        ROS_ERROR("JointHardwareInterface::init - Dynamixel motors are not available on CAN Bus");
-                    else if (EBusProtocol::TTL == eBusProto)
-                        result = _ttl_interface->addJoint(dxlState);
-
-                    // on success, we initialize the joint and go out of loop
-                    if (niryo_robot_msgs::CommandStatus::SUCCESS == result)
-                    {
-                        result = initHardware(dxlState, torque_status);
-                        if (niryo_robot_msgs::CommandStatus::SUCCESS == result)
-                        {
-                            ROS_INFO("JointHardwareInterface::init - add dxl joint success");
-                            break;
-                        }
-
-                        ROS_WARN("JointHardwareInterface::init - "
-                                 "init dxl joint failure, return : %d. Retrying (%d)...",
-                                 result, tries);
-                    }
-                    else
-                    {
-                        ROS_WARN("JointHardwareInterface::init - "
-                                 "add dxl joint failure, return : %d. Retrying (%d)...",
-                                 result, tries);
-                    }
+                    ttl_joint_list.emplace_back(dxlState);
                 }
-
-                if (niryo_robot_msgs::CommandStatus::SUCCESS != result)
+                else
                 {
-                    ROS_ERROR("JointHardwareInterface::init - Fail to add joint, return : %d", result);
+                    ROS_ERROR("JointHardwareInterface::init - Dynamixel motors are not available on CAN Bus");
                     dxlState->setConnectionStatus(false);
-                    ros::Duration(0.05).sleep();
                 }
             }
             else
@@ -255,6 +243,11 @@ bool JointHardwareInterface::init(ros::NodeHandle & /*rootnh*/, ros::NodeHandle
         }
     }  // end for (size_t j = 0; j < nb_joints; j++)
 
+    if (!ttl_joint_list.empty())
+        initTtlHardware(ttl_joint_list, torque_status);
+
+    initTrajectoryCommands();
+
     // register the interfaces
     registerInterface(&_joint_state_interface);
     registerInterface(&_joint_position_interface);
@@ -435,12 +428,20 @@ bool JointHardwareInterface::initDxlState(ros::NodeHandle &robot_hwnh, const std
  */
 void JointHardwareInterface::read(const ros::Time & /*time*/, const ros::Duration & /*period*/)
 {
+    auto now = common::model::AbstractMotorState::Clock::now();
+    _sample_time = now;
+
     for (auto &jState : _joint_state_list)
     {
         if (jState && jState->isValid())
         {
             jState->pos = jState->to_rad_pos(jState->getPosition());
             // jState->vel = jState->to_rad_vel(jState->getVelocity());
+
+            // the joints not read for a while (disconnected) do not date the others
+            auto position_time = jState->getPositionTime();
+            if (now - position_time < MAX_SAMPLE_AGE)
+                _sample_time = std::min(_sample_time, position_time);
         }
     }
 
@@ -453,25 +454,30 @@ void JointHardwareInterface::read(const ros::Time & /*time*/, const ros::Duratio
  */
 void JointHardwareInterface::write(const ros::Time & /*time*/, const ros::Duration & /*period*/)
 {
-    std::vector<std::pair<uint8_t, int32_t>> can_cmd;
-    std::vector<std::pair<uint8_t, uint32_t>> ttl_cmd;
-
-    for (auto const &jState : _joint_state_list)
+    // the goals are written in place, in the slots given at init
+    if (_can_interface && !_can_trajectory_joints.empty())
     {
-        if (jState && jState->isValid())
-        {
-            if (jState->getBusProtocol() == EBusProtocol::CAN)
-                can_cmd.emplace_back(jState->getId(), jState->to_motor_pos(jState->cmd));
-            if (jState->getBusProtocol() == EBusProtocol::TTL)
-                ttl_cmd.emplace_back(jState->getId(), jState->to_motor_pos(jState->cmd));
-        }
+        for (size_t slot = 0; slot < _can_trajectory_joints.size(); ++slot)
+            _can_trajectory_goals[slot] = _can_trajectory_joints[slot]->to_motor_pos(_can_trajectory_joints[slot]->cmd);
+        _can_interface->setTrajectoryControllerCommands(_can_trajectory_goals, _sample_time);
     }
 
-    if (_can_interface)
-        _can_interface->setTrajectoryControllerCommands(std::move(can_cmd));
+    if (_ttl_interface && !_ttl_trajectory_joints.empty())
+    {
+        for (size_t slot = 0; slot < _ttl_trajectory_joints.size(); ++slot)
+            _ttl_trajectory_goals[slot] = static_cast<uint32_t>(_ttl_trajectory_joints[slot]->to_motor_pos(_ttl_trajectory_joints[slot]->cmd));
+        _ttl_interface->setTrajectoryControllerCommands(_ttl_trajectory_goals, _sample_time);
+    }
+}
 
-    if (_ttl_interface)
-        _ttl_interface->setTrajectoryControllerCommands(std::move(ttl_cmd));
+/**
+ * @brief JointHardwareInterface::getSampleStamp
+ * @return ros time at which the joint positions of the last read have been received from the buses
+ */
+ros::Time JointHardwareInterface::getSampleStamp() const
+{
+    auto age = std::chrono::duration<double>(common::model::AbstractMotorState::Clock::now() - _sample_time);
+    return ros::Time::now() - ros::Duration(std::max(age.count(), 0.0));
 }
 
 /**
@@ -512,9 +518,10 @@ bool JointHardwareInterface::rebootAll(bool torque_on)
 {
     _ttl_interface->waitSingleQueueFree();
 
-    bool res = true;
+    std::vector<std::shared_ptr<common::model::JointState>> ttl_joint_list;
     for (auto const &jState : _joint_state_list)
     {
+        // reboot not available for CAN
         if (jState->getBusProtocol() == EBusProtocol::TTL)
         {
             // first set torque state
@@ -522,25 +529,228 @@ bool JointHardwareInterface::rebootAll(bool torque_on)
                 _ttl_interface->addSingleCommandToQueue(
                     std::make_unique<StepperTtlSingleCmd>(EStepperCommandType::CMD_TYPE_TORQUE, jState->getId(), std::initializer_list<uint32_t>{torque_on}));
 
-            ros::Duration(0.2).sleep();
+            ttl_joint_list.emplace_back(jState);
+        }
+    }
+
+    _ttl_interface->waitSingleQueueFree();
+
+    // all the joints are rebooted together and configured again as soon as they answer
+    std::vector<uint8_t> rebooted_ids;
+    bool res = _ttl_interface->rebootJoints(ttl_joint_list, rebooted_ids);
+
+    std::vector<std::shared_ptr<common::model::JointState>> rebooted_joint_list;
+    for (auto const &jState : ttl_joint_list)
+    {
+        if (std::find(rebooted_ids.begin(), rebooted_ids.end(), jState->getId()) != rebooted_ids.end())
+            rebooted_joint_list.emplace_back(jState);
+        else
+            ROS_ERROR("JointHardwareInterface::rebootAll - Fail to reboot motor id %d", jState->getId());
+    }
+
+    if (!rebooted_joint_list.empty() && niryo_robot_msgs::CommandStatus::SUCCESS != configureTtlHardware(rebooted_joint_list, torque_on))
+        res = false;
+
+    // reset learning mode correctly
+    activateLearningMode(!torque_on);
+
+    return res;
+}
+
+/**
+ * @brief JointHardwareInterface::initTtlHardware : add and initialize all the ttl joints at once
+ * @param joint_list
+ * @param torque_on
+ * @return
+ */
+int JointHardwareInterface::initTtlHardware(const std::vector<std::shared_ptr<common::model::JointState>> &joint_list, bool torque_on)
+{
+    ROS_DEBUG("JointHardwareInterface::initTtlHardware");
+
+    int result = niryo_robot_msgs::CommandStatus::TTL_READ_ERROR;
+
+    // Try 3 times
+    for (int tries = 0; tries < 3; tries++)
+    {
+        result = _ttl_interface->addJoints(joint_list);
+        if (niryo_robot_msgs::CommandStatus::SUCCESS == result)
+            break;
+
+        ROS_WARN("JointHardwareInterface::initTtlHardware - add ttl joints failure, return : %d. Retrying (%d)...", result, tries);
+    }
+
+    if (niryo_robot_msgs::CommandStatus::SUCCESS != result)
+    {
+        ROS_ERROR("JointHardwareInterface::initTtlHardware - Fail to add joints, return : %d", result);
+        for (auto const &jState : joint_list)
+            jState->setConnectionStatus(true);
+
+        return result;
+    }
+
+    return configureTtlHardware(joint_list, torque_on);
+}
+
+/**
+ * @brief JointHardwareInterface::configureTtlHardware : write the configuration of ttl joints already added,
+ * after their initialization or a reboot
+ * @param joint_list
+ * @param torque_on
+ * @return
+ * The configuration is sent grouped by register: the torque with sync commands, the PID and profiles
+ * (which have no sync write) all queued before a single wait. The torque state is then checked with one sync read
+ * and only the joints failing it are initialized again one by one with initHardware
+ */
+int JointHardwareInterface::configureTtlHardware(const std::vector<std::shared_ptr<common::model::JointState>> &joint_list, bool torque_on)
+{
+    ROS_DEBUG("JointHardwareInterface::configureTtlHardware");
+
+    // 1. TORQUE cmd off on dxl to ensure commands can be written on the motors
+    DxlSyncCmd dxl_torque_off_cmd(EDxlCommandType::CMD_TYPE_TORQUE);
+    for (auto const &jState : joint_list)
+    {
+        if (jState->isDynamixel())
+            dxl_torque_off_cmd.addMotorParam(jState->getHardwareType(), jState->getId(), false);
+    }
 
-            if (_ttl_interface->rebootHardware(jState))
+    if (dxl_torque_off_cmd.isValid())
+    {
+        _ttl_interface->addSyncCommandToQueue(std::make_unique<DxlSyncCmd>(dxl_torque_off_cmd));
+        _ttl_interface->waitSyncQueueFree();
+    }
+
+    // 2. configuration registers, one wait for all the joints
+    for (auto const &jState : joint_list)
+    {
+        if (jState->isStepper())
+        {
+            auto stepperState = std::dynamic_pointer_cast<common::model::StepperMotorState>(jState);
+            if (stepperState)
             {
-                initHardware(jState, torque_on);
+                // CMD_TYPE_VELOCITY_PROFILE cmd
+                _ttl_interface->addSingleCommandToQueue(
+                    std::make_unique<StepperTtlSingleCmd>(EStepperCommandType::CMD_TYPE_VELOCITY_PROFILE, stepperState->getId(), stepperState->getVelocityProfile().to_list()));
             }
-            else
+        }
+        else if (jState->isDynamixel())
+        {
+            auto dxlState = std::dynamic_pointer_cast<common::model::DxlMotorState>(jState);
+            if (dxlState)
             {
-                ROS_ERROR("JointHardwareInterface::init - Fail to reboot motor id %d", jState->getId());
-                res = false;
+                // set PID
+                _ttl_interface->addSingleCommandToQueue(
+                    std::make_unique<DxlSingleCmd>(EDxlCommandType::CMD_TYPE_PID, dxlState->getId(),
+                                                   std::initializer_list<uint32_t>({dxlState->getPositionPGain(), dxlState->getPositionIGain(), dxlState->getPositionDGain(),
+                                                                                    dxlState->getVelocityPGain(), dxlState->getVelocityIGain(), dxlState->getFF1Gain(),
+                                                                                    dxlState->getFF2Gain(), dxlState->getVelProfile(), dxlState->getAccProfile()})));
+                // set velocity and acceleration profile
+                _ttl_interface->addSingleCommandToQueue(std::make_unique<DxlSingleCmd>(EDxlCommandType::CMD_TYPE_PROFILE, dxlState->getId(),
+                                                                                       std::initializer_list<uint32_t>({dxlState->getVelProfile(), dxlState->getAccProfile()})));
+
+                // set startup configuration so that torque is on when motor is alimented
+                _ttl_interface->addSingleCommandToQueue(std::make_unique<DxlSingleCmd>(EDxlCommandType::CMD_TYPE_STARTUP, dxlState->getId(), std::initializer_list<uint32_t>({1})));
             }
         }
-        // reboot not available for CAN
     }
 
-    // reset learning mode correctly
-    activateLearningMode(!torque_on);
+    _ttl_interface->waitSingleQueueFree();
 
-    return res;
+    // 3. TORQUE cmd on if ned2, off otherwise
+    DxlSyncCmd dxl_torque_cmd(EDxlCommandType::CMD_TYPE_TORQUE);
+    StepperTtlSyncCmd stepper_torque_cmd(EStepperCommandType::CMD_TYPE_TORQUE);
+    std::vector<uint8_t> id_list;
+    for (auto const &jState : joint_list)
+    {
+        if (jState->isDynamixel())
+            dxl_torque_cmd.addMotorParam(jState->getHardwareType(), jState->getId(), torque_on);
+        else
+            stepper_torque_cmd.addMotorParam(jState->getHardwareType(), jState->getId(), torque_on);
+
+        id_list.emplace_back(jState->getId());
+    }
+
+    if (dxl_torque_cmd.isValid())
+        _ttl_interface->addSyncCommandToQueue(std::make_unique<DxlSyncCmd>(dxl_torque_cmd));
+    if (stepper_torque_cmd.isValid())
+        _ttl_interface->addSyncCommandToQueue(std::make_unique<StepperTtlSyncCmd>(stepper_torque_cmd));
+
+    _ttl_interface->waitSyncQueueFree();
+
+    // 4. verification, the joints not in the expected state are initialized alone
+    std::vector<uint8_t> mismatch_id_list;
+    if (_ttl_interface->readTorqueEnable(id_list, torque_on, mismatch_id_list))
+    {
+        ROS_INFO("JointHardwareInterface::configureTtlHardware - configure %d ttl joints success", static_cast<int>(joint_list.size()));
+        return niryo_robot_msgs::CommandStatus::SUCCESS;
+    }
+
+    ROS_WARN("JointHardwareInterface::configureTtlHardware - torque state not applied on joints %s, initializing them one by one",
+             common::util::listToString(mismatch_id_list).c_str());
+
+    int result = niryo_robot_msgs::CommandStatus::SUCCESS;
+    for (auto const &jState : joint_list)
+    {
+        if (std::find(mismatch_id_list.begin(), mismatch_id_list.end(), jState->getId()) == mismatch_id_list.end())
+            continue;
+
+        std::vector<uint8_t> still_mismatching;
+        for (int tries = 0; tries < 3; tries++)
+        {
+            if (niryo_robot_msgs::CommandStatus::SUCCESS == initHardware(jState, torque_on) &&
+                _ttl_interface->readTorqueEnable({jState->getId()}, torque_on, still_mismatching))
+                break;
+
+            ROS_WARN("JointHardwareInterface::configureTtlHardware - init joint %d failure. Retrying (%d)...", jState->getId(), tries);
+        }
+
+        if (!still_mismatching.empty())
+        {
+            ROS_ERROR("JointHardwareInterface::configureTtlHardware - Fail to init joint %d", jState->getId());
+            jState->setConnectionStatus(true);
+            result = niryo_robot_msgs::CommandStatus::TTL_WRITE_ERROR;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief JointHardwareInterface::initTrajectoryCommands : give each joint a slot in the trajectory commands of its bus.
+ * The layout is fixed from now on, so that writing the goals at each cycle neither allocates nor looks up the joints
+ */
+void JointHardwareInterface::initTrajectoryCommands()
+{
+    std::vector<uint8_t> ttl_ids;
+    std::vector<uint8_t> can_ids;
+
+    _ttl_trajectory_joints.clear();
+    _can_trajectory_joints.clear();
+
+    for (auto const &jState : _joint_state_list)
+    {
+        if (!jState || !jState->isValid())
+            continue;
+
+        if (EBusProtocol::TTL == jState->getBusProtocol())
+        {
+            _ttl_trajectory_joints.emplace_back(jState);
+            ttl_ids.emplace_back(jState->getId());
+        }
+        else if (EBusProtocol::CAN == jState->getBusProtocol())
+        {
+            _can_trajectory_joints.emplace_back(jState);
+            can_ids.emplace_back(jState->getId());
+        }
+    }
+
+    _ttl_trajectory_goals.assign(_ttl_trajectory_joints.size(), 0);
+    _can_trajectory_goals.assign(_can_trajectory_joints.size(), 0);
+
+    if (_ttl_interface)
+        _ttl_interface->initTrajectoryControllerCommands(ttl_ids);
+
+    if (_can_interface)
+        _can_interface->initTrajectoryControllerCommands(can_ids);
 }
 
 /**
@@ -641,9 +851,7 @@ int JointHardwareInterface::calibrateJoints(int mode, string &result_message)
             else
                 _ttl_interface->startCalibration();
 
-            // sleep for 2.5 seconds, waiting for light and sound
-            ros::Duration(2.0).sleep();
-
+            // 2. start the calibration, it is then processed by updateCalibration
             calib_res = _calibration_manager->startCalibration(mode, result_message);
         }
         else
@@ -660,6 +868,24 @@ int JointHardwareInterface::calibrateJoints(int mode, string &result_message)
     return calib_res;
 }
 
+/**
+ * @brief JointHardwareInterface::cancelCalibration
+ * @return true if a calibration was in progress
+ */
+bool JointHardwareInterface::cancelCalibration()
+{
+    return _calibration_manager->cancelCalibration();
+}
+
+/**
+ * @brief JointHardwareInterface::updateCalibration : advances the calibration in progress, if any
+ * @return true while the calibration is in progress
+ */
+bool JointHardwareInterface::updateCalibration()
+{
+    return _calibration_manager->update();
+}
+
 /**
  * @brief JointHardwareInterface::newCalibration : setNeedCalibration for all steppers
  */
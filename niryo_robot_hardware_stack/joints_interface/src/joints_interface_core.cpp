@@ -18,6 +18,7 @@
 */
 
 // C++
+#include <algorithm>
 #include <functional>
 #include <memory>
 #include <string>
@@ -115,6 +116,8 @@ void JointsInterfaceCore::startServices(ros::NodeHandle &nh)
 {
     _calibrate_motors_server = nh.advertiseService("/niryo_robot/joints_interface/calibrate_motors", &JointsInterfaceCore::_callbackCalibrateMotors, this);
 
+    _cancel_calibration_server = nh.advertiseService("/niryo_robot/joints_interface/cancel_calibration", &JointsInterfaceCore::_callbackCancelCalibration, this);
+
     _request_new_calibration_server = nh.advertiseService("/niryo_robot/joints_interface/request_new_calibration", &JointsInterfaceCore::_callbackRequestNewCalibration, this);
 
     _activate_learning_mode_server = nh.advertiseService("/niryo_robot/learning_mode/activate", &JointsInterfaceCore::_callbackActivateLearningMode, this);
@@ -224,11 +227,25 @@ void JointsInterfaceCore::rosControlLoop()
 {
     ros::Time last_time = ros::Time::now();
     ros::Time current_time = ros::Time::now();
+    ros::Time sample_stamp;
     ros::Duration elapsed_time;
+    bool calibration_in_progress = false;
 
     while (ros::ok())
     {
-        if (_enable_control_loop)
+        // the calibration is advanced by the control loop, ros control is paused until it ends
+        if (_robot->updateCalibration())
+        {
+            calibration_in_progress = true;
+            _control_loop_rate.sleep();
+        }
+        else if (calibration_in_progress)
+        {
+            calibration_in_progress = false;
+            onCalibrationDone();
+            last_time = ros::Time::now();
+        }
+        else if (_enable_control_loop)
         {
             _robot->read(current_time, elapsed_time);
 
@@ -245,16 +262,20 @@ void JointsInterfaceCore::rosControlLoop()
             elapsed_time = ros::Duration(current_time - last_time);
             last_time = current_time;
 
+            // the controllers are updated at the time the joint positions have been received from the buses,
+            // so that the published joint states carry the actual sampling time
+            sample_stamp = std::max(_robot->getSampleStamp(), sample_stamp);
+
             if (_reset_controller)
             {
                 ROS_DEBUG("JointsInterfaceCore::rosControlLoop - Reset Controller");
                 _robot->setCommandToCurrentPosition();
-                _cm->update(ros::Time::now(), elapsed_time, true);
+                _cm->update(sample_stamp, elapsed_time, true);
                 _reset_controller = false;
             }
             else
             {
-                _cm->update(ros::Time::now(), elapsed_time, false);
+                _cm->update(sample_stamp, elapsed_time, false);
             }
 
             // we just use cmd from moveit only in torque on + calibration finished
@@ -278,6 +299,20 @@ void JointsInterfaceCore::rosControlLoop()
     }
 }
 
+/**
+ * @brief JointsInterfaceCore::onCalibrationDone
+ */
+void JointsInterfaceCore::onCalibrationDone()
+{
+    if (!_robot->needCalibration())
+    {
+        // we have to reset controller to avoid ros controller set command to the previous position
+        // before the calibration
+        _reset_controller = true;
+        _previous_state_learning_mode = ("ned2" != _hardware_version && !_simulation_mode);
+    }
+}
+
 /**
  * @brief JointsInterfaceCore::resetController
  */
@@ -352,22 +387,37 @@ bool JointsInterfaceCore::_callbackCalibrateMotors(niryo_robot_msgs::SetInt::Req
     ROS_DEBUG("JointsInterfaceCore::_callbackCalibrateMotors - Received a calibration request");
     int calibration_mode = req.value;
     std::string result_message;
-    _enable_control_loop = false;
     int result = niryo_robot_msgs::CommandStatus::FAILURE;
     // first activate learning mode for ned and one
     activateLearningMode(("ned2" != _hardware_version && !_simulation_mode), result, result_message);
 
+    // the calibration runs in the control loop, its end is given by the hardware status
     result = _robot->calibrateJoints(calibration_mode, result_message);
     res.status = result;
     res.message = result_message;
 
-    if (niryo_robot_msgs::CommandStatus::SUCCESS == result)
+    return true;
+}
+
+/**
+ * @brief JointsInterfaceCore::_callbackCancelCalibration
+ * @param req
+ * @param res
+ * @return
+ */
+bool JointsInterfaceCore::_callbackCancelCalibration(niryo_robot_msgs::Trigger::Request & /*req*/, niryo_robot_msgs::Trigger::Response &res)
+{
+    ROS_DEBUG("JointsInterfaceCore::_callbackCancelCalibration - Received a calibration cancel request");
+
+    if (_robot->cancelCalibration())
     {
-        // we have to reset controller to avoid ros controller set command to the previous position
-        // before the calibration
-        _reset_controller = true;
-        _previous_state_learning_mode = ("ned2" != _hardware_version && !_simulation_mode);
-        _enable_control_loop = true;
+        res.status = niryo_robot_msgs::CommandStatus::SUCCESS;
+        res.message = "Joints Interface Core - Calibration cancelled, a new calibration is needed";
+    }
+    else
+    {
+        res.status = niryo_robot_msgs::CommandStatus::ABORTED;
+        res.message = "Joints Interface Core - No calibration in progress";
     }
 
     return true;
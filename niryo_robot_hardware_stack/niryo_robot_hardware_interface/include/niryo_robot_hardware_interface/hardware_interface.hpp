@@ -33,6 +33,8 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #include "ttl_driver/ttl_interface_core.hpp"
 #include "can_driver/can_interface_core.hpp"
 
+#include "niryo_robot_hardware_interface/hardware_status_aggregator.hpp"
+
 #include "niryo_robot_msgs/Trigger.h"
 #include "niryo_robot_msgs/SetBool.h"
 
@@ -81,6 +83,10 @@ class HardwareInterface : common::util::IInterfaceCore
         ros::Publisher _hw_status_publisher;
         ros::Timer _hw_status_publisher_timer;
         ros::Duration _hw_status_publisher_duration{1.0};
+        ros::Duration _hw_status_poll_duration{0.1};
+        ros::Time _hw_status_last_publish_time;
+
+        HardwareStatusAggregator _hw_status_aggregator;
 
         ros::Publisher _sw_version_publisher;
         ros::Timer _sw_version_publisher_timer;
@@ -103,6 +109,8 @@ class HardwareInterface : common::util::IInterfaceCore
         bool _can_enabled{false};
         bool _ttl_enabled{false};
         bool _end_effector_enabled{false};
+        // maximum time to wait for a bus to be connected during the bring-up, in s
+        double _bus_ready_timeout{1.0};
         int8_t _hardware_state = niryo_robot_msgs::HardwareStatus::NORMAL;
 
         common::model::EBusProtocol _conveyor_bus{common::model::EBusProtocol::CAN};
@@ -0,0 +1,112 @@
+/*
+hardware_status_aggregator.hpp
+Copyright (C) 2020 Niryo
+All rights reserved.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#ifndef HARDWARE_STATUS_AGGREGATOR_HPP
+#define HARDWARE_STATUS_AGGREGATOR_HPP
+
+#include <ros/time.h>
+#include <string>
+#include <vector>
+
+#include "common/model/abstract_hardware_state.hpp"
+
+#include "niryo_robot_msgs/HardwareStatus.h"
+
+namespace niryo_robot_hardware_interface
+{
+/**
+ * @brief The HardwareStatusAggregator class keeps a single HardwareStatus message
+ * and updates it in place from the hardware states.
+ *
+ * An update pass is a call to beginUpdate(), one call to updateMotor() per motor,
+ * in a stable order, then endUpdate(). Each motor occupies a slot in the message
+ * arrays: names and types are only rewritten when the component found in a slot changes,
+ * other fields are only rewritten when their value changed.
+ * Any change of a hardware error, of the bus connection, of the error message or of the hardware
+ * state is reported as an error transition, which should be published without waiting for the next heartbeat.
+ */
+class HardwareStatusAggregator
+{
+    public:
+        HardwareStatusAggregator() = default;
+
+        void beginUpdate();
+        void updateMotor(const common::model::AbstractHardwareState &state, const std::string &name);
+        void updateMotor(const common::model::AbstractHardwareState &state, const char *name_prefix, bool append_id);
+        void endUpdate();
+
+        void setConnectionUp(bool connection_up);
+        void setErrorMessage(const std::string &can_error, const std::string &ttl_error);
+        void setHardwareState(int8_t hardware_state);
+        void setCalibrationStatus(bool calibration_needed, bool calibration_in_progress);
+        void setRpiTemperature(int32_t temperature);
+        void setHardwareVersion(const std::string &hardware_version);
+
+        bool hasChanged() const;
+        bool hasErrorTransition() const;
+
+        const niryo_robot_msgs::HardwareStatus &getMessage(const ros::Time &stamp);
+
+    private:
+        bool isSameComponent(size_t slot, const common::model::AbstractHardwareState &state) const;
+        void fillSlot(size_t slot, const common::model::AbstractHardwareState &state);
+
+    private:
+        /**
+         * @brief identity of the component stored in a slot of the message arrays
+         */
+        struct SlotId
+        {
+            common::model::EHardwareType hw_type;
+            common::model::EComponentType component_type;
+            uint8_t id;
+        };
+
+        niryo_robot_msgs::HardwareStatus _msg;
+        std::vector<SlotId> _slots;
+
+        size_t _cursor{0};
+
+        bool _changed{true};
+        bool _error_transition{true};
+};
+
+/**
+ * @brief HardwareStatusAggregator::hasChanged
+ * @return true if any field changed since the last call to getMessage
+ */
+inline
+bool HardwareStatusAggregator::hasChanged() const
+{
+    return _changed;
+}
+
+/**
+ * @brief HardwareStatusAggregator::hasErrorTransition
+ * @return true if an error related field changed since the last call to getMessage
+ */
+inline
+bool HardwareStatusAggregator::hasErrorTransition() const
+{
+    return _error_transition;
+}
+
+}  // namespace niryo_robot_hardware_interface
+
+#endif  // HARDWARE_STATUS_AGGREGATOR_HPP
@@ -0,0 +1,88 @@
+/*
+startup_timeline.hpp
+Copyright (C) 2020 Niryo
+All rights reserved.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#ifndef STARTUP_TIMELINE_HPP
+#define STARTUP_TIMELINE_HPP
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace niryo_robot_hardware_interface
+{
+/**
+ * @brief The StartupTimeline class records the start and the duration of each phase of the hardware bring-up.
+ * Phases can be recorded from several threads, each one being tagged with the line of bring-up (bus) it belongs to.
+ */
+class StartupTimeline
+{
+    public:
+        /**
+         * @brief RAII helper closing its phase when destroyed
+         */
+        class Phase
+        {
+            public:
+                Phase(StartupTimeline &timeline, std::string line, std::string name);
+                ~Phase();
+
+                Phase( const Phase& ) = delete;
+                Phase( Phase&& ) = delete;
+                Phase& operator= ( Phase && ) = delete;
+                Phase& operator= ( const Phase& ) = delete;
+
+            private:
+                StartupTimeline &_timeline;
+                std::string _line;
+                std::string _name;
+                std::chrono::steady_clock::time_point _start;
+        };
+
+    public:
+        StartupTimeline();
+
+        void record(const std::string &line, const std::string &name,
+                    std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+
+        bool waitFor(const std::string &line, const std::string &name, const std::function<bool()> &is_ready, double timeout);
+
+        double getTotalDuration() const;
+        std::string str() const;
+
+    private:
+        struct PhaseRecord
+        {
+            std::string line;
+            std::string name;
+            double start_ms;
+            double duration_ms;
+        };
+
+        mutable std::mutex _mutex;
+        std::chrono::steady_clock::time_point _origin;
+        std::vector<PhaseRecord> _phases;
+
+        static constexpr double READINESS_POLL_PERIOD = 0.01;
+};
+
+} // namespace niryo_robot_hardware_interface
+
+#endif // STARTUP_TIMELINE_HPP
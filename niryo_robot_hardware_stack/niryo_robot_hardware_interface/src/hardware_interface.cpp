@@ -17,14 +17,15 @@
     along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
 #include <functional>
+#include <future>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "niryo_robot_hardware_interface/hardware_interface.hpp"
-
-#include "common/model/hardware_type_enum.hpp"
+#include "niryo_robot_hardware_interface/startup_timeline.hpp"
 
 #include "common/util/util_defs.hpp"
 
@@ -78,17 +79,22 @@ bool HardwareInterface::init(ros::NodeHandle &nh)
 void HardwareInterface::initParameters(ros::NodeHandle &nh)
 {
     double hw_status_frequency{1.0};
+    double hw_status_poll_frequency{10.0};
     double sw_version_frequency{1.0};
     nh.getParam("publish_hw_status_frequency", hw_status_frequency);
+    nh.getParam("poll_hw_status_frequency", hw_status_poll_frequency);
     nh.getParam("publish_software_version_frequency", sw_version_frequency);
 
     ROS_DEBUG("HardwareInterface::initParameters - publish_hw_status_frequency : %f", hw_status_frequency);
+    ROS_DEBUG("HardwareInterface::initParameters - poll_hw_status_frequency : %f", hw_status_poll_frequency);
     ROS_DEBUG("HardwareInterface::initParameters - publish_software_version_frequency : %f", sw_version_frequency);
 
     assert(hw_status_frequency);
+    assert(hw_status_poll_frequency);
     assert(sw_version_frequency);
 
     _hw_status_publisher_duration = ros::Duration(1.0 / hw_status_frequency);
+    _hw_status_poll_duration = ros::Duration(1.0 / std::max(hw_status_poll_frequency, hw_status_frequency));
     _sw_version_publisher_duration = ros::Duration(1.0 / sw_version_frequency);
 
     nh.getParam("/niryo_robot/info/image_version", _rpi_image_version);
@@ -98,6 +104,7 @@ void HardwareInterface::initParameters(ros::NodeHandle &nh)
     nh.getParam("gazebo", _gazebo);
 
     nh.getParam("can_enabled", _can_enabled);
+    nh.getParam("startup_bus_ready_timeout", _bus_ready_timeout);
     nh.getParam("ttl_enabled", _ttl_enabled);
 
     _rpi_image_version.erase(_rpi_image_version.find_last_not_of(" \n\r\t") + 1);
@@ -133,57 +140,101 @@ void HardwareInterface::initNodes(ros::NodeHandle &nh)
 {
     ROS_DEBUG("HardwareInterface::initNodes - Init Nodes");
 
-    ROS_DEBUG("HardwareInterface::initNodes - Start CPU Interface Node");
-    ros::NodeHandle nh_cpu(nh, "cpu_interface");
-    _cpu_interface = std::make_shared<cpu_interface::CpuInterfaceCore>(nh_cpu);
-    ros::Duration(0.25).sleep();
+    StartupTimeline timeline;
+
+    // the cpu interface and the two buses do not depend on each other, they are brought up concurrently
+    auto cpu_bringup = std::async(std::launch::async, [&]() {
+        StartupTimeline::Phase phase(timeline, "cpu", "cpu_interface");
 
+        ROS_DEBUG("HardwareInterface::initNodes - Start CPU Interface Node");
+        ros::NodeHandle nh_cpu(nh, "cpu_interface");
+        _cpu_interface = std::make_shared<cpu_interface::CpuInterfaceCore>(nh_cpu);
+    });
+
+    std::future<void> ttl_bringup;
     if (_ttl_enabled)
     {
-        ROS_DEBUG("HardwareInterface::initNodes - Start Dynamixel Driver Node");
-        ros::NodeHandle nh_ttl(nh, "ttl_driver");
-        _ttl_interface = std::make_shared<ttl_driver::TtlInterfaceCore>(nh_ttl);
-        ros::Duration(0.25).sleep();
+        ttl_bringup = std::async(std::launch::async, [&]() {
+            {
+                StartupTimeline::Phase phase(timeline, "ttl", "ttl_driver");
 
-        ROS_DEBUG("HardwareInterface::initNodes - Start Tools Interface Node");
-        ros::NodeHandle nh_tool(nh, "tools_interface");
-        _tools_interface = std::make_shared<tools_interface::ToolsInterfaceCore>(nh_tool, _ttl_interface);
-        ros::Duration(0.25).sleep();
+                ROS_DEBUG("HardwareInterface::initNodes - Start Dynamixel Driver Node");
+                ros::NodeHandle nh_ttl(nh, "ttl_driver");
+                _ttl_interface = std::make_shared<ttl_driver::TtlInterfaceCore>(nh_ttl);
+            }
 
-        if (_end_effector_enabled)
-        {
-            ROS_DEBUG("HardwareInterface::initNodes - Start End Effector Interface Node");
-            ros::NodeHandle nh_ee(nh, "end_effector_interface");
-            _end_effector_interface = std::make_shared<end_effector_interface::EndEffectorInterfaceCore>(nh_ee, _ttl_interface);
-        }
-        ros::Duration(0.25).sleep();
+            if (!timeline.waitFor("ttl", "ttl_driver ready", [this]() { return _ttl_interface->isConnectionOk(); }, _bus_ready_timeout))
+                ROS_WARN("HardwareInterface::initNodes - TTL bus not connected after %.2f s, continuing", _bus_ready_timeout);
+
+            {
+                StartupTimeline::Phase phase(timeline, "ttl", "tools_interface");
+
+                ROS_DEBUG("HardwareInterface::initNodes - Start Tools Interface Node");
+                ros::NodeHandle nh_tool(nh, "tools_interface");
+                _tools_interface = std::make_shared<tools_interface::ToolsInterfaceCore>(nh_tool, _ttl_interface);
+            }
+
+            if (_end_effector_enabled)
+            {
+                StartupTimeline::Phase phase(timeline, "ttl", "end_effector_interface");
+
+                ROS_DEBUG("HardwareInterface::initNodes - Start End Effector Interface Node");
+                ros::NodeHandle nh_ee(nh, "end_effector_interface");
+                _end_effector_interface = std::make_shared<end_effector_interface::EndEffectorInterfaceCore>(nh_ee, _ttl_interface);
+            }
+        });
     }
     else
     {
         ROS_WARN("HardwareInterface::initNodes - DXL communication is disabled for debug purposes");
     }
 
+    std::future<void> can_bringup;
     if (_can_enabled)
     {
-        ROS_DEBUG("HardwareInterface::initNodes - Start CAN Driver Node");
-        ros::NodeHandle nh_can(nh, "can_driver");
-        _can_interface = std::make_shared<can_driver::CanInterfaceCore>(nh_can);
-        ros::Duration(0.25).sleep();
+        can_bringup = std::async(std::launch::async, [&]() {
+            {
+                StartupTimeline::Phase phase(timeline, "can", "can_driver");
+
+                ROS_DEBUG("HardwareInterface::initNodes - Start CAN Driver Node");
+                ros::NodeHandle nh_can(nh, "can_driver");
+                _can_interface = std::make_shared<can_driver::CanInterfaceCore>(nh_can);
+            }
+
+            if (!timeline.waitFor("can", "can_driver ready", [this]() { return _can_interface->isConnectionOk(); }, _bus_ready_timeout))
+                ROS_WARN("HardwareInterface::initNodes - CAN bus not connected after %.2f s, continuing", _bus_ready_timeout);
+        });
     }
     else
     {
         ROS_DEBUG("HardwareInterface::initNodes - CAN communication is disabled for debug purposes");
     }
 
-    ROS_DEBUG("HardwareInterface::initNodes - Start Joints Interface Node");
-    ros::NodeHandle nh_joints(nh, "joints_interface");
-    _joints_interface = std::make_shared<joints_interface::JointsInterfaceCore>(nh, nh_joints, _ttl_interface, _can_interface);
-    ros::Duration(0.25).sleep();
+    // joints and conveyors need both buses. get() rethrows an exception raised during a bring-up
+    if (ttl_bringup.valid())
+        ttl_bringup.get();
+    if (can_bringup.valid())
+        can_bringup.get();
+
+    {
+        StartupTimeline::Phase phase(timeline, "main", "joints_interface");
+
+        ROS_DEBUG("HardwareInterface::initNodes - Start Joints Interface Node");
+        ros::NodeHandle nh_joints(nh, "joints_interface");
+        _joints_interface = std::make_shared<joints_interface::JointsInterfaceCore>(nh, nh_joints, _ttl_interface, _can_interface);
+    }
 
-    ROS_DEBUG("HardwareInterface::initNodes - Start Conveyor Interface Node");
-    ros::NodeHandle nh_conveyor(nh, "conveyor");
-    _conveyor_interface = std::make_shared<conveyor_interface::ConveyorInterfaceCore>(nh_conveyor, _ttl_interface, _can_interface);
-    ros::Duration(0.25).sleep();
+    {
+        StartupTimeline::Phase phase(timeline, "main", "conveyor_interface");
+
+        ROS_DEBUG("HardwareInterface::initNodes - Start Conveyor Interface Node");
+        ros::NodeHandle nh_conveyor(nh, "conveyor");
+        _conveyor_interface = std::make_shared<conveyor_interface::ConveyorInterfaceCore>(nh_conveyor, _ttl_interface, _can_interface);
+    }
+
+    cpu_bringup.get();
+
+    ROS_INFO("HardwareInterface::initNodes - Hardware started in %.1f ms:%s", timeline.getTotalDuration(), timeline.str().c_str());
 }
 
 /**
@@ -206,7 +257,7 @@ void HardwareInterface::startPublishers(ros::NodeHandle &nh)
 {
     _hw_status_publisher = nh.advertise<niryo_robot_msgs::HardwareStatus>("/niryo_robot_hardware_interface/hardware_status", 10);
 
-    _hw_status_publisher_timer = nh.createTimer(_hw_status_publisher_duration, &HardwareInterface::_publishHardwareStatus, this);
+    _hw_status_publisher_timer = nh.createTimer(_hw_status_poll_duration, &HardwareInterface::_publishHardwareStatus, this);
 
     _sw_version_publisher = nh.advertise<niryo_robot_msgs::SoftwareVersion>("/niryo_robot_hardware_interface/software_version", 10);
 
@@ -326,9 +377,6 @@ bool HardwareInterface::_callbackRebootMotors(niryo_robot_msgs::Trigger::Request
     std::string message;
     bool torque_on = ("ned2" == _hardware_version);
 
-    if ("ned2" == _hardware_version)
-        ros::Duration(3).sleep();
-
     if (_joints_interface && !_joints_interface->rebootAll(torque_on))
     {
         ret++;
@@ -364,131 +412,87 @@ bool HardwareInterface::_callbackRebootMotors(niryo_robot_msgs::Trigger::Request
 
 /**
  * @brief HardwareInterface::_publishHardwareStatus
- * Called every _hw_status_publisher_duration via the _hw_status_publisher_timer
+ * Called every _hw_status_poll_duration via the _hw_status_publisher_timer
+ * The status message is updated in place. It is published right away on error transitions,
+ * and every _hw_status_publisher_duration otherwise
  */
-void HardwareInterface::_publishHardwareStatus(const ros::TimerEvent &)
+void HardwareInterface::_publishHardwareStatus(const ros::TimerEvent &event)
 {
-    niryo_robot_msgs::BusState ttl_bus_state;
-    niryo_robot_msgs::BusState can_bus_state;
-
-    bool need_calibration = false;
-    bool calibration_in_progress = false;
+    static const std::string end_effector_name = "End Effector";
+    static const std::string tool_name = "Tool";
 
-    int cpu_temperature = 0;
-
-    niryo_robot_msgs::HardwareStatus msg;
-    msg.header.stamp = ros::Time::now();
-    msg.connection_up = true;
-
-    std::vector<std::string> motor_names;
-    std::vector<int32_t> temperatures;
-    std::vector<double> voltages;
-    std::vector<std::string> motor_types;
-
-    std::vector<int32_t> hw_errors;
-    std::vector<std::string> hw_errors_msg;
+    bool connection_up = true;
+    std::string can_error;
+    std::string ttl_error;
 
     if (_can_interface)
     {
-        can_bus_state = _can_interface->getBusState();
-        msg.connection_up = msg.connection_up && can_bus_state.connection_status;
+        niryo_robot_msgs::BusState can_bus_state = _can_interface->getBusState();
+        connection_up = connection_up && can_bus_state.connection_status;
+        can_error = std::move(can_bus_state.error);
     }
 
     if (_ttl_interface)
     {
-        ttl_bus_state = _ttl_interface->getBusState();
-        msg.connection_up = msg.connection_up && ttl_bus_state.connection_status;
+        niryo_robot_msgs::BusState ttl_bus_state = _ttl_interface->getBusState();
+        connection_up = connection_up && ttl_bus_state.connection_status;
+        ttl_error = std::move(ttl_bus_state.error);
     }
 
+    _hw_status_aggregator.setConnectionUp(connection_up);
+    _hw_status_aggregator.setErrorMessage(can_error, ttl_error);
+    _hw_status_aggregator.setHardwareState(_hardware_state);
+    _hw_status_aggregator.setHardwareVersion(_hardware_version);
+    _hw_status_aggregator.setRpiTemperature(_cpu_interface->getCpuTemperature());
+
+    _hw_status_aggregator.beginUpdate();
+
     if (_joints_interface)
     {
-        need_calibration = _joints_interface->needCalibration();
-        calibration_in_progress = _joints_interface->isCalibrationInProgress();
+        _hw_status_aggregator.setCalibrationStatus(_joints_interface->needCalibration(), _joints_interface->isCalibrationInProgress());
 
-        auto joints_states = _joints_interface->getJointsState();
-        for (const auto &jState : joints_states)
+        for (const auto &jState : _joints_interface->getJointsState())
         {
-            motor_names.emplace_back(jState->getName());
-            voltages.emplace_back(jState->getVoltage());
-            temperatures.emplace_back(jState->getTemperature());
-            hw_errors.emplace_back(jState->getHardwareError());
-            hw_errors_msg.emplace_back(jState->getHardwareErrorMessage());
-            motor_types.emplace_back(common::model::HardwareTypeEnum(jState->getHardwareType()).toString());
+            if (jState)
+                _hw_status_aggregator.updateMotor(*jState, jState->getName());
         }
     }
+    else
+    {
+        _hw_status_aggregator.setCalibrationStatus(false, false);
+    }
 
     if (_end_effector_interface)
     {
         auto ee_state = _end_effector_interface->getEndEffectorState();
         if (ee_state && ee_state->isValid())
-        {
-            motor_names.emplace_back("End Effector");
-            voltages.emplace_back(ee_state->getVoltage());
-            temperatures.emplace_back(ee_state->getTemperature());
-            hw_errors.emplace_back(ee_state->getHardwareError());
-            hw_errors_msg.emplace_back(ee_state->getHardwareErrorMessage());
-            motor_types.emplace_back(common::model::HardwareTypeEnum(ee_state->getHardwareType()).toString());
-        }
+            _hw_status_aggregator.updateMotor(*ee_state, end_effector_name);
     }
 
     if (_tools_interface)
     {
         auto tool_state = _tools_interface->getToolState();
         if (tool_state && tool_state->isValid())
-        {
-            motor_names.emplace_back("Tool");
-            voltages.emplace_back(tool_state->getVoltage());
-            temperatures.emplace_back(tool_state->getTemperature());
-            hw_errors.emplace_back(tool_state->getHardwareError());
-            hw_errors_msg.emplace_back(tool_state->getHardwareErrorMessage());
-            motor_types.emplace_back(common::model::HardwareTypeEnum(tool_state->getHardwareType()).toString());
-        }
+            _hw_status_aggregator.updateMotor(*tool_state, tool_name);
     }
 
     if (_conveyor_interface)
     {
-        auto conveyor_states = _conveyor_interface->getConveyorStates();
-        for (const auto &cState : conveyor_states)
+        for (const auto &cState : _conveyor_interface->getConveyorStates())
         {
             if (cState && cState->isValid())
-            {
-                motor_names.emplace_back("Conveyor_" + std::to_string(cState->getId()));
-                voltages.emplace_back(cState->getVoltage());
-                temperatures.emplace_back(cState->getTemperature());
-                hw_errors.emplace_back(cState->getHardwareError());
-                hw_errors_msg.emplace_back(cState->getHardwareErrorMessage());
-                motor_types.emplace_back(common::model::HardwareTypeEnum(cState->getHardwareType()).toString());
-            }
+                _hw_status_aggregator.updateMotor(*cState, "Conveyor", true);
         }
     }
 
-    cpu_temperature = _cpu_interface->getCpuTemperature();
+    _hw_status_aggregator.endUpdate();
 
-    msg.rpi_temperature = cpu_temperature;
-    msg.hardware_version = _hardware_version;
-
-    std::string error_message = can_bus_state.error;
-    if (!ttl_bus_state.error.empty())
+    // error transitions are published right away, everything else waits for the heartbeat
+    if (_hw_status_aggregator.hasErrorTransition() || (event.current_real - _hw_status_last_publish_time) >= _hw_status_publisher_duration)
     {
-        error_message += "\n";
-        error_message += ttl_bus_state.error;
+        _hw_status_last_publish_time = event.current_real;
+        _hw_status_publisher.publish(_hw_status_aggregator.getMessage(ros::Time::now()));
     }
-
-    msg.error_message = error_message;
-    msg.hardware_state = _hardware_state;
-
-    msg.calibration_needed = need_calibration;
-    msg.calibration_in_progress = calibration_in_progress;
-
-    msg.motor_names = motor_names;
-    msg.motor_types = motor_types;
-
-    msg.temperatures = temperatures;
-    msg.voltages = voltages;
-    msg.hardware_errors = hw_errors;
-    msg.hardware_errors_message = hw_errors_msg;
-
-    _hw_status_publisher.publish(msg);
 }
 
 /**
@@ -0,0 +1,273 @@
+/*
+    hardware_status_aggregator.cpp
+    Copyright (C) 2020 Niryo
+    All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#include <string>
+#include <vector>
+
+#include "niryo_robot_hardware_interface/hardware_status_aggregator.hpp"
+
+#include "common/model/hardware_type_enum.hpp"
+
+namespace niryo_robot_hardware_interface
+{
+/**
+ * @brief HardwareStatusAggregator::beginUpdate
+ * Starts a new update pass. Slots are filled in the order of the following updateMotor calls
+ */
+void HardwareStatusAggregator::beginUpdate()
+{
+    _cursor = 0;
+}
+
+/**
+ * @brief HardwareStatusAggregator::updateMotor
+ * @param state
+ * @param name : only copied into the message if the component in this slot changed
+ */
+void HardwareStatusAggregator::updateMotor(const common::model::AbstractHardwareState &state, const std::string &name)
+{
+    size_t slot = _cursor++;
+
+    if (slot >= _slots.size() || !isSameComponent(slot, state))
+    {
+        fillSlot(slot, state);
+        _msg.motor_names[slot] = name;
+    }
+
+    if (_msg.temperatures[slot] != state.getTemperature())
+    {
+        _msg.temperatures[slot] = state.getTemperature();
+        _changed = true;
+    }
+
+    if (_msg.voltages[slot] != state.getVoltage())
+    {
+        _msg.voltages[slot] = state.getVoltage();
+        _changed = true;
+    }
+
+    if (static_cast<uint32_t>(_msg.hardware_errors[slot]) != state.getHardwareError())
+    {
+        _msg.hardware_errors[slot] = static_cast<int32_t>(state.getHardwareError());
+        _changed = true;
+        _error_transition = true;
+    }
+
+    if (_msg.hardware_errors_message[slot] != state.getHardwareErrorMessage())
+    {
+        _msg.hardware_errors_message[slot] = state.getHardwareErrorMessage();
+        _changed = true;
+        _error_transition = true;
+    }
+}
+
+/**
+ * @brief HardwareStatusAggregator::updateMotor
+ * @param state
+ * @param name_prefix
+ * @param append_id : if true, the name is name_prefix + "_" + id
+ * The name is only built when the component in this slot changed
+ */
+void HardwareStatusAggregator::updateMotor(const common::model::AbstractHardwareState &state, const char *name_prefix, bool append_id)
+{
+    if (_cursor < _slots.size() && isSameComponent(_cursor, state))
+    {
+        updateMotor(state, _msg.motor_names[_cursor]);
+        return;
+    }
+
+    std::string name(name_prefix);
+    if (append_id)
+        name += "_" + std::to_string(state.getId());
+
+    updateMotor(state, name);
+}
+
+/**
+ * @brief HardwareStatusAggregator::endUpdate
+ * Removes the slots of the components that disappeared since the last update pass
+ */
+void HardwareStatusAggregator::endUpdate()
+{
+    if (_cursor == _slots.size())
+        return;
+
+    _slots.resize(_cursor);
+    _msg.motor_names.resize(_cursor);
+    _msg.motor_types.resize(_cursor);
+    _msg.temperatures.resize(_cursor);
+    _msg.voltages.resize(_cursor);
+    _msg.hardware_errors.resize(_cursor);
+    _msg.hardware_errors_message.resize(_cursor);
+
+    _changed = true;
+    _error_transition = true;
+}
+
+/**
+ * @brief HardwareStatusAggregator::setConnectionUp
+ * @param connection_up
+ */
+void HardwareStatusAggregator::setConnectionUp(bool connection_up)
+{
+    if (static_cast<bool>(_msg.connection_up) != connection_up)
+    {
+        _msg.connection_up = connection_up;
+        _changed = true;
+        _error_transition = true;
+    }
+}
+
+/**
+ * @brief HardwareStatusAggregator::setErrorMessage
+ * @param can_error
+ * @param ttl_error
+ */
+void HardwareStatusAggregator::setErrorMessage(const std::string &can_error, const std::string &ttl_error)
+{
+    // compare without building the concatenated message
+    const std::string &current = _msg.error_message;
+    bool same = ttl_error.empty() ? (current == can_error)
+                                  : (current.size() == can_error.size() + 1 + ttl_error.size() &&
+                                     0 == current.compare(0, can_error.size(), can_error) &&
+                                     '\n' == current[can_error.size()] &&
+                                     0 == current.compare(can_error.size() + 1, std::string::npos, ttl_error));
+    if (same)
+        return;
+
+    _msg.error_message = can_error;
+    if (!ttl_error.empty())
+    {
+        _msg.error_message += "\n";
+        _msg.error_message += ttl_error;
+    }
+
+    _changed = true;
+    _error_transition = true;
+}
+
+/**
+ * @brief HardwareStatusAggregator::setHardwareState
+ * @param hardware_state
+ */
+void HardwareStatusAggregator::setHardwareState(int8_t hardware_state)
+{
+    if (_msg.hardware_state != hardware_state)
+    {
+        _msg.hardware_state = hardware_state;
+        _changed = true;
+        _error_transition = true;
+    }
+}
+
+/**
+ * @brief HardwareStatusAggregator::setCalibrationStatus
+ * @param calibration_needed
+ * @param calibration_in_progress
+ */
+void HardwareStatusAggregator::setCalibrationStatus(bool calibration_needed, bool calibration_in_progress)
+{
+    if (static_cast<bool>(_msg.calibration_needed) != calibration_needed ||
+        static_cast<bool>(_msg.calibration_in_progress) != calibration_in_progress)
+    {
+        _msg.calibration_needed = calibration_needed;
+        _msg.calibration_in_progress = calibration_in_progress;
+        _changed = true;
+    }
+}
+
+/**
+ * @brief HardwareStatusAggregator::setRpiTemperature
+ * @param temperature
+ */
+void HardwareStatusAggregator::setRpiTemperature(int32_t temperature)
+{
+    if (_msg.rpi_temperature != temperature)
+    {
+        _msg.rpi_temperature = temperature;
+        _changed = true;
+    }
+}
+
+/**
+ * @brief HardwareStatusAggregator::setHardwareVersion
+ * @param hardware_version
+ */
+void HardwareStatusAggregator::setHardwareVersion(const std::string &hardware_version)
+{
+    if (_msg.hardware_version != hardware_version)
+    {
+        _msg.hardware_version = hardware_version;
+        _changed = true;
+    }
+}
+
+/**
+ * @brief HardwareStatusAggregator::getMessage
+ * @param stamp
+ * @return the up to date message. Resets the change flags
+ */
+const niryo_robot_msgs::HardwareStatus &HardwareStatusAggregator::getMessage(const ros::Time &stamp)
+{
+    _msg.header.stamp = stamp;
+    _changed = false;
+    _error_transition = false;
+
+    return _msg;
+}
+
+/**
+ * @brief HardwareStatusAggregator::isSameComponent
+ * @param slot
+ * @param state
+ * @return
+ */
+bool HardwareStatusAggregator::isSameComponent(size_t slot, const common::model::AbstractHardwareState &state) const
+{
+    const SlotId &slot_id = _slots.at(slot);
+    return slot_id.id == state.getId() && slot_id.hw_type == state.getHardwareType() && slot_id.component_type == state.getComponentType();
+}
+
+/**
+ * @brief HardwareStatusAggregator::fillSlot
+ * @param slot
+ * @param state
+ * Allocates the slot if needed and stores the identity of the component in it
+ */
+void HardwareStatusAggregator::fillSlot(size_t slot, const common::model::AbstractHardwareState &state)
+{
+    if (slot >= _slots.size())
+    {
+        _slots.resize(slot + 1);
+        _msg.motor_names.resize(slot + 1);
+        _msg.motor_types.resize(slot + 1);
+        _msg.temperatures.resize(slot + 1, 0);
+        _msg.voltages.resize(slot + 1, 0.0);
+        _msg.hardware_errors.resize(slot + 1, 0);
+        _msg.hardware_errors_message.resize(slot + 1);
+    }
+
+    _slots.at(slot) = {state.getHardwareType(), state.getComponentType(), state.getId()};
+    _msg.motor_types.at(slot) = common::model::HardwareTypeEnum(state.getHardwareType()).toString();
+
+    _changed = true;
+    _error_transition = true;
+}
+
+}  // namespace niryo_robot_hardware_interface
@@ -0,0 +1,135 @@
+/*
+startup_timeline.cpp
+Copyright (C) 2020 Niryo
+All rights reserved.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#include "niryo_robot_hardware_interface/startup_timeline.hpp"
+
+// c++
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace niryo_robot_hardware_interface
+{
+
+/**
+ * @brief StartupTimeline::Phase::Phase
+ * @param timeline
+ * @param line
+ * @param name
+ */
+StartupTimeline::Phase::Phase(StartupTimeline &timeline, std::string line, std::string name)
+    : _timeline(timeline), _line(std::move(line)), _name(std::move(name)), _start(std::chrono::steady_clock::now())
+{
+}
+
+/**
+ * @brief StartupTimeline::Phase::~Phase
+ */
+StartupTimeline::Phase::~Phase()
+{
+    _timeline.record(_line, _name, _start, std::chrono::steady_clock::now());
+}
+
+/**
+ * @brief StartupTimeline::StartupTimeline
+ */
+StartupTimeline::StartupTimeline() : _origin(std::chrono::steady_clock::now()) {}
+
+/**
+ * @brief StartupTimeline::record
+ * @param line
+ * @param name
+ * @param start
+ * @param end
+ */
+void StartupTimeline::record(const std::string &line, const std::string &name, std::chrono::steady_clock::time_point start,
+                             std::chrono::steady_clock::time_point end)
+{
+    std::lock_guard<std::mutex> lck(_mutex);
+    _phases.push_back({line, name, std::chrono::duration<double, std::milli>(start - _origin).count(),
+                       std::chrono::duration<double, std::milli>(end - start).count()});
+}
+
+/**
+ * @brief StartupTimeline::waitFor : replaces a fixed sleep by waiting for a readiness condition, recorded as a phase
+ * @param line
+ * @param name
+ * @param is_ready
+ * @param timeout : in seconds
+ * @return false if the condition was not met before the timeout
+ */
+bool StartupTimeline::waitFor(const std::string &line, const std::string &name, const std::function<bool()> &is_ready, double timeout)
+{
+    Phase phase(*this, line, name);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(timeout);
+    while (!is_ready())
+    {
+        if (std::chrono::steady_clock::now() >= deadline)
+            return false;
+
+        std::this_thread::sleep_for(std::chrono::duration<double>(READINESS_POLL_PERIOD));
+    }
+
+    return true;
+}
+
+/**
+ * @brief StartupTimeline::getTotalDuration
+ * @return time between the creation of the timeline and the end of the last phase, in ms
+ */
+double StartupTimeline::getTotalDuration() const
+{
+    std::lock_guard<std::mutex> lck(_mutex);
+
+    double total{0.0};
+    for (auto const &phase : _phases)
+        total = std::max(total, phase.start_ms + phase.duration_ms);
+
+    return total;
+}
+
+/**
+ * @brief StartupTimeline::str : one line per phase, sorted by start time
+ * @return
+ */
+std::string StartupTimeline::str() const
+{
+    std::vector<PhaseRecord> phases;
+    {
+        std::lock_guard<std::mutex> lck(_mutex);
+        phases = _phases;
+    }
+
+    std::sort(phases.begin(), phases.end(), [](const PhaseRecord &a, const PhaseRecord &b) { return a.start_ms < b.start_ms; });
+
+    std::string res;
+    char line[160];
+    for (auto const &phase : phases)
+    {
+        snprintf(line, sizeof(line), "\n  [%-6s] %-32s start %8.1f ms  duration %8.1f ms", phase.line.c_str(), phase.name.c_str(), phase.start_ms, phase.duration_ms);
+        res += line;
+    }
+
+    return res;
+}
+
+} // namespace niryo_robot_hardware_interface
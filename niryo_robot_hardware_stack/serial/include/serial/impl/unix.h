@@ -84,6 +84,8 @@ class serial::Serial::SerialImpl
 
     void waitByteTimes(size_t count);
 
+    bool waitTransmitted(uint32_t timeout_ns);
+
     size_t read(uint8_t *buf, size_t size = 1);
 
     size_t write(const uint8_t *data, size_t length);
@@ -102,6 +104,10 @@ class serial::Serial::SerialImpl
 
     void setDTR(bool level);
 
+    bool setRS485(bool enable);
+
+    uint32_t setLowLatency();
+
     bool waitForChange();
 
     bool getCTS();
@@ -93,6 +93,18 @@ typedef enum
     flowcontrol_hardware
 } flowcontrol_t;
 
+/*!
+ * Enumeration defines the kernel latency settings of the real-time bus
+ * profile, see Serial::setLowLatency.
+ */
+typedef enum
+{
+    low_latency_none = 0,
+    low_latency_async = 1,       // ASYNC_LOW_LATENCY flag of the tty driver
+    low_latency_usb_timer = 2,   // latency timer of a USB-serial adapter at 1 ms
+    low_latency_rx_trigger = 4   // receive FIFO interrupt at the first byte
+} low_latency_t;
+
 /*!
  * Structure for setting the timeout of the serial port, times are
  * in milliseconds.
@@ -221,6 +233,15 @@ class Serial
      * port. */
     void waitByteTimes(size_t count);
 
+    /*! Block until the last byte written has left the transmitter, shift
+     * register included, polling the line status for at most timeout_ns.
+     * Unlike flush, it does not sleep for a whole scheduler tick when the
+     * UART FIFO is not empty yet. Falls back to tcdrain if the line status
+     * cannot be read or on timeout.
+     *
+     * \return false if it had to fall back to tcdrain on timeout. */
+    bool waitTransmitted(uint32_t timeout_ns);
+
     /*! Read a given amount of bytes from the serial port into a given buffer.
      *
      * The read function will return in one of three cases:
@@ -572,6 +593,25 @@ class Serial
     /*! Set the DTR handshaking line to the given level.  Defaults to true. */
     void setDTR(bool level = true);
 
+    /*!
+     * Let the driver drive RTS as the half-duplex direction of an RS-485
+     * transceiver: RTS is raised for each write and dropped as soon as the
+     * last stop bit is sent (TIOCSRS485 on Linux).
+     *
+     * \return false if the driver of the port does not support it.
+     */
+    bool setRS485(bool enable = true);
+
+    /*!
+     * Apply the real-time bus profile: the kernel settings reducing the
+     * delay between a byte received by the UART and its availability to
+     * read, where the driver of the port supports them. The settings stay
+     * applied until the port is reconfigured by another program.
+     *
+     * \return the settings which took effect, a combination of low_latency_t.
+     */
+    uint32_t setLowLatency();
+
     /*!
      * Blocks until CTS, DSR, RI, CD changes or something interrupts it.
      *
@@ -21,6 +21,10 @@
 
 #if defined(__linux__)
 # include <linux/serial.h>
+# include <fstream>
+# include <libgen.h>
+# include <limits.h>
+# include <stdlib.h>
 #endif
 
 #include <sys/select.h>
@@ -534,6 +538,41 @@ Serial::SerialImpl::waitByteTimes (size_t count)
   pselect (0, NULL, NULL, NULL, &wait_time, NULL);
 }
 
+bool
+Serial::SerialImpl::waitTransmitted (uint32_t timeout_ns)
+{
+  if (is_open_ == false) {
+    throw PortNotOpenedException ("Serial::waitTransmitted");
+  }
+
+#if defined(TIOCSERGETLSR) && defined(TIOCSER_TEMT)
+  timespec start, now;
+  clock_gettime (CLOCK_MONOTONIC, &start);
+
+  for (;;) {
+    unsigned int lsr = 0;
+    if (-1 == ioctl (fd_, TIOCSERGETLSR, &lsr)) {
+      break;
+    }
+    if (lsr & TIOCSER_TEMT) {
+      return true;
+    }
+
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    int64_t elapsed_ns = static_cast<int64_t>(now.tv_sec - start.tv_sec) * 1000000000 + (now.tv_nsec - start.tv_nsec);
+    if (elapsed_ns > timeout_ns) {
+      tcdrain (fd_);
+      return false;
+    }
+  }
+#else
+  (void)timeout_ns;
+#endif
+
+  tcdrain (fd_);
+  return true;
+}
+
 size_t
 Serial::SerialImpl::read (uint8_t *buf, size_t size)
 {
@@ -924,6 +963,90 @@ Serial::SerialImpl::setDTR (bool level)
   }
 }
 
+bool
+Serial::SerialImpl::setRS485 (bool enable)
+{
+  if (is_open_ == false) {
+    throw PortNotOpenedException ("Serial::setRS485");
+  }
+
+#if defined(__linux__) && defined(TIOCSRS485)
+  struct serial_rs485 rs485;
+  memset (&rs485, 0, sizeof (rs485));
+
+  if (enable) {
+    // RTS high while sending, low right after the last stop bit, no extra delay
+    rs485.flags = SER_RS485_ENABLED | SER_RS485_RTS_ON_SEND;
+  }
+
+  return -1 != ioctl (fd_, TIOCSRS485, &rs485);
+#else
+  return !enable;
+#endif
+}
+
+#if defined(__linux__)
+// write a sysfs attribute of the port, true if it reads back as written
+static bool
+writeSysfsAttribute (const string &path, const string &value)
+{
+  {
+    std::ofstream out (path.c_str());
+    if (!out) {
+      return false;
+    }
+    out << value;
+    if (!out.flush()) {
+      return false;
+    }
+  }
+
+  std::ifstream in (path.c_str());
+  string read_value;
+  return (in >> read_value) && read_value == value;
+}
+#endif
+
+uint32_t
+Serial::SerialImpl::setLowLatency ()
+{
+  if (is_open_ == false) {
+    throw PortNotOpenedException ("Serial::setLowLatency");
+  }
+
+  uint32_t applied = low_latency_none;
+
+#if defined(__linux__)
+  // push the received bytes to the line discipline at once instead of batching them
+  struct serial_struct ser;
+  if (-1 != ioctl (fd_, TIOCGSERIAL, &ser)) {
+    ser.flags |= ASYNC_LOW_LATENCY;
+    if (-1 != ioctl (fd_, TIOCSSERIAL, &ser) && -1 != ioctl (fd_, TIOCGSERIAL, &ser) &&
+        (ser.flags & ASYNC_LOW_LATENCY)) {
+      applied |= low_latency_async;
+    }
+  }
+
+  // the sysfs attributes are named after the tty, not after a link to it (/dev/serial0)
+  char real_port[PATH_MAX];
+  if (NULL != realpath (port_.c_str(), real_port)) {
+    string tty_name = basename (real_port);
+
+    // USB-serial adapters (FTDI) hold the received bytes up to 16 ms by default
+    if (writeSysfsAttribute ("/sys/bus/usb-serial/devices/" + tty_name + "/latency_timer", "1")) {
+      applied |= low_latency_usb_timer;
+    }
+
+    // 16550 like UARTs raise the receive interrupt when their FIFO reaches the trigger level
+    if (writeSysfsAttribute ("/sys/class/tty/" + tty_name + "/rx_trig_bytes", "1")) {
+      applied |= low_latency_rx_trigger;
+    }
+  }
+#endif
+
+  return applied;
+}
+
 bool
 Serial::SerialImpl::waitForChange ()
 {
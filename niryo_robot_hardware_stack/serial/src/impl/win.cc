@@ -327,6 +327,12 @@ Serial::SerialImpl::waitByteTimes (size_t /*count*/)
   THROW (IOException, "waitByteTimes is not implemented on Windows.");
 }
 
+bool
+Serial::SerialImpl::waitTransmitted (uint32_t /*timeout_ns*/)
+{
+  THROW (IOException, "waitTransmitted is not implemented on Windows.");
+}
+
 size_t
 Serial::SerialImpl::read (uint8_t *buf, size_t size)
 {
@@ -531,6 +537,26 @@ Serial::SerialImpl::setDTR (bool level)
   }
 }
 
+bool
+Serial::SerialImpl::setRS485 (bool enable)
+{
+  if (is_open_ == false) {
+    throw PortNotOpenedException ("Serial::setRS485");
+  }
+  // no driver direction control on Windows
+  return !enable;
+}
+
+uint32_t
+Serial::SerialImpl::setLowLatency ()
+{
+  if (is_open_ == false) {
+    throw PortNotOpenedException ("Serial::setLowLatency");
+  }
+  // the latency timer of USB adapters is set in the device manager on Windows
+  return low_latency_none;
+}
+
 bool
 Serial::SerialImpl::waitForChange ()
 {
@@ -114,6 +114,12 @@ Serial::waitByteTimes (size_t count)
   pimpl_->waitByteTimes(count);
 }
 
+bool
+Serial::waitTransmitted (uint32_t timeout_ns)
+{
+  return pimpl_->waitTransmitted(timeout_ns);
+}
+
 size_t
 Serial::read_ (uint8_t *buffer, size_t size)
 {
@@ -412,6 +418,16 @@ void Serial::setDTR (bool level)
   pimpl_->setDTR (level);
 }
 
+bool Serial::setRS485 (bool enable)
+{
+  return pimpl_->setRS485 (enable);
+}
+
+uint32_t Serial::setLowLatency ()
+{
+  return pimpl_->setLowLatency ();
+}
+
 bool Serial::waitForChange()
 {
   return pimpl_->waitForChange();
@@ -198,7 +198,7 @@ void ToolsInterfaceCore::initParameters(ros::NodeHandle &nh)
     for (auto const &tool : _available_tools_map)
     {
         ROS_DEBUG("ToolsInterfaceCore::initParameters - Available tools map: %d => %s (%s)", static_cast<int>(tool.first), tool.second.name.c_str(),
-                  HardwareTypeEnum(tool.second.type).toString().c_str());
+                  HardwareTypeEnum(tool.second.type).toString());
     }
 }
 
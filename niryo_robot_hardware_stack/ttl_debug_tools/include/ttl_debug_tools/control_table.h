@@ -0,0 +1,60 @@
+/*
+control_table.h
+Copyright (C) 2020 Niryo
+All rights reserved.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TTL_DEBUG_TOOLS_CONTROL_TABLE_H
+#define TTL_DEBUG_TOOLS_CONTROL_TABLE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ttl_debug_tools
+{
+
+/**
+ * @brief RegisterSpan : consecutive bytes of a control table
+ */
+struct RegisterSpan
+{
+    uint16_t address;
+    uint16_t length;
+};
+
+/**
+ * @brief The ControlTable struct describes how to dump and restore the control table of a device model,
+ * using the address maps of the ttl_driver package
+ * - dump_spans cover the whole EEPROM and RAM areas, with as few spans as possible
+ * - restore_spans cover only the writable configuration registers (not the id, baudrate, goals...),
+ * adjacent registers being merged to limit the number of writes
+ */
+struct ControlTable
+{
+    std::string name;
+    uint16_t torque_enable_address;
+    std::vector<RegisterSpan> dump_spans;
+    std::vector<RegisterSpan> restore_spans;
+};
+
+bool getControlTable(uint16_t model_number, ControlTable &table);
+
+std::vector<RegisterSpan> mergeSpans(std::vector<RegisterSpan> spans);
+
+}  // namespace ttl_debug_tools
+
+#endif  // TTL_DEBUG_TOOLS_CONTROL_TABLE_H
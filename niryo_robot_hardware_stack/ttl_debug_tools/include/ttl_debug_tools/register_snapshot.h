@@ -0,0 +1,83 @@
+/*
+register_snapshot.h
+Copyright (C) 2020 Niryo
+All rights reserved.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TTL_DEBUG_TOOLS_REGISTER_SNAPSHOT_H
+#define TTL_DEBUG_TOOLS_REGISTER_SNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ttl_debug_tools/control_table.h"
+
+namespace ttl_debug_tools
+{
+
+/**
+ * @brief The DeviceSnapshot struct : raw control table content of one device
+ */
+struct DeviceSnapshot
+{
+    struct Segment
+    {
+        uint16_t address;
+        std::vector<uint8_t> data;
+    };
+
+    uint8_t id;
+    uint16_t model_number;
+    std::vector<Segment> segments;
+
+    bool getBytes(const RegisterSpan &span, std::vector<uint8_t> &data) const;
+};
+
+/**
+ * @brief The RegisterSnapshot class holds the control tables of several devices.
+ * It is stored in a compact binary file (little endian):
+ * magic "NREG", version (1 byte), device count (2 bytes), then for each device
+ * id (1 byte), model number (2 bytes), segment count (1 byte), and for each segment
+ * address (2 bytes), length (2 bytes) and the raw bytes
+ */
+class RegisterSnapshot
+{
+  public:
+    void addSegment(uint8_t id, uint16_t model_number, uint16_t address, std::vector<uint8_t> data);
+
+    const std::vector<DeviceSnapshot> &getDevices() const;
+    size_t getSize() const;
+
+    std::vector<uint8_t> serialize() const;
+    bool deserialize(const std::vector<uint8_t> &buffer);
+
+    bool save(const std::string &file_path) const;
+    bool load(const std::string &file_path);
+
+  private:
+    std::vector<DeviceSnapshot> _devices;
+};
+
+/**
+ * @brief RegisterSnapshot::getDevices
+ * @return
+ */
+inline const std::vector<DeviceSnapshot> &RegisterSnapshot::getDevices() const { return _devices; }
+
+}  // namespace ttl_debug_tools
+
+#endif  // TTL_DEBUG_TOOLS_REGISTER_SNAPSHOT_H
@@ -20,16 +20,35 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef TTL_DEBUG_TOOLS_TTL_TOOLS_H
 #define TTL_DEBUG_TOOLS_TTL_TOOLS_H
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include "common/util/bus_capture.hpp"
+#include "common/util/latency_histogram.hpp"
 #include "dynamixel_sdk/dynamixel_sdk.h"
+#include "ttl_debug_tools/control_table.h"
+#include "ttl_debug_tools/register_snapshot.h"
 
 namespace ttl_debug_tools
 {
 
+/**
+ * @brief The ReplayReport struct : result of the replay of a capture
+ */
+struct ReplayReport
+{
+    uint32_t nb_instructions{0};
+    uint32_t nb_status{0};
+    uint32_t nb_errors{0};
+    double capture_duration_ms{0.0};
+    double replay_duration_ms{0.0};
+    double decode_duration_ms{0.0};
+};
+
 /**
  * @brief The TtlTools class
  */
@@ -38,21 +57,44 @@ class TtlTools
   public:
     TtlTools();
     TtlTools(std::shared_ptr<dynamixel::PortHandler> portHandler, std::shared_ptr<dynamixel::PacketHandler> packetHandler);
+    virtual ~TtlTools();
 
     int setupBus(int baudrate);
     void broadcastPing();
+    int scan(std::vector<uint8_t> &id_list);
     void ping(int id);
+    int benchmarkRoundTrip(uint8_t id, int nb_round_trips, common::util::LatencyHistogram &histogram);
     int setRegister(uint8_t id, uint16_t reg_address, uint32_t value, uint8_t byte_number);
     int getRegister(uint8_t id, uint16_t reg_address, uint32_t &value, uint8_t byte_number);
 
     int setRegisters(std::vector<uint8_t> ids, uint16_t reg_address, std::vector<uint32_t> values, uint8_t byte_number);
     int getRegisters(std::vector<uint8_t> ids, uint16_t reg_address, std::vector<uint32_t> &values, uint8_t byte_number);
 
+    int readSpan(const std::vector<uint8_t> &ids, const RegisterSpan &span, std::vector<std::vector<uint8_t>> &data_list);
+    int writeSpan(const std::vector<uint8_t> &ids, const RegisterSpan &span, const std::vector<std::vector<uint8_t>> &data_list);
+
+    int dumpRegisters(const std::vector<uint8_t> &ids, RegisterSnapshot &snapshot, int &nb_transactions);
+    int restoreRegisters(const RegisterSnapshot &snapshot, int &nb_transactions);
+
+    bool startCapture(const std::string &file_path);
+    uint32_t stopCapture();
+    int replay(const std::vector<common::util::CaptureRecord> &records, bool realtime, ReplayReport &report);
+
+    static size_t extractPackets(std::vector<uint8_t> &buffer, common::util::BusCaptureWriter &writer);
+
     void closePort();
 
+  private:
+    void captureLoop();
+
   protected:
     std::shared_ptr<dynamixel::PortHandler> _portHandler;
     std::shared_ptr<dynamixel::PacketHandler> _packetHandler;
+
+  private:
+    common::util::BusCaptureWriter _capture_writer;
+    std::thread _capture_thread;
+    std::atomic<bool> _capture_ok{false};
 };
 
 }  // namespace ttl_debug_tools
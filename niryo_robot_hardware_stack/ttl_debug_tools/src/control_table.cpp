@@ -0,0 +1,232 @@
+/*
+    control_table.cpp
+    Copyright (C) 2020 Niryo
+    All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#include "ttl_debug_tools/control_table.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "ttl_driver/end_effector_reg.hpp"
+#include "ttl_driver/stepper_reg.hpp"
+#include "ttl_driver/xc430_reg.hpp"
+#include "ttl_driver/xl320_reg.hpp"
+#include "ttl_driver/xl330_reg.hpp"
+#include "ttl_driver/xl430_reg.hpp"
+#include "ttl_driver/xm430_reg.hpp"
+
+namespace ttl_debug_tools
+{
+
+namespace
+{
+
+/**
+ * @brief span : span of one register of the given type
+ */
+template <typename T>
+RegisterSpan span(uint16_t address)
+{
+    return {address, static_cast<uint16_t>(sizeof(T))};
+}
+
+/**
+ * @brief spanTo : span from address to the end of the register at last_address (included)
+ */
+template <typename T>
+RegisterSpan spanTo(uint16_t address, uint16_t last_address)
+{
+    return {address, static_cast<uint16_t>(last_address + sizeof(T) - address)};
+}
+
+/**
+ * @brief xSeriesControlTable : the X series share the same control table layout
+ */
+template <typename reg>
+ControlTable xSeriesControlTable(const std::string &name, std::vector<RegisterSpan> extra_restore_spans)
+{
+    ControlTable table;
+    table.name = name;
+    table.torque_enable_address = reg::ADDR_TORQUE_ENABLE;
+
+    // EEPROM and RAM are contiguous
+    table.dump_spans = {spanTo<typename reg::TYPE_PRESENT_TEMPERATURE>(reg::ADDR_MODEL_NUMBER, reg::ADDR_PRESENT_TEMPERATURE)};
+
+    std::vector<RegisterSpan> restore_spans = {span<typename reg::TYPE_RETURN_DELAY_TIME>(reg::ADDR_RETURN_DELAY_TIME),
+                                               span<typename reg::TYPE_DRIVE_MODE>(reg::ADDR_DRIVE_MODE),
+                                               span<typename reg::TYPE_OPERATING_MODE>(reg::ADDR_OPERATING_MODE),
+                                               span<typename reg::TYPE_HOMING_OFFSET>(reg::ADDR_HOMING_OFFSET),
+                                               span<typename reg::TYPE_TEMPERATURE_LIMIT>(reg::ADDR_TEMPERATURE_LIMIT),
+                                               span<typename reg::TYPE_MAX_VOLTAGE_LIMIT>(reg::ADDR_MAX_VOLTAGE_LIMIT),
+                                               span<typename reg::TYPE_MIN_VOLTAGE_LIMIT>(reg::ADDR_MIN_VOLTAGE_LIMIT),
+                                               span<typename reg::TYPE_PWM_LIMIT>(reg::ADDR_PWM_LIMIT),
+                                               span<typename reg::TYPE_VELOCITY_LIMIT>(reg::ADDR_VELOCITY_LIMIT),
+                                               span<typename reg::TYPE_MAX_POSITION_LIMIT>(reg::ADDR_MAX_POSITION_LIMIT),
+                                               span<typename reg::TYPE_MIN_POSITION_LIMIT>(reg::ADDR_MIN_POSITION_LIMIT),
+                                               span<typename reg::TYPE_STARTUP_CONFIGURATION>(reg::ADDR_STARTUP_CONFIGURATION),
+                                               span<typename reg::TYPE_ALARM_SHUTDOWN>(reg::ADDR_ALARM_SHUTDOWN),
+                                               span<typename reg::TYPE_LED>(reg::ADDR_LED),
+                                               span<typename reg::TYPE_PID_GAIN>(reg::ADDR_VELOCITY_I_GAIN),
+                                               span<typename reg::TYPE_PID_GAIN>(reg::ADDR_VELOCITY_P_GAIN),
+                                               span<typename reg::TYPE_PID_GAIN>(reg::ADDR_POSITION_D_GAIN),
+                                               span<typename reg::TYPE_PID_GAIN>(reg::ADDR_POSITION_I_GAIN),
+                                               span<typename reg::TYPE_PID_GAIN>(reg::ADDR_POSITION_P_GAIN),
+                                               span<typename reg::TYPE_PID_GAIN>(reg::ADDR_FF2_GAIN),
+                                               span<typename reg::TYPE_PID_GAIN>(reg::ADDR_FF1_GAIN),
+                                               span<typename reg::TYPE_PROFILE>(reg::ADDR_PROFILE_ACCELERATION),
+                                               span<typename reg::TYPE_PROFILE>(reg::ADDR_PROFILE_VELOCITY)};
+
+    restore_spans.insert(restore_spans.end(), extra_restore_spans.begin(), extra_restore_spans.end());
+    table.restore_spans = mergeSpans(std::move(restore_spans));
+
+    return table;
+}
+
+/**
+ * @brief xl320ControlTable
+ */
+ControlTable xl320ControlTable()
+{
+    using reg = ttl_driver::XL320Reg;
+
+    ControlTable table;
+    table.name = "xl320";
+    table.torque_enable_address = reg::ADDR_TORQUE_ENABLE;
+    table.dump_spans = {spanTo<reg::TYPE_PUNCH>(reg::ADDR_MODEL_NUMBER, reg::ADDR_PUNCH)};
+    table.restore_spans = mergeSpans({span<reg::TYPE_RETURN_DELAY_TIME>(reg::ADDR_RETURN_DELAY_TIME),
+                                      span<reg::TYPE_CW_ANGLE_LIMIT>(reg::ADDR_CW_ANGLE_LIMIT),
+                                      span<reg::TYPE_CCW_ANGLE_LIMIT>(reg::ADDR_CCW_ANGLE_LIMIT),
+                                      span<reg::TYPE_CONTROL_MODE>(reg::ADDR_CONTROL_MODE),
+                                      span<reg::TYPE_TEMPERATURE_LIMIT>(reg::ADDR_TEMPERATURE_LIMIT),
+                                      span<reg::TYPE_MIN_VOLTAGE_LIMIT>(reg::ADDR_MIN_VOLTAGE_LIMIT),
+                                      span<reg::TYPE_MAX_VOLTAGE_LIMIT>(reg::ADDR_MAX_VOLTAGE_LIMIT),
+                                      span<reg::TYPE_MAX_TORQUE>(reg::ADDR_MAX_TORQUE),
+                                      span<reg::TYPE_ALARM_SHUTDOWN>(reg::ADDR_ALARM_SHUTDOWN),
+                                      span<reg::TYPE_LED>(reg::ADDR_LED),
+                                      span<reg::TYPE_PID_GAIN>(reg::ADDR_POSITION_D_GAIN),
+                                      span<reg::TYPE_PID_GAIN>(reg::ADDR_POSITION_I_GAIN),
+                                      span<reg::TYPE_PID_GAIN>(reg::ADDR_POSITION_P_GAIN),
+                                      span<reg::TYPE_PUNCH>(reg::ADDR_PUNCH)});
+    return table;
+}
+
+/**
+ * @brief stepperControlTable : the profile registers are far from the main table, hence two dump spans
+ */
+ControlTable stepperControlTable()
+{
+    using reg = ttl_driver::StepperReg;
+
+    ControlTable table;
+    table.name = "stepper";
+    table.torque_enable_address = reg::ADDR_TORQUE_ENABLE;
+    table.dump_spans = {spanTo<reg::TYPE_HOMING_ABS_POSITION>(reg::ADDR_MODEL_NUMBER, reg::ADDR_HOMING_ABS_POSITION),
+                        spanTo<reg::TYPE_PROFILE>(reg::ADDR_VSTART, reg::ADDR_VSTOP)};
+    table.restore_spans = mergeSpans({span<reg::TYPE_MAX_POSITION_LIMIT>(reg::ADDR_MAX_POSITION_LIMIT),
+                                      span<reg::TYPE_MIN_POSITION_LIMIT>(reg::ADDR_MIN_POSITION_LIMIT),
+                                      span<reg::TYPE_HOMING_DIRECTION>(reg::ADDR_HOMING_DIRECTION),
+                                      span<reg::TYPE_HOMING_STALL_THRESHOLD>(reg::ADDR_HOMING_STALL_THRESHOLD),
+                                      span<reg::TYPE_HOMING_ABS_POSITION>(reg::ADDR_HOMING_ABS_POSITION),
+                                      spanTo<reg::TYPE_PROFILE>(reg::ADDR_VSTART, reg::ADDR_VSTOP)});
+    return table;
+}
+
+/**
+ * @brief endEffectorControlTable : the end effector has no torque, its address is kept to 0 (not used)
+ */
+ControlTable endEffectorControlTable()
+{
+    using reg = ttl_driver::EndEffectorReg;
+
+    ControlTable table;
+    table.name = "end_effector";
+    table.torque_enable_address = 0;
+    table.dump_spans = {spanTo<reg::TYPE_PRESENT_TEMPERATURE>(reg::ADDR_MODEL_NUMBER, reg::ADDR_PRESENT_TEMPERATURE),
+                        spanTo<reg::TYPE_ACCELERO_VALUE_Z>(reg::ADDR_BUTTON_0_STATUS, reg::ADDR_ACCELERO_VALUE_Z)};
+    table.restore_spans = {span<reg::TYPE_COLLISION_THRESHOLD>(reg::ADDR_COLLISION_THRESHOLD)};
+    return table;
+}
+
+}  // namespace
+
+/**
+ * @brief getControlTable
+ * @param model_number : as read at address 0 of any device
+ * @param table
+ * @return false if the model is unknown
+ */
+bool getControlTable(uint16_t model_number, ControlTable &table)
+{
+    switch (model_number)
+    {
+    case ttl_driver::XL320Reg::MODEL_NUMBER:
+        table = xl320ControlTable();
+        break;
+    case ttl_driver::XL430Reg::MODEL_NUMBER:
+        table = xSeriesControlTable<ttl_driver::XL430Reg>("xl430", {});
+        break;
+    case ttl_driver::XC430Reg::MODEL_NUMBER:
+        table = xSeriesControlTable<ttl_driver::XC430Reg>("xc430", {});
+        break;
+    case ttl_driver::XM430Reg::MODEL_NUMBER:
+        table = xSeriesControlTable<ttl_driver::XM430Reg>("xm430", {span<ttl_driver::XM430Reg::TYPE_CURRENT_LIMIT>(ttl_driver::XM430Reg::ADDR_CURRENT_LIMIT)});
+        break;
+    case ttl_driver::XL330Reg::MODEL_NUMBER:
+        table = xSeriesControlTable<ttl_driver::XL330Reg>("xl330", {span<ttl_driver::XL330Reg::TYPE_CURRENT_LIMIT>(ttl_driver::XL330Reg::ADDR_CURRENT_LIMIT)});
+        break;
+    case ttl_driver::StepperReg::MODEL_NUMBER:
+        table = stepperControlTable();
+        break;
+    case ttl_driver::EndEffectorReg::MODEL_NUMBER:
+        table = endEffectorControlTable();
+        break;
+    default:
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief mergeSpans : sort the spans and merge the adjacent or overlapping ones
+ * @param spans
+ * @return
+ */
+std::vector<RegisterSpan> mergeSpans(std::vector<RegisterSpan> spans)
+{
+    std::sort(spans.begin(), spans.end(), [](const RegisterSpan &a, const RegisterSpan &b) { return a.address < b.address; });
+
+    std::vector<RegisterSpan> merged;
+    for (auto const &s : spans)
+    {
+        if (!merged.empty() && s.address <= merged.back().address + merged.back().length)
+        {
+            auto end = std::max(merged.back().address + merged.back().length, s.address + s.length);
+            merged.back().length = static_cast<uint16_t>(end - merged.back().address);
+        }
+        else
+        {
+            merged.push_back(s);
+        }
+    }
+
+    return merged;
+}
+
+}  // namespace ttl_debug_tools
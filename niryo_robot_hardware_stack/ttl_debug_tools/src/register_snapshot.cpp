@@ -0,0 +1,234 @@
+/*
+    register_snapshot.cpp
+    Copyright (C) 2020 Niryo
+    All rights reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#include "ttl_debug_tools/register_snapshot.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace ttl_debug_tools
+{
+
+namespace
+{
+constexpr char MAGIC[4] = {'N', 'R', 'E', 'G'};
+constexpr uint8_t VERSION = 1;
+
+void putU16(std::vector<uint8_t> &buffer, uint16_t value)
+{
+    buffer.push_back(static_cast<uint8_t>(value & 0xFF));
+    buffer.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+/**
+ * @brief The Reader struct : bounds checked reading of a buffer
+ */
+struct Reader
+{
+    const std::vector<uint8_t> &buffer;
+    size_t pos;
+
+    bool u8(uint8_t &value)
+    {
+        if (pos + 1 > buffer.size())
+            return false;
+        value = buffer[pos++];
+        return true;
+    }
+
+    bool u16(uint16_t &value)
+    {
+        if (pos + 2 > buffer.size())
+            return false;
+        value = static_cast<uint16_t>(buffer[pos] | (buffer[pos + 1] << 8));
+        pos += 2;
+        return true;
+    }
+
+    bool bytes(size_t length, std::vector<uint8_t> &data)
+    {
+        if (pos + length > buffer.size())
+            return false;
+        data.assign(buffer.begin() + static_cast<std::ptrdiff_t>(pos), buffer.begin() + static_cast<std::ptrdiff_t>(pos + length));
+        pos += length;
+        return true;
+    }
+};
+}  // namespace
+
+/**
+ * @brief DeviceSnapshot::getBytes
+ * @param span
+ * @param data
+ * @return false if the span is not fully contained in a dumped segment
+ */
+bool DeviceSnapshot::getBytes(const RegisterSpan &span, std::vector<uint8_t> &data) const
+{
+    for (auto const &segment : segments)
+    {
+        if (span.address >= segment.address && span.address + span.length <= segment.address + segment.data.size())
+        {
+            auto begin = segment.data.begin() + (span.address - segment.address);
+            data.assign(begin, begin + span.length);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief RegisterSnapshot::addSegment
+ * @param id
+ * @param model_number
+ * @param address
+ * @param data
+ */
+void RegisterSnapshot::addSegment(uint8_t id, uint16_t model_number, uint16_t address, std::vector<uint8_t> data)
+{
+    auto it = std::find_if(_devices.begin(), _devices.end(), [id](const DeviceSnapshot &device) { return device.id == id; });
+    if (it == _devices.end())
+    {
+        _devices.push_back({id, model_number, {}});
+        it = std::prev(_devices.end());
+    }
+
+    it->segments.push_back({address, std::move(data)});
+}
+
+/**
+ * @brief RegisterSnapshot::getSize
+ * @return number of register bytes in the snapshot
+ */
+size_t RegisterSnapshot::getSize() const
+{
+    size_t size = 0;
+    for (auto const &device : _devices)
+    {
+        for (auto const &segment : device.segments)
+            size += segment.data.size();
+    }
+
+    return size;
+}
+
+/**
+ * @brief RegisterSnapshot::serialize
+ * @return
+ */
+std::vector<uint8_t> RegisterSnapshot::serialize() const
+{
+    std::vector<uint8_t> buffer(std::begin(MAGIC), std::end(MAGIC));
+    buffer.push_back(VERSION);
+    putU16(buffer, static_cast<uint16_t>(_devices.size()));
+
+    for (auto const &device : _devices)
+    {
+        buffer.push_back(device.id);
+        putU16(buffer, device.model_number);
+        buffer.push_back(static_cast<uint8_t>(device.segments.size()));
+
+        for (auto const &segment : device.segments)
+        {
+            putU16(buffer, segment.address);
+            putU16(buffer, static_cast<uint16_t>(segment.data.size()));
+            buffer.insert(buffer.end(), segment.data.begin(), segment.data.end());
+        }
+    }
+
+    return buffer;
+}
+
+/**
+ * @brief RegisterSnapshot::deserialize
+ * @param buffer
+ * @return false if the buffer is not a valid snapshot, the snapshot is then left unchanged
+ */
+bool RegisterSnapshot::deserialize(const std::vector<uint8_t> &buffer)
+{
+    if (buffer.size() < sizeof(MAGIC) || !std::equal(std::begin(MAGIC), std::end(MAGIC), buffer.begin()))
+        return false;
+
+    Reader reader{buffer, sizeof(MAGIC)};
+
+    uint8_t version{0};
+    uint16_t nb_devices{0};
+    if (!reader.u8(version) || VERSION != version || !reader.u16(nb_devices))
+        return false;
+
+    std::vector<DeviceSnapshot> devices(nb_devices);
+    for (auto &device : devices)
+    {
+        uint8_t nb_segments{0};
+        if (!reader.u8(device.id) || !reader.u16(device.model_number) || !reader.u8(nb_segments))
+            return false;
+
+        device.segments.resize(nb_segments);
+        for (auto &segment : device.segments)
+        {
+            uint16_t length{0};
+            if (!reader.u16(segment.address) || !reader.u16(length) || !reader.bytes(length, segment.data))
+                return false;
+        }
+    }
+
+    if (reader.pos != buffer.size())
+        return false;
+
+    _devices = std::move(devices);
+    return true;
+}
+
+/**
+ * @brief RegisterSnapshot::save
+ * @param file_path
+ * @return
+ */
+bool RegisterSnapshot::save(const std::string &file_path) const
+{
+    std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+        return false;
+
+    auto buffer = serialize();
+    file.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+
+    return file.good();
+}
+
+/**
+ * @brief RegisterSnapshot::load
+ * @param file_path
+ * @return
+ */
+bool RegisterSnapshot::load(const std::string &file_path)
+{
+    std::ifstream file(file_path, std::ios::binary);
+    if (!file.is_open())
+        return false;
+
+    std::vector<uint8_t> buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    return deserialize(buffer);
+}
+
+}  // namespace ttl_debug_tools
@@ -32,8 +32,11 @@
 #include <vector>
 
 // niryo
+#include "common/util/bus_capture.hpp"
 #include "dynamixel_sdk/dynamixel_sdk.h"
+#include "dynamixel_sdk/port_handler_linux.h"
 #include "ttl_debug_tools/ttl_tools.h"
+#include "ttl_driver/replay_port_handler.hpp"
 
 #define PROTOCOL_VERSION 2.0
 
@@ -46,6 +49,9 @@
 // - scan
 // - ping specific ID
 // - set register
+// - dump and restore the control tables
+// - capture the traffic of the bus and replay it
+// - benchmark the round trip of a device
 
 namespace po = boost::program_options;
 
@@ -76,7 +82,14 @@ int handleUserInput(int argc, char **argv)
             "calibrate", "calibrate joints")("test", "a test movement")("set-register", po::value<std::vector<int>>()->multitoken(),
                                                                         "Set a value to a register (args: reg_addr, value, size)")(
             "set-registers", po::value<std::vector<int>>()->multitoken(), "Set the values to a register for multiples devices (args: reg_addr, size, values)")(
-            "get-registers", po::value<int>()->multitoken(), "get the values of a register for multiples devices (arg: reg_addr)");
+            "get-registers", po::value<int>()->multitoken(), "get the values of a register for multiples devices (arg: reg_addr)")(
+            "dump-registers", po::value<std::string>(), "Save the control tables of the devices (--ids, or all devices found) in a file (arg: file)")(
+            "restore-registers", po::value<std::string>(), "Write back the configuration registers saved in a file (arg: file)")(
+            "capture", po::value<std::string>(), "Record all the packets seen on the bus until Enter is pressed, without sending anything (arg: file)")(
+            "replay", po::value<std::string>(), "Replay a capture through an emulated port and decode its status packets (arg: file)")(
+            "realtime", "Keep the timing of the capture (for replay only)")(
+            "direction", po::value<std::string>()->default_value("gpio_sleep"), "Half-duplex direction control: gpio_sleep, gpio_drain or rs485")(
+            "benchmark", po::value<int>(), "Time round trips (pings) with the device given by --id (arg: number of round trips)");
 
         // po::positional_options_description p;
         // p.add("set-register", 3);
@@ -110,8 +123,37 @@ int handleUserInput(int argc, char **argv)
 
         std::cout << "Using baudrate: " << baudrate << ", port: " << serial_port << "\n";
 
-        // Setup TTL communication
-        std::shared_ptr<dynamixel::PortHandler> portHandler(dynamixel::PortHandler::getPortHandler(serial_port.c_str()));
+        // Setup TTL communication, on the emulated port for a replay
+        std::shared_ptr<dynamixel::PortHandler> portHandler;
+        std::vector<common::util::CaptureRecord> records;
+        if (vars.count("replay"))
+        {
+            std::string file_path = vars["replay"].as<std::string>();
+            common::util::BusCaptureReader reader;
+            if (!reader.open(file_path) || common::model::EBusProtocol::TTL != reader.getProtocol() || !reader.readAll(records))
+            {
+                printf("Failed to read a TTL capture from %s\n", file_path.c_str());
+                return -1;
+            }
+
+            auto replay_port = std::make_shared<ttl_driver::ReplayPortHandler>(vars.count("realtime") > 0);
+            replay_port->setRecords(records);
+            portHandler = replay_port;
+        }
+        else
+        {
+            portHandler.reset(dynamixel::PortHandler::getPortHandler(serial_port.c_str()));
+
+            dynamixel::PortHandlerLinux::DirectionControl direction_control;
+            auto linux_port = std::dynamic_pointer_cast<dynamixel::PortHandlerLinux>(portHandler);
+            if (!dynamixel::PortHandlerLinux::parseDirectionControl(vars["direction"].as<std::string>(), direction_control))
+            {
+                printf("Unknown direction control %s\n", vars["direction"].as<std::string>().c_str());
+                return -1;
+            }
+            if (linux_port)
+                linux_port->setDirectionControl(direction_control);
+        }
 
         std::shared_ptr<dynamixel::PacketHandler> packetHandler(dynamixel::PacketHandler::getPacketHandler(PROTOCOL_VERSION));
 
@@ -184,6 +226,89 @@ int handleUserInput(int argc, char **argv)
                 std::this_thread::sleep_for(std::chrono::milliseconds(10));
                 printf("pos %d\n", pos);
             }
+            else if (vars.count("dump-registers"))  // dump-registers
+            {
+                std::string file_path = vars["dump-registers"].as<std::string>();
+                auto start = std::chrono::steady_clock::now();
+
+                if (ids.empty() && COMM_SUCCESS != ttlTools.scan(ids))
+                    printf("Failed to scan the TTL bus\n");
+
+                ttl_debug_tools::RegisterSnapshot snapshot;
+                int nb_transactions = 0;
+                comm_result = ttlTools.dumpRegisters(ids, snapshot, nb_transactions);
+                double duration_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+                if (COMM_SUCCESS != comm_result)
+                    printf("Some registers could not be read: %d\n", comm_result);
+
+                for (auto const &device : snapshot.getDevices())
+                    printf("- id %d, model %d, %d segment(s)\n", device.id, device.model_number, static_cast<int>(device.segments.size()));
+
+                printf("Read %d bytes of %d devices in %d transactions, %.1f ms\n", static_cast<int>(snapshot.getSize()), static_cast<int>(snapshot.getDevices().size()),
+                       nb_transactions, duration_ms);
+
+                if (snapshot.save(file_path))
+                    printf("Snapshot saved in %s\n", file_path.c_str());
+                else
+                    printf("Failed to save snapshot in %s\n", file_path.c_str());
+            }
+            else if (vars.count("restore-registers"))  // restore-registers
+            {
+                std::string file_path = vars["restore-registers"].as<std::string>();
+
+                ttl_debug_tools::RegisterSnapshot snapshot;
+                if (!snapshot.load(file_path))
+                {
+                    printf("Failed to load snapshot from %s\n", file_path.c_str());
+                }
+                else
+                {
+                    auto start = std::chrono::steady_clock::now();
+                    int nb_transactions = 0;
+                    comm_result = ttlTools.restoreRegisters(snapshot, nb_transactions);
+                    double duration_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+                    if (COMM_SUCCESS != comm_result)
+                        printf("Failed to restore some registers: %d\n", comm_result);
+                    else
+                        printf("Registers of %d devices restored (torque disabled)\n", static_cast<int>(snapshot.getDevices().size()));
+
+                    printf("Restore done in %d transactions, %.1f ms\n", nb_transactions, duration_ms);
+                }
+            }
+            else if (vars.count("capture"))  // capture
+            {
+                std::string file_path = vars["capture"].as<std::string>();
+                if (ttlTools.startCapture(file_path))
+                {
+                    auto start = std::chrono::steady_clock::now();
+                    printf("--> Capturing TTL bus in %s\n", file_path.c_str());
+                    std::cout << "Press Enter to Exit" << std::endl;
+                    std::cin.get();
+
+                    uint32_t nb_records = ttlTools.stopCapture();
+                    double duration_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                    printf("%u packets captured in %.1f s (%.0f packets/s)\n", nb_records, duration_s, nb_records / duration_s);
+                }
+                else
+                {
+                    printf("Failed to create capture file %s\n", file_path.c_str());
+                }
+            }
+            else if (vars.count("replay"))  // replay
+            {
+                auto replay_port = std::static_pointer_cast<ttl_driver::ReplayPortHandler>(portHandler);
+
+                printf("--> Replaying %d records\n", static_cast<int>(records.size()));
+                ttl_debug_tools::ReplayReport report;
+                comm_result = ttlTools.replay(records, vars.count("realtime") > 0, report);
+
+                printf("%u instructions (%u found in the capture), %u status decoded, %u errors\n", report.nb_instructions, replay_port->getMatchedCount(),
+                       report.nb_status, report.nb_errors);
+                printf("Capture duration %.1f ms, replay duration %.1f ms, decoding %.3f ms (%.2f us/status)\n", report.capture_duration_ms,
+                       report.replay_duration_ms, report.decode_duration_ms, report.nb_status ? 1000.0 * report.decode_duration_ms / report.nb_status : 0.0);
+            }
             else if (-1 == id && ids.empty())
             {
                 printf("Ping: you need to give an ID! (--id or --ids)\n");
@@ -195,6 +320,29 @@ int handleUserInput(int argc, char **argv)
                     printf("--> PING Motor (ID: %d)\n", id);
                     ttlTools.ping(id);
                 }
+                else if (vars.count("benchmark"))  // benchmark
+                {
+                    int nb_round_trips = vars["benchmark"].as<int>();
+                    auto linux_port = std::dynamic_pointer_cast<dynamixel::PortHandlerLinux>(portHandler);
+                    const char *direction_names[] = {"gpio_sleep", "gpio_drain", "rs485"};
+
+                    printf("--> BENCHMARK %d round trips (ID: %d, direction control: %s)\n", nb_round_trips, id,
+                           linux_port ? direction_names[linux_port->getDirectionControl()] : "none");
+                    if (linux_port)
+                    {
+                        uint32_t low_latency = linux_port->getLowLatencySettings();
+                        printf("Low latency settings: async low latency %s, usb latency timer %s, rx fifo trigger %s\n",
+                               (low_latency & serial::low_latency_async) ? "on" : "n/a", (low_latency & serial::low_latency_usb_timer) ? "on" : "n/a",
+                               (low_latency & serial::low_latency_rx_trigger) ? "on" : "n/a");
+                    }
+
+                    common::util::LatencyHistogram histogram(10, 1000);
+                    int nb_failures = ttlTools.benchmarkRoundTrip(static_cast<uint8_t>(id), nb_round_trips, histogram);
+
+                    printf("%s, %d failures\n", histogram.str().c_str(), nb_failures);
+                    if (linux_port)
+                        printf("Status timeout margin learnt: %.0f us\n", linux_port->getStatusLatencyMarginUs());
+                }
                 else if (vars.count("set-register"))  // set-register
                 {
                     std::vector<int> params = vars["set-register"].as<std::vector<int>>();
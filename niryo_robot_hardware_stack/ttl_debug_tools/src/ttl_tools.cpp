@@ -17,7 +17,12 @@
     along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <map>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -27,6 +32,19 @@
 namespace ttl_debug_tools
 {
 
+namespace
+{
+// protocol 2.0 packet : header (0xFF 0xFF 0xFD 0x00), id, length (2 bytes), instruction, params, crc (2 bytes)
+constexpr std::array<uint8_t, 3> PKT_HEADER{{0xFF, 0xFF, 0xFD}};
+constexpr size_t PKT_ID = 4;
+constexpr size_t PKT_LENGTH_L = 5;
+constexpr size_t PKT_LENGTH_H = 6;
+constexpr size_t PKT_INSTRUCTION = 7;
+constexpr size_t PKT_HEADER_SIZE = 7;
+
+constexpr size_t RX_PACKET_MAX_LEN = 1024;
+}  // namespace
+
 /**
  * @brief TtlTools::TtlTools
  */
@@ -42,6 +60,11 @@ TtlTools::TtlTools(std::shared_ptr<dynamixel::PortHandler> portHandler, std::sha
 {
 }
 
+/**
+ * @brief TtlTools::~TtlTools
+ */
+TtlTools::~TtlTools() { stopCapture(); }
+
 /**
  * @brief TtlTools::setupTtlBus
  * @param baudrate
@@ -86,6 +109,17 @@ void TtlTools::broadcastPing()
     }
 }
 
+/**
+ * @brief TtlTools::scan
+ * @param id_list
+ * @return
+ */
+int TtlTools::scan(std::vector<uint8_t> &id_list)
+{
+    id_list.clear();
+    return _packetHandler->broadcastPing(_portHandler.get(), id_list);
+}
+
 /**
  * @brief TtlTools::ping
  * @param id
@@ -111,6 +145,35 @@ void TtlTools::ping(int id)
     }
 }
 
+/**
+ * @brief TtlTools::benchmarkRoundTrip : time consecutive pings of a device, from the instruction sent to the status received
+ * @param id
+ * @param nb_round_trips
+ * @param histogram : durations of the successful round trips
+ * @return number of failed round trips
+ */
+int TtlTools::benchmarkRoundTrip(uint8_t id, int nb_round_trips, common::util::LatencyHistogram &histogram)
+{
+    int nb_failures = 0;
+
+    for (int i = 0; i < nb_round_trips; ++i)
+    {
+        uint8_t error = 0;
+        uint16_t model_number = 0;
+
+        auto start = common::util::LatencyHistogram::Clock::now();
+        int comm_result = _packetHandler->ping(_portHandler.get(), id, &model_number, &error);
+        auto duration = common::util::LatencyHistogram::Clock::now() - start;
+
+        if (COMM_SUCCESS == comm_result)
+            histogram.record(duration);
+        else
+            nb_failures++;
+    }
+
+    return nb_failures;
+}
+
 /**
  * @brief TtlTools::setRegister
  * @param id
@@ -311,6 +374,391 @@ int TtlTools::getRegisters(std::vector<uint8_t> ids, uint16_t reg_address, std::
     return dxl_comm_result;
 }
 
+/**
+ * @brief TtlTools::readSpan : read consecutive bytes on several devices with one sync read
+ * @param ids
+ * @param span
+ * @param data_list : raw bytes for each id
+ * @return
+ */
+int TtlTools::readSpan(const std::vector<uint8_t> &ids, const RegisterSpan &span, std::vector<std::vector<uint8_t>> &data_list)
+{
+    data_list.clear();
+
+    dynamixel::GroupSyncRead groupSyncRead(_portHandler.get(), _packetHandler.get(), span.address, span.length);
+
+    for (auto const &id : ids)
+    {
+        if (!groupSyncRead.addParam(id))
+        {
+            groupSyncRead.clearParam();
+            return COMM_RX_FAIL;
+        }
+    }
+
+    int dxl_comm_result = groupSyncRead.txRxPacket();
+
+    if (COMM_SUCCESS == dxl_comm_result)
+    {
+        for (auto const &id : ids)
+        {
+            if (!groupSyncRead.isAvailable(id, span.address, span.length))
+            {
+                dxl_comm_result = COMM_RX_FAIL;
+                break;
+            }
+
+            std::vector<uint8_t> data;
+            data.reserve(span.length);
+            for (uint16_t i = 0; i < span.length; ++i)
+                data.push_back(static_cast<uint8_t>(groupSyncRead.getData(id, static_cast<uint16_t>(span.address + i), 1)));
+
+            data_list.emplace_back(std::move(data));
+        }
+    }
+
+    groupSyncRead.clearParam();
+
+    return dxl_comm_result;
+}
+
+/**
+ * @brief TtlTools::writeSpan : write consecutive bytes on several devices with one sync write
+ * @param ids
+ * @param span
+ * @param data_list : raw bytes for each id, of size span.length
+ * @return
+ */
+int TtlTools::writeSpan(const std::vector<uint8_t> &ids, const RegisterSpan &span, const std::vector<std::vector<uint8_t>> &data_list)
+{
+    if (ids.empty())
+        return COMM_SUCCESS;
+
+    if (ids.size() != data_list.size())
+        return COMM_TX_ERROR;
+
+    dynamixel::GroupSyncWrite groupSyncWrite(_portHandler.get(), _packetHandler.get(), span.address, span.length);
+
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+        std::vector<uint8_t> params = data_list.at(i);
+        if (params.size() != span.length || !groupSyncWrite.addParam(ids.at(i), params.data()))
+        {
+            groupSyncWrite.clearParam();
+            return COMM_TX_ERROR;
+        }
+    }
+
+    int dxl_comm_result = groupSyncWrite.txPacket();
+    groupSyncWrite.clearParam();
+
+    return dxl_comm_result;
+}
+
+/**
+ * @brief TtlTools::dumpRegisters : read the whole control table of the given devices.
+ * Devices are grouped by model, so that each dump span of a model is read with one sync read
+ * @param ids
+ * @param snapshot
+ * @param nb_transactions : number of bus transactions used
+ * @return
+ */
+int TtlTools::dumpRegisters(const std::vector<uint8_t> &ids, RegisterSnapshot &snapshot, int &nb_transactions)
+{
+    nb_transactions = 0;
+
+    // 1. model numbers, all at address 0 on 2 bytes
+    std::vector<uint32_t> models;
+    ++nb_transactions;
+    if (COMM_SUCCESS != getRegisters(ids, 0, models, 2))
+    {
+        // a missing device makes the sync read fail, find the answering ones
+        models.clear();
+        for (auto const id : ids)
+        {
+            uint32_t model{0};
+            ++nb_transactions;
+            models.push_back(COMM_SUCCESS == getRegister(id, 0, model, 2) ? model : 0);
+        }
+    }
+
+    std::map<uint16_t, std::vector<uint8_t>> ids_by_model;
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+        if (0 == models.at(i))
+            printf("Device %d not answering, skipped\n", ids.at(i));
+        else
+            ids_by_model[static_cast<uint16_t>(models.at(i))].push_back(ids.at(i));
+    }
+
+    // 2. control tables, one sync read per span and model
+    int result = COMM_SUCCESS;
+    for (auto const &it : ids_by_model)
+    {
+        ControlTable table;
+        if (!getControlTable(it.first, table))
+        {
+            printf("Unknown model number %d, devices skipped\n", it.first);
+            continue;
+        }
+
+        for (auto const &span : table.dump_spans)
+        {
+            std::vector<std::vector<uint8_t>> data_list;
+            ++nb_transactions;
+            int res = readSpan(it.second, span, data_list);
+            if (COMM_SUCCESS != res)
+            {
+                printf("Failed to read %s registers [%d, %d]: %d\n", table.name.c_str(), span.address, span.address + span.length - 1, res);
+                result = res;
+                continue;
+            }
+
+            for (size_t i = 0; i < it.second.size(); ++i)
+                snapshot.addSegment(it.second.at(i), it.first, span.address, std::move(data_list.at(i)));
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief TtlTools::restoreRegisters : write back the configuration registers of a snapshot.
+ * For each model, the torque is disabled (needed to write in EEPROM) and each restore span is written
+ * to all the devices of this model with one sync write. The torque is left disabled
+ * @param snapshot
+ * @param nb_transactions : number of bus transactions used
+ * @return
+ */
+int TtlTools::restoreRegisters(const RegisterSnapshot &snapshot, int &nb_transactions)
+{
+    nb_transactions = 0;
+
+    std::map<uint16_t, std::vector<const DeviceSnapshot *>> devices_by_model;
+    for (auto const &device : snapshot.getDevices())
+        devices_by_model[device.model_number].push_back(&device);
+
+    int result = COMM_SUCCESS;
+    for (auto const &it : devices_by_model)
+    {
+        ControlTable table;
+        if (!getControlTable(it.first, table))
+        {
+            printf("Unknown model number %d, devices skipped\n", it.first);
+            continue;
+        }
+
+        std::vector<uint8_t> ids;
+        for (auto const *device : it.second)
+            ids.push_back(device->id);
+
+        if (0 != table.torque_enable_address)
+        {
+            ++nb_transactions;
+            int res = setRegisters(ids, table.torque_enable_address, std::vector<uint32_t>(ids.size(), 0), 1);
+            if (COMM_SUCCESS != res)
+            {
+                printf("Failed to disable torque on %s devices: %d\n", table.name.c_str(), res);
+                result = res;
+                continue;
+            }
+        }
+
+        for (auto const &span : table.restore_spans)
+        {
+            std::vector<uint8_t> span_ids;
+            std::vector<std::vector<uint8_t>> data_list;
+            for (auto const *device : it.second)
+            {
+                std::vector<uint8_t> data;
+                if (device->getBytes(span, data))
+                {
+                    span_ids.push_back(device->id);
+                    data_list.emplace_back(std::move(data));
+                }
+            }
+
+            if (span_ids.empty())
+                continue;
+
+            ++nb_transactions;
+            int res = writeSpan(span_ids, span, data_list);
+            if (COMM_SUCCESS != res)
+            {
+                printf("Failed to write %s registers [%d, %d]: %d\n", table.name.c_str(), span.address, span.address + span.length - 1, res);
+                result = res;
+            }
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief TtlTools::startCapture : listen to the bus without sending anything, and record every packet seen
+ * The port must be a second access to the bus (a sniffer adapter), as the robot keeps driving it
+ * @param file_path
+ * @return
+ */
+bool TtlTools::startCapture(const std::string &file_path)
+{
+    if (_capture_ok || !_capture_writer.open(file_path, common::model::EBusProtocol::TTL))
+        return false;
+
+    _portHandler->clearPort();
+    _capture_ok = true;
+    _capture_thread = std::thread(&TtlTools::captureLoop, this);
+
+    return true;
+}
+
+/**
+ * @brief TtlTools::stopCapture
+ * @return number of records captured
+ */
+uint32_t TtlTools::stopCapture()
+{
+    _capture_ok = false;
+    if (_capture_thread.joinable())
+        _capture_thread.join();
+
+    _capture_writer.close();
+    return _capture_writer.getRecordCount();
+}
+
+/**
+ * @brief TtlTools::captureLoop : the port is polled without blocking, packets are timestamped as soon as they are complete
+ */
+void TtlTools::captureLoop()
+{
+    std::array<uint8_t, RX_PACKET_MAX_LEN> rx{};
+    std::vector<uint8_t> buffer;
+    buffer.reserve(4 * RX_PACKET_MAX_LEN);
+
+    while (_capture_ok)
+    {
+        int nb_bytes = _portHandler->readPort(rx.data(), static_cast<int>(rx.size()));
+        if (nb_bytes > 0)
+        {
+            buffer.insert(buffer.end(), rx.begin(), rx.begin() + nb_bytes);
+            extractPackets(buffer, _capture_writer);
+        }
+        else
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+}
+
+/**
+ * @brief TtlTools::extractPackets : record the complete packets at the beginning of the buffer and remove them.
+ * Bytes before a packet header are recorded as an error, an incomplete packet is kept for the next call
+ * @param buffer
+ * @param writer
+ * @return number of packets recorded
+ */
+size_t TtlTools::extractPackets(std::vector<uint8_t> &buffer, common::util::BusCaptureWriter &writer)
+{
+    size_t nb_packets = 0;
+    size_t pos = 0;
+
+    while (pos < buffer.size())
+    {
+        auto header = std::search(buffer.begin() + static_cast<std::ptrdiff_t>(pos), buffer.end(), PKT_HEADER.begin(), PKT_HEADER.end());
+        auto header_pos = static_cast<size_t>(header - buffer.begin());
+
+        // keep a possible beginning of header for the next call
+        if (header == buffer.end())
+            header_pos = buffer.size() >= PKT_HEADER.size() ? std::max(pos, buffer.size() - (PKT_HEADER.size() - 1)) : pos;
+
+        if (header_pos > pos)
+        {
+            writer.record(common::util::CaptureRecord::ERROR, 0, buffer.data() + pos, header_pos - pos);
+            pos = header_pos;
+        }
+
+        if (buffer.size() - pos <= PKT_INSTRUCTION)
+            break;
+
+        size_t packet_length = PKT_HEADER_SIZE + (buffer.at(pos + PKT_LENGTH_L) | (buffer.at(pos + PKT_LENGTH_H) << 8));
+        if (0x00 != buffer.at(pos + PKT_HEADER.size()) || packet_length > RX_PACKET_MAX_LEN)
+        {
+            // not a real header, skip it
+            writer.record(common::util::CaptureRecord::ERROR, 0, buffer.data() + pos, 1);
+            pos++;
+            continue;
+        }
+
+        if (buffer.size() - pos < packet_length)
+            break;
+
+        uint8_t flags = (INST_STATUS == buffer.at(pos + PKT_INSTRUCTION)) ? common::util::CaptureRecord::RX : common::util::CaptureRecord::TX;
+        writer.record(flags, buffer.at(pos + PKT_ID), buffer.data() + pos, packet_length);
+        pos += packet_length;
+        nb_packets++;
+    }
+
+    buffer.erase(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(pos));
+    return nb_packets;
+}
+
+/**
+ * @brief TtlTools::replay : send again the instructions of a capture and decode the status packets given back by the port
+ * The port is expected to be a ttl_driver::ReplayPortHandler loaded with the same capture
+ * @param records
+ * @param realtime : keep the delays between the instructions of the capture
+ * @param report
+ * @return
+ */
+int TtlTools::replay(const std::vector<common::util::CaptureRecord> &records, bool realtime, ReplayReport &report)
+{
+    report = ReplayReport();
+    if (records.empty())
+        return COMM_SUCCESS;
+
+    std::array<uint8_t, RX_PACKET_MAX_LEN> rxpacket{};
+    auto start = std::chrono::steady_clock::now();
+    auto decode_duration = std::chrono::steady_clock::duration::zero();
+
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        const common::util::CaptureRecord &instruction = records.at(i);
+        if (!(instruction.flags & common::util::CaptureRecord::TX))
+            continue;
+
+        if (realtime)
+            std::this_thread::sleep_until(start + std::chrono::microseconds(instruction.timestamp_us - records.front().timestamp_us));
+
+        std::vector<uint8_t> txpacket(instruction.data);
+        _portHandler->clearPort();
+        _portHandler->writePort(txpacket.data(), static_cast<int>(txpacket.size()));
+        report.nb_instructions++;
+
+        // decode as many status packets as recorded after this instruction
+        for (size_t j = i + 1; j < records.size() && !(records.at(j).flags & common::util::CaptureRecord::TX); ++j)
+        {
+            if (records.at(j).flags & common::util::CaptureRecord::ERROR)
+                continue;
+
+            auto decode_start = std::chrono::steady_clock::now();
+            _portHandler->setPacketTimeout(static_cast<uint16_t>(records.at(j).data.size()));
+            int result = _packetHandler->rxPacket(_portHandler.get(), rxpacket.data());
+            decode_duration += std::chrono::steady_clock::now() - decode_start;
+
+            if (COMM_SUCCESS == result)
+                report.nb_status++;
+            else
+                report.nb_errors++;
+        }
+    }
+
+    report.capture_duration_ms = static_cast<double>(records.back().timestamp_us - records.front().timestamp_us) / 1000.0;
+    report.replay_duration_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    report.decode_duration_ms = std::chrono::duration<double, std::milli>(decode_duration).count();
+
+    return report.nb_errors ? COMM_RX_CORRUPT : COMM_SUCCESS;
+}
+
 /**
  * @brief TtlTools::closePort
  */
@@ -26,10 +26,16 @@
 // Bring in my package's API, which is what I'm testing
 #include "dynamixel_sdk/packet_handler.h"
 #include "dynamixel_sdk/port_handler.h"
+#include "ttl_debug_tools/control_table.h"
+#include "ttl_debug_tools/register_snapshot.h"
 #include "ttl_debug_tools/ttl_tools.h"
+#include "ttl_driver/replay_port_handler.hpp"
 
+#include <cstdio>
 #include <memory>
 #include <string>
+#include <unistd.h>
+#include <vector>
 
 // Bring in gtest
 #include <gtest/gtest.h>
@@ -59,6 +65,137 @@ TEST(TtlDebugToolsTestSuite, testInit)
     }
 }
 
+TEST(TtlDebugToolsTestSuite, testMergeSpans)
+{
+    auto spans = ttl_debug_tools::mergeSpans({{84, 2}, {76, 2}, {78, 2}, {80, 2}, {82, 2}, {88, 2}, {90, 2}, {89, 1}});
+
+    ASSERT_EQ(spans.size(), 2u);
+    EXPECT_EQ(spans.at(0).address, 76);
+    EXPECT_EQ(spans.at(0).length, 10);
+    EXPECT_EQ(spans.at(1).address, 88);
+    EXPECT_EQ(spans.at(1).length, 4);
+}
+
+TEST(TtlDebugToolsTestSuite, testControlTables)
+{
+    ttl_debug_tools::ControlTable table;
+
+    for (uint16_t model : {350, 1060, 1080, 1020, 1200, 2000, 2001})
+    {
+        ASSERT_TRUE(ttl_debug_tools::getControlTable(model, table));
+        ASSERT_FALSE(table.dump_spans.empty());
+
+        // every restored register must be part of the dump
+        ttl_debug_tools::DeviceSnapshot device{1, model, {}};
+        for (auto const &span : table.dump_spans)
+            device.segments.push_back({span.address, std::vector<uint8_t>(span.length, 0)});
+
+        std::vector<uint8_t> data;
+        for (auto const &span : table.restore_spans)
+            EXPECT_TRUE(device.getBytes(span, data)) << table.name << " " << span.address;
+    }
+
+    // x series: EEPROM and RAM are dumped in a single read
+    ASSERT_TRUE(ttl_debug_tools::getControlTable(1060, table));
+    EXPECT_EQ(table.dump_spans.size(), 1u);
+    EXPECT_EQ(table.dump_spans.front().length, 147);
+
+    EXPECT_FALSE(ttl_debug_tools::getControlTable(12345, table));
+}
+
+TEST(TtlDebugToolsTestSuite, testSnapshotSerialization)
+{
+    ttl_debug_tools::RegisterSnapshot snapshot;
+    snapshot.addSegment(2, 2000, 0, {1, 2, 3, 4});
+    snapshot.addSegment(2, 2000, 1024, {5, 6});
+    snapshot.addSegment(5, 1060, 0, {7});
+
+    EXPECT_EQ(snapshot.getSize(), 7u);
+
+    auto buffer = snapshot.serialize();
+
+    ttl_debug_tools::RegisterSnapshot loaded;
+    ASSERT_TRUE(loaded.deserialize(buffer));
+    ASSERT_EQ(loaded.getDevices().size(), 2u);
+    EXPECT_EQ(loaded.getDevices().at(0).id, 2);
+    EXPECT_EQ(loaded.getDevices().at(0).model_number, 2000);
+    ASSERT_EQ(loaded.getDevices().at(0).segments.size(), 2u);
+    EXPECT_EQ(loaded.getDevices().at(0).segments.at(1).address, 1024);
+    EXPECT_EQ(loaded.getDevices().at(0).segments.at(1).data, std::vector<uint8_t>({5, 6}));
+
+    std::vector<uint8_t> data;
+    EXPECT_TRUE(loaded.getDevices().at(0).getBytes({1, 2}, data));
+    EXPECT_EQ(data, std::vector<uint8_t>({2, 3}));
+    EXPECT_FALSE(loaded.getDevices().at(0).getBytes({3, 2}, data));
+
+    // truncated or corrupted buffers are rejected
+    auto truncated = buffer;
+    truncated.pop_back();
+    EXPECT_FALSE(loaded.deserialize(truncated));
+
+    auto bad_magic = buffer;
+    bad_magic.at(0) = 'X';
+    EXPECT_FALSE(loaded.deserialize(bad_magic));
+}
+
+TEST(TtlDebugToolsTestSuite, testCaptureAndReplayPort)
+{
+    char path_template[] = "/tmp/ttl_capture_XXXXXX";
+    int fd = mkstemp(path_template);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    std::string file_path(path_template);
+
+    // ping of id 1 and its status packet (crc not checked by the capture)
+    std::vector<uint8_t> ping{0xFF, 0xFF, 0xFD, 0x00, 0x01, 0x03, 0x00, 0x01, 0x19, 0x4E};
+    std::vector<uint8_t> status{0xFF, 0xFF, 0xFD, 0x00, 0x01, 0x07, 0x00, 0x55, 0x00, 0x06, 0x04, 0x26, 0x65, 0x5D};
+
+    common::util::BusCaptureWriter writer;
+    ASSERT_TRUE(writer.open(file_path, common::model::EBusProtocol::TTL));
+
+    // noise, the ping, and the status packet received in two parts
+    std::vector<uint8_t> buffer{0x12, 0x34};
+    buffer.insert(buffer.end(), ping.begin(), ping.end());
+    buffer.insert(buffer.end(), status.begin(), status.begin() + 5);
+    EXPECT_EQ(ttl_debug_tools::TtlTools::extractPackets(buffer, writer), 1u);
+    EXPECT_EQ(buffer.size(), 5u);
+
+    buffer.insert(buffer.end(), status.begin() + 5, status.end());
+    EXPECT_EQ(ttl_debug_tools::TtlTools::extractPackets(buffer, writer), 1u);
+    EXPECT_TRUE(buffer.empty());
+    ASSERT_TRUE(writer.close());
+
+    common::util::BusCaptureReader reader;
+    std::vector<common::util::CaptureRecord> records;
+    ASSERT_TRUE(reader.open(file_path));
+    ASSERT_TRUE(reader.readAll(records));
+    ASSERT_EQ(records.size(), 3u);
+    EXPECT_EQ(records.at(0).flags, common::util::CaptureRecord::ERROR);
+    EXPECT_EQ(records.at(1).flags, common::util::CaptureRecord::TX);
+    EXPECT_EQ(records.at(1).data, ping);
+    EXPECT_EQ(records.at(2).flags, common::util::CaptureRecord::RX);
+    EXPECT_EQ(records.at(2).id, 1u);
+    EXPECT_EQ(records.at(2).data, status);
+    std::remove(file_path.c_str());
+
+    // the emulated port answers the recorded status to the same instruction
+    ttl_driver::ReplayPortHandler port;
+    port.setRecords(records);
+    ASSERT_TRUE(port.openPort());
+
+    EXPECT_EQ(port.writePort(ping.data(), static_cast<int>(ping.size())), static_cast<int>(ping.size()));
+    ASSERT_EQ(port.getBytesAvailable(), static_cast<int>(status.size()));
+    std::vector<uint8_t> rx(status.size());
+    EXPECT_EQ(port.readPort(rx.data(), static_cast<int>(rx.size())), static_cast<int>(status.size()));
+    EXPECT_EQ(rx, status);
+
+    // the capture has been consumed, nobody answers anymore
+    EXPECT_EQ(port.writePort(ping.data(), static_cast<int>(ping.size())), static_cast<int>(ping.size()));
+    EXPECT_EQ(port.getBytesAvailable(), 0);
+    EXPECT_EQ(port.getMatchedCount(), 1u);
+    EXPECT_EQ(port.getMissedCount(), 1u);
+}
+
 // Run all the tests that were declared with TEST()
 int main(int argc, char **argv)
 {
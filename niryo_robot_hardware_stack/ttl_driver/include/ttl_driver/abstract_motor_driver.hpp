@@ -74,8 +74,15 @@ public:
     virtual int readVelocity(uint8_t id, uint32_t& present_velocity) = 0;
 
     virtual int syncReadPosition(const std::vector<uint8_t>& id_list, std::vector<uint32_t>& position_list) = 0;
+    virtual int syncReadTorqueEnable(const std::vector<uint8_t>& id_list, std::vector<uint8_t>& torque_enable_list) = 0;
     virtual int syncReadVelocity(const std::vector<uint8_t> &id_list, std::vector<uint32_t>& velocity_list) = 0;
     virtual int syncReadJointStatus(const std::vector<uint8_t> &id_list, std::vector<std::array<uint32_t, 2> >& data_array_list) = 0;
+
+    // one position per id, valid_list telling which ones have been received
+    virtual int syncReadPartialPosition(const std::vector<uint8_t>& id_list, std::vector<uint32_t>& position_list, std::vector<uint8_t>& valid_list);
+
+    // register read by syncReadPosition, for the drivers whose reads can be prepared in advance
+    virtual bool getPositionRegister(uint16_t& address, uint8_t& data_len) const { (void)address; (void)data_len; return false; }
 };
 
 } // ttl_driver
@@ -67,6 +67,9 @@ namespace ttl_driver
 
         virtual int syncReadHomingAbsPosition(const std::vector<uint8_t> &id_list, std::vector<uint32_t> &abs_position) = 0;
         virtual int syncWriteHomingAbsPosition(const std::vector<uint8_t> &id_list, const std::vector<uint32_t> &abs_position) = 0;
+
+        // profile of the next moves, without the waits of writeVelocityProfile
+        virtual int syncWriteVelocityMax(const std::vector<uint8_t> &id_list, const std::vector<uint32_t> &v_max_list) = 0;
     };
 
 } // ttl_driver
@@ -17,6 +17,7 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #ifndef ABSTRACT_TTL_DRIVER_HPP
 #define ABSTRACT_TTL_DRIVER_HPP
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 #include <string>
@@ -47,10 +48,12 @@ public:
     virtual int getModelNumber(uint8_t id,
                        uint16_t& model_number);
     virtual int scan(std::vector<uint8_t>& id_list);
+    virtual int scanKnownIds(const std::vector<uint8_t>& expected_ids, std::vector<uint8_t>& found_ids);
     virtual int reboot(uint8_t id);
 
     virtual int readCustom(uint16_t address, uint8_t data_len, uint8_t id, uint32_t& data);
     virtual int writeCustom(uint16_t address, uint8_t data_len, uint8_t id, uint32_t data);
+    virtual int syncWriteCustom(uint16_t address, uint8_t data_len, const std::vector<uint8_t>& id_list, uint32_t data);
     
     virtual int writeSingleCmd(const std::unique_ptr<common::model::AbstractTtlSingleMotorCmd >& cmd) = 0;
     virtual int writeSyncCmd(int type, const std::vector<uint8_t>& ids, const std::vector<uint32_t>& params) = 0;
@@ -79,6 +82,10 @@ public:
     virtual int syncReadHwErrorStatus(const std::vector<uint8_t>& id_list, std::vector<uint8_t>& hw_error_list) = 0;
     virtual int syncReadHwStatus(const std::vector<uint8_t> &id_list, std::vector<std::pair<double, uint8_t> >& data_array_list) = 0;
 
+    // one value per id, valid_list telling which ones have been received
+    virtual int syncReadPartialHwErrorStatus(const std::vector<uint8_t>& id_list, std::vector<uint8_t>& hw_error_list, std::vector<uint8_t>& valid_list);
+    virtual int syncReadPartialHwStatus(const std::vector<uint8_t> &id_list, std::vector<std::pair<double, uint8_t> >& data_array_list, std::vector<uint8_t>& valid_list);
+
 protected:
     // we use those commands in the children classes to actually read and write values in registers
     template<typename T>
@@ -87,11 +94,20 @@ protected:
     template<typename T>
     int syncRead(uint16_t address, const std::vector<uint8_t>& id_list, std::vector<T>& data_list);
 
+    template<typename T>
+    int syncRead(uint16_t address, const std::vector<uint8_t>& id_list, std::vector<T>& data_list, std::vector<uint8_t>& valid_list);
+
     template<typename T, const size_t N>
     int syncReadConsecutiveBytes(uint16_t address,
                                  const std::vector<uint8_t> &id_list,
                                  std::vector<std::array<T, N> >& data_list);
 
+    template<typename T, const size_t N>
+    int syncReadConsecutiveBytes(uint16_t address,
+                                 const std::vector<uint8_t> &id_list,
+                                 std::vector<std::array<T, N> >& data_list,
+                                 std::vector<uint8_t>& valid_list);
+
     template<typename T>
     int write(uint16_t address, uint8_t id, T data);
 
@@ -110,6 +126,13 @@ private:
     static constexpr uint8_t DXL_LEN_TWO_BYTES   = 2;
     static constexpr uint8_t DXL_LEN_FOUR_BYTES  = 4;
 
+    // model number register, at the same address for all the devices of the bus
+    static constexpr uint16_t ADDR_MODEL_NUMBER  = 0;
+    // index of the id in a protocol 2 status packet
+    static constexpr size_t STATUS_PACKET_ID_INDEX = 4;
+    // 11 bytes of packet structure + 2 bytes of data, with room for byte stuffing and corrupted lengths
+    static constexpr size_t STATUS_PACKET_MAX_LEN = 1024;
+
     static constexpr int GROUP_SYNC_REDONDANT_ID = 10;
     static constexpr int GROUP_SYNC_READ_RX_FAIL = 11;
     static constexpr int LEN_ID_DATA_NOT_SAME    = 20;
@@ -195,7 +218,36 @@ int AbstractTtlDriver::syncReadConsecutiveBytes(uint16_t address,
                                                 const std::vector<uint8_t> &id_list,
                                                 std::vector<std::array<T, N> >& data_list)
 {
-    data_list.clear();
+    std::vector<uint8_t> valid_list;
+    int dxl_comm_result = syncReadConsecutiveBytes<T, N>(address, id_list, data_list, valid_list);
+
+    // only the data received before the first missing id are given
+    auto first_missing = std::find(valid_list.begin(), valid_list.end(), 0);
+    data_list.resize(static_cast<size_t>(std::distance(valid_list.begin(), first_missing)));
+
+    if (COMM_SUCCESS == dxl_comm_result && first_missing != valid_list.end())
+        dxl_comm_result = GROUP_SYNC_READ_RX_FAIL;
+
+    return dxl_comm_result;
+}
+
+/**
+ * @brief AbstractTtlDriver::syncReadConsecutiveBytes : the data of the ids which answered are given even if some others did not
+ * @param address
+ * @param id_list
+ * @param data_list : one block per id
+ * @param valid_list : one flag per id, set if its data has been received
+ * Reads N consecutive blocks of T bytes simultaneously
+ * @return COMM_SUCCESS if all the ids answered
+ */
+template<typename T, const size_t N>
+int AbstractTtlDriver::syncReadConsecutiveBytes(uint16_t address,
+                                                const std::vector<uint8_t> &id_list,
+                                                std::vector<std::array<T, N> >& data_list,
+                                                std::vector<uint8_t>& valid_list)
+{
+    data_list.assign(id_list.size(), std::array<T, N>{});
+    valid_list.assign(id_list.size(), 0);
     uint16_t data_size = sizeof(T);
     int dxl_comm_result = COMM_TX_FAIL;
 
@@ -212,27 +264,19 @@ int AbstractTtlDriver::syncReadConsecutiveBytes(uint16_t address,
 
     dxl_comm_result = groupSyncRead.txRxPacket();
 
-    if (COMM_SUCCESS == dxl_comm_result)
+    for (size_t i = 0; i < id_list.size(); ++i)
     {
-        for (auto const& id : id_list)
+        uint8_t id = id_list.at(i);
+        if (groupSyncRead.isAvailable(id, address, data_size * N))
         {
-            if (groupSyncRead.isAvailable(id, address, data_size * N))
-            {
-                std::array<T, N> blocks{};
-
-                for(uint8_t b = 0; b < N; ++b)
-                {
-                    T data = static_cast<T>(groupSyncRead.getData(id, address + b * data_size, data_size));
-                    blocks.at(b) = data;
-                }
+            for(uint8_t b = 0; b < N; ++b)
+                data_list.at(i).at(b) = static_cast<T>(groupSyncRead.getData(id, address + b * data_size, data_size));
 
-                data_list.emplace_back(std::move(blocks));
-            }
-            else
-            {
-                dxl_comm_result = GROUP_SYNC_READ_RX_FAIL;
-                break;
-            }
+            valid_list.at(i) = 1;
+        }
+        else if (COMM_SUCCESS == dxl_comm_result)
+        {
+            dxl_comm_result = GROUP_SYNC_READ_RX_FAIL;
         }
     }
 
@@ -252,10 +296,38 @@ template<typename T>
 int AbstractTtlDriver::syncRead(uint16_t address,
                                 const std::vector<uint8_t> &id_list,
                                 std::vector<T> &data_list)
+{
+    std::vector<uint8_t> valid_list;
+    int dxl_comm_result = syncRead<T>(address, id_list, data_list, valid_list);
+
+    // only the data received before the first missing id are given
+    auto first_missing = std::find(valid_list.begin(), valid_list.end(), 0);
+    data_list.resize(static_cast<size_t>(std::distance(valid_list.begin(), first_missing)));
+
+    if (COMM_SUCCESS == dxl_comm_result && first_missing != valid_list.end())
+        dxl_comm_result = GROUP_SYNC_READ_RX_FAIL;
+
+    return dxl_comm_result;
+}
+
+/**
+ * @brief AbstractTtlDriver::syncRead : the data of the ids which answered are given even if some others did not
+ * @param address
+ * @param id_list
+ * @param data_list : one value per id
+ * @param valid_list : one flag per id, set if its value has been received
+ * @return COMM_SUCCESS if all the ids answered
+ */
+template<typename T>
+int AbstractTtlDriver::syncRead(uint16_t address,
+                                const std::vector<uint8_t> &id_list,
+                                std::vector<T> &data_list,
+                                std::vector<uint8_t> &valid_list)
 {
     int dxl_comm_result = COMM_TX_FAIL;
 
-    data_list.clear();
+    data_list.assign(id_list.size(), T{});
+    valid_list.assign(id_list.size(), 0);
     uint8_t data_len = sizeof(T);
     if(data_len <= 4)
     {
@@ -272,20 +344,17 @@ int AbstractTtlDriver::syncRead(uint16_t address,
 
         dxl_comm_result = groupSyncRead.txRxPacket();
 
-        if (COMM_SUCCESS == dxl_comm_result)
+        for (size_t i = 0; i < id_list.size(); ++i)
         {
-            for (auto const& id : id_list)
+            uint8_t id = id_list.at(i);
+            if (groupSyncRead.isAvailable(id, address, data_len))
             {
-                if (groupSyncRead.isAvailable(id, address, data_len))
-                {
-                    T data = static_cast<T>(groupSyncRead.getData(id, address, data_len));
-                    data_list.emplace_back(data);
-                }
-                else
-                {
-                    dxl_comm_result = GROUP_SYNC_READ_RX_FAIL;
-                    break;
-                }
+                data_list.at(i) = static_cast<T>(groupSyncRead.getData(id, address, data_len));
+                valid_list.at(i) = 1;
+            }
+            else if (COMM_SUCCESS == dxl_comm_result)
+            {
+                dxl_comm_result = GROUP_SYNC_READ_RX_FAIL;
             }
         }
 
@@ -109,7 +109,7 @@ EndEffectorDriver<reg_type>::EndEffectorDriver(std::shared_ptr<dynamixel::PortHa
 template<typename reg_type>
 std::string EndEffectorDriver<reg_type>::str() const
 {
-    return common::model::HardwareTypeEnum(reg_type::motor_type).toString() + " : " + ttl_driver::AbstractEndEffectorDriver::str();
+    return std::string(common::model::HardwareTypeEnum(reg_type::motor_type).toString()) + " : " + ttl_driver::AbstractEndEffectorDriver::str();
 }
 
 /**
@@ -29,6 +29,7 @@ struct EndEffectorReg
     static constexpr float PROTOCOL_VERSION                     = 2.0;
     static constexpr int MODEL_NUMBER                           = 2001;
     static constexpr int VOLTAGE_CONVERSION                     = 1000;
+    static constexpr int MAX_BAUDRATE                           = 4000000;
 
     // see table here : http:// support.robotis.com/en/product/actuator/dynamixel_x/xl_series/xl-320.htm
     // EEPROM
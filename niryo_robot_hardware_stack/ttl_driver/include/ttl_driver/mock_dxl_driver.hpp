@@ -49,6 +49,7 @@ namespace ttl_driver
         int getModelNumber(uint8_t id,
                            uint16_t &model_number) override;
         int scan(std::vector<uint8_t> &id_list) override;
+        int scanKnownIds(const std::vector<uint8_t> &expected_ids, std::vector<uint8_t> &found_ids) override;
         int reboot(uint8_t id) override;
 
         std::string interpretErrorState(uint32_t hw_state) const override;
@@ -89,8 +90,10 @@ namespace ttl_driver
         int readHwErrorStatus(uint8_t id, uint8_t &hardware_error_status) override;
 
         int syncReadPosition(const std::vector<uint8_t> &id_list, std::vector<uint32_t> &position_list) override;
+        int syncReadTorqueEnable(const std::vector<uint8_t> &id_list, std::vector<uint8_t> &torque_enable_list) override;
         int syncReadVelocity(const std::vector<uint8_t> &id_list, std::vector<uint32_t> &velocity_list) override;
         int syncReadJointStatus(const std::vector<uint8_t> &id_list, std::vector<std::array<uint32_t, 2>> &data_array_list) override;
+        int syncReadPartialPosition(const std::vector<uint8_t> &id_list, std::vector<uint32_t> &position_list, std::vector<uint8_t> &valid_list) override;
 
         int syncReadFirmwareVersion(const std::vector<uint8_t> &id_list, std::vector<std::string> &firmware_list) override;
         int syncReadTemperature(const std::vector<uint8_t> &id_list, std::vector<uint8_t> &temperature_list) override;
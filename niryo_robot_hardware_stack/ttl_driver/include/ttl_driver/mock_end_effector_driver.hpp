@@ -70,6 +70,7 @@ class MockEndEffectorDriver : public AbstractEndEffectorDriver
         int getModelNumber(uint8_t id,
                             uint16_t& model_number) override;
         int scan(std::vector<uint8_t> &id_list) override;
+        int scanKnownIds(const std::vector<uint8_t> &expected_ids, std::vector<uint8_t> &found_ids) override;
         int reboot(uint8_t id) override;
 
         // AbstractEndEffectorDriver
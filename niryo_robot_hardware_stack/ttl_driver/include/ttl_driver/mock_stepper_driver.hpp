@@ -48,6 +48,7 @@ class MockStepperDriver : public AbstractStepperDriver
         int getModelNumber(uint8_t id,
                             uint16_t& model_number) override;
         int scan(std::vector<uint8_t>& id_list) override;
+        int scanKnownIds(const std::vector<uint8_t> &expected_ids, std::vector<uint8_t> &found_ids) override;
         int reboot(uint8_t id) override;
 
         // eeprom write
@@ -78,8 +79,10 @@ class MockStepperDriver : public AbstractStepperDriver
         int readVelocity(uint8_t id, uint32_t &present_velocity) override;
 
         int syncReadPosition(const std::vector<uint8_t> &id_list, std::vector<uint32_t> &position_list) override;
+        int syncReadTorqueEnable(const std::vector<uint8_t> &id_list, std::vector<uint8_t> &torque_enable_list) override;
         int syncReadVelocity(const std::vector<uint8_t> &id_list, std::vector<uint32_t> &velocity_list) override;
         int syncReadJointStatus(const std::vector<uint8_t> &id_list, std::vector<std::array<uint32_t, 2> >& data_array) override;
+        int syncReadPartialPosition(const std::vector<uint8_t> &id_list, std::vector<uint32_t> &position_list, std::vector<uint8_t> &valid_list) override;
 
         int syncReadFirmwareVersion(const std::vector<uint8_t> &id_list, std::vector<std::string> &firmware_list) override;
         int syncReadTemperature(const std::vector<uint8_t> &id_list, std::vector<uint8_t>& temperature_list) override;
@@ -105,6 +108,8 @@ class MockStepperDriver : public AbstractStepperDriver
         int syncReadHomingAbsPosition(const std::vector<uint8_t> &id_list, std::vector<uint32_t> &abs_position) override;
         int syncWriteHomingAbsPosition(const std::vector<uint8_t> &id_list, const std::vector<uint32_t> &abs_position) override;
 
+        int syncWriteVelocityMax(const std::vector<uint8_t> &id_list, const std::vector<uint32_t> &v_max_list) override;
+
     private:
         bool init();
 
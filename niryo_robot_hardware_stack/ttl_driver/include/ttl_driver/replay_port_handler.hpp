@@ -0,0 +1,136 @@
+/*
+replay_port_handler.hpp
+Copyright (C) 2020 Niryo
+All rights reserved.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#ifndef REPLAY_PORT_HANDLER_HPP
+#define REPLAY_PORT_HANDLER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "dynamixel_sdk/port_handler.h"
+#include "common/util/bus_capture.hpp"
+
+namespace ttl_driver
+{
+
+    /**
+     * @brief The ReplayPortHandler class emulates a TTL port from a bus capture.
+     * Each instruction packet written on the port is matched against the recorded instructions,
+     * and the status packets recorded after it are given back on the following reads.
+     * The matching goes forward in the capture : an identical instruction is searched first, then
+     * an instruction with the same id and instruction type (its parameters, like goal positions, may differ).
+     * With realtime enabled, the status packets are available after the delay measured during the capture.
+     */
+    class ReplayPortHandler : public dynamixel::PortHandler
+    {
+    public:
+        ReplayPortHandler(bool realtime = false);
+
+        bool load(const std::string &file_path);
+        void setRecords(std::vector<common::util::CaptureRecord> records);
+
+        uint32_t getMatchedCount() const;
+        uint32_t getMissedCount() const;
+        size_t getRecordCount() const;
+
+        // PortHandler interface
+    public:
+        void gpioHigh() override;
+        void gpioLow() override;
+
+        bool openPort() override;
+        void closePort() override;
+        void clearPort() override;
+        void flushInput() override;
+
+        void setPortName(const char *port_name) override;
+        const char *getPortName() override;
+
+        bool setBaudRate(const int baudrate) override;
+        int getBaudRate() override;
+
+        int getBytesAvailable() override;
+        int readPort(uint8_t *packet, int length) override;
+        int writePort(uint8_t *packet, int length) override;
+
+        void setPacketTimeout(uint16_t packet_length) override;
+        void setPacketTimeout(double msec) override;
+        bool isPacketTimeout() override;
+
+    private:
+        bool findInstruction(const uint8_t *packet, int length, size_t &index) const;
+        void receivePending();
+
+    private:
+        std::vector<common::util::CaptureRecord> _records;
+        size_t _cursor{0};
+
+        // status packets not yet received (realtime), and bytes ready to be read
+        std::deque<std::pair<std::chrono::steady_clock::time_point, std::vector<uint8_t>>> _pending_status;
+        std::deque<uint8_t> _rx_buffer;
+        std::chrono::steady_clock::time_point _packet_timeout_time;
+
+        std::string _port_name{"replay"};
+        int _baudrate{DEFAULT_BAUDRATE_};
+        bool _realtime{false};
+
+        uint32_t _matched_count{0};
+        uint32_t _missed_count{0};
+
+        // number of records looked at to find the next instruction
+        static constexpr size_t LOOKAHEAD = 256;
+        // position of the id and of the instruction in a protocol 2.0 packet
+        static constexpr size_t PKT_ID = 4;
+        static constexpr size_t PKT_INSTRUCTION = 7;
+    };
+
+    /**
+     * @brief ReplayPortHandler::getMatchedCount
+     * @return number of written instructions found in the capture
+     */
+    inline
+    uint32_t ReplayPortHandler::getMatchedCount() const
+    {
+        return _matched_count;
+    }
+
+    /**
+     * @brief ReplayPortHandler::getMissedCount
+     * @return number of written instructions not found in the capture
+     */
+    inline
+    uint32_t ReplayPortHandler::getMissedCount() const
+    {
+        return _missed_count;
+    }
+
+    /**
+     * @brief ReplayPortHandler::getRecordCount
+     * @return
+     */
+    inline
+    size_t ReplayPortHandler::getRecordCount() const
+    {
+        return _records.size();
+    }
+
+} // ttl_driver
+
+#endif // REPLAY_PORT_HANDLER_HPP
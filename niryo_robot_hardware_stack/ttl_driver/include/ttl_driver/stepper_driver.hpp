@@ -59,6 +59,8 @@ namespace ttl_driver
         int syncReadHwStatus(const std::vector<uint8_t> &id_list, std::vector<std::pair<double, uint8_t>> &data_list) override;
 
         int syncReadHwErrorStatus(const std::vector<uint8_t> &id_list, std::vector<uint8_t> &hw_error_list) override;
+        int syncReadPartialHwErrorStatus(const std::vector<uint8_t> &id_list, std::vector<uint8_t> &hw_error_list, std::vector<uint8_t> &valid_list) override;
+        int syncReadPartialHwStatus(const std::vector<uint8_t> &id_list, std::vector<std::pair<double, uint8_t>> &data_list, std::vector<uint8_t> &valid_list) override;
 
     public:
         // AbstractMotorDriver interface : we cannot define them globally in AbstractMotorDriver
@@ -83,8 +85,12 @@ namespace ttl_driver
         int readVelocity(uint8_t id, uint32_t &present_velocity) override;
 
         int syncReadPosition(const std::vector<uint8_t> &id_list, std::vector<uint32_t> &position_list) override;
+        int syncReadTorqueEnable(const std::vector<uint8_t> &id_list, std::vector<uint8_t> &torque_enable_list) override;
         int syncReadVelocity(const std::vector<uint8_t> &id_list, std::vector<uint32_t> &velocity_list) override;
         int syncReadJointStatus(const std::vector<uint8_t> &id_list, std::vector<std::array<uint32_t, 2>> &data_array_list) override;
+        int syncReadPartialPosition(const std::vector<uint8_t> &id_list, std::vector<uint32_t> &position_list, std::vector<uint8_t> &valid_list) override;
+
+        bool getPositionRegister(uint16_t &address, uint8_t &data_len) const override;
 
         // AbstractStepperDriver interface
     public:
@@ -102,6 +108,8 @@ namespace ttl_driver
         int syncReadHomingAbsPosition(const std::vector<uint8_t> &id_list, std::vector<uint32_t> &abs_position) override;
         int syncWriteHomingAbsPosition(const std::vector<uint8_t> &id_list, const std::vector<uint32_t> &abs_position) override;
 
+        int syncWriteVelocityMax(const std::vector<uint8_t> &id_list, const std::vector<uint32_t> &v_max_list) override;
+
     private:
         int writeVStart(uint8_t id, uint32_t v_start);
         int writeA1(uint8_t id, uint32_t a_1);
@@ -136,7 +144,7 @@ namespace ttl_driver
     template <typename reg_type>
     std::string StepperDriver<reg_type>::str() const
     {
-        return common::model::HardwareTypeEnum(reg_type::motor_type).toString() + " : " + AbstractStepperDriver::str();
+        return std::string(common::model::HardwareTypeEnum(reg_type::motor_type).toString()) + " : " + AbstractStepperDriver::str();
     }
 
     /**
@@ -370,6 +378,49 @@ namespace ttl_driver
         return syncRead<typename reg_type::TYPE_PRESENT_POSITION>(reg_type::ADDR_PRESENT_POSITION, id_list, position_list);
     }
 
+    /**
+     * @brief StepperDriver<reg_type>::getPositionRegister
+     * @param address
+     * @param data_len
+     * @return
+     */
+    template <typename reg_type>
+    bool StepperDriver<reg_type>::getPositionRegister(uint16_t &address, uint8_t &data_len) const
+    {
+        address = static_cast<uint16_t>(reg_type::ADDR_PRESENT_POSITION);
+        data_len = static_cast<uint8_t>(sizeof(typename reg_type::TYPE_PRESENT_POSITION));
+        return true;
+    }
+
+    /**
+     * @brief StepperDriver<reg_type>::syncReadPartialPosition
+     * @param id_list
+     * @param position_list
+     * @param valid_list
+     * @return
+     */
+    template <typename reg_type>
+    int StepperDriver<reg_type>::syncReadPartialPosition(const std::vector<uint8_t> &id_list, std::vector<uint32_t> &position_list, std::vector<uint8_t> &valid_list)
+    {
+        std::vector<typename reg_type::TYPE_PRESENT_POSITION> raw_data_list;
+        int res = syncRead<typename reg_type::TYPE_PRESENT_POSITION>(reg_type::ADDR_PRESENT_POSITION, id_list, raw_data_list, valid_list);
+        position_list.assign(raw_data_list.begin(), raw_data_list.end());
+
+        return res;
+    }
+
+    /**
+     * @brief StepperDriver<reg_type>::syncReadTorqueEnable
+     * @param id_list
+     * @param torque_enable_list
+     * @return
+     */
+    template <typename reg_type>
+    int StepperDriver<reg_type>::syncReadTorqueEnable(const std::vector<uint8_t> &id_list, std::vector<uint8_t> &torque_enable_list)
+    {
+        return syncRead<typename reg_type::TYPE_TORQUE_ENABLE>(reg_type::ADDR_TORQUE_ENABLE, id_list, torque_enable_list);
+    }
+
     /**
      * @brief StepperDriver<reg_type>::syncReadVelocity
      * @param id_list
@@ -529,6 +580,51 @@ namespace ttl_driver
         return syncRead<typename reg_type::TYPE_HW_ERROR_STATUS>(reg_type::ADDR_HW_ERROR_STATUS, id_list, hw_error_list);
     }
 
+    /**
+     * @brief StepperDriver<reg_type>::syncReadPartialHwStatus
+     * @param id_list
+     * @param data_list
+     * @param valid_list
+     * @return
+     */
+    template <typename reg_type>
+    int StepperDriver<reg_type>::syncReadPartialHwStatus(const std::vector<uint8_t> &id_list,
+                                                         std::vector<std::pair<double, uint8_t>> &data_list,
+                                                         std::vector<uint8_t> &valid_list)
+    {
+        data_list.clear();
+
+        std::vector<std::array<uint8_t, 3>> raw_data;
+        int res = syncReadConsecutiveBytes<uint8_t, 3>(reg_type::ADDR_PRESENT_VOLTAGE, id_list, raw_data, valid_list);
+
+        for (auto const &data : raw_data)
+        {
+            // Voltage is first reg, uint16
+            auto v = static_cast<uint16_t>((static_cast<uint16_t>(data.at(1)) << 8) | data.at(0)); // concatenate 2 bytes
+            auto voltage = static_cast<double>(v);
+
+            // Temperature is second reg, uint8
+            uint8_t temperature = data.at(2);
+
+            data_list.emplace_back(std::make_pair(voltage, temperature));
+        }
+
+        return res;
+    }
+
+    /**
+     * @brief StepperDriver<reg_type>::syncReadPartialHwErrorStatus
+     * @param id_list
+     * @param hw_error_list
+     * @param valid_list
+     * @return
+     */
+    template <typename reg_type>
+    int StepperDriver<reg_type>::syncReadPartialHwErrorStatus(const std::vector<uint8_t> &id_list, std::vector<uint8_t> &hw_error_list, std::vector<uint8_t> &valid_list)
+    {
+        return syncRead<typename reg_type::TYPE_HW_ERROR_STATUS>(reg_type::ADDR_HW_ERROR_STATUS, id_list, hw_error_list, valid_list);
+    }
+
     //*****************************
     // AbstractStepperDriver interface
     //*****************************
@@ -777,6 +873,18 @@ namespace ttl_driver
         return syncWrite<typename reg_type::TYPE_HOMING_ABS_POSITION>(reg_type::ADDR_HOMING_ABS_POSITION, id_list, abs_position);
     }
 
+    /**
+     * @brief StepperDriver<reg_type>::syncWriteVelocityMax : max velocity of the profile, for all the given motors in one packet
+     * @param id_list
+     * @param v_max_list
+     * @return
+     */
+    template <typename reg_type>
+    int StepperDriver<reg_type>::syncWriteVelocityMax(const std::vector<uint8_t> &id_list, const std::vector<uint32_t> &v_max_list)
+    {
+        return syncWrite<typename reg_type::TYPE_PROFILE>(reg_type::ADDR_VMAX, id_list, v_max_list);
+    }
+
     /**
      * @brief StepperDriver<reg_type>::syncReadHomingAbsPosition
      * @param id
@@ -30,6 +30,7 @@ namespace ttl_driver
         static constexpr float PROTOCOL_VERSION = 2.0;
         static constexpr int MODEL_NUMBER = 2000;
         static constexpr int VOLTAGE_CONVERSION = 1000;
+        static constexpr int MAX_BAUDRATE = 4000000;
 
         // EEPROM
         static constexpr uint16_t ADDR_MODEL_NUMBER = 0;
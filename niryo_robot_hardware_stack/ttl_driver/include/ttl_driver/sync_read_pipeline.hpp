@@ -0,0 +1,144 @@
+/*
+sync_read_pipeline.hpp
+Copyright (C) 2020 Niryo
+All rights reserved.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#ifndef SYNC_READ_PIPELINE_HPP
+#define SYNC_READ_PIPELINE_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "dynamixel_sdk/dynamixel_sdk.h"
+
+namespace ttl_driver
+{
+
+    /**
+     * @brief The SyncReadPipeline class runs a fixed sequence of sync reads once per cycle.
+     * The instruction packets are built once, when the stages are added, and only written on the bus afterwards.
+     * As soon as the last status packet of a stage is received, the instruction of the next stage is sent,
+     * and the status packets of the stage are decoded while the devices answer the next one :
+     * the bus does not wait for the decoding.
+     */
+    class SyncReadPipeline
+    {
+    public:
+        /**
+         * @brief The Stage struct : one sync read, with the values of its last run
+         */
+        struct Stage
+        {
+            uint16_t address{0};
+            uint8_t data_len{0};
+            std::vector<uint8_t> ids;
+
+            std::vector<uint8_t> packet;
+            uint16_t rx_length{0};
+
+            // one value per id, valid if its status packet has been received
+            std::vector<uint32_t> values;
+            std::vector<uint8_t> received;
+            // time at which the last status packet of the stage was received
+            std::chrono::steady_clock::time_point receive_time;
+        };
+
+    public:
+        SyncReadPipeline(std::shared_ptr<dynamixel::PortHandler> portHandler, std::shared_ptr<dynamixel::PacketHandler> packetHandler);
+
+        bool addStage(uint16_t address, uint8_t data_len, const std::vector<uint8_t> &id_list);
+        void clear();
+
+        size_t size() const;
+        bool empty() const;
+
+        template <typename Decode>
+        int run(Decode &&decode);
+
+    private:
+        int send(const Stage &stage);
+        int receive(Stage &stage);
+
+    private:
+        std::shared_ptr<dynamixel::PortHandler> _portHandler;
+        std::shared_ptr<dynamixel::PacketHandler> _packetHandler;
+
+        std::vector<Stage> _stages;
+        // raw data and errors of the status packets of a stage
+        std::vector<uint8_t> _rx_data;
+        std::vector<uint8_t> _rx_error;
+    };
+
+    /**
+     * @brief SyncReadPipeline::run : run all the stages, in the order they were added
+     * @param decode : called as decode(const Stage &stage, int result) for each stage, while the next one is on the bus
+     * @return COMM_SUCCESS if all the stages succeeded, the error of the last failed stage otherwise
+     */
+    template <typename Decode>
+    int SyncReadPipeline::run(Decode &&decode)
+    {
+        int result = COMM_SUCCESS;
+
+        if (_stages.empty())
+            return result;
+
+        int tx_result = send(_stages.front());
+        for (size_t i = 0; i < _stages.size(); ++i)
+        {
+            Stage &stage = _stages.at(i);
+            int stage_result = tx_result;
+            if (COMM_SUCCESS == tx_result)
+                stage_result = receive(stage);
+            else
+                std::fill(stage.received.begin(), stage.received.end(), 0);
+
+            // the bus is free : the next instruction goes out before this stage is decoded
+            if (i + 1 < _stages.size())
+                tx_result = send(_stages.at(i + 1));
+
+            decode(static_cast<const Stage &>(stage), stage_result);
+
+            if (COMM_SUCCESS != stage_result)
+                result = stage_result;
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief SyncReadPipeline::size
+     * @return
+     */
+    inline
+    size_t SyncReadPipeline::size() const
+    {
+        return _stages.size();
+    }
+
+    /**
+     * @brief SyncReadPipeline::empty
+     * @return
+     */
+    inline
+    bool SyncReadPipeline::empty() const
+    {
+        return _stages.empty();
+    }
+
+} // ttl_driver
+
+#endif // SYNC_READ_PIPELINE_HPP
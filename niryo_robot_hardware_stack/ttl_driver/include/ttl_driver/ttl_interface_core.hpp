@@ -21,6 +21,7 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #define TTL_INTERFACE_CORE_HPP
 
 // std
+#include <chrono>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -34,6 +35,11 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 // ros
 #include <ros/ros.h>
 
+#include "common/util/goal_filter.hpp"
+#include "common/util/trajectory_segmenter.hpp"
+#include "common/util/joint_command_buffer.hpp"
+#include "common/util/latency_histogram.hpp"
+#include "common/util/retry_policy.hpp"
 #include "common/util/i_driver_core.hpp"
 #include "common/util/i_interface_core.hpp"
 
@@ -89,7 +95,8 @@ namespace ttl_driver
         void clearConveyorCommandQueue();
         void clearSyncCommandQueue();
 
-        void setTrajectoryControllerCommands(std::vector<std::pair<uint8_t, uint32_t>> &&cmd);
+        void initTrajectoryControllerCommands(const std::vector<uint8_t> &id_list);
+        void setTrajectoryControllerCommands(const std::vector<uint32_t> &goals, common::util::JointCommandBuffer<uint32_t>::Clock::time_point sample_time);
 
         void addSyncCommandToQueue(std::unique_ptr<common::model::ISynchronizeMotorCmd> &&cmd) override;
 
@@ -100,6 +107,9 @@ namespace ttl_driver
 
         // joints control
         int addJoint(const std::shared_ptr<common::model::JointState> &jointState);
+        int addJoints(const std::vector<std::shared_ptr<common::model::JointState>> &joint_states);
+        bool readTorqueEnable(const std::vector<uint8_t> &id_list, bool expected_torque, std::vector<uint8_t> &mismatch_id_list);
+        bool rebootJoints(const std::vector<std::shared_ptr<common::model::JointState>> &joint_states, std::vector<uint8_t> &rebooted_ids);
         int initMotor(const std::shared_ptr<common::model::AbstractMotorState> &motor_state);
 
         // Tool control
@@ -148,6 +158,8 @@ namespace ttl_driver
         bool getCollisionStatus() const;
         void waitSyncQueueFree();
         void waitSingleQueueFree();
+        bool isSyncQueueFree() const;
+        bool isSingleQueueFree() const;
 
         bool readHomingAbsPosition();
 
@@ -160,12 +172,14 @@ namespace ttl_driver
         void resetHardwareControlLoopRates() override;
         void controlLoop() override;
         void _executeCommand() override;
+        void recordCommandLatency(std::chrono::steady_clock::time_point write_time);
 
         int motorScanReport(uint8_t motor_id);
         int motorCmdReport(const common::model::JointState &jState, common::model::EHardwareType motor_type);
 
         // use other callbacks instead of executecommand
         bool _callbackActivateLeds(niryo_robot_msgs::SetInt::Request &req, niryo_robot_msgs::SetInt::Response &res);
+        bool _callbackSetBusBaudrate(niryo_robot_msgs::SetInt::Request &req, niryo_robot_msgs::SetInt::Response &res);
         bool _callbackWriteCustomValue(ttl_driver::WriteCustomValue::Request &req, ttl_driver::WriteCustomValue::Response &res);
         bool _callbackReadCustomValue(ttl_driver::ReadCustomValue::Request &req, ttl_driver::ReadCustomValue::Response &res);
 
@@ -186,6 +200,8 @@ namespace ttl_driver
 
         bool _control_loop_flag{false};
         bool _debug_flag{false};
+        // some motors are missing: only the connected ones are read, the trajectory is held
+        bool _degraded_mode{false};
 
         bool _collision_detected{false};
 
@@ -197,6 +213,8 @@ namespace ttl_driver
         std::thread _control_loop_thread;
 
         double _control_loop_frequency{0.0};
+        // part of the control period in which a failed write can be retried
+        static constexpr double WRITE_RETRY_WINDOW_RATIO = 0.5;
 
         double _delta_time_data_read{0.0};
         double _delta_time_end_effector_read{0.0};
@@ -206,6 +224,7 @@ namespace ttl_driver
         double _time_hw_end_effector_last_read{0.0};
         double _time_hw_data_last_write{0.0};
 
+        double _delta_time_check_connection{0.0};
         double _time_check_connection_last_read{0.0};
 
         // specific to dxl
@@ -216,7 +235,20 @@ namespace ttl_driver
 
         std::unique_ptr<TtlManager> _ttl_manager;
 
-        std::vector<std::pair<uint8_t, uint32_t>> _joint_trajectory_cmd;
+        // attempts of the command at the front of each queue, kept while it is deferred
+        common::util::RetryPolicy _single_cmd_retry{TtlManager::getRetryBudget(TtlManager::ERetryClass::SINGLE_WRITE)};
+        common::util::RetryPolicy _conveyor_cmd_retry{TtlManager::getRetryBudget(TtlManager::ERetryClass::SINGLE_WRITE)};
+        common::util::RetryPolicy _sync_cmd_retry{TtlManager::getRetryBudget(TtlManager::ERetryClass::SYNC_WRITE)};
+
+        // one goal per joint, in the order given to initTrajectoryControllerCommands
+        common::util::JointCommandBuffer<uint32_t> _joint_trajectory_cmd;
+        // only the goals that changed are written on the bus
+        common::util::GoalFilter<uint32_t> _joint_goal_filter;
+        std::vector<uint8_t> _joint_goal_mask;
+        // the steppers can execute the trajectory by segments, the other joints still get their goals at each cycle
+        common::util::TrajectorySegmenter<uint32_t> _joint_segmenter;
+        // delay between the reception of the joint positions and the write of the goals computed from them
+        common::util::LatencyHistogram _command_latency;
 
         // ttl cmds
         // TODO(CC) it seems like having two queues can lead to pbs if a sync is launched before the sincle queue is finished
@@ -226,6 +258,7 @@ namespace ttl_driver
         std::queue<std::unique_ptr<common::model::AbstractTtlSingleMotorCmd>> _conveyor_cmds_queue;
 
         ros::ServiceServer _activate_leds_server;
+        ros::ServiceServer _bus_baudrate_server;
 
         ros::ServiceServer _custom_cmd_server;
         ros::ServiceServer _custom_cmd_getter;
@@ -280,6 +313,26 @@ namespace ttl_driver
         return _ttl_manager->getCollisionStatus();
     }
 
+    /**
+     * @brief TtlInterfaceCore::isSyncQueueFree
+     * @return true if all the sync commands have been sent, non blocking version of waitSyncQueueFree
+     */
+    inline bool TtlInterfaceCore::isSyncQueueFree() const
+    {
+        std::lock_guard<std::mutex> lock(_sync_cmd_queue_mutex);
+        return _sync_cmds_queue.empty();
+    }
+
+    /**
+     * @brief TtlInterfaceCore::isSingleQueueFree
+     * @return true if all the single commands have been sent, non blocking version of waitSingleQueueFree
+     */
+    inline bool TtlInterfaceCore::isSingleQueueFree() const
+    {
+        std::lock_guard<std::mutex> lock(_single_cmd_queue_mutex);
+        return _single_cmds_queue.empty();
+    }
+
     /**
      * @brief TtlInterfaceCore::setCalibrationStatus
      */
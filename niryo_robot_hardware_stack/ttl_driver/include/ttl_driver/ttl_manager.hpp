@@ -21,16 +21,20 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #define TTL_DRIVER_HPP
 
 #include "common/util/util_defs.hpp"
+#include "common/util/log_defs.hpp"
 #include "common/util/i_bus_manager.hpp"
+#include "common/util/retry_policy.hpp"
 
 // cpp
 #include <memory>
+#include <mutex>
 #include <ros/ros.h>
 #include <string>
 #include <thread>
 #include <queue>
 #include <functional>
 #include <algorithm>
+#include <chrono>
 #include <set>
 #include <utility>
 
@@ -43,9 +47,12 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #include "niryo_robot_msgs/SetInt.h"
 #include "niryo_robot_msgs/CommandStatus.h"
 
+#include "ttl_driver/abstract_end_effector_driver.hpp"
 #include "ttl_driver/abstract_motor_driver.hpp"
 #include "ttl_driver/abstract_stepper_driver.hpp"
 #include "ttl_driver/fake_ttl_data.hpp"
+#include "ttl_driver/sync_read_pipeline.hpp"
+#include "ttl_driver/ttl_port.hpp"
 #include "ttl_driver/MotorCommand.h"
 
 #include "common/model/dxl_motor_state.hpp"
@@ -64,11 +71,15 @@ constexpr int TTL_FAIL_OPEN_PORT         = -4500;
 
 constexpr int TTL_FAIL_PORT_SET_BAUDRATE = -4501;
 constexpr int TTL_FAIL_SETUP_GPIO        = -4502;
+constexpr int TTL_FAIL_BAUDRATE_NOT_SUPPORTED = -4503;
+constexpr int TTL_FAIL_BAUDRATE_CHANGE   = -4504;
 
 constexpr int TTL_SCAN_OK                = 0;
 constexpr int TTL_SCAN_MISSING_MOTOR     = -50;
 constexpr int TTL_SCAN_UNALLOWED_MOTOR   = -51;
 constexpr int TTL_WRONG_TYPE             = -52;
+// the write failed and is left for the next cycle (see TtlManager::ERetryClass)
+constexpr int TTL_WRITE_DEFERRED         = -53;
 
 /**
  * Parameters for Stepper
@@ -96,11 +107,13 @@ public:
     bool init(ros::NodeHandle& nh) override;
 
     int addHardwareComponent(std::shared_ptr<common::model::AbstractHardwareState> &&state) override;
+    int addHardwareComponents(const std::vector<std::shared_ptr<common::model::AbstractHardwareState> > &states);
 
     void removeHardwareComponent(uint8_t id) override;
     bool isConnectionOk() const override;
 
     int scanAndCheck() override;
+    int checkRemovedMotors();
     bool ping(uint8_t id) override;
 
     size_t getNbMotors() const override;
@@ -110,13 +123,39 @@ public:
     // commands
 
     int changeId(common::model::EHardwareType motor_type, uint8_t old_id, uint8_t new_id);
+    int changeBaudrate(int baudrate);
+    int getBaudrate() const;
+
+    /**
+     * @brief The ERetryClass enum : each class of commands has its own retry budget (see getRetryBudget)
+     */
+    enum class ERetryClass
+    {
+        SYNC_WRITE,
+        SINGLE_WRITE,
+        LEDS,
+        REBOOT,
+        ADD_COMPONENT
+    };
+
+    static common::util::RetryPolicy::Budget getRetryBudget(ERetryClass retry_class);
 
     int writeSynchronizeCommand(std::unique_ptr<common::model::AbstractTtlSynchronizeMotorCmd >&& cmd);
+    int writeSynchronizeCommand(const std::unique_ptr<common::model::AbstractTtlSynchronizeMotorCmd >& cmd, common::util::RetryPolicy& retry,
+                                common::util::RetryPolicy::Clock::time_point deadline = common::util::RetryPolicy::Clock::time_point::max());
     int writeSingleCommand(std::unique_ptr<common::model::AbstractTtlSingleMotorCmd >&& cmd);
+    int writeSingleCommand(const std::unique_ptr<common::model::AbstractTtlSingleMotorCmd >& cmd, common::util::RetryPolicy& retry,
+                           common::util::RetryPolicy::Clock::time_point deadline = common::util::RetryPolicy::Clock::time_point::max());
 
-    void executeJointTrajectoryCmd(std::vector<std::pair<uint8_t, uint32_t> > cmd_vec);
+    void setJointTrajectoryLayout(const std::vector<uint8_t>& id_list);
+    std::chrono::steady_clock::time_point executeJointTrajectoryCmd(const std::vector<uint32_t>& goals, std::vector<uint8_t>& mask);
+    std::chrono::steady_clock::time_point executeJointTrajectorySegment(const std::vector<uint32_t>& start_goals, const std::vector<uint32_t>& end_goals,
+                                                                        const std::vector<uint8_t>& slots, double duration);
 
     int rebootHardware(uint8_t id);
+    int rebootHardware(const std::vector<uint8_t>& id_list, std::vector<uint8_t>& rebooted_ids);
+    static std::vector<uint8_t> waitRebootedIds(std::map<std::shared_ptr<ttl_driver::AbstractTtlDriver>, std::vector<uint8_t> > ids_by_bus,
+                                                common::util::RetryPolicy& retry);
 
     int setLeds(int led);
 
@@ -132,6 +171,7 @@ public:
     bool readJointsStatus();
     bool readHomingAbsPosition();
     bool readCollisionStatus();
+    int readTorqueEnable(const std::vector<uint8_t> &id_list, bool expected_torque, std::vector<uint8_t> &mismatch_id_list);
 
     int readMotorPID(uint8_t id,
                      uint16_t& pos_p_gain, uint16_t& pos_i_gain, uint16_t& pos_d_gain,
@@ -156,6 +196,7 @@ public:
 
     // getters
     int getAllIdsOnBus(std::vector<uint8_t> &id_list);
+    int getKnownIdsOnBus(const std::vector<uint8_t> &expected_ids, std::vector<uint8_t> &id_list);
 
     uint32_t getPosition(const common::model::JointState &motor_state);
     int getLedState() const;
@@ -172,6 +213,11 @@ public:
 private:
     // IBusManager Interface
     int setupCommunication() override;
+    void initExtraPorts(ros::NodeHandle& nh);
+    int negotiateBaudrate();
+    int writeBaudrate(const std::vector<uint8_t>& id_list, int baudrate);
+    void readTorqueOnIds(const std::vector<uint8_t>& id_list, std::vector<uint8_t>& torque_on_ids);
+    int writeBaudrateTorque(const std::vector<uint8_t>& id_list, uint8_t torque_enable);
     void addHardwareDriver(common::model::EHardwareType hardware_type) override;
 
     // Config params using in fake driver
@@ -183,20 +229,116 @@ private:
     // this helps get only one driver to use for all motors to get/set on the same address
     bool isMotorType(common::model::EHardwareType type);
 
+    std::vector<uint8_t> getConnectedIds(common::model::EHardwareType type) const;
+    std::vector<uint8_t> getConnectedIds(const std::vector<uint8_t> &id_list) const;
+
+    TtlPort* getExtraPort(uint8_t id) const;
+    std::shared_ptr<ttl_driver::AbstractTtlDriver> getDriver(uint8_t id) const;
+    std::shared_ptr<ttl_driver::AbstractEndEffectorDriver> getEndEffectorDriver(uint8_t &id) const;
+    int writeSyncCmd(common::model::EHardwareType type, int cmd_type, const std::vector<uint8_t> &ids, const std::vector<uint32_t> &params);
+    static int scanKnownIds(const std::shared_ptr<ttl_driver::AbstractTtlDriver> &driver, const std::vector<uint8_t> &expected_ids, std::vector<uint8_t> &id_list);
+
     bool checkCollision();
 
+    void registerHardwareComponent(const std::shared_ptr<common::model::AbstractHardwareState> &state);
+    void updateJointTrajectoryLayout();
+    void updateJointsStatusPipeline();
+    bool setJointsPosition(const std::vector<uint8_t> &id_list, const std::vector<uint32_t> &position_list, const std::vector<uint8_t> &valid_list,
+                           common::model::AbstractMotorState::Clock::time_point sample_time);
+    void readFirmwareVersions(const std::vector<uint8_t> &id_list);
+
+    /**
+     * @brief The HardwareStatusSample struct : voltage, temperature and error state of the devices of one driver,
+     * read on their bus then applied to their states
+     */
+    struct HardwareStatusSample
+    {
+        std::shared_ptr<ttl_driver::AbstractTtlDriver> driver;
+        std::vector<uint8_t> ids;
+        std::vector<std::pair<double, uint8_t> > hw_data_list;
+        std::vector<uint8_t> hw_data_valid_list;
+        std::vector<uint8_t> hw_error_status_list;
+        std::vector<uint8_t> hw_error_valid_list;
+    };
+
+    /**
+     * @brief The PositionSample struct : positions of the motors of one driver, read on their bus then applied to their states
+     */
+    struct PositionSample
+    {
+        std::shared_ptr<ttl_driver::AbstractMotorDriver> driver;
+        std::vector<uint8_t> ids;
+        std::vector<uint32_t> position_list;
+        std::vector<uint8_t> valid_list;
+        common::model::AbstractMotorState::Clock::time_point sample_time;
+    };
+
+    /**
+     * @brief The ExtraPortStatus struct : status read by the I/O thread of an extra port during one cycle
+     */
+    struct ExtraPortStatus
+    {
+        std::vector<HardwareStatusSample> hw_status;
+        std::vector<uint8_t> conveyor_ids;
+        std::vector<uint32_t> conveyor_velocity_list;
+        unsigned int errors{0};
+    };
+
+    static unsigned int syncReadHardwareStatus(HardwareStatusSample &sample);
+    void applyHardwareStatus(const HardwareStatusSample &sample);
+    unsigned int applyConveyorsVelocity(const std::vector<uint8_t> &conveyor_ids, const std::vector<uint32_t> &velocity_list);
+
+    void postHardwareStatusRead(TtlPort &port, ExtraPortStatus &status);
+    void postPositionsRead(TtlPort &port, std::vector<PositionSample> &samples);
+
+    /**
+     * @brief The EBusError enum : last error on the bus. The corresponding message
+     * is only built when requested (see getErrorMessage)
+     */
+    enum class EBusError
+    {
+        NONE,
+        NOT_CONNECTED_YET,
+        SET_BAUDRATE_FAILED,
+        OPEN_PORT_FAILED,
+        MISSING_MOTORS,
+        BUS_TOO_BUSY,
+        CONNECTION_PROBLEM,
+        DRIVER_NOT_FOUND,
+        NO_MOTOR_FOUND,
+        SCAN_FAILED,
+        SYNC_WRITE_FAILED,
+        SINGLE_WRITE_FAILED,
+        POSITION_WRITE_FAILED
+    };
+
+    void setBusError(EBusError error);
+    void setBusError(EBusError error, uint8_t cmd_id, const char* cmd_type);
+
 private:
     ros::NodeHandle _nh;
     std::shared_ptr<dynamixel::PortHandler> _portHandler;
     std::shared_ptr<dynamixel::PacketHandler> _packetHandler;
 
+    // protects the details of the bus error, set by the control loop and read by the services
     mutable std::mutex _sync_mutex;
 
     std::string _device_name;
+    // current speed of the bus, the one configured is the safe speed all the devices start with
     int _baudrate{1000000};
-
-    std::vector<uint8_t> _all_ids_connected; // with all ttl motors connected (including the tool)
+    // speed the bus is upgraded to at startup, 0 to keep the safe speed
+    int _target_baudrate{0};
+    // how the half-duplex direction is switched after a write ("gpio_sleep", "gpio_drain" or "rs485")
+    std::string _direction_control{"gpio_sleep"};
+    std::string _replay_file;
+
+    // registered ttl motors (including the tool) found on the bus by the last scan
+    std::vector<uint8_t> _connected_motor_id_list;
     std::vector<uint8_t> _removed_motor_id_list;
+    // consecutive successful pings of each missing motor
+    std::map<uint8_t, int> _reconnection_counters;
+    // consecutive sync reads without position for each motor
+    std::map<uint8_t, uint32_t> _position_fail_counters;
 
     // state of a component for a given id
     std::map<uint8_t, std::shared_ptr<common::model::AbstractHardwareState> > _state_map;
@@ -209,13 +351,53 @@ private:
     std::shared_ptr<ttl_driver::AbstractTtlDriver> _default_ttl_driver;
     std::shared_ptr<ttl_driver::AbstractStepperDriver> _default_stepper_driver;
 
+    // additional buses, each one with its devices, its drivers and its I/O thread.
+    // The devices of the main bus are the ones not assigned to any of them
+    std::vector<std::unique_ptr<TtlPort> > _extra_ports;
+
     // vector of ids of motors and conveyors
     // Theses vector help remove loop not necessary
     std::vector<uint8_t> _conveyor_list;
 
+    /**
+     * @brief The JointTrajectoryGroup struct : joints of the trajectory written with the same driver,
+     * with the buffers of their sync write allocated once
+     */
+    struct JointTrajectoryGroup
+    {
+        std::shared_ptr<ttl_driver::AbstractMotorDriver> driver;
+        std::vector<size_t> slots;
+        std::vector<uint8_t> ids;
+        std::vector<uint32_t> params;
+
+        // steppers only : max velocity of the profile last written for each slot (0 if unknown), see executeJointTrajectorySegment
+        std::shared_ptr<ttl_driver::AbstractStepperDriver> stepper_driver;
+        std::vector<uint32_t> v_max;
+        // steppers only : 1 for the slots whose goal of the last segment has not been written yet
+        std::vector<uint8_t> goal_pending;
+        std::vector<uint8_t> v_max_ids;
+        std::vector<uint32_t> v_max_params;
+    };
+
+    // ids of the joints for each slot of the trajectory goals
+    std::vector<uint8_t> _joint_trajectory_ids;
+    std::vector<JointTrajectoryGroup> _joint_trajectory_groups;
+    // the groups are built again when a component is added or removed
+    bool _joint_trajectory_layout_changed{true};
+
+    // sync reads of the joints positions, one stage per driver, prepared once
+    std::unique_ptr<SyncReadPipeline> _joints_status_pipeline;
+    // the stages are built again when a component is added or removed
+    bool _joints_status_layout_changed{true};
+
     // for hardware control
     bool _is_connection_ok{false};
-    std::string _debug_error_message;
+    EBusError _bus_error{EBusError::NOT_CONNECTED_YET};
+    // details of the last SINGLE_WRITE_FAILED error
+    uint8_t _bus_error_cmd_id{0};
+    const char* _bus_error_cmd_type{""};
+    // missing motors when the MISSING_MOTORS error was set
+    std::vector<uint8_t> _bus_error_missing_ids;
 
     uint32_t _hw_fail_counter_read{0};
     uint32_t _end_effector_fail_counter_read{0};
@@ -225,6 +407,11 @@ private:
 
     static constexpr uint32_t MAX_HW_FAILURE = 150;
     static constexpr uint32_t MAX_READ_EE_FAILURE = 150;
+    static constexpr int RECONNECTION_HYSTERESIS = 3;
+
+    // firmware version read at registration: sync read per type first, then one read per id
+    static constexpr int FIRMWARE_SYNC_READ_TRIES = 3;
+    static constexpr int FIRMWARE_SINGLE_READ_TRIES = 7;
 
     // at init, no hw, so no calib needed
     common::model::EStepperCalibrationStatus _calibration_status{common::model::EStepperCalibrationStatus::OK};
@@ -318,23 +505,23 @@ size_t TtlManager::getNbMotors() const
 }
 
 /**
- * @brief TtlManager::getRemovedMotorList
- * @return
+ * @brief TtlManager::getBaudrate
+ * @return baudrate of the main bus
  */
 inline
-std::vector<uint8_t> TtlManager::getRemovedMotorList() const
+int TtlManager::getBaudrate() const
 {
-    return _removed_motor_id_list;
+    return _baudrate;
 }
 
 /**
- * @brief TtlManager::getErrorMessage
+ * @brief TtlManager::getRemovedMotorList
  * @return
  */
 inline
-std::string TtlManager::getErrorMessage() const
+std::vector<uint8_t> TtlManager::getRemovedMotorList() const
 {
-    return _debug_error_message;
+    return _removed_motor_id_list;
 }
 
 /**
@@ -437,6 +624,34 @@ void TtlManager::retrieveFakeMotorData(const std::string& current_ns, std::map<u
     }
 }
 
+/**
+ * @brief TtlManager::setBusError
+ * @param error
+ */
+inline
+void TtlManager::setBusError(EBusError error)
+{
+    std::lock_guard<std::mutex> lck(_sync_mutex);
+    _bus_error = error;
+    if (EBusError::MISSING_MOTORS == error)
+        _bus_error_missing_ids = _removed_motor_id_list;
+}
+
+/**
+ * @brief TtlManager::setBusError : error of a command, set with its details so that they are read together
+ * @param error
+ * @param cmd_id : id of the device the command failed on
+ * @param cmd_type : name of the command type
+ */
+inline
+void TtlManager::setBusError(EBusError error, uint8_t cmd_id, const char* cmd_type)
+{
+    std::lock_guard<std::mutex> lck(_sync_mutex);
+    _bus_error = error;
+    _bus_error_cmd_id = cmd_id;
+    _bus_error_cmd_type = cmd_type;
+}
+
 /**
  * @brief TtlManager::getCollisionStatus
  * @return
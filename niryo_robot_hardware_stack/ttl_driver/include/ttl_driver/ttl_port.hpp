@@ -0,0 +1,179 @@
+/*
+ttl_port.hpp
+Copyright (C) 2020 Niryo
+All rights reserved.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#ifndef TTL_PORT_HPP
+#define TTL_PORT_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dynamixel_sdk/dynamixel_sdk.h"
+
+#include "common/model/hardware_type_enum.hpp"
+#include "ttl_driver/abstract_ttl_driver.hpp"
+
+namespace ttl_driver
+{
+
+    /**
+     * @brief The TtlPort class is an additional TTL bus, with its own device, baudrate, devices and drivers.
+     * Its exchanges are done by its own I/O thread : the jobs posted on several ports run in parallel,
+     * the caller waiting for them before using their results. Between two jobs, the port can be used
+     * directly by the caller (single commands, services), as nothing else accesses it
+     */
+    class TtlPort
+    {
+    public:
+        TtlPort(std::string device_name, int baudrate, std::vector<uint8_t> assigned_ids);
+        ~TtlPort();
+        TtlPort(const TtlPort &) = delete;
+        TtlPort(TtlPort &&) = delete;
+        TtlPort &operator=(TtlPort &&) = delete;
+        TtlPort &operator=(const TtlPort &) = delete;
+
+        bool init(const std::string &direction_control);
+        int setupCommunication();
+
+        const std::string &getDeviceName() const;
+        int getBaudRate() const;
+        std::shared_ptr<dynamixel::PortHandler> getPortHandler() const;
+        std::shared_ptr<dynamixel::PacketHandler> getPacketHandler() const;
+
+        // devices
+        bool isAssigned(uint8_t id) const;
+
+        void addId(common::model::EHardwareType type, uint8_t id);
+        void removeId(uint8_t id);
+        const std::map<common::model::EHardwareType, std::vector<uint8_t>> &getIdsMap() const;
+        std::vector<uint8_t> getIds() const;
+
+        // drivers
+        void addDriver(common::model::EHardwareType type, std::shared_ptr<AbstractTtlDriver> driver);
+        bool hasDriver(common::model::EHardwareType type) const;
+        std::shared_ptr<AbstractTtlDriver> getDriver(common::model::EHardwareType type) const;
+        std::shared_ptr<AbstractTtlDriver> getDefaultDriver() const;
+        const std::map<common::model::EHardwareType, std::shared_ptr<AbstractTtlDriver>> &getDriverMap() const;
+
+        // I/O thread
+        void post(std::function<void()> job);
+        void wait();
+
+    private:
+        void ioLoop();
+
+    private:
+        std::string _device_name;
+        int _baudrate;
+        // ids configured on this port
+        std::vector<uint8_t> _assigned_ids;
+
+        std::shared_ptr<dynamixel::PortHandler> _portHandler;
+        std::shared_ptr<dynamixel::PacketHandler> _packetHandler;
+
+        // registered ids and drivers of the devices of this port, for each hardware type
+        std::map<common::model::EHardwareType, std::vector<uint8_t>> _ids_map;
+        std::map<common::model::EHardwareType, std::shared_ptr<AbstractTtlDriver>> _driver_map;
+        // for the operations common to all the drivers (ping, scan)
+        std::shared_ptr<AbstractTtlDriver> _default_driver;
+
+        std::thread _io_thread;
+        std::mutex _job_mutex;
+        std::condition_variable _job_cv;
+        std::function<void()> _job;
+        bool _job_pending{false};
+        bool _stop{false};
+    };
+
+    /**
+     * @brief TtlPort::getDeviceName
+     * @return
+     */
+    inline
+    const std::string &TtlPort::getDeviceName() const
+    {
+        return _device_name;
+    }
+
+    /**
+     * @brief TtlPort::getBaudRate
+     * @return
+     */
+    inline
+    int TtlPort::getBaudRate() const
+    {
+        return _baudrate;
+    }
+
+    /**
+     * @brief TtlPort::getPortHandler
+     * @return
+     */
+    inline
+    std::shared_ptr<dynamixel::PortHandler> TtlPort::getPortHandler() const
+    {
+        return _portHandler;
+    }
+
+    /**
+     * @brief TtlPort::getPacketHandler
+     * @return
+     */
+    inline
+    std::shared_ptr<dynamixel::PacketHandler> TtlPort::getPacketHandler() const
+    {
+        return _packetHandler;
+    }
+
+    /**
+     * @brief TtlPort::getIdsMap
+     * @return
+     */
+    inline
+    const std::map<common::model::EHardwareType, std::vector<uint8_t>> &TtlPort::getIdsMap() const
+    {
+        return _ids_map;
+    }
+
+    /**
+     * @brief TtlPort::getDefaultDriver
+     * @return
+     */
+    inline
+    std::shared_ptr<AbstractTtlDriver> TtlPort::getDefaultDriver() const
+    {
+        return _default_driver;
+    }
+
+    /**
+     * @brief TtlPort::getDriverMap
+     * @return
+     */
+    inline
+    const std::map<common::model::EHardwareType, std::shared_ptr<AbstractTtlDriver>> &TtlPort::getDriverMap() const
+    {
+        return _driver_map;
+    }
+
+} // ttl_driver
+
+#endif // TTL_PORT_HPP
@@ -16,6 +16,7 @@
 
 #include "ttl_driver/abstract_motor_driver.hpp"
 
+#include <algorithm>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -43,4 +44,22 @@ AbstractMotorDriver::AbstractMotorDriver(shared_ptr<dynamixel::PortHandler> port
  */
 std::string AbstractMotorDriver::str() const { return "Motor Driver (" + AbstractTtlDriver::str() + ")"; }
 
+/**
+ * @brief AbstractMotorDriver::syncReadPartialPosition : by default, only the positions read before the first failure are valid
+ * @param id_list
+ * @param position_list : one position per id
+ * @param valid_list : one flag per id
+ * @return
+ */
+int AbstractMotorDriver::syncReadPartialPosition(const std::vector<uint8_t> &id_list, std::vector<uint32_t> &position_list, std::vector<uint8_t> &valid_list)
+{
+    int res = syncReadPosition(id_list, position_list);
+
+    valid_list.assign(id_list.size(), 0);
+    std::fill_n(valid_list.begin(), std::min(position_list.size(), id_list.size()), 1);
+    position_list.resize(id_list.size());
+
+    return res;
+}
+
 }  // namespace ttl_driver
@@ -16,6 +16,8 @@
 
 #include "ttl_driver/abstract_ttl_driver.hpp"
 
+#include <algorithm>
+#include <array>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -76,6 +78,43 @@ int AbstractTtlDriver::getModelNumber(uint8_t id, uint16_t &model_number)
  */
 int AbstractTtlDriver::scan(vector<uint8_t> &id_list) { return _dxlPacketHandler->broadcastPing(_dxlPortHandler.get(), id_list); }
 
+/**
+ * @brief AbstractTtlDriver::scanKnownIds : check that the given ids are on the bus, with a single sync read
+ * of their model number. Contrary to scan, which always waits for the whole broadcast ping window,
+ * status packets are parsed as they arrive and the scan ends as soon as every expected id has answered.
+ * @param expected_ids
+ * @param found_ids : ids which answered, in their order of arrival
+ * @return COMM_SUCCESS if all the expected ids answered, COMM_RX_TIMEOUT if some are missing
+ */
+int AbstractTtlDriver::scanKnownIds(const vector<uint8_t> &expected_ids, vector<uint8_t> &found_ids)
+{
+    found_ids.clear();
+
+    if (expected_ids.empty())
+        return COMM_SUCCESS;
+
+    vector<uint8_t> param(expected_ids);
+    int result = _dxlPacketHandler->syncReadTx(_dxlPortHandler.get(), ADDR_MODEL_NUMBER, DXL_LEN_TWO_BYTES, param.data(), static_cast<uint16_t>(param.size()));
+
+    // the timeout of the sync read is the worst case of all the status packets, rxPacket does not restart it
+    std::array<uint8_t, STATUS_PACKET_MAX_LEN> rxpacket{};
+    while (COMM_SUCCESS == result && found_ids.size() < expected_ids.size())
+    {
+        result = _dxlPacketHandler->rxPacket(_dxlPortHandler.get(), rxpacket.data());
+
+        uint8_t id = rxpacket.at(STATUS_PACKET_ID_INDEX);
+        if (COMM_SUCCESS == result && std::find(expected_ids.begin(), expected_ids.end(), id) != expected_ids.end() &&
+            std::find(found_ids.begin(), found_ids.end(), id) == found_ids.end())
+            found_ids.emplace_back(id);
+    }
+
+    if (found_ids.size() == expected_ids.size())
+        return COMM_SUCCESS;
+
+    // a missing device only shows up as a timeout, a corrupted packet stops the parsing too
+    return (COMM_RX_CORRUPT == result || COMM_RX_TIMEOUT == result) ? COMM_RX_TIMEOUT : result;
+}
+
 /**
  * @brief AbstractTtlDriver::reboot
  * @param id
@@ -192,4 +231,72 @@ int AbstractTtlDriver::writeCustom(uint16_t address, uint8_t data_len, uint8_t i
     return dxl_comm_result;
 }
 
+/**
+ * @brief AbstractTtlDriver::syncWriteCustom : write the same value in the same register of several devices
+ * @param address
+ * @param data_len
+ * @param id_list
+ * @param data
+ * @return
+ */
+int AbstractTtlDriver::syncWriteCustom(uint16_t address, uint8_t data_len, const std::vector<uint8_t> &id_list, uint32_t data)
+{
+    int dxl_comm_result = COMM_TX_FAIL;
+
+    switch (data_len)
+    {
+    case DXL_LEN_ONE_BYTE:
+        dxl_comm_result = syncWrite<uint8_t>(address, id_list, std::vector<uint8_t>(id_list.size(), static_cast<uint8_t>(data)));
+        break;
+    case DXL_LEN_TWO_BYTES:
+        dxl_comm_result = syncWrite<uint16_t>(address, id_list, std::vector<uint16_t>(id_list.size(), static_cast<uint16_t>(data)));
+        break;
+    case DXL_LEN_FOUR_BYTES:
+        dxl_comm_result = syncWrite<uint32_t>(address, id_list, std::vector<uint32_t>(id_list.size(), data));
+        break;
+    default:
+        printf("AbstractTtlDriver::syncWriteCustom ERROR: Size param must be 1, 2 or 4 bytes\n");
+        break;
+    }
+
+    return dxl_comm_result;
+}
+
+/**
+ * @brief AbstractTtlDriver::syncReadPartialHwErrorStatus : by default, only the values read before the first failure are valid
+ * @param id_list
+ * @param hw_error_list : one value per id
+ * @param valid_list : one flag per id
+ * @return
+ */
+int AbstractTtlDriver::syncReadPartialHwErrorStatus(const std::vector<uint8_t> &id_list, std::vector<uint8_t> &hw_error_list, std::vector<uint8_t> &valid_list)
+{
+    int res = syncReadHwErrorStatus(id_list, hw_error_list);
+
+    valid_list.assign(id_list.size(), 0);
+    std::fill_n(valid_list.begin(), std::min(hw_error_list.size(), id_list.size()), 1);
+    hw_error_list.resize(id_list.size());
+
+    return res;
+}
+
+/**
+ * @brief AbstractTtlDriver::syncReadPartialHwStatus : by default, only the values read before the first failure are valid
+ * @param id_list
+ * @param data_array_list : one (voltage, temperature) per id
+ * @param valid_list : one flag per id
+ * @return
+ */
+int AbstractTtlDriver::syncReadPartialHwStatus(const std::vector<uint8_t> &id_list, std::vector<std::pair<double, uint8_t>> &data_array_list,
+                                               std::vector<uint8_t> &valid_list)
+{
+    int res = syncReadHwStatus(id_list, data_array_list);
+
+    valid_list.assign(id_list.size(), 0);
+    std::fill_n(valid_list.begin(), std::min(data_array_list.size(), id_list.size()), 1);
+    data_array_list.resize(id_list.size());
+
+    return res;
+}
+
 }  // namespace ttl_driver
@@ -16,6 +16,7 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 
 #include "ttl_driver/mock_dxl_driver.hpp"
 #include "dynamixel_sdk/packet_handler.h"
+#include <algorithm>
 #include <cstdint>
 #include <cstdio>
 #include <map>
@@ -108,6 +109,24 @@ int MockDxlDriver::scan(std::vector<uint8_t> &id_list)
     return COMM_SUCCESS;
 }
 
+/**
+ * @brief MockDxlDriver::scanKnownIds
+ * @param expected_ids
+ * @param found_ids
+ * @return
+ */
+int MockDxlDriver::scanKnownIds(const std::vector<uint8_t> &expected_ids, std::vector<uint8_t> &found_ids)
+{
+    found_ids.clear();
+    for (auto const &id : expected_ids)
+    {
+        if (std::find(_fake_data->full_id_list.begin(), _fake_data->full_id_list.end(), id) != _fake_data->full_id_list.end())
+            found_ids.emplace_back(id);
+    }
+
+    return (found_ids.size() == expected_ids.size()) ? COMM_SUCCESS : COMM_RX_TIMEOUT;
+}
+
 /**
  * @brief MockDxlDriver::reboot
  * @param id
@@ -516,6 +535,68 @@ int MockDxlDriver::syncReadPosition(const std::vector<uint8_t> &id_list, std::ve
     return COMM_SUCCESS;
 }
 
+/**
+ * @brief MockDxlDriver::syncReadPartialPosition : the ids missing in the fake data do not answer, the others still do
+ * @param id_list
+ * @param position_list : one position per id
+ * @param valid_list : one flag per id
+ * @return COMM_SUCCESS if all the ids answered
+ */
+int MockDxlDriver::syncReadPartialPosition(const std::vector<uint8_t> &id_list, std::vector<uint32_t> &position_list, std::vector<uint8_t> &valid_list)
+{
+    std::set<uint8_t> countSet;
+    int res = COMM_SUCCESS;
+
+    position_list.assign(id_list.size(), 0);
+    valid_list.assign(id_list.size(), 0);
+    for (size_t i = 0; i < id_list.size(); ++i)
+    {
+        uint8_t id = id_list.at(i);
+        if (!countSet.insert(id).second)
+            return GROUP_SYNC_REDONDANT_ID;  // redondant id
+
+        if (_fake_data->dxl_registers.count(id))
+            position_list.at(i) = _fake_data->dxl_registers.at(id).position;
+        else if (_fake_data->stepper_registers.count(id))
+            position_list.at(i) = _fake_data->stepper_registers.at(id).position;
+        else
+        {
+            res = COMM_RX_FAIL;
+            continue;
+        }
+
+        valid_list.at(i) = 1;
+    }
+    return res;
+}
+
+/**
+ * @brief MockDxlDriver::syncReadTorqueEnable
+ * @param id_list
+ * @param torque_enable_list
+ * @return
+ */
+int MockDxlDriver::syncReadTorqueEnable(const std::vector<uint8_t> &id_list, std::vector<uint8_t> &torque_enable_list)
+{
+    std::set<uint8_t> countSet;
+
+    torque_enable_list.clear();
+    for (auto &id : id_list)
+    {
+        if (_fake_data->dxl_registers.count(id))
+            torque_enable_list.emplace_back(_fake_data->dxl_registers.at(id).torque);
+        else if (_fake_data->stepper_registers.count(id))
+            torque_enable_list.emplace_back(_fake_data->stepper_registers.at(id).torque);
+        else
+            return COMM_RX_FAIL;
+
+        auto result = countSet.insert(id);
+        if (!result.second)
+            return GROUP_SYNC_REDONDANT_ID;  // redondant id
+    }
+    return COMM_SUCCESS;
+}
+
 /**
  * @brief MockDxlDriver::syncReadVelocity
  * @param id_list
@@ -17,6 +17,7 @@ along with this program.  If not, see <http:// www.gnu.org/licenses/>.
 #include "ttl_driver/mock_end_effector_driver.hpp"
 
 #include "ttl_driver/end_effector_reg.hpp"
+#include <algorithm>
 #include <cstddef>
 #include <memory>
 #include <string>
@@ -42,7 +43,7 @@ MockEndEffectorDriver::MockEndEffectorDriver(std::shared_ptr<FakeTtlData> data)
  */
 std::string MockEndEffectorDriver::str() const
 {
-    return common::model::HardwareTypeEnum(EndEffectorReg::motor_type).toString() + " : " + ttl_driver::AbstractEndEffectorDriver::str();
+    return std::string(common::model::HardwareTypeEnum(EndEffectorReg::motor_type).toString()) + " : " + ttl_driver::AbstractEndEffectorDriver::str();
 }
 
 /**
@@ -104,6 +105,24 @@ int MockEndEffectorDriver::scan(std::vector<uint8_t> &id_list)
     return COMM_SUCCESS;
 }
 
+/**
+ * @brief MockEndEffectorDriver::scanKnownIds
+ * @param expected_ids
+ * @param found_ids
+ * @return
+ */
+int MockEndEffectorDriver::scanKnownIds(const std::vector<uint8_t> &expected_ids, std::vector<uint8_t> &found_ids)
+{
+    found_ids.clear();
+    for (auto const &id : expected_ids)
+    {
+        if (std::find(_fake_data->full_id_list.begin(), _fake_data->full_id_list.end(), id) != _fake_data->full_id_list.end())
+            found_ids.emplace_back(id);
+    }
+
+    return (found_ids.size() == expected_ids.size()) ? COMM_SUCCESS : COMM_RX_TIMEOUT;
+}
+
 /**
  * @brief MockEndEffectorDriver::reboot
  * @param id
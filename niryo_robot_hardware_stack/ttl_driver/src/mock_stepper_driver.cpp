@@ -128,6 +128,24 @@ int MockStepperDriver::scan(std::vector<uint8_t> &id_list)
     return COMM_SUCCESS;
 }
 
+/**
+ * @brief MockStepperDriver::scanKnownIds
+ * @param expected_ids
+ * @param found_ids
+ * @return
+ */
+int MockStepperDriver::scanKnownIds(const std::vector<uint8_t> &expected_ids, std::vector<uint8_t> &found_ids)
+{
+    found_ids.clear();
+    for (auto const &id : expected_ids)
+    {
+        if (std::find(_fake_data->full_id_list.begin(), _fake_data->full_id_list.end(), id) != _fake_data->full_id_list.end())
+            found_ids.emplace_back(id);
+    }
+
+    return (found_ids.size() == expected_ids.size()) ? COMM_SUCCESS : COMM_RX_TIMEOUT;
+}
+
 /**
  * @brief MockStepperDriver::reboot
  * @param id
@@ -220,11 +238,14 @@ int MockStepperDriver::readMaxPosition(uint8_t id, uint32_t &pos)
  * @param torque_enable
  * @return
  */
-int MockStepperDriver::writeTorqueEnable(uint8_t id, uint8_t /*torque_enable*/)
+int MockStepperDriver::writeTorqueEnable(uint8_t id, uint8_t torque_enable)
 {
     if (COMM_SUCCESS != ping(id))
         return COMM_RX_FAIL;
 
+    if (_fake_data->stepper_registers.count(id))
+        _fake_data->stepper_registers.at(id).torque = torque_enable;
+
     return COMM_SUCCESS;
 }
 
@@ -265,7 +286,7 @@ int MockStepperDriver::writeVelocityGoal(uint8_t id, uint32_t velocity)
  * @param torque_enable_list
  * @return
  */
-int MockStepperDriver::syncWriteTorqueEnable(const std::vector<uint8_t> &id_list, const std::vector<uint8_t> & /*torque_enable_list*/)
+int MockStepperDriver::syncWriteTorqueEnable(const std::vector<uint8_t> &id_list, const std::vector<uint8_t> &torque_enable_list)
 {
     // Create a map to store the frequency of each element in vector
     std::set<uint8_t> countSet;
@@ -277,6 +298,12 @@ int MockStepperDriver::syncWriteTorqueEnable(const std::vector<uint8_t> &id_list
         if (!result.second)
             return GROUP_SYNC_REDONDANT_ID;  // redondant id
     }
+
+    for (size_t i = 0; i < id_list.size() && i < torque_enable_list.size(); i++)
+    {
+        if (_fake_data->stepper_registers.count(id_list.at(i)))
+            _fake_data->stepper_registers.at(id_list.at(i)).torque = torque_enable_list.at(i);
+    }
     return COMM_SUCCESS;
 }
 
@@ -430,6 +457,68 @@ int MockStepperDriver::syncReadPosition(const std::vector<uint8_t> &id_list, std
     return COMM_SUCCESS;
 }
 
+/**
+ * @brief MockStepperDriver::syncReadPartialPosition : the ids missing in the fake data do not answer, the others still do
+ * @param id_list
+ * @param position_list : one position per id
+ * @param valid_list : one flag per id
+ * @return COMM_SUCCESS if all the ids answered
+ */
+int MockStepperDriver::syncReadPartialPosition(const std::vector<uint8_t> &id_list, std::vector<uint32_t> &position_list, std::vector<uint8_t> &valid_list)
+{
+    std::set<uint8_t> countSet;
+    int res = COMM_SUCCESS;
+
+    position_list.assign(id_list.size(), 0);
+    valid_list.assign(id_list.size(), 0);
+    for (size_t i = 0; i < id_list.size(); ++i)
+    {
+        uint8_t id = id_list.at(i);
+        if (!countSet.insert(id).second)
+            return GROUP_SYNC_REDONDANT_ID;  // redondant id
+
+        if (_fake_data->dxl_registers.count(id))
+            position_list.at(i) = _fake_data->dxl_registers.at(id).position;
+        else if (_fake_data->stepper_registers.count(id))
+            position_list.at(i) = _fake_data->stepper_registers.at(id).position;
+        else
+        {
+            res = COMM_RX_FAIL;
+            continue;
+        }
+
+        valid_list.at(i) = 1;
+    }
+    return res;
+}
+
+/**
+ * @brief MockStepperDriver::syncReadTorqueEnable
+ * @param id_list
+ * @param torque_enable_list
+ * @return
+ */
+int MockStepperDriver::syncReadTorqueEnable(const std::vector<uint8_t> &id_list, std::vector<uint8_t> &torque_enable_list)
+{
+    std::set<uint8_t> countSet;
+
+    torque_enable_list.clear();
+    for (auto &id : id_list)
+    {
+        if (_fake_data->dxl_registers.count(id))
+            torque_enable_list.emplace_back(_fake_data->dxl_registers.at(id).torque);
+        else if (_fake_data->stepper_registers.count(id))
+            torque_enable_list.emplace_back(_fake_data->stepper_registers.at(id).torque);
+        else
+            return COMM_RX_FAIL;
+
+        auto result = countSet.insert(id);
+        if (!result.second)
+            return GROUP_SYNC_REDONDANT_ID;  // redondant id
+    }
+    return COMM_SUCCESS;
+}
+
 /**
  * @brief MockStepperDriver::syncReadVelocity
  * @param id_list
@@ -875,4 +964,31 @@ int MockStepperDriver::syncWriteHomingAbsPosition(const std::vector<uint8_t> &id
     return COMM_SUCCESS;
 }
 
+/**
+ * @brief MockStepperDriver::syncWriteVelocityMax
+ * @param id_list
+ * @param v_max_list
+ * @return
+ */
+int MockStepperDriver::syncWriteVelocityMax(const std::vector<uint8_t> &id_list, const std::vector<uint32_t> &v_max_list)
+{
+    if (id_list.size() != v_max_list.size())
+        return LEN_ID_DATA_NOT_SAME;
+
+    std::set<uint8_t> countSet;
+
+    for (size_t i = 0; i < id_list.size(); ++i)
+    {
+        if (_fake_data->stepper_registers.count(id_list.at(i)))
+            _fake_data->stepper_registers.at(id_list.at(i)).v_max = v_max_list.at(i);
+        else
+            return COMM_TX_ERROR;
+
+        auto result = countSet.insert(id_list.at(i));
+        if (!result.second)
+            return GROUP_SYNC_REDONDANT_ID;  // redondant id
+    }
+    return COMM_SUCCESS;
+}
+
 }  // namespace ttl_driver
@@ -0,0 +1,287 @@
+/*
+replay_port_handler.cpp
+Copyright (C) 2020 Niryo
+All rights reserved.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#include "ttl_driver/replay_port_handler.hpp"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ros/ros.h"
+
+using ::common::util::CaptureRecord;
+
+namespace ttl_driver
+{
+
+// latency of the usb serial adapters, as taken into account by the dynamixel port handlers
+static constexpr double LATENCY_TIMER_MS = 16.0;
+
+/**
+ * @brief ReplayPortHandler::ReplayPortHandler
+ * @param realtime : reproduce the response delays of the capture
+ */
+ReplayPortHandler::ReplayPortHandler(bool realtime) : _realtime(realtime)
+{
+    is_using_ = false;
+}
+
+/**
+ * @brief ReplayPortHandler::load
+ * @param file_path : capture of a TTL bus
+ * @return
+ */
+bool ReplayPortHandler::load(const std::string &file_path)
+{
+    common::util::BusCaptureReader reader;
+    std::vector<CaptureRecord> records;
+
+    if (!reader.open(file_path) || common::model::EBusProtocol::TTL != reader.getProtocol() || !reader.readAll(records))
+    {
+        ROS_ERROR("ReplayPortHandler::load - unable to read a TTL capture from %s", file_path.c_str());
+        return false;
+    }
+
+    if (!reader.isComplete())
+        ROS_WARN("ReplayPortHandler::load - capture %s has been interrupted, %u records recovered", file_path.c_str(), reader.getRecordCount());
+
+    setRecords(std::move(records));
+    return true;
+}
+
+/**
+ * @brief ReplayPortHandler::setRecords
+ * @param records
+ */
+void ReplayPortHandler::setRecords(std::vector<CaptureRecord> records)
+{
+    _records = std::move(records);
+    _cursor = 0;
+    _matched_count = 0;
+    _missed_count = 0;
+    clearPort();
+}
+
+//*****************************
+// PortHandler interface
+//*****************************
+
+/**
+ * @brief ReplayPortHandler::gpioHigh
+ */
+void ReplayPortHandler::gpioHigh() {}
+
+/**
+ * @brief ReplayPortHandler::gpioLow
+ */
+void ReplayPortHandler::gpioLow() {}
+
+/**
+ * @brief ReplayPortHandler::openPort
+ * @return
+ */
+bool ReplayPortHandler::openPort() { return setBaudRate(_baudrate); }
+
+/**
+ * @brief ReplayPortHandler::closePort
+ */
+void ReplayPortHandler::closePort() { clearPort(); }
+
+/**
+ * @brief ReplayPortHandler::clearPort
+ */
+void ReplayPortHandler::clearPort()
+{
+    _pending_status.clear();
+    _rx_buffer.clear();
+}
+
+/**
+ * @brief ReplayPortHandler::flushInput
+ */
+void ReplayPortHandler::flushInput() { clearPort(); }
+
+/**
+ * @brief ReplayPortHandler::setPortName
+ * @param port_name
+ */
+void ReplayPortHandler::setPortName(const char *port_name) { _port_name = port_name; }
+
+/**
+ * @brief ReplayPortHandler::getPortName
+ * @return
+ */
+const char *ReplayPortHandler::getPortName() { return _port_name.c_str(); }
+
+/**
+ * @brief ReplayPortHandler::setBaudRate
+ * @param baudrate
+ * @return
+ */
+bool ReplayPortHandler::setBaudRate(const int baudrate)
+{
+    if (baudrate <= 0)
+        return false;
+
+    _baudrate = baudrate;
+    return true;
+}
+
+/**
+ * @brief ReplayPortHandler::getBaudRate
+ * @return
+ */
+int ReplayPortHandler::getBaudRate() { return _baudrate; }
+
+/**
+ * @brief ReplayPortHandler::getBytesAvailable
+ * @return
+ */
+int ReplayPortHandler::getBytesAvailable()
+{
+    receivePending();
+    return static_cast<int>(_rx_buffer.size());
+}
+
+/**
+ * @brief ReplayPortHandler::readPort
+ * @param packet
+ * @param length
+ * @return
+ */
+int ReplayPortHandler::readPort(uint8_t *packet, int length)
+{
+    receivePending();
+
+    auto nb_bytes = std::min(static_cast<size_t>(std::max(length, 0)), _rx_buffer.size());
+    std::copy(_rx_buffer.begin(), _rx_buffer.begin() + static_cast<std::ptrdiff_t>(nb_bytes), packet);
+    _rx_buffer.erase(_rx_buffer.begin(), _rx_buffer.begin() + static_cast<std::ptrdiff_t>(nb_bytes));
+
+    return static_cast<int>(nb_bytes);
+}
+
+/**
+ * @brief ReplayPortHandler::writePort : look for the instruction in the capture and prepare the status packets that followed it
+ * @param packet
+ * @param length
+ * @return
+ */
+int ReplayPortHandler::writePort(uint8_t *packet, int length)
+{
+    size_t index = 0;
+    if (!findInstruction(packet, length, index))
+    {
+        // no device answers
+        _missed_count++;
+        return length;
+    }
+
+    _matched_count++;
+    auto now = std::chrono::steady_clock::now();
+    const CaptureRecord &instruction = _records.at(index);
+
+    for (_cursor = index + 1; _cursor < _records.size() && !(_records.at(_cursor).flags & CaptureRecord::TX); ++_cursor)
+    {
+        const CaptureRecord &status = _records.at(_cursor);
+        if (status.flags & CaptureRecord::ERROR)
+            continue;
+
+        auto delay = std::chrono::microseconds(_realtime ? status.timestamp_us - instruction.timestamp_us : 0);
+        _pending_status.emplace_back(now + delay, status.data);
+    }
+
+    return length;
+}
+
+/**
+ * @brief ReplayPortHandler::setPacketTimeout : same timeout as the dynamixel port handlers
+ * @param packet_length
+ */
+void ReplayPortHandler::setPacketTimeout(uint16_t packet_length)
+{
+    double tx_time_per_byte = (1000.0 / static_cast<double>(_baudrate)) * 10.0;
+    setPacketTimeout((tx_time_per_byte * static_cast<double>(packet_length)) + (LATENCY_TIMER_MS * 2.0) + 2.0);
+}
+
+/**
+ * @brief ReplayPortHandler::setPacketTimeout
+ * @param msec
+ */
+void ReplayPortHandler::setPacketTimeout(double msec)
+{
+    _packet_timeout_time = std::chrono::steady_clock::now() + std::chrono::microseconds(static_cast<int64_t>(msec * 1000.0));
+}
+
+/**
+ * @brief ReplayPortHandler::isPacketTimeout
+ * @return
+ */
+bool ReplayPortHandler::isPacketTimeout() { return std::chrono::steady_clock::now() > _packet_timeout_time; }
+
+//*****************************
+// private
+//*****************************
+
+/**
+ * @brief ReplayPortHandler::findInstruction
+ * @param packet
+ * @param length
+ * @param index : index of the instruction in the records
+ * @return
+ */
+bool ReplayPortHandler::findInstruction(const uint8_t *packet, int length, size_t &index) const
+{
+    if (length <= static_cast<int>(PKT_INSTRUCTION))
+        return false;
+
+    size_t end = std::min(_records.size(), _cursor + LOOKAHEAD);
+    size_t similar = end;
+
+    for (size_t i = _cursor; i < end; ++i)
+    {
+        const CaptureRecord &record = _records.at(i);
+        if (!(record.flags & CaptureRecord::TX) || record.data.size() <= PKT_INSTRUCTION)
+            continue;
+
+        if (record.data.size() == static_cast<size_t>(length) && std::equal(record.data.begin(), record.data.end(), packet))
+        {
+            index = i;
+            return true;
+        }
+
+        if (similar == end && record.data.at(PKT_ID) == packet[PKT_ID] && record.data.at(PKT_INSTRUCTION) == packet[PKT_INSTRUCTION])
+            similar = i;
+    }
+
+    index = similar;
+    return similar != end;
+}
+
+/**
+ * @brief ReplayPortHandler::receivePending : move the status packets whose delay has elapsed to the reception buffer
+ */
+void ReplayPortHandler::receivePending()
+{
+    auto now = std::chrono::steady_clock::now();
+    while (!_pending_status.empty() && _pending_status.front().first <= now)
+    {
+        _rx_buffer.insert(_rx_buffer.end(), _pending_status.front().second.begin(), _pending_status.front().second.end());
+        _pending_status.pop_front();
+    }
+}
+
+} // namespace ttl_driver
@@ -0,0 +1,154 @@
+/*
+sync_read_pipeline.cpp
+Copyright (C) 2020 Niryo
+All rights reserved.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#include "ttl_driver/sync_read_pipeline.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace ttl_driver
+{
+
+namespace
+{
+// protocol 2 packet layout : FF FF FD 00 ID LEN_L LEN_H INST PARAMS... CRC_L CRC_H
+constexpr size_t PACKET_ID_INDEX = 4;
+constexpr size_t PACKET_LENGTH_L_INDEX = 5;
+constexpr size_t PACKET_LENGTH_H_INDEX = 6;
+constexpr size_t PACKET_INSTRUCTION_INDEX = 7;
+constexpr size_t PACKET_PARAMETER_INDEX = 8;
+// header, reserved, id and length
+constexpr size_t PACKET_HEADER_LEN = 7;
+// header, length, instruction, error and crc of a status packet, as counted by the sdk for the timeout
+constexpr uint16_t STATUS_PACKET_LEN = 11;
+}  // namespace
+
+/**
+ * @brief SyncReadPipeline::SyncReadPipeline
+ * @param portHandler
+ * @param packetHandler
+ */
+SyncReadPipeline::SyncReadPipeline(std::shared_ptr<dynamixel::PortHandler> portHandler, std::shared_ptr<dynamixel::PacketHandler> packetHandler)
+    : _portHandler(std::move(portHandler)), _packetHandler(std::move(packetHandler))
+{
+}
+
+/**
+ * @brief SyncReadPipeline::addStage : build the sync read instruction of a stage
+ * @param address
+ * @param data_len : 1, 2 or 4 bytes
+ * @param id_list
+ * @return false if the instruction cannot be prepared (protocol without prepared packets, packet too long)
+ */
+bool SyncReadPipeline::addStage(uint16_t address, uint8_t data_len, const std::vector<uint8_t> &id_list)
+{
+    if (id_list.empty() || (1 != data_len && 2 != data_len && 4 != data_len))
+        return false;
+
+    Stage stage;
+    stage.address = address;
+    stage.data_len = data_len;
+    stage.ids = id_list;
+    stage.values.assign(id_list.size(), 0);
+    stage.received.assign(id_list.size(), 0);
+    stage.rx_length = static_cast<uint16_t>((STATUS_PACKET_LEN + data_len) * id_list.size());
+
+    // instruction, address, data length, ids and crc, with room for the byte stuffing
+    size_t param_length = 4 + id_list.size();
+    size_t packet_length = PACKET_HEADER_LEN + 1 + param_length + 2;
+    stage.packet.assign(packet_length + packet_length / 3 + 1, 0);
+
+    stage.packet.at(PACKET_ID_INDEX) = BROADCAST_ID;
+    stage.packet.at(PACKET_LENGTH_L_INDEX) = DXL_LOBYTE(param_length + 3);
+    stage.packet.at(PACKET_LENGTH_H_INDEX) = DXL_HIBYTE(param_length + 3);
+    stage.packet.at(PACKET_INSTRUCTION_INDEX) = INST_SYNC_READ;
+    stage.packet.at(PACKET_PARAMETER_INDEX) = DXL_LOBYTE(address);
+    stage.packet.at(PACKET_PARAMETER_INDEX + 1) = DXL_HIBYTE(address);
+    stage.packet.at(PACKET_PARAMETER_INDEX + 2) = data_len;
+    stage.packet.at(PACKET_PARAMETER_INDEX + 3) = 0;
+    std::copy(id_list.begin(), id_list.end(), stage.packet.begin() + PACKET_PARAMETER_INDEX + 4);
+
+    uint16_t prepared_length = _packetHandler->prepareTxPacket(stage.packet.data());
+    if (0 == prepared_length)
+        return false;
+
+    stage.packet.resize(prepared_length);
+
+    _rx_data.resize(std::max(_rx_data.size(), id_list.size() * data_len));
+    _rx_error.resize(std::max(_rx_error.size(), id_list.size()));
+
+    _stages.emplace_back(std::move(stage));
+
+    return true;
+}
+
+/**
+ * @brief SyncReadPipeline::clear
+ */
+void SyncReadPipeline::clear() { _stages.clear(); }
+
+/**
+ * @brief SyncReadPipeline::send : write the prepared instruction of a stage and start the timeout of its status packets
+ * @param stage
+ * @return
+ */
+int SyncReadPipeline::send(const Stage &stage)
+{
+    int result = _packetHandler->txPreparedPacket(_portHandler.get(), stage.packet.data(), static_cast<uint16_t>(stage.packet.size()));
+
+    if (COMM_SUCCESS == result)
+        _portHandler->setStatusPacketsTimeout(stage.rx_length, static_cast<uint16_t>(stage.ids.size()));
+
+    return result;
+}
+
+/**
+ * @brief SyncReadPipeline::receive : parse the status packets of a stage, the values of the ids which answered are kept
+ * @param stage
+ * @return
+ */
+int SyncReadPipeline::receive(Stage &stage)
+{
+    int result = _packetHandler->syncReadRx(_portHandler.get(), stage.data_len, stage.ids.data(), static_cast<uint16_t>(stage.ids.size()),
+                                            _rx_data.data(), _rx_error.data(), stage.received.data());
+    stage.receive_time = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < stage.ids.size(); ++i)
+    {
+        if (!stage.received.at(i))
+            continue;
+
+        const uint8_t *data = _rx_data.data() + i * stage.data_len;
+        switch (stage.data_len)
+        {
+        case 1:
+            stage.values.at(i) = data[0];
+            break;
+        case 2:
+            stage.values.at(i) = DXL_MAKEWORD(data[0], data[1]);
+            break;
+        default:
+            stage.values.at(i) = DXL_MAKEDWORD(DXL_MAKEWORD(data[0], data[1]), DXL_MAKEWORD(data[2], data[3]));
+            break;
+        }
+    }
+
+    return result;
+}
+
+}  // namespace ttl_driver
@@ -19,6 +19,7 @@
 #include "common/model/abstract_synchronize_motor_cmd.hpp"
 #include "common/model/hardware_type_enum.hpp"
 #include "common/model/joint_state.hpp"
+#include "common/util/log_defs.hpp"
 #include "common/util/unique_ptr_cast.hpp"
 #include "niryo_robot_msgs/CommandStatus.h"
 #include "ros/duration.h"
@@ -114,6 +115,10 @@ void TtlInterfaceCore::initParameters(ros::NodeHandle &nh)
     double read_data_frequency = 0.0;
     double read_end_effector_frequency = 0.0;
     double read_status_frequency = 0.0;
+    double check_connection_frequency = 0.0;
+    int goal_deadband = 0;
+    double goal_keep_alive = 1.0;
+    double trajectory_segment_duration = 0.0;
 
     nh.getParam("ttl_hardware_control_loop_frequency", _control_loop_frequency);
 
@@ -125,6 +130,14 @@ void TtlInterfaceCore::initParameters(ros::NodeHandle &nh)
 
     nh.getParam("ttl_hardware_read_status_frequency", read_status_frequency);
 
+    nh.getParam("ttl_hardware_check_connection_frequency", check_connection_frequency);
+
+    nh.getParam("ttl_hardware_goal_deadband", goal_deadband);
+
+    nh.getParam("ttl_hardware_goal_keep_alive", goal_keep_alive);
+
+    nh.getParam("ttl_hardware_trajectory_segment_duration", trajectory_segment_duration);
+
     nh.getParam("hardware_version", _hardware_version);
 
     ROS_DEBUG("TtlInterfaceCore::initParameters - ttl_hardware_control_loop_frequency : %f", _control_loop_frequency);
@@ -132,12 +145,21 @@ void TtlInterfaceCore::initParameters(ros::NodeHandle &nh)
     ROS_DEBUG("TtlInterfaceCore::initParameters - ttl_hardware_read_data_frequency : %f", read_data_frequency);
     ROS_DEBUG("TtlInterfaceCore::initParameters - ttl_hardware_read_end_effector_frequency : %f", read_end_effector_frequency);
     ROS_DEBUG("TtlInterfaceCore::initParameters - ttl_hardware_read_status_frequency : %f", read_status_frequency);
+    ROS_DEBUG("TtlInterfaceCore::initParameters - ttl_hardware_check_connection_frequency : %f", check_connection_frequency);
+    ROS_DEBUG("TtlInterfaceCore::initParameters - ttl_hardware_goal_deadband : %d", goal_deadband);
+    ROS_DEBUG("TtlInterfaceCore::initParameters - ttl_hardware_goal_keep_alive : %f", goal_keep_alive);
+    ROS_DEBUG("TtlInterfaceCore::initParameters - ttl_hardware_trajectory_segment_duration : %f", trajectory_segment_duration);
     ROS_DEBUG("TtlInterfaceCore::initParameters - hardware_version : %s", _hardware_version.c_str());
 
     _delta_time_data_read = 1.0 / read_data_frequency;
     _delta_time_end_effector_read = 1.0 / read_end_effector_frequency;
     _delta_time_status_read = 1.0 / read_status_frequency;
     _delta_time_write = 1.0 / write_frequency;
+    _delta_time_check_connection = 1.0 / check_connection_frequency;
+
+    _joint_goal_filter.setDeadband(goal_deadband);
+    _joint_goal_filter.setKeepAlive(goal_keep_alive);
+    _joint_segmenter.setDuration(trajectory_segment_duration);
 }
 
 /**
@@ -149,6 +171,8 @@ void TtlInterfaceCore::startServices(ros::NodeHandle &nh)
     // advertise services
     _activate_leds_server = nh.advertiseService("/niryo_robot/ttl_driver/set_dxl_leds", &TtlInterfaceCore::_callbackActivateLeds, this);
 
+    _bus_baudrate_server = nh.advertiseService("/niryo_robot/ttl_driver/set_bus_baudrate", &TtlInterfaceCore::_callbackSetBusBaudrate, this);
+
     _custom_cmd_server = nh.advertiseService("/niryo_robot/ttl_driver/send_custom_value", &TtlInterfaceCore::_callbackWriteCustomValue, this);
 
     _custom_cmd_getter = nh.advertiseService("/niryo_robot/ttl_driver/read_custom_value", &TtlInterfaceCore::_callbackReadCustomValue, this);
@@ -402,7 +426,7 @@ int TtlInterfaceCore::launchMotorsReport()
 
         for (auto const &res : results)
         {
-            ROS_INFO("%d \t| %s \t| %d | %d", std::get<0>(res), HardwareTypeEnum(std::get<1>(res)).toString().c_str(), std::get<2>(res), std::get<3>(res));
+            ROS_INFO("%d \t| %s \t| %d | %d", std::get<0>(res), HardwareTypeEnum(std::get<1>(res)).toString(), std::get<2>(res), std::get<3>(res));
         }
     }
     else
@@ -527,46 +551,48 @@ void TtlInterfaceCore::controlLoop()
         if (!_debug_flag)
         {
             // 1. check connection status of motors
+            // the motors still connected keep being read and the missing ones are probed in between (degraded mode)
             if (!_ttl_manager->isConnectionOk())
             {
-                // clear all commands concerned move joints to avoid when a motor reconnected, it moves a little bit because of command unsent yet
-                _joint_trajectory_cmd.clear();
-
-                // scan motors again
-                ROS_WARN_THROTTLE(1.0, "TtlInterfaceCore::controlLoop - motor connection error");
-                ros::Duration(0.1).sleep();
-
-                vector<uint8_t> missing_ids;
+                lock_guard<mutex> lck(_control_loop_mutex);
+                if (!_degraded_mode)
+                {
+                    // clear all commands concerned move joints to avoid when a motor reconnected, it moves a little bit because of command unsent yet
+                    _joint_trajectory_cmd.clear();
+                    _joint_goal_filter.reset();
+                    _joint_segmenter.reset();
+                    _degraded_mode = true;
 
-                int bus_state = COMM_PORT_BUSY;
+                    ROS_WARN("TtlInterfaceCore::controlLoop - motor connection error");
 
-                while (TTL_SCAN_OK != bus_state)
+                    // identify the missing motors
+                    _ttl_manager->scanAndCheck();
+                    _time_check_connection_last_read = ros::Time::now().toSec();
+                }
+                else if (ros::Time::now().toSec() - _time_check_connection_last_read >= _delta_time_check_connection)
                 {
-                    // scan and get removed motor
+                    if (TTL_SCAN_OK == _ttl_manager->checkRemovedMotors())
                     {
-                        lock_guard<mutex> lck(_control_loop_mutex);
-                        bus_state = _ttl_manager->scanAndCheck();
+                        _joint_trajectory_cmd.clear();
+                        _joint_goal_filter.reset();
+                        _joint_segmenter.reset();
+                        _degraded_mode = false;
+                        ROS_INFO("TtlInterfaceCore::controlLoop - Bus is ok");
                     }
-
-                    if (bus_state == TTL_SCAN_OK)
-                        break;
-
-                    missing_ids = getRemovedMotorList();
-
-                    std::string msg;
-                    msg += "TtlInterfaceCore::controlLoop - motor";
-                    for (auto const &id : missing_ids)
+                    else
                     {
-                        msg += " " + std::to_string(id);
+                        ROS_WARN_THROTTLE(1.0, "TtlInterfaceCore::controlLoop - motor %s do not seem to be connected",
+                                          common::util::listToString(_ttl_manager->getRemovedMotorList()).c_str());
                     }
-                    msg += " do not seem to be connected";
-                    ROS_WARN_THROTTLE(1.0, "%s", msg.c_str());
-
-                    // still keep hardware status updated
-                    _ttl_manager->readHardwareStatus();
-                    ros::Duration(0.25).sleep();
+                    _time_check_connection_last_read = ros::Time::now().toSec();
                 }
-
+            }
+            else if (_degraded_mode)
+            {
+                // connection recovered by another scan (scanAndCheck service for instance)
+                _joint_goal_filter.reset();
+                _joint_segmenter.reset();
+                _degraded_mode = false;
                 ROS_INFO("TtlInterfaceCore::controlLoop - Bus is ok");
             }
 
@@ -622,19 +648,54 @@ void TtlInterfaceCore::controlLoop()
 void TtlInterfaceCore::_executeCommand()
 {
     bool _need_sleep = false;
-    if (!_joint_trajectory_cmd.empty())
-    {
-        _ttl_manager->executeJointTrajectoryCmd(_joint_trajectory_cmd);
+
+    // a failed write is retried until the middle of the control period, then left for the next cycle
+    auto retry_deadline = common::util::RetryPolicy::Clock::time_point::max();
+    if (_control_loop_frequency > 0.0)
+        retry_deadline = common::util::RetryPolicy::Clock::now() +
+                         std::chrono::microseconds(static_cast<int64_t>(WRITE_RETRY_WINDOW_RATIO * 1000000.0 / _control_loop_frequency));
+
+    // the trajectory is held while a motor is missing, the other commands are still sent to the connected motors
+    if (_degraded_mode)
         _joint_trajectory_cmd.clear();
+
+    // an idle robot sends the same goals again and again : only the ones that changed are written
+    const std::vector<uint32_t> *goals = _joint_trajectory_cmd.read();
+    if (goals && _joint_segmenter.update(*goals))
+    {
+        // the steppers are only given the end of each segment, with the profile to reach it in time
+        recordCommandLatency(_ttl_manager->executeJointTrajectorySegment(_joint_segmenter.getStartGoals(), _joint_segmenter.getEndGoals(),
+                                                                         _joint_segmenter.getSlots(), _joint_segmenter.getElapsed()));
         _need_sleep = true;
     }
+    if (goals && _joint_goal_filter.filter(*goals, _joint_goal_mask))
+    {
+        if (_joint_segmenter.isEnabled())
+        {
+            for (size_t slot = 0; slot < _joint_goal_mask.size() && slot < _joint_segmenter.getSlots().size(); ++slot)
+            {
+                if (_joint_segmenter.getSlots()[slot])
+                    _joint_goal_mask[slot] = 0;
+            }
+        }
+
+        if (std::find(_joint_goal_mask.begin(), _joint_goal_mask.end(), 1) != _joint_goal_mask.end())
+        {
+            recordCommandLatency(_ttl_manager->executeJointTrajectoryCmd(*goals, _joint_goal_mask));
+            // only the goals written are recorded, the others are written again at the next cycle
+            _joint_goal_filter.commit(*goals, _joint_goal_mask);
+            _need_sleep = true;
+        }
+    }
+    // the single and sync commands (torque, reboot...) can change the goal of the motors, the next goals are all written
     if (!_single_cmds_queue.empty())
     {
         std::lock_guard<std::mutex> lock(_single_cmd_queue_mutex);
         if (_need_sleep)
             ros::Duration(0.001).sleep();
-        _ttl_manager->writeSingleCommand(std::move(_single_cmds_queue.front()));
-        _single_cmds_queue.pop();
+        if (TTL_WRITE_DEFERRED != _ttl_manager->writeSingleCommand(_single_cmds_queue.front(), _single_cmd_retry, retry_deadline))
+            _single_cmds_queue.pop();
+        _joint_goal_filter.reset();
         _need_sleep = true;
     }
     if (!_conveyor_cmds_queue.empty())
@@ -642,8 +703,8 @@ void TtlInterfaceCore::_executeCommand()
         std::lock_guard<std::mutex> lock(_conveyor_cmd_queue_mutex);
         if (_need_sleep)
             ros::Duration(0.001).sleep();
-        _ttl_manager->writeSingleCommand(std::move(_conveyor_cmds_queue.front()));
-        _conveyor_cmds_queue.pop();
+        if (TTL_WRITE_DEFERRED != _ttl_manager->writeSingleCommand(_conveyor_cmds_queue.front(), _conveyor_cmd_retry, retry_deadline))
+            _conveyor_cmds_queue.pop();
     }
     if (!_sync_cmds_queue.empty())
     {
@@ -651,8 +712,9 @@ void TtlInterfaceCore::_executeCommand()
 
         if (_need_sleep)
             ros::Duration(0.001).sleep();
-        _ttl_manager->writeSynchronizeCommand(std::move(_sync_cmds_queue.front()));
-        _sync_cmds_queue.pop();
+        if (TTL_WRITE_DEFERRED != _ttl_manager->writeSynchronizeCommand(_sync_cmds_queue.front(), _sync_cmd_retry, retry_deadline))
+            _sync_cmds_queue.pop();
+        _joint_goal_filter.reset();
         _need_sleep = true;
     }
     if (_need_sleep)
@@ -675,6 +737,55 @@ int TtlInterfaceCore::addJoint(const std::shared_ptr<common::model::JointState>
     return _ttl_manager->addHardwareComponent(jointState);
 }
 
+/**
+ * @brief TtlInterfaceCore::addJoints : add several joints at once, see TtlManager::addHardwareComponents
+ * @param joint_states
+ * @return
+ */
+int TtlInterfaceCore::addJoints(const std::vector<std::shared_ptr<common::model::JointState>> &joint_states)
+{
+    std::vector<std::shared_ptr<common::model::AbstractHardwareState>> states(joint_states.begin(), joint_states.end());
+
+    // protect bus with mutex because of sync read of firmware versions in addHardwareComponents
+    lock_guard<mutex> lck(_control_loop_mutex);
+    return _ttl_manager->addHardwareComponents(states);
+}
+
+/**
+ * @brief TtlInterfaceCore::readTorqueEnable : check the torque state of the given motors
+ * @param id_list
+ * @param expected_torque
+ * @param mismatch_id_list
+ * @return true if all the motors have the expected torque state
+ */
+bool TtlInterfaceCore::readTorqueEnable(const std::vector<uint8_t> &id_list, bool expected_torque, std::vector<uint8_t> &mismatch_id_list)
+{
+    lock_guard<mutex> lck(_control_loop_mutex);
+    return COMM_SUCCESS == _ttl_manager->readTorqueEnable(id_list, expected_torque, mismatch_id_list);
+}
+
+/**
+ * @brief TtlInterfaceCore::rebootJoints : reboot several joints at once, see TtlManager::rebootHardware.
+ * Contrary to rebootHardware, returns as soon as the joints answer again, without a fixed wait
+ * @param joint_states
+ * @param rebooted_ids : joints rebooted and back on the bus, to be configured again
+ * @return true if all the joints are back
+ */
+bool TtlInterfaceCore::rebootJoints(const std::vector<std::shared_ptr<common::model::JointState>> &joint_states, std::vector<uint8_t> &rebooted_ids)
+{
+    std::vector<uint8_t> id_list;
+    for (auto const &jState : joint_states)
+    {
+        if (jState && jState->isValid())
+            id_list.emplace_back(jState->getId());
+    }
+
+    ROS_INFO("TtlInterfaceCore::rebootJoints - Reboot joints %s", common::util::listToString(id_list).c_str());
+
+    lock_guard<mutex> lck(_control_loop_mutex);
+    return COMM_SUCCESS == _ttl_manager->rebootHardware(id_list, rebooted_ids);
+}
+
 /**
  * @brief TtlInterfaceCore::setTool
  * @param toolState
@@ -803,6 +914,7 @@ void TtlInterfaceCore::clearSingleCommandQueue()
 
     while (!_single_cmds_queue.empty())
         _single_cmds_queue.pop();
+    _single_cmd_retry.reset();
 }
 
 /**
@@ -814,6 +926,7 @@ void TtlInterfaceCore::clearConveyorCommandQueue()
 
     while (!_conveyor_cmds_queue.empty())
         _conveyor_cmds_queue.pop();
+    _conveyor_cmd_retry.reset();
 }
 
 /**
@@ -825,13 +938,55 @@ void TtlInterfaceCore::clearSyncCommandQueue()
 
     while (!_sync_cmds_queue.empty())
         _sync_cmds_queue.pop();
+    _sync_cmd_retry.reset();
 }
 
 /**
- * @brief TtlInterfaceCore::setTrajectoryControllerCommands
- * @param cmd
+ * @brief TtlInterfaceCore::recordCommandLatency : delay between the reception of the joint positions and the write of the goals computed from them
+ * @param write_time : epoch if no goal has been written
+ */
+void TtlInterfaceCore::recordCommandLatency(std::chrono::steady_clock::time_point write_time)
+{
+    auto sample_time = _joint_trajectory_cmd.getStamp();
+    if (std::chrono::steady_clock::time_point() == write_time || std::chrono::steady_clock::time_point() == sample_time)
+        return;
+
+    _command_latency.record(write_time - sample_time);
+    ROS_DEBUG_THROTTLE(10.0, "TtlInterfaceCore::recordCommandLatency - joint position to goal latency : %s", _command_latency.str().c_str());
+}
+
+/**
+ * @brief TtlInterfaceCore::initTrajectoryControllerCommands : allocate the trajectory commands, one slot per joint
+ * @param id_list : ids of the joints, in the order of the goals given to setTrajectoryControllerCommands
+ */
+void TtlInterfaceCore::initTrajectoryControllerCommands(const std::vector<uint8_t> &id_list)
+{
+    lock_guard<mutex> lck(_control_loop_mutex);
+
+    _joint_trajectory_cmd.init(id_list.size());
+    _joint_goal_filter.resize(id_list.size());
+    _joint_goal_mask.assign(id_list.size(), 0);
+    _ttl_manager->setJointTrajectoryLayout(id_list);
+
+    // only the steppers have a profile to execute the segments
+    std::vector<uint8_t> segment_slots;
+    for (auto const id : id_list)
+    {
+        auto state = std::dynamic_pointer_cast<common::model::StepperMotorState>(_ttl_manager->getHardwareState(id));
+        segment_slots.emplace_back((state && !state->isConveyor()) ? 1 : 0);
+    }
+    _joint_segmenter.setSlots(segment_slots);
+}
+
+/**
+ * @brief TtlInterfaceCore::setTrajectoryControllerCommands : called at each cycle of the controller, does not allocate nor wait for the bus
+ * @param goals : one goal per joint, in the order given to initTrajectoryControllerCommands
+ * @param sample_time : time at which the joint positions the goals are computed from have been received
  */
-void TtlInterfaceCore::setTrajectoryControllerCommands(std::vector<std::pair<uint8_t, uint32_t>> &&cmd) { _joint_trajectory_cmd = cmd; }  // NOLINT
+void TtlInterfaceCore::setTrajectoryControllerCommands(const std::vector<uint32_t> &goals, common::util::JointCommandBuffer<uint32_t>::Clock::time_point sample_time)
+{
+    _joint_trajectory_cmd.write(goals, sample_time);
+}
 
 /**
  * @brief TtlInterfaceCore::setSyncCommand
@@ -936,7 +1091,7 @@ double TtlInterfaceCore::getPosition(uint8_t id) const { return static_cast<doub
 
 /**
  * @brief TtlInterfaceCore::getBusState
- * @return
+ * @return state of the bus, with the registered motors found by the last scan
  */
 niryo_robot_msgs::BusState TtlInterfaceCore::getBusState() const
 {
@@ -1000,6 +1155,39 @@ bool TtlInterfaceCore::_callbackActivateLeds(niryo_robot_msgs::SetInt::Request &
     return true;
 }
 
+/**
+ * @brief TtlInterfaceCore::_callbackSetBusBaudrate : switch all the devices of the bus to a new baudrate
+ * @param req : baudrate in bps
+ * @param res
+ * @return
+ */
+bool TtlInterfaceCore::_callbackSetBusBaudrate(niryo_robot_msgs::SetInt::Request &req, niryo_robot_msgs::SetInt::Response &res)
+{
+    lock_guard<mutex> lck(_control_loop_mutex);
+
+    // the torque of the motors is switched off during the change by the manager, and restored afterwards
+    int result = _ttl_manager->changeBaudrate(req.value);
+
+    if (COMM_SUCCESS == result)
+    {
+        res.status = niryo_robot_msgs::CommandStatus::SUCCESS;
+        res.message = "Bus baudrate changed to " + std::to_string(req.value);
+    }
+    else if (ttl_driver::TTL_FAIL_BAUDRATE_NOT_SUPPORTED == result)
+    {
+        res.status = niryo_robot_msgs::CommandStatus::INVALID_PARAMETERS;
+        res.message = "Baudrate not supported by all the devices of the bus";
+    }
+    else
+    {
+        res.status = niryo_robot_msgs::CommandStatus::TTL_WRITE_ERROR;
+        res.message = "Baudrate change failed, the bus stays at its previous baudrate";
+    }
+
+    // return response even request failed
+    return true;
+}
+
 /**
  * @brief TtlInterfaceCore::callbackReadCustomValue
  * @param req
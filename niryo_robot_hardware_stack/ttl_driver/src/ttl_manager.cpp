@@ -18,6 +18,7 @@
 
 // cpp
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cmath>
 #include <cstdlib>
@@ -43,6 +44,9 @@
 #include "common/model/tool_state.hpp"
 
 #include "dynamixel_sdk/packet_handler.h"
+#if defined(__linux__)
+#include "dynamixel_sdk/port_handler_linux.h"
+#endif
 #include "ttl_driver/end_effector_reg.hpp"
 #include "ttl_driver/stepper_reg.hpp"
 
@@ -52,7 +56,13 @@
 #include "ttl_driver/mock_dxl_driver.hpp"
 #include "ttl_driver/mock_end_effector_driver.hpp"
 #include "ttl_driver/mock_stepper_driver.hpp"
+#include "ttl_driver/replay_port_handler.hpp"
 #include "ttl_driver/stepper_driver.hpp"
+#include "ttl_driver/xc430_reg.hpp"
+#include "ttl_driver/xl320_reg.hpp"
+#include "ttl_driver/xl330_reg.hpp"
+#include "ttl_driver/xl430_reg.hpp"
+#include "ttl_driver/xm430_reg.hpp"
 
 using ::std::ostringstream;
 using ::std::set;
@@ -70,10 +80,96 @@ using ::common::model::StepperMotorState;
 
 namespace ttl_driver
 {
+namespace
+{
+/**
+ * @brief cmdTypeName
+ * @param cmd
+ * @return name of the command type, without any allocation
+ */
+const char *cmdTypeName(const common::model::AbstractTtlSingleMotorCmd &cmd)
+{
+    if (cmd.isDxlCmd())
+        return common::model::DxlCommandTypeEnum(static_cast<common::model::EDxlCommandType>(cmd.getCmdType())).toString();
+    if (cmd.isStepperCmd())
+        return common::model::StepperCommandTypeEnum(static_cast<common::model::EStepperCommandType>(cmd.getCmdType())).toString();
+
+    return common::model::EndEffectorCommandTypeEnum(static_cast<common::model::EEndEffectorCommandType>(cmd.getCmdType())).toString();
+}
+
+// bus speed for each value of the baudrate register, the same for all the devices of the bus
+constexpr std::array<int, 8> BAUDRATE_REGISTER_VALUES{{9600, 57600, 115200, 1000000, 2000000, 3000000, 4000000, 4500000}};
+
+/**
+ * @brief The BaudrateRegister struct : where each model stores its baudrate, and the highest one it supports.
+ * The baudrate is in EEPROM, only written with the torque off : torque_address is 0 for the models without torque
+ */
+struct BaudrateRegister
+{
+    int model_number;
+    uint16_t address;
+    int max_baudrate;
+    uint16_t torque_address;
+};
+
+template <typename Reg>
+constexpr BaudrateRegister baudrateRegister()
+{
+    return {Reg::MODEL_NUMBER, Reg::ADDR_BAUDRATE, Reg::MAX_BAUDRATE, Reg::ADDR_TORQUE_ENABLE};
+}
+
+constexpr std::array<BaudrateRegister, 7> BAUDRATE_REGISTERS{{baudrateRegister<XL430Reg>(), baudrateRegister<XC430Reg>(), baudrateRegister<XM430Reg>(),
+                                                              baudrateRegister<XL330Reg>(), baudrateRegister<XL320Reg>(), baudrateRegister<StepperReg>(),
+                                                              {EndEffectorReg::MODEL_NUMBER, EndEffectorReg::ADDR_BAUDRATE, EndEffectorReg::MAX_BAUDRATE, 0}}};
+
+// time for the devices to apply their new baudrate
+constexpr double BAUDRATE_SWITCH_DELAY = 0.05;
+
+// retry budgets : attempts, first and max backoff in us
+// the writes keep the attempts and waits they had with fixed sleeps : 150 sync writes 50 ms apart, 50 single writes 0.5 ms apart
+constexpr common::util::RetryPolicy::Budget SYNC_WRITE_RETRY_BUDGET{150, 500, 50000};
+constexpr common::util::RetryPolicy::Budget SINGLE_WRITE_RETRY_BUDGET{50, 500, 500};
+constexpr common::util::RetryPolicy::Budget LEDS_RETRY_BUDGET{5, 500, 2000};
+// the firmware of a rebooted device takes a few hundred ms to answer again
+constexpr common::util::RetryPolicy::Budget REBOOT_RETRY_BUDGET{15, 10000, 100000};
+constexpr common::util::RetryPolicy::Budget ADD_COMPONENT_RETRY_BUDGET{7, 10000, 100000};
+
+/**
+ * @brief makeTtlDriver : driver of a real device type, on the given bus
+ * @param hardware_type
+ * @param portHandler
+ * @param packetHandler
+ * @return nullptr for the simulated and unknown types
+ */
+std::shared_ptr<ttl_driver::AbstractTtlDriver> makeTtlDriver(EHardwareType hardware_type, const std::shared_ptr<dynamixel::PortHandler> &portHandler,
+                                                             const std::shared_ptr<dynamixel::PacketHandler> &packetHandler)
+{
+    switch (hardware_type)
+    {
+    case EHardwareType::STEPPER:
+        return std::make_shared<ttl_driver::StepperDriver<ttl_driver::StepperReg>>(portHandler, packetHandler);
+    case EHardwareType::XL430:
+        return std::make_shared<ttl_driver::DxlDriver<ttl_driver::XL430Reg>>(portHandler, packetHandler);
+    case EHardwareType::XC430:
+        return std::make_shared<ttl_driver::DxlDriver<ttl_driver::XC430Reg>>(portHandler, packetHandler);
+    case EHardwareType::XM430:
+        return std::make_shared<ttl_driver::DxlDriver<ttl_driver::XM430Reg>>(portHandler, packetHandler);
+    case EHardwareType::XL320:
+        return std::make_shared<ttl_driver::DxlDriver<ttl_driver::XL320Reg>>(portHandler, packetHandler);
+    case EHardwareType::XL330:
+        return std::make_shared<ttl_driver::DxlDriver<ttl_driver::XL330Reg>>(portHandler, packetHandler);
+    case EHardwareType::END_EFFECTOR:
+        return std::make_shared<ttl_driver::EndEffectorDriver<ttl_driver::EndEffectorReg>>(portHandler, packetHandler);
+    default:
+        return nullptr;
+    }
+}
+}  // namespace
+
 /**
  * @brief TtlManager::TtlManager
  */
-TtlManager::TtlManager(ros::NodeHandle &nh) : _nh(nh), _debug_error_message("TtlManager - No connection with TTL motors has been made yet")
+TtlManager::TtlManager(ros::NodeHandle &nh) : _nh(nh)
 {
     ROS_DEBUG("TtlManager - ctor");
 
@@ -81,6 +177,8 @@ TtlManager::TtlManager(ros::NodeHandle &nh) : _nh(nh), _debug_error_message("Ttl
 
     if (COMM_SUCCESS != setupCommunication())
         ROS_WARN("TtlManager - TTL Communication Failed");
+    else if (COMM_SUCCESS != negotiateBaudrate())
+        ROS_WARN("TtlManager - TTL bus kept at %d bps", _baudrate);
 }
 
 /**
@@ -108,6 +206,9 @@ bool TtlManager::init(ros::NodeHandle &nh)
 
     nh.getParam("bus_params/uart_device_name", _device_name);
     nh.getParam("bus_params/baudrate", _baudrate);
+    nh.getParam("bus_params/target_baudrate", _target_baudrate);
+    nh.getParam("bus_params/direction_control", _direction_control);
+    nh.getParam("bus_params/replay_file", _replay_file);
     nh.getParam("led_motor", _led_motor_type_cfg);
 
     nh.getParam("simulation_mode", _simulation_mode);
@@ -122,21 +223,100 @@ bool TtlManager::init(ros::NodeHandle &nh)
 
     if (!_simulation_mode)
     {
-        _portHandler.reset(dynamixel::PortHandler::getPortHandler(_device_name.c_str()));
-        _packetHandler.reset(dynamixel::PacketHandler::getPacketHandler(TTL_BUS_PROTOCOL_VERSION));
+        // replay of a bus capture in place of the real port, to reproduce a session offline
+        if (!_replay_file.empty())
+        {
+            auto replay_port = std::make_shared<ReplayPortHandler>(true);
+            if (replay_port->load(_replay_file))
+            {
+                ROS_WARN("TtlManager::init - replaying the TTL capture %s (%zu records)", _replay_file.c_str(), replay_port->getRecordCount());
+                _portHandler = replay_port;
+            }
+        }
+
+        if (!_portHandler)
+        {
+            _portHandler.reset(dynamixel::PortHandler::getPortHandler(_device_name.c_str()));
+
+#if defined(__linux__)
+            // applied when the port is opened by setupCommunication
+            dynamixel::PortHandlerLinux::DirectionControl direction_control;
+            auto linux_port = std::dynamic_pointer_cast<dynamixel::PortHandlerLinux>(_portHandler);
+            if (linux_port && dynamixel::PortHandlerLinux::parseDirectionControl(_direction_control, direction_control))
+                linux_port->setDirectionControl(direction_control);
+            else if (linux_port)
+                ROS_WARN("TtlManager::init - unknown direction control %s, kept gpio_sleep", _direction_control.c_str());
+#endif
+        }
+
+        // the packet handler is a singleton shared with the extra ports, it is not owned by the manager
+        _packetHandler.reset(dynamixel::PacketHandler::getPacketHandler(TTL_BUS_PROTOCOL_VERSION), [](dynamixel::PacketHandler *) {});
 
         // init default ttl driver for common operations between drivers
         _default_ttl_driver = std::make_shared<StepperDriver<StepperReg>>(_portHandler, _packetHandler);
+
+        initExtraPorts(nh);
     }
     else
     {
         readFakeConfig(use_simu_gripper, use_simu_conveyor);
         _default_ttl_driver = std::make_shared<MockStepperDriver>(_fake_data);
+
+        ROS_WARN_COND(nh.hasParam("bus_params/extra_ports_names"), "TtlManager::init - extra TTL ports are not simulated, all the devices are on the main bus");
     }
 
     return true;
 }
 
+/**
+ * @brief TtlManager::initExtraPorts : create the additional buses listed in bus_params/extra_ports_names.
+ * Each one is configured in bus_params/extra_ports/<name>/ with its uart_device_name, baudrate and the ids of its devices
+ * @param nh
+ */
+void TtlManager::initExtraPorts(ros::NodeHandle &nh)
+{
+    vector<string> port_names;
+    nh.getParam("bus_params/extra_ports_names", port_names);
+
+    for (auto const &name : port_names)
+    {
+        string current_ns = "bus_params/extra_ports/" + name + "/";
+        string device_name;
+        int baudrate = _baudrate;
+        vector<int> id_list;
+        nh.getParam(current_ns + "uart_device_name", device_name);
+        nh.getParam(current_ns + "baudrate", baudrate);
+        nh.getParam(current_ns + "ids", id_list);
+
+        if (device_name.empty() || device_name == _device_name)
+        {
+            ROS_ERROR("TtlManager::initExtraPorts - invalid device \"%s\" for the TTL port %s", device_name.c_str(), name.c_str());
+            continue;
+        }
+
+        // a device is on one bus only
+        vector<uint8_t> assigned_ids;
+        for (auto const id : id_list)
+        {
+            if (getExtraPort(static_cast<uint8_t>(id)))
+                ROS_ERROR("TtlManager::initExtraPorts - id %d is already assigned to another TTL port, ignored for %s", id, name.c_str());
+            else
+                assigned_ids.emplace_back(static_cast<uint8_t>(id));
+        }
+
+        auto port = std::make_unique<TtlPort>(device_name, baudrate, assigned_ids);
+        if (!port->init(_direction_control))
+        {
+            ROS_ERROR("TtlManager::initExtraPorts - unable to create the TTL port %s on %s", name.c_str(), device_name.c_str());
+            continue;
+        }
+
+        ROS_INFO("TtlManager::initExtraPorts - TTL port %s on %s at %d bps, devices %s", name.c_str(), device_name.c_str(), baudrate,
+                 common::util::listToString(assigned_ids).c_str());
+        _extra_ports.emplace_back(std::move(port));
+    }
+}
+
 /**
  * @brief TtlManager::setupCommunication
  * @return
@@ -157,7 +337,7 @@ int TtlManager::setupCommunication()
         // Ttl bus setup
         if (_portHandler)
         {
-            _debug_error_message.clear();
+            setBusError(EBusError::NONE);
 
             // Open port
             if (_portHandler->openPort())
@@ -171,29 +351,280 @@ int TtlManager::setupCommunication()
                     // clear port
                     _portHandler->clearPort();
 
+#if defined(__linux__)
+                    auto linux_port = std::dynamic_pointer_cast<dynamixel::PortHandlerLinux>(_portHandler);
+                    if (linux_port && "rs485" == _direction_control && dynamixel::PortHandlerLinux::DIRECTION_RS485 != linux_port->getDirectionControl())
+                        ROS_WARN("TtlManager::setupCommunication - RS-485 mode not supported by the UART driver, direction GPIO drained instead");
+                    if (linux_port)
+                    {
+                        uint32_t low_latency = linux_port->getLowLatencySettings();
+                        ROS_INFO("TtlManager::setupCommunication - low latency settings: async low latency %s, usb latency timer %s, rx fifo trigger %s",
+                                 (low_latency & serial::low_latency_async) ? "on" : "n/a", (low_latency & serial::low_latency_usb_timer) ? "on" : "n/a",
+                                 (low_latency & serial::low_latency_rx_trigger) ? "on" : "n/a");
+                    }
+#endif
+
                     ret = COMM_SUCCESS;
                 }
                 else
                 {
                     ROS_ERROR("TtlManager::setupCommunication - Failed to set baudrate for Dynamixel bus");
-                    _debug_error_message = "TtlManager - Failed to set baudrate for Dynamixel bus";
+                    setBusError(EBusError::SET_BAUDRATE_FAILED);
                     ret = TTL_FAIL_PORT_SET_BAUDRATE;
                 }
             }
             else
             {
                 ROS_ERROR("TtlManager::setupCommunication - Failed to open Uart port for Dynamixel bus");
-                _debug_error_message = "TtlManager - Failed to open Uart port for Dynamixel bus";
+                setBusError(EBusError::OPEN_PORT_FAILED);
                 ret = TTL_FAIL_OPEN_PORT;
             }
         }
         else
             ROS_ERROR("TtlManager::setupCommunication - Invalid port handler");
+
+        // the devices of an extra port which cannot be opened are reported missing by the scans
+        for (auto const &port : _extra_ports)
+        {
+            if (COMM_SUCCESS != port->setupCommunication())
+                ROS_WARN("TtlManager::setupCommunication - TTL port %s not available", port->getDeviceName().c_str());
+        }
     }
 
     return ret;
 }
 
+/**
+ * @brief TtlManager::negotiateBaudrate : bring the bus to the target baudrate, if any.
+ * The devices keep their baudrate when powered off, so the bus can already be at the target baudrate
+ * @return
+ */
+int TtlManager::negotiateBaudrate()
+{
+    if (_simulation_mode || !_target_baudrate || _target_baudrate == _baudrate)
+        return COMM_SUCCESS;
+
+    int safe_baudrate = _baudrate;
+    vector<uint8_t> id_list;
+    getAllIdsOnBus(id_list);
+
+    if (id_list.empty())
+    {
+        // nobody answers at the safe baudrate, the bus may have been upgraded during a previous session
+        if (_portHandler->setBaudRate(_target_baudrate) && COMM_SUCCESS == getAllIdsOnBus(id_list) && !id_list.empty())
+        {
+            _baudrate = _target_baudrate;
+            _portHandler->clearPort();
+            ROS_INFO("TtlManager::negotiateBaudrate - bus already at %d bps", _baudrate);
+            return COMM_SUCCESS;
+        }
+
+        ROS_WARN("TtlManager::negotiateBaudrate - no device found, the bus stays at %d bps", safe_baudrate);
+        _portHandler->setBaudRate(safe_baudrate);
+        _portHandler->clearPort();
+        return TTL_FAIL_BAUDRATE_CHANGE;
+    }
+
+    return changeBaudrate(_target_baudrate);
+}
+
+/**
+ * @brief TtlManager::changeBaudrate : switch all the devices of the bus to a new baudrate.
+ * The devices are discovered at the current baudrate and all of them must support the new one.
+ * Their torque is switched off during the change, the baudrate being in EEPROM, and restored afterwards.
+ * If one of them does not answer once switched, the bus goes back to the current baudrate.
+ * @param baudrate
+ * @return
+ */
+int TtlManager::changeBaudrate(int baudrate)
+{
+    if (baudrate == _baudrate)
+        return COMM_SUCCESS;
+
+    if (std::find(BAUDRATE_REGISTER_VALUES.begin(), BAUDRATE_REGISTER_VALUES.end(), baudrate) == BAUDRATE_REGISTER_VALUES.end())
+    {
+        ROS_ERROR("TtlManager::changeBaudrate - %d bps is not a TTL baudrate", baudrate);
+        return TTL_FAIL_BAUDRATE_NOT_SUPPORTED;
+    }
+
+    if (_simulation_mode)
+    {
+        _baudrate = baudrate;
+        return COMM_SUCCESS;
+    }
+
+    // 1. discover the devices at the current baudrate
+    vector<uint8_t> id_list;
+    int result = getAllIdsOnBus(id_list);
+    if (COMM_SUCCESS != result || id_list.empty())
+    {
+        ROS_ERROR("TtlManager::changeBaudrate - unable to discover the devices of the bus (%d)", result);
+        return TTL_FAIL_BAUDRATE_CHANGE;
+    }
+
+    // 2. check that all of them support the new baudrate
+    for (auto const &id : id_list)
+    {
+        uint16_t model_number = 0;
+        auto it = BAUDRATE_REGISTERS.end();
+        if (COMM_SUCCESS == _default_ttl_driver->getModelNumber(id, model_number))
+            it = std::find_if(BAUDRATE_REGISTERS.begin(), BAUDRATE_REGISTERS.end(), [model_number](const BaudrateRegister &reg) { return reg.model_number == model_number; });
+
+        if (it == BAUDRATE_REGISTERS.end() || it->max_baudrate < baudrate)
+        {
+            ROS_ERROR("TtlManager::changeBaudrate - device %d (model %d) does not support %d bps", id, model_number, baudrate);
+            return TTL_FAIL_BAUDRATE_NOT_SUPPORTED;
+        }
+    }
+
+    // 3. the baudrate is in EEPROM, the devices only write it with their torque off
+    vector<uint8_t> torque_on_ids;
+    readTorqueOnIds(id_list, torque_on_ids);
+    if (!torque_on_ids.empty() && COMM_SUCCESS != writeBaudrateTorque(torque_on_ids, 0))
+    {
+        ROS_ERROR("TtlManager::changeBaudrate - unable to switch off the torque of devices %s", common::util::listToString(torque_on_ids).c_str());
+        writeBaudrateTorque(torque_on_ids, 1);
+        return TTL_FAIL_BAUDRATE_CHANGE;
+    }
+
+    // 4. switch all of them, then the port
+    int previous_baudrate = _baudrate;
+    ROS_INFO("TtlManager::changeBaudrate - switching devices %s from %d to %d bps", common::util::listToString(id_list).c_str(), previous_baudrate, baudrate);
+
+    if (COMM_SUCCESS == writeBaudrate(id_list, baudrate))
+    {
+        ros::Duration(BAUDRATE_SWITCH_DELAY).sleep();
+        if (_portHandler->setBaudRate(baudrate))
+        {
+            _portHandler->clearPort();
+
+            // 5. check that all of them answer at the new baudrate
+            vector<uint8_t> found_ids;
+            getKnownIdsOnBus(id_list, found_ids);
+            if (found_ids.size() == id_list.size())
+            {
+                _baudrate = baudrate;
+                ROS_INFO("TtlManager::changeBaudrate - bus at %d bps", _baudrate);
+
+                if (!torque_on_ids.empty())
+                    writeBaudrateTorque(torque_on_ids, 1);
+                return COMM_SUCCESS;
+            }
+
+            // 6. fall back : the devices which switched go back to the previous baudrate
+            ROS_ERROR("TtlManager::changeBaudrate - only devices %s answer at %d bps, back to %d bps", common::util::listToString(found_ids).c_str(), baudrate,
+                      previous_baudrate);
+            if (!found_ids.empty())
+            {
+                writeBaudrate(found_ids, previous_baudrate);
+                ros::Duration(BAUDRATE_SWITCH_DELAY).sleep();
+            }
+        }
+    }
+
+    _portHandler->setBaudRate(previous_baudrate);
+    _portHandler->clearPort();
+
+    vector<uint8_t> found_ids;
+    getKnownIdsOnBus(id_list, found_ids);
+    if (found_ids.size() != id_list.size())
+        ROS_ERROR("TtlManager::changeBaudrate - devices %s lost during the fall back to %d bps", common::util::listToString(id_list).c_str(), previous_baudrate);
+
+    if (!torque_on_ids.empty())
+        writeBaudrateTorque(torque_on_ids, 1);
+
+    return TTL_FAIL_BAUDRATE_CHANGE;
+}
+
+/**
+ * @brief TtlManager::readTorqueOnIds : read the torque of the devices of known models
+ * @param id_list
+ * @param torque_on_ids : devices with their torque on. A device which does not answer is considered with its torque on
+ */
+void TtlManager::readTorqueOnIds(const std::vector<uint8_t> &id_list, std::vector<uint8_t> &torque_on_ids)
+{
+    torque_on_ids.clear();
+
+    for (auto const &id : id_list)
+    {
+        uint16_t model_number = 0;
+        _default_ttl_driver->getModelNumber(id, model_number);
+        auto it = std::find_if(BAUDRATE_REGISTERS.begin(), BAUDRATE_REGISTERS.end(), [model_number](const BaudrateRegister &reg) { return reg.model_number == model_number; });
+        if (it == BAUDRATE_REGISTERS.end() || 0 == it->torque_address)
+            continue;
+
+        uint32_t torque = 0;
+        if (COMM_SUCCESS != _default_ttl_driver->readCustom(it->torque_address, 1, id, torque) || torque)
+            torque_on_ids.emplace_back(id);
+    }
+}
+
+/**
+ * @brief TtlManager::writeBaudrateTorque : one sync write per address of the torque register
+ * @param id_list : devices of known models, with a torque
+ * @param torque_enable
+ * @return
+ */
+int TtlManager::writeBaudrateTorque(const std::vector<uint8_t> &id_list, uint8_t torque_enable)
+{
+    std::map<uint16_t, vector<uint8_t>> ids_by_address;
+    for (auto const &id : id_list)
+    {
+        uint16_t model_number = 0;
+        _default_ttl_driver->getModelNumber(id, model_number);
+        auto it = std::find_if(BAUDRATE_REGISTERS.begin(), BAUDRATE_REGISTERS.end(), [model_number](const BaudrateRegister &reg) { return reg.model_number == model_number; });
+        if (it != BAUDRATE_REGISTERS.end() && 0 != it->torque_address)
+            ids_by_address[it->torque_address].emplace_back(id);
+    }
+
+    int result = COMM_SUCCESS;
+    for (auto const &it : ids_by_address)
+    {
+        int res = _default_ttl_driver->syncWriteCustom(it.first, 1, it.second, torque_enable);
+        if (COMM_SUCCESS != res)
+        {
+            ROS_ERROR("TtlManager::writeBaudrateTorque - failed to write the torque of devices %s (%d)", common::util::listToString(it.second).c_str(), res);
+            result = res;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief TtlManager::writeBaudrate : one sync write per address of the baudrate register
+ * @param id_list : devices of known models
+ * @param baudrate
+ * @return
+ */
+int TtlManager::writeBaudrate(const std::vector<uint8_t> &id_list, int baudrate)
+{
+    auto register_value = static_cast<uint32_t>(std::find(BAUDRATE_REGISTER_VALUES.begin(), BAUDRATE_REGISTER_VALUES.end(), baudrate) - BAUDRATE_REGISTER_VALUES.begin());
+
+    std::map<uint16_t, vector<uint8_t>> ids_by_address;
+    for (auto const &id : id_list)
+    {
+        uint16_t model_number = 0;
+        _default_ttl_driver->getModelNumber(id, model_number);
+        auto it = std::find_if(BAUDRATE_REGISTERS.begin(), BAUDRATE_REGISTERS.end(), [model_number](const BaudrateRegister &reg) { return reg.model_number == model_number; });
+        if (it != BAUDRATE_REGISTERS.end())
+            ids_by_address[it->address].emplace_back(id);
+    }
+
+    int result = COMM_SUCCESS;
+    for (auto const &it : ids_by_address)
+    {
+        int res = _default_ttl_driver->syncWriteCustom(it.first, 1, it.second, register_value);
+        if (COMM_SUCCESS != res)
+        {
+            ROS_ERROR("TtlManager::writeBaudrate - failed to write the baudrate of devices %s (%d)", common::util::listToString(it.second).c_str(), res);
+            result = res;
+        }
+    }
+
+    return result;
+}
+
 /**
  * @brief TtlManager::addHardwareComponent add hardware component like joint, ee, tool... to ttl manager
  * @param state
@@ -202,41 +633,137 @@ int TtlManager::addHardwareComponent(std::shared_ptr<common::model::AbstractHard
 {
     if (state)
     {
-        EHardwareType hardware_type = state->getHardwareType();
-        uint8_t id = state->getId();
+        registerHardwareComponent(state);
+
+        // update firmware version
+        readFirmwareVersions({state->getId()});
+
+        setLeds(_led_state);
+        return niryo_robot_msgs::CommandStatus::SUCCESS;
+    }
+    return niryo_robot_msgs::CommandStatus::FAILURE;
+}
+
+/**
+ * @brief TtlManager::addHardwareComponents : add several components at once. The firmware versions are
+ * retrieved with one sync read per hardware type instead of one read per component
+ * @param states
+ * @return
+ */
+int TtlManager::addHardwareComponents(const std::vector<std::shared_ptr<common::model::AbstractHardwareState>> &states)
+{
+    vector<uint8_t> ids;
+    for (auto const &state : states)
+    {
+        if (!state)
+            return niryo_robot_msgs::CommandStatus::FAILURE;
+
+        registerHardwareComponent(state);
+        ids.emplace_back(state->getId());
+    }
+
+    readFirmwareVersions(ids);
 
-        ROS_DEBUG("TtlManager::addHardwareComponent : %s", state->str().c_str());
+    setLeds(_led_state);
+    return niryo_robot_msgs::CommandStatus::SUCCESS;
+}
+
+/**
+ * @brief TtlManager::registerHardwareComponent : add the state to the maps and create its driver if needed
+ * @param state
+ */
+void TtlManager::registerHardwareComponent(const std::shared_ptr<common::model::AbstractHardwareState> &state)
+{
+    EHardwareType hardware_type = state->getHardwareType();
+    uint8_t id = state->getId();
 
-        // add state to state map
-        _state_map[id] = state;
+    ROS_DEBUG("TtlManager::addHardwareComponent : %s", state->str().c_str());
 
-        // add id to ids_map
+    // add state to state map
+    _state_map[id] = state;
+
+    // add id to ids_map of its bus, the devices of an extra port are driven by the drivers of this port
+    TtlPort *port = getExtraPort(id);
+    if (port)
+    {
+        port->addId(hardware_type, id);
+        if (!port->hasDriver(hardware_type))
+            port->addDriver(hardware_type, makeTtlDriver(hardware_type, port->getPortHandler(), port->getPacketHandler()));
+    }
+    else
+    {
         _ids_map[hardware_type].emplace_back(id);
+        addHardwareDriver(hardware_type);
+    }
+
+    // add to global lists
+    if (common::model::EComponentType::CONVEYOR == state->getComponentType())
+    {
+        if (std::find(_conveyor_list.begin(), _conveyor_list.end(), id) == _conveyor_list.end())
+            _conveyor_list.emplace_back(id);
+    }
+
+    _joint_trajectory_layout_changed = true;
+    _joints_status_layout_changed = true;
+}
 
-        // add to global lists
-        if (common::model::EComponentType::CONVEYOR == state->getComponentType())
+/**
+ * @brief TtlManager::readFirmwareVersions : update the firmware version of the given registered components.
+ * One sync read is sent per hardware type, the components not answering it are then read one by one
+ * @param id_list
+ */
+void TtlManager::readFirmwareVersions(const std::vector<uint8_t> &id_list)
+{
+    // group ids by driver, as each hardware type of each bus has its own driver
+    std::map<std::shared_ptr<AbstractTtlDriver>, vector<uint8_t>> ids_by_driver;
+    for (auto const id : id_list)
+    {
+        auto driver = getDriver(id);
+        if (driver)
+            ids_by_driver[driver].emplace_back(id);
+    }
+
+    for (auto const &it : ids_by_driver)
+    {
+        auto driver = it.first;
+        auto const &ids = it.second;
+
+        vector<std::string> versions;
+        int res = COMM_RX_FAIL;
+        auto budget = getRetryBudget(ERetryClass::ADD_COMPONENT);
+        budget.max_attempts = FIRMWARE_SYNC_READ_TRIES;
+        common::util::RetryPolicy retry(budget);
+        do
         {
-            if (std::find(_conveyor_list.begin(), _conveyor_list.end(), id) == _conveyor_list.end())
-                _conveyor_list.emplace_back(id);
-        }
+            versions.clear();
+            res = driver->syncReadFirmwareVersion(ids, versions);
+            if (COMM_SUCCESS == res && versions.size() == ids.size())
+                break;
 
-        addHardwareDriver(hardware_type);
+            res = COMM_RX_FAIL;
+        } while (common::util::RetryPolicy::EDecision::RETRY == retry.onFailure());
 
-        // update firmware version
-        if (_driver_map.at(hardware_type))
+        if (COMM_SUCCESS == res)
+        {
+            for (size_t i = 0; i < ids.size(); ++i)
+                _state_map.at(ids.at(i))->setFirmwareVersion(versions.at(i));
+
+            continue;
+        }
+
+        // sync read failed for this driver, a missing component can prevent the others from answering
+        ROS_DEBUG("TtlManager::readFirmwareVersions : sync read failed for ids %s, reading them one by one", common::util::listToString(ids).c_str());
+        for (auto const id : ids)
         {
             std::string version;
-            int res = COMM_RX_FAIL;
-            for (int tries = 10; tries > 0; tries--)
-            {
-                res = _driver_map.at(hardware_type)->readFirmwareVersion(id, version);
-                if (COMM_SUCCESS == res)
-                {
-                    state->setFirmwareVersion(version);
-                    break;
-                }
-                ros::Duration(0.1).sleep();
-            }
+            budget.max_attempts = FIRMWARE_SINGLE_READ_TRIES;
+            common::util::RetryPolicy single_retry(budget);
+            res = driver->readFirmwareVersion(id, version);
+            while (COMM_SUCCESS != res && common::util::RetryPolicy::EDecision::RETRY == single_retry.onFailure())
+                res = driver->readFirmwareVersion(id, version);
+
+            if (COMM_SUCCESS == res)
+                _state_map.at(id)->setFirmwareVersion(version);
 
             if (COMM_SUCCESS != res)
             {
@@ -245,11 +772,7 @@ int TtlManager::addHardwareComponent(std::shared_ptr<common::model::AbstractHard
                          id, res);
             }
         }
-
-        setLeds(_led_state);
-        return niryo_robot_msgs::CommandStatus::SUCCESS;
     }
-    return niryo_robot_msgs::CommandStatus::FAILURE;
 }
 
 /**
@@ -264,6 +787,10 @@ void TtlManager::removeHardwareComponent(uint8_t id)
     {
         EHardwareType type = _state_map.at(id)->getHardwareType();
 
+        TtlPort *port = getExtraPort(id);
+        if (port)
+            port->removeId(id);
+
         // std::remove to remove hypothetic duplicates too
         if (_ids_map.count(type))
         {
@@ -281,6 +808,103 @@ void TtlManager::removeHardwareComponent(uint8_t id)
     _conveyor_list.erase(std::remove(_conveyor_list.begin(), _conveyor_list.end(), id), _conveyor_list.end());
 
     _removed_motor_id_list.erase(std::remove(_removed_motor_id_list.begin(), _removed_motor_id_list.end(), id), _removed_motor_id_list.end());
+    _reconnection_counters.erase(id);
+    _position_fail_counters.erase(id);
+    _joint_trajectory_layout_changed = true;
+    _joints_status_layout_changed = true;
+}
+
+/**
+ * @brief TtlManager::getConnectedIds
+ * @param type
+ * @return ids registered for this hardware type, without the ones currently missing on the bus
+ */
+std::vector<uint8_t> TtlManager::getConnectedIds(EHardwareType type) const
+{
+    if (_ids_map.count(type))
+        return getConnectedIds(_ids_map.at(type));
+
+    return {};
+}
+
+/**
+ * @brief TtlManager::getConnectedIds
+ * @param id_list
+ * @return ids of id_list, without the ones currently missing on the bus
+ */
+std::vector<uint8_t> TtlManager::getConnectedIds(const std::vector<uint8_t> &id_list) const
+{
+    vector<uint8_t> ids_list;
+    std::copy_if(id_list.begin(), id_list.end(), std::back_inserter(ids_list),
+                 [this](uint8_t id) { return std::find(_removed_motor_id_list.begin(), _removed_motor_id_list.end(), id) == _removed_motor_id_list.end(); });
+
+    return ids_list;
+}
+
+/**
+ * @brief TtlManager::getExtraPort
+ * @param id
+ * @return the extra port the device is connected to, nullptr if it is on the main bus
+ */
+TtlPort *TtlManager::getExtraPort(uint8_t id) const
+{
+    for (auto const &port : _extra_ports)
+    {
+        if (port->isAssigned(id))
+            return port.get();
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief TtlManager::getDriver
+ * @param id
+ * @return driver of a registered device, on the bus of the device. nullptr if the device or its driver is unknown
+ */
+std::shared_ptr<AbstractTtlDriver> TtlManager::getDriver(uint8_t id) const
+{
+    auto state = _state_map.find(id);
+    if (state == _state_map.end() || !state->second)
+        return nullptr;
+
+    EHardwareType hardware_type = state->second->getHardwareType();
+
+    TtlPort *port = getExtraPort(id);
+    if (port)
+        return port->getDriver(hardware_type);
+
+    auto driver = _driver_map.find(hardware_type);
+    return driver != _driver_map.end() ? driver->second : nullptr;
+}
+
+/**
+ * @brief TtlManager::getEndEffectorDriver : the end effector is read on its own bus, the main one or an extra port
+ * @param id : id of the end effector
+ * @return driver of the end effector, on its bus. nullptr if no end effector is registered
+ */
+std::shared_ptr<AbstractEndEffectorDriver> TtlManager::getEndEffectorDriver(uint8_t &id) const
+{
+    EHardwareType ee_type = _simulation_mode ? EHardwareType::FAKE_END_EFFECTOR : EHardwareType::END_EFFECTOR;
+
+    auto ids = _ids_map.find(ee_type);
+    if (ids != _ids_map.end() && !ids->second.empty())
+    {
+        id = ids->second.front();
+        return std::dynamic_pointer_cast<AbstractEndEffectorDriver>(getDriver(id));
+    }
+
+    for (auto const &port : _extra_ports)
+    {
+        auto port_ids = port->getIdsMap().find(ee_type);
+        if (port_ids != port->getIdsMap().end() && !port_ids->second.empty())
+        {
+            id = port_ids->second.front();
+            return std::dynamic_pointer_cast<AbstractEndEffectorDriver>(getDriver(id));
+        }
+    }
+
+    return nullptr;
 }
 
 /**
@@ -314,6 +938,11 @@ int TtlManager::changeId(EHardwareType motor_type, uint8_t old_id, uint8_t new_i
     {
         ret = COMM_SUCCESS;
     }
+    else if (getExtraPort(old_id) || getExtraPort(new_id))
+    {
+        // the devices of the extra ports are assigned by id in the configuration
+        ROS_ERROR("TtlManager::changeId - ids of the extra TTL ports cannot be changed (%d -> %d)", old_id, new_id);
+    }
     else if (_driver_map.count(motor_type))
     {
         auto driver = std::dynamic_pointer_cast<AbstractMotorDriver>(_driver_map.at(motor_type));
@@ -332,6 +961,8 @@ int TtlManager::changeId(EHardwareType motor_type, uint8_t old_id, uint8_t new_i
                     std::swap(_state_map[new_id], i_state->second);
                     // update all maps
                     _state_map.erase(i_state);
+                    _joint_trajectory_layout_changed = true;
+                    _joints_status_layout_changed = true;
 
                     assert(_state_map.at(new_id));
 
@@ -371,30 +1002,62 @@ int TtlManager::scanAndCheck()
     _is_connection_ok = false;
 
     // 1. retrieve list of connected motors
-    _all_ids_connected.clear();
+    // the devices of the extra ports are scanned by their own thread, while the main bus is scanned
+    vector<vector<uint8_t>> extra_found_ids(_extra_ports.size());
+    for (size_t i = 0; i < _extra_ports.size(); ++i)
+    {
+        auto driver = _extra_ports.at(i)->getDefaultDriver();
+        vector<uint8_t> port_ids = _extra_ports.at(i)->getIds();
+        auto &found_ids = extra_found_ids.at(i);
+        if (driver && !port_ids.empty())
+            _extra_ports.at(i)->post([driver, port_ids, &found_ids]() { scanKnownIds(driver, port_ids, found_ids); });
+    }
+
+    // the known motors are checked with a targeted scan, the broadcast ping is only used when there is nothing known yet
+    vector<uint8_t> expected_ids;
+    for (auto const &istate : _state_map)
+    {
+        if (istate.second && !getExtraPort(istate.first))
+            expected_ids.emplace_back(istate.first);
+    }
+
+    _connected_motor_id_list.clear();
     for (int counter = 0; counter < 50 && COMM_SUCCESS != result; ++counter)
     {
-        result = getAllIdsOnBus(_all_ids_connected);
+        if (!expected_ids.empty())
+            result = getKnownIdsOnBus(expected_ids, _connected_motor_id_list);
+        else if (_state_map.empty())
+            result = getAllIdsOnBus(_connected_motor_id_list);
+        else
+            result = COMM_SUCCESS;
         ROS_DEBUG_COND(COMM_SUCCESS != result, "TtlManager::scanAndCheck status: %d (counter: %d)", result, counter);
-        ros::Duration(TIME_TO_WAIT_IF_BUSY).sleep();
+
+        if (COMM_SUCCESS != result)
+            ros::Duration(TIME_TO_WAIT_IF_BUSY).sleep();
+    }
+
+    // a device of an extra port not found is missing, whatever the result of the scan of its port
+    for (size_t i = 0; i < _extra_ports.size(); ++i)
+    {
+        _extra_ports.at(i)->wait();
+        _connected_motor_id_list.insert(_connected_motor_id_list.end(), extra_found_ids.at(i).begin(), extra_found_ids.at(i).end());
     }
 
     if (COMM_SUCCESS == result)
     {
         // 2. update list of removed ids and update corresponding states
-        _removed_motor_id_list.clear();
-        std::string error_motors_message;
+        vector<uint8_t> previous_removed_ids;
+        previous_removed_ids.swap(_removed_motor_id_list);
         for (auto &istate : _state_map)
         {
             if (istate.second)
             {
                 uint8_t id = istate.first;
-                auto it = find(_all_ids_connected.begin(), _all_ids_connected.end(), id);
+                auto it = find(_connected_motor_id_list.begin(), _connected_motor_id_list.end(), id);
                 // not found
-                if (it == _all_ids_connected.end())
+                if (it == _connected_motor_id_list.end())
                 {
                     _removed_motor_id_list.emplace_back(id);
-                    error_motors_message += " " + to_string(id);
                     istate.second->setConnectionStatus(true);
                 }
                 else
@@ -404,21 +1067,25 @@ int TtlManager::scanAndCheck()
             }
         }
 
+        // the missing motors are not read anymore
+        if (previous_removed_ids != _removed_motor_id_list)
+            _joints_status_layout_changed = true;
+
         if (_removed_motor_id_list.empty())
         {
             _is_connection_ok = true;
-            _debug_error_message.clear();
+            setBusError(EBusError::NONE);
             result = TTL_SCAN_OK;
         }
         else
         {
-            _debug_error_message = "Motor(s):" + error_motors_message + " do not seem to be connected";
+            setBusError(EBusError::MISSING_MOTORS);
             result = TTL_SCAN_MISSING_MOTOR;
         }
     }
     else
     {
-        _debug_error_message = "TtlManager - Failed to scan motors, physical bus is too busy. Will retry...";
+        setBusError(EBusError::BUS_TOO_BUSY);
         ROS_WARN_THROTTLE(1, "TtlManager::scanAndCheck - Failed to scan motors, physical bus is too busy");
     }
 
@@ -436,15 +1103,73 @@ bool TtlManager::ping(uint8_t id)
 {
     int result = false;
 
-    if (_default_ttl_driver)
+    // the devices of an extra port are pinged on their port
+    TtlPort *port = getExtraPort(id);
+    auto driver = port ? port->getDefaultDriver() : _default_ttl_driver;
+    if (driver)
     {
-        if (COMM_SUCCESS == _default_ttl_driver->ping(id))
+        if (COMM_SUCCESS == driver->ping(id))
             result = true;
     }
 
     return result;
 }
 
+/**
+ * @brief TtlManager::checkRemovedMotors : ping each missing motor once. A motor is considered reconnected only after
+ * RECONNECTION_HYSTERESIS consecutive successful pings, so that a flickering connection does not toggle the bus state.
+ * If the missing motors are not known yet (connection lost on read failures), a scan is done instead
+ * @return TTL_SCAN_OK when all the motors are back, TTL_SCAN_MISSING_MOTOR otherwise
+ */
+int TtlManager::checkRemovedMotors()
+{
+    if (_removed_motor_id_list.empty())
+        return scanAndCheck();
+
+    // forget counters of motors which are not missing anymore
+    for (auto it = _reconnection_counters.begin(); it != _reconnection_counters.end();)
+    {
+        if (std::find(_removed_motor_id_list.begin(), _removed_motor_id_list.end(), it->first) == _removed_motor_id_list.end())
+            it = _reconnection_counters.erase(it);
+        else
+            ++it;
+    }
+
+    vector<uint8_t> reconnected_ids;
+    for (auto const id : _removed_motor_id_list)
+    {
+        if (ping(id))
+        {
+            if (++_reconnection_counters[id] >= RECONNECTION_HYSTERESIS)
+                reconnected_ids.emplace_back(id);
+        }
+        else
+        {
+            _reconnection_counters[id] = 0;
+        }
+    }
+
+    for (auto const id : reconnected_ids)
+    {
+        ROS_INFO("TtlManager::checkRemovedMotors - motor %d reconnected", id);
+
+        _removed_motor_id_list.erase(std::remove(_removed_motor_id_list.begin(), _removed_motor_id_list.end(), id), _removed_motor_id_list.end());
+        _reconnection_counters.erase(id);
+
+        if (_state_map.count(id) && _state_map.at(id))
+            _state_map.at(id)->setConnectionStatus(false);
+
+        _joints_status_layout_changed = true;
+    }
+
+    if (!_removed_motor_id_list.empty())
+        return TTL_SCAN_MISSING_MOTOR;
+
+    _is_connection_ok = true;
+    setBusError(EBusError::NONE);
+    return TTL_SCAN_OK;
+}
+
 /**
  * @brief TtlManager::rebootHardware
  * @param hw_id
@@ -456,25 +1181,22 @@ int TtlManager::rebootHardware(uint8_t hw_id)
 
     if (_state_map.count(hw_id) != 0 && _state_map.at(hw_id))
     {
-        EHardwareType type = _state_map.at(hw_id)->getHardwareType();
         ROS_DEBUG("TtlManager::rebootHardware - Reboot hardware with ID: %d", hw_id);
-        if (_driver_map.count(type) && _driver_map.at(type))
+        auto driver = getDriver(hw_id);
+        if (driver)
         {
-            return_value = _driver_map.at(type)->reboot(hw_id);
+            return_value = driver->reboot(hw_id);
             if (COMM_SUCCESS == return_value)
             {
+                // the device answers again once its firmware has booted
                 std::string version;
-                int res = COMM_RX_FAIL;
-                for (int tries = 10; tries > 0; tries--)
-                {
-                    res = _driver_map.at(type)->readFirmwareVersion(hw_id, version);
-                    if (COMM_SUCCESS == res)
-                    {
-                        _state_map.at(hw_id)->setFirmwareVersion(version);
-                        break;
-                    }
-                    ros::Duration(0.1).sleep();
-                }
+                common::util::RetryPolicy retry(getRetryBudget(ERetryClass::REBOOT));
+                int res = driver->readFirmwareVersion(hw_id, version);
+                while (COMM_SUCCESS != res && common::util::RetryPolicy::EDecision::RETRY == retry.onFailure())
+                    res = driver->readFirmwareVersion(hw_id, version);
+
+                if (COMM_SUCCESS == res)
+                    _state_map.at(hw_id)->setFirmwareVersion(version);
 
                 if (COMM_SUCCESS != res)
                 {
@@ -490,6 +1212,101 @@ int TtlManager::rebootHardware(uint8_t hw_id)
     return return_value;
 }
 
+/**
+ * @brief TtlManager::rebootHardware : reboot the given components together. The reboots are sent back-to-back,
+ * then all the pending components are polled with one targeted sync read of their model number per bus,
+ * until they all answered or the reboot budget is spent : the recovery time is the boot time of the slowest firmware
+ * @param id_list
+ * @param rebooted_ids : components which were rebooted and answer again
+ * @return COMM_SUCCESS if all the components are back
+ */
+int TtlManager::rebootHardware(const std::vector<uint8_t> &id_list, std::vector<uint8_t> &rebooted_ids)
+{
+    // protocol 2 has no group reboot instruction, each component gets its own reboot packet
+    // the pending components are split by bus
+    std::map<std::shared_ptr<AbstractTtlDriver>, vector<uint8_t>> ids_by_bus;
+    vector<uint8_t> pending_ids;
+    for (auto const id : id_list)
+    {
+        auto driver = (_state_map.count(id) && _state_map.at(id)) ? getDriver(id) : nullptr;
+        if (!driver)
+            continue;
+
+        int res = driver->reboot(id);
+        if (COMM_SUCCESS == res)
+        {
+            TtlPort *port = getExtraPort(id);
+            ids_by_bus[port ? port->getDefaultDriver() : _default_ttl_driver].emplace_back(id);
+            pending_ids.emplace_back(id);
+        }
+        else
+            ROS_WARN("TtlManager::rebootHardware - Failed to reboot hardware %d: %d", id, res);
+    }
+
+    ROS_DEBUG("TtlManager::rebootHardware - Reboot sent to ids %s", common::util::listToString(pending_ids).c_str());
+
+    common::util::RetryPolicy retry(getRetryBudget(ERetryClass::REBOOT));
+    rebooted_ids = waitRebootedIds(std::move(ids_by_bus), retry);
+
+    for (auto const id : rebooted_ids)
+        pending_ids.erase(std::remove(pending_ids.begin(), pending_ids.end(), id), pending_ids.end());
+
+    ROS_WARN_COND(!pending_ids.empty(), "TtlManager::rebootHardware - Hardware %s did not come back after reboot",
+                  common::util::listToString(pending_ids).c_str());
+
+    // the firmware version can change with a reboot (update)
+    readFirmwareVersions(rebooted_ids);
+
+    return pending_ids.empty() ? COMM_SUCCESS : COMM_RX_TIMEOUT;
+}
+
+/**
+ * @brief TtlManager::waitRebootedIds : poll the rebooted components until they answer again.
+ * A component still booting cuts the sync read of the scan at its id, the components after it being found by the next polls.
+ * The components still missing once the retries are spent are pinged one by one, so that a component
+ * which never comes back does not hide the ones after it
+ * @param ids_by_bus : rebooted components, by driver of their bus
+ * @param retry : polls allowed and wait between them
+ * @return components which answered
+ */
+std::vector<uint8_t> TtlManager::waitRebootedIds(std::map<std::shared_ptr<AbstractTtlDriver>, std::vector<uint8_t>> ids_by_bus,
+                                                 common::util::RetryPolicy &retry)
+{
+    vector<uint8_t> rebooted_ids;
+    size_t nb_pending = 0;
+    for (auto const &it : ids_by_bus)
+        nb_pending += it.second.size();
+
+    auto poll = [&](bool ping_fallback)
+    {
+        for (auto &it : ids_by_bus)
+        {
+            if (!it.first || it.second.empty())
+                continue;
+
+            vector<uint8_t> found_ids;
+            if (ping_fallback)
+                scanKnownIds(it.first, it.second, found_ids);
+            else
+                it.first->scanKnownIds(it.second, found_ids);
+
+            for (auto const id : found_ids)
+            {
+                rebooted_ids.emplace_back(id);
+                it.second.erase(std::remove(it.second.begin(), it.second.end(), id), it.second.end());
+            }
+        }
+    };
+
+    while (rebooted_ids.size() < nb_pending && common::util::RetryPolicy::EDecision::RETRY == retry.onFailure())
+        poll(false);
+
+    if (rebooted_ids.size() < nb_pending)
+        poll(true);
+
+    return rebooted_ids;
+}
+
 /**
  * @brief TtlManager::resetTorques
  * @return
@@ -503,8 +1320,10 @@ void TtlManager::resetTorques()
 
         if (driver && _ids_map.count(hw_type) && !_ids_map.at(hw_type).empty())
         {
-            // we retrieve all the associated id for the type of the current driver
-            vector<uint8_t> ids_list = _ids_map.at(hw_type);
+            // we retrieve all the associated id for the type of the current driver, except the missing ones
+            vector<uint8_t> ids_list = getConnectedIds(hw_type);
+            if (ids_list.empty())
+                continue;
 
             // we retrieve all the associated id for the type of the current driver
             vector<uint32_t> position_list;
@@ -515,7 +1334,23 @@ void TtlManager::resetTorques()
                 driver->writeTorqueEnable(ids_list.at(i), 1);
             }  // for ids_list
         }
-    }  // for _driver_map
+    }  // for _driver_map
+
+    for (auto const &port : _extra_ports)
+    {
+        for (auto const &it : port->getIdsMap())
+        {
+            auto driver = std::dynamic_pointer_cast<ttl_driver::AbstractMotorDriver>(port->getDriver(it.first));
+            if (!driver)
+                continue;
+
+            for (auto const id : getConnectedIds(it.second))
+            {
+                ROS_DEBUG("TtlManager::resetTorques - Torque ON on ID: %d (port %s)", static_cast<int>(id), port->getDeviceName().c_str());
+                driver->writeTorqueEnable(id, 1);
+            }
+        }
+    }
 }
 
 // ******************
@@ -531,9 +1366,16 @@ uint32_t TtlManager::getPosition(const JointState &motor_state)
 {
     uint32_t position = 0;
     EHardwareType hardware_type = motor_state.getHardwareType();
-    if (_driver_map.count(hardware_type))
+    TtlPort *port = getExtraPort(motor_state.getId());
+    std::shared_ptr<AbstractTtlDriver> bus_driver;
+    if (port)
+        bus_driver = port->getDriver(hardware_type);
+    else if (_driver_map.count(hardware_type))
+        bus_driver = _driver_map.at(hardware_type);
+
+    if (bus_driver)
     {
-        auto driver = std::dynamic_pointer_cast<AbstractMotorDriver>(_driver_map.at(hardware_type));
+        auto driver = std::dynamic_pointer_cast<AbstractMotorDriver>(bus_driver);
         if (driver)
         {
             for (_hw_fail_counter_read = 0; _hw_fail_counter_read < MAX_HW_FAILURE; ++_hw_fail_counter_read)
@@ -549,7 +1391,7 @@ uint32_t TtlManager::getPosition(const JointState &motor_state)
         if (0 < _hw_fail_counter_read)
         {
             ROS_ERROR_THROTTLE(1, "TtlManager::getPosition - motor connection problem - Failed to read from bus");
-            _debug_error_message = "TtlManager - Connection problem with Bus.";
+            setBusError(EBusError::CONNECTION_PROBLEM);
             _hw_fail_counter_read = 0;
             _is_connection_ok = false;
         }
@@ -557,7 +1399,7 @@ uint32_t TtlManager::getPosition(const JointState &motor_state)
     else
     {
         ROS_ERROR_THROTTLE(1, "TtlManager::getPosition - Driver not found for requested motor id");
-        _debug_error_message = "TtlManager::getPosition - Driver not found for requested motor id";
+        setBusError(EBusError::DRIVER_NOT_FOUND);
     }
     return position;
 }
@@ -629,6 +1471,136 @@ bool TtlManager::readHomingAbsPosition()
     return true;
 }
 
+/**
+ * @brief TtlManager::readTorqueEnable : read back the torque state of the given motors, one sync read per hardware type
+ * @param id_list
+ * @param expected_torque
+ * @param mismatch_id_list : ids with a torque state different from the expected one, or which could not be read
+ * @return COMM_SUCCESS if all the motors have the expected torque state
+ */
+int TtlManager::readTorqueEnable(const std::vector<uint8_t> &id_list, bool expected_torque, std::vector<uint8_t> &mismatch_id_list)
+{
+    mismatch_id_list.clear();
+
+    std::map<EHardwareType, vector<uint8_t>> ids_by_type;
+    for (auto const id : id_list)
+    {
+        if (_state_map.count(id) && _state_map.at(id))
+            ids_by_type[_state_map.at(id)->getHardwareType()].emplace_back(id);
+        else
+            mismatch_id_list.emplace_back(id);
+    }
+
+    for (auto const &it : ids_by_type)
+    {
+        auto const &ids = it.second;
+        auto driver = _driver_map.count(it.first) ? std::dynamic_pointer_cast<AbstractMotorDriver>(_driver_map.at(it.first)) : nullptr;
+
+        vector<uint8_t> torque_list;
+        if (!driver || COMM_SUCCESS != driver->syncReadTorqueEnable(ids, torque_list) || torque_list.size() != ids.size())
+        {
+            ROS_WARN("TtlManager::readTorqueEnable - unable to read torque state for hardware type %d", static_cast<int>(it.first));
+            mismatch_id_list.insert(mismatch_id_list.end(), ids.begin(), ids.end());
+            continue;
+        }
+
+        for (size_t i = 0; i < ids.size(); ++i)
+        {
+            if (static_cast<bool>(torque_list.at(i)) != expected_torque)
+                mismatch_id_list.emplace_back(ids.at(i));
+        }
+    }
+
+    return mismatch_id_list.empty() ? COMM_SUCCESS : COMM_RX_FAIL;
+}
+
+/**
+ * @brief TtlManager::setJointsPosition : apply the positions received, and count the consecutive failures of each id
+ * @param id_list
+ * @param position_list : one position per id
+ * @param valid_list : one flag per id, set if its position has been received
+ * @param sample_time : time at which the positions have been received
+ * @return false if a position is missing
+ */
+bool TtlManager::setJointsPosition(const std::vector<uint8_t> &id_list, const std::vector<uint32_t> &position_list, const std::vector<uint8_t> &valid_list,
+                                   common::model::AbstractMotorState::Clock::time_point sample_time)
+{
+    if (id_list.size() != position_list.size() || id_list.size() != valid_list.size())
+    {
+        // warn to avoid sound and light error on high level (error on ROS_ERROR)
+        ROS_WARN("TtlManager::readJointStatus : Fail to sync read joint state - "
+                 "vector mismatch (id_list size %d, position_list size %d)",
+                 static_cast<int>(id_list.size()), static_cast<int>(position_list.size()));
+        return false;
+    }
+
+    bool res = true;
+
+    // set motors states accordingly
+    for (size_t i = 0; i < id_list.size(); ++i)
+    {
+        uint8_t id = id_list.at(i);
+
+        if (!valid_list.at(i))
+        {
+            uint32_t nb_failures = ++_position_fail_counters[id];
+            (void)nb_failures;  // unused without HW_TRACE
+            // debug to avoid sound and light error on high level (error on ROS_ERROR)
+            HW_TRACE("TtlManager::readJointStatus : no position received from motor %d (%u times in a row)", id, nb_failures);
+            res = false;
+            continue;
+        }
+
+        _position_fail_counters[id] = 0;
+
+        auto it = _state_map.find(id);
+        if (it != _state_map.end())
+        {
+            auto state = std::dynamic_pointer_cast<common::model::AbstractMotorState>(it->second);
+            if (state)
+            {
+                state->setPosition(static_cast<int>(position_list.at(i)), sample_time);
+            }
+        }
+    }
+
+    return res;
+}
+
+/**
+ * @brief TtlManager::updateJointsStatusPipeline : prepare one sync read of the positions per motor driver.
+ * The pipeline is left empty, and the drivers are read one after the other, if one of them cannot be prepared
+ */
+void TtlManager::updateJointsStatusPipeline()
+{
+    _joints_status_layout_changed = false;
+
+    if (_simulation_mode || !_portHandler || !_packetHandler)
+        return;
+
+    if (!_joints_status_pipeline)
+        _joints_status_pipeline = std::make_unique<SyncReadPipeline>(_portHandler, _packetHandler);
+
+    _joints_status_pipeline->clear();
+
+    for (auto const &it : _driver_map)
+    {
+        auto driver = std::dynamic_pointer_cast<ttl_driver::AbstractMotorDriver>(it.second);
+        // a missing motor would make the whole stage wait for the timeout
+        vector<uint8_t> ids_list = getConnectedIds(it.first);
+        if (!driver || ids_list.empty())
+            continue;
+
+        uint16_t address = 0;
+        uint8_t data_len = 0;
+        if (!driver->getPositionRegister(address, data_len) || !_joints_status_pipeline->addStage(address, data_len, ids_list))
+        {
+            _joints_status_pipeline->clear();
+            return;
+        }
+    }
+}
+
 /**
  * @brief TtlManager::readJointsStatus
  * @return
@@ -640,59 +1612,60 @@ bool TtlManager::readJointsStatus()
     // syncread position for all motors.
     // for ned and one -> we need at least one xl430 and one xl320 drivers as they are different
 
-    for (auto const &it : _driver_map)
-    {
-        auto hw_type = it.first;
-        auto driver = std::dynamic_pointer_cast<ttl_driver::AbstractMotorDriver>(it.second);
+    if (_joints_status_layout_changed)
+        updateJointsStatusPipeline();
 
-        if (driver && _ids_map.count(hw_type) && !_ids_map.at(hw_type).empty())
+    // the motors of the extra ports are read by their own thread, while the main bus is read
+    vector<vector<PositionSample>> extra_positions(_extra_ports.size());
+    for (size_t i = 0; i < _extra_ports.size(); ++i)
+        postPositionsRead(*_extra_ports.at(i), extra_positions.at(i));
+
+    if (_joints_status_pipeline && !_joints_status_pipeline->empty())
+    {
+        // each stage is decoded while the next one is on the bus
+        _joints_status_pipeline->run(
+            [&](const SyncReadPipeline::Stage &stage, int /*res*/)
+            {
+                // the positions received are applied even if some motors did not answer
+                if (!setJointsPosition(stage.ids, stage.values, stage.received, stage.receive_time))
+                    hw_errors_increment++;
+            });
+    }
+    else
+    {
+        for (auto const &it : _driver_map)
         {
-            // we retrieve all the associated id for the type of the current driver
-            vector<uint8_t> ids_list = _ids_map.at(hw_type);
+            auto hw_type = it.first;
+            auto driver = std::dynamic_pointer_cast<ttl_driver::AbstractMotorDriver>(it.second);
 
-            // we retrieve all the associated id for the type of the current driver
-            vector<uint32_t> position_list;
+            // we retrieve all the associated id for the type of the current driver, the missing ones are not read
+            vector<uint8_t> ids_list = getConnectedIds(hw_type);
 
-            // retrieve joint status
-            int res = driver->syncReadPosition(ids_list, position_list);
-            if (COMM_SUCCESS == res)
+            if (driver && !ids_list.empty())
             {
-                if (ids_list.size() == position_list.size())
-                {
-                    // set motors states accordingly
-                    for (size_t i = 0; i < ids_list.size(); ++i)
-                    {
-                        uint8_t id = ids_list.at(i);
+                vector<uint32_t> position_list;
+                vector<uint8_t> valid_list;
 
-                        if (_state_map.count(id))
-                        {
-                            auto state = std::dynamic_pointer_cast<common::model::AbstractMotorState>(_state_map.at(id));
-                            if (state)
-                            {
-                                state->setPosition(static_cast<int>((position_list.at(i))));
-                            }
-                        }
-                    }
-                }
-                else
-                {
-                    // warn to avoid sound and light error on high level (error on ROS_ERROR)
-                    ROS_WARN("TtlManager::readJointStatus : Fail to sync read joint state - "
-                             "vector mismatch (id_list size %d, position_list size %d)",
-                             static_cast<int>(ids_list.size()), static_cast<int>(position_list.size()));
+                // retrieve joint status, the positions of the motors which answered are kept
+                // also for Ned which has much more errors on XL320 motor
+                driver->syncReadPartialPosition(ids_list, position_list, valid_list);
+                // the sync read returns once the last status packet has arrived
+                auto sample_time = common::model::AbstractMotorState::Clock::now();
+                if (!setJointsPosition(ids_list, position_list, valid_list, sample_time))
                     hw_errors_increment++;
-                }
             }
-            else
-            {
-                // debug to avoid sound and light error on high level (error on ROS_ERROR)
-                // also for Ned which has much more errors on XL320 motor
-                ROS_DEBUG("TtlManager::readJointStatus : Fail to sync read joint state - "
-                          "driver fail to syncReadPosition");
+        }  // for driver_map
+    }
+
+    for (size_t i = 0; i < _extra_ports.size(); ++i)
+    {
+        _extra_ports.at(i)->wait();
+        for (auto const &sample : extra_positions.at(i))
+        {
+            if (!setJointsPosition(sample.ids, sample.position_list, sample.valid_list, sample.sample_time))
                 hw_errors_increment++;
-            }
         }
-    }  // for driver_map
+    }
 
     // check collision by END_EFFECTOR
     if (_isRealCollision)
@@ -713,7 +1686,7 @@ bool TtlManager::readJointsStatus()
         }
     }
 
-    ROS_DEBUG_THROTTLE(2, "_hw_fail_counter_read, hw_errors_increment: %d, %d", _hw_fail_counter_read, hw_errors_increment);
+    HW_TRACE_THROTTLE(2, "_hw_fail_counter_read, hw_errors_increment: %d, %d", _hw_fail_counter_read, hw_errors_increment);
 
     // we reset the global error variable only if no errors
     if (0 == hw_errors_increment)
@@ -736,85 +1709,78 @@ bool TtlManager::readEndEffectorStatus()
 {
     bool res = false;
 
-    EHardwareType ee_type = _simulation_mode ? EHardwareType::FAKE_END_EFFECTOR : EHardwareType::END_EFFECTOR;
+    // the end effector is either on the main bus or on an extra port
+    uint8_t id = 0;
+    auto driver = getEndEffectorDriver(id);
 
-    if (_driver_map.count(ee_type))
+    if (driver)
     {
         // if calibration not in progress
         if (!isCalibrationInProgress())
         {
             unsigned int hw_errors_increment = 0;
 
-            auto driver = std::dynamic_pointer_cast<AbstractEndEffectorDriver>(_driver_map.at(ee_type));
-            if (driver)
+            if (_state_map.count(id))
             {
-                if (_ids_map.count(ee_type) && !_ids_map.at(ee_type).empty())
+                // we retrieve the associated id for the end effector
+                auto state = std::dynamic_pointer_cast<EndEffectorState>(_state_map[id]);
+
+                if (state)
                 {
-                    uint8_t id = _ids_map.at(ee_type).front();
+                    vector<common::model::EActionType> action_list;
 
-                    if (_state_map.count(id))
+                    // **********  buttons
+                    // get action of free driver button, save pos button, custom button
+                    if (COMM_SUCCESS == driver->syncReadButtonsStatus(id, action_list))
                     {
-                        // we retrieve the associated id for the end effector
-                        auto state = std::dynamic_pointer_cast<EndEffectorState>(_state_map[id]);
-
-                        if (state)
+                        for (uint8_t i = 0; i < action_list.size(); i++)
                         {
-                            vector<common::model::EActionType> action_list;
-
-                            // **********  buttons
-                            // get action of free driver button, save pos button, custom button
-                            if (COMM_SUCCESS == driver->syncReadButtonsStatus(id, action_list))
+                            state->setButtonStatus(i, action_list.at(i));
+                            // In case free driver button, it we hold this button, normally, because of the small threshold of collision detection
+                            // this action make EE confuse that it is a collision. That's why when we hold buttons, we need to deactivate the detection of collision.
+                            if (action_list.at(i) != common::model::EActionType::NO_ACTION)
                             {
-                                for (uint8_t i = 0; i < action_list.size(); i++)
-                                {
-                                    state->setButtonStatus(i, action_list.at(i));
-                                    // In case free driver button, it we hold this button, normally, because of the small threshold of collision detection
-                                    // this action make EE confuse that it is a collision. That's why when we hold buttons, we need to deactivate the detection of collision.
-                                    if (action_list.at(i) != common::model::EActionType::NO_ACTION)
-                                    {
-                                        _isRealCollision = false;
-                                    }
-                                    else if (!_isRealCollision)
-                                    {
-                                        // when previous action is not no_action => need to wait a short period to make sure no collision detected
-                                        // Note, we need to read one time the status of collision just after releasing button to reset the status.
-                                        _isRealCollision = true;
-                                        _isWrongAction = true;
-                                        _last_collision_detection_activating = ros::Time::now().toSec();
-                                    }
-                                }
+                                _isRealCollision = false;
                             }
-                            else
+                            else if (!_isRealCollision)
                             {
-                                hw_errors_increment++;
+                                // when previous action is not no_action => need to wait a short period to make sure no collision detected
+                                // Note, we need to read one time the status of collision just after releasing button to reset the status.
+                                _isRealCollision = true;
+                                _isWrongAction = true;
+                                _last_collision_detection_activating = ros::Time::now().toSec();
                             }
+                        }
+                    }
+                    else
+                    {
+                        hw_errors_increment++;
+                    }
 
-                            // **********  digital data
-                            bool digital_data{};
-                            if (COMM_SUCCESS == driver->readDigitalInput(id, digital_data))
-                            {
-                                state->setDigitalIn(digital_data);
-                            }
-                            else
-                            {
-                                hw_errors_increment++;
-                            }
-                        }  // if (state)
+                    // **********  digital data
+                    bool digital_data{};
+                    if (COMM_SUCCESS == driver->readDigitalInput(id, digital_data))
+                    {
+                        state->setDigitalIn(digital_data);
+                    }
+                    else
+                    {
+                        hw_errors_increment++;
                     }
-                }  // if (_ids_map.count(EHardwareType::END_EFFECTOR))
-            }      // if (driver)
+                }  // if (state)
+            }
 
             // we reset the global error variable only if no errors
             if (0 == hw_errors_increment)
             {
                 _end_effector_fail_counter_read = 0;
-                _debug_error_message.clear();
+                setBusError(EBusError::NONE);
 
                 res = true;
             }
             else
             {
-                ROS_DEBUG_COND(_end_effector_fail_counter_read > 10, "TtlManager::readEndEffectorStatus: nb error > 10 :  %d", _end_effector_fail_counter_read);
+                HW_TRACE_COND(_end_effector_fail_counter_read > 10, "TtlManager::readEndEffectorStatus: nb error > 10 :  %d", _end_effector_fail_counter_read);
                 _end_effector_fail_counter_read += hw_errors_increment;
             }
 
@@ -822,12 +1788,12 @@ bool TtlManager::readEndEffectorStatus()
             {
                 ROS_ERROR("TtlManager::readEndEffectorStatus - motor connection problem - Failed to read from bus (hw_fail_counter_read : %d)", _end_effector_fail_counter_read);
                 _end_effector_fail_counter_read = 0;
-                _debug_error_message = "TtlManager - Connection problem with physical Bus.";
+                setBusError(EBusError::CONNECTION_PROBLEM);
             }
         }
         else
         {
-            ROS_DEBUG_THROTTLE(2, "TtlManager::readEndEffectorStatus - calibration is in progress");
+            HW_TRACE_THROTTLE(2, "TtlManager::readEndEffectorStatus - calibration is in progress");
         }
     }
 
@@ -843,55 +1809,48 @@ bool TtlManager::checkCollision()
 {
     bool res = false;
 
-    EHardwareType ee_type = _simulation_mode ? EHardwareType::FAKE_END_EFFECTOR : EHardwareType::END_EFFECTOR;
+    // the end effector is either on the main bus or on an extra port
+    uint8_t id = 0;
+    auto driver = getEndEffectorDriver(id);
 
-    if (_driver_map.count(ee_type))
+    if (driver)
     {
         unsigned int hw_errors_increment = 0;
 
-        auto driver = std::dynamic_pointer_cast<AbstractEndEffectorDriver>(_driver_map.at(ee_type));
-        if (driver)
+        // **********  collision
+        // not accept other status of collistion in 1 second if it detected a collision
+        if (0.0 == _last_collision_detection_activating)
         {
-            if (_ids_map.count(ee_type) && !_ids_map.at(ee_type).empty())
+            bool last_statut = _collision_status;
+            if (COMM_SUCCESS == driver->readCollisionStatus(id, _collision_status))
             {
-                uint8_t id = _ids_map.at(ee_type).front();
-
-                // **********  collision
-                // not accept other status of collistion in 1 second if it detected a collision
-                if (0.0 == _last_collision_detection_activating)
+                if (last_statut == _collision_status && _collision_status)
                 {
-                    bool last_statut = _collision_status;
-                    if (COMM_SUCCESS == driver->readCollisionStatus(id, _collision_status))
+                    // if we have a collision, we will publish the statut collision only once
+                    // This avoid that the delay in reading statut influent to next movement.
+                    _collision_status = false;
+                }
+                else if (_collision_status)
+                {
+                    if (_isWrongAction)
                     {
-                        if (last_statut == _collision_status && _collision_status)
-                        {
-                            // if we have a collision, we will publish the statut collision only once
-                            // This avoid that the delay in reading statut influent to next movement.
-                            _collision_status = false;
-                        }
-                        else if (_collision_status)
-                        {
-                            if (_isWrongAction)
-                            {
-                                // if an action did a wrong detection of collision, we need to read once to reset the status
-                                _isWrongAction = false;
-                                _collision_status = false;
-                            }
-                            else
-                                _last_collision_detection_activating = ros::Time::now().toSec();
-                        }
+                        // if an action did a wrong detection of collision, we need to read once to reset the status
+                        _isWrongAction = false;
+                        _collision_status = false;
                     }
                     else
-                    {
-                        hw_errors_increment++;
-                    }
-                }
-                else if (ros::Time::now().toSec() - _last_collision_detection_activating >= 1.0)
-                {
-                    _last_collision_detection_activating = 0.0;
+                        _last_collision_detection_activating = ros::Time::now().toSec();
                 }
-            }  // if (_ids_map.count(EHardwareType::END_EFFECTOR))
-        }      // if (driver)
+            }
+            else
+            {
+                hw_errors_increment++;
+            }
+        }
+        else if (ros::Time::now().toSec() - _last_collision_detection_activating >= 1.0)
+        {
+            _last_collision_detection_activating = 0.0;
+        }
 
         // we reset the global error variable only if no errors
         if (0 == hw_errors_increment)
@@ -901,7 +1860,7 @@ bool TtlManager::checkCollision()
         }
         else
         {
-            ROS_DEBUG_COND(_end_effector_fail_counter_read > 10, "TtlManager::checkCollision: nb error > 10 :  %d", _end_effector_fail_counter_read);
+            HW_TRACE_COND(_end_effector_fail_counter_read > 10, "TtlManager::checkCollision: nb error > 10 :  %d", _end_effector_fail_counter_read);
             _end_effector_fail_counter_read += hw_errors_increment;
         }
     }
@@ -916,50 +1875,42 @@ bool TtlManager::readCollisionStatus()
 {
     bool res = false;
 
-    EHardwareType ee_type = _simulation_mode ? EHardwareType::FAKE_END_EFFECTOR : EHardwareType::END_EFFECTOR;
+    // the end effector is either on the main bus or on an extra port
+    uint8_t id = 0;
+    auto driver = getEndEffectorDriver(id);
 
-    if (_driver_map.count(ee_type))
+    if (driver)
     {
-        auto driver = std::dynamic_pointer_cast<AbstractEndEffectorDriver>(_driver_map.at(ee_type));
-
-        if (driver)
+        // **********  collision
+        // don't accept other status of collistion in 1 second if it detected a collision
+        if (0.0 == _last_collision_detection_activating)
         {
-            if (_ids_map.count(ee_type) && !_ids_map.at(ee_type).empty())
+            if (COMM_SUCCESS == driver->readCollisionStatus(id, _collision_status))
             {
-                uint8_t id = _ids_map.at(ee_type).front();
+                res = true;
 
-                // **********  collision
-                // don't accept other status of collistion in 1 second if it detected a collision
-                if (0.0 == _last_collision_detection_activating)
+                if (_collision_status)
                 {
-                    if (COMM_SUCCESS == driver->readCollisionStatus(id, _collision_status))
+                    if (_isWrongAction)
                     {
-                        res = true;
-
-                        if (_collision_status)
-                        {
-                            if (_isWrongAction)
-                            {
-                                // if an action did a wrong detection of collision, we need to read once to reset the status
-                                _isWrongAction = false;
-                                _collision_status = false;
-                            }
-                            else
-                            {
-                                _last_collision_detection_activating = ros::Time::now().toSec();
-                            }
-                        }
+                        // if an action did a wrong detection of collision, we need to read once to reset the status
+                        _isWrongAction = false;
+                        _collision_status = false;
                     }
                     else
                     {
-                        _end_effector_fail_counter_read++;
+                        _last_collision_detection_activating = ros::Time::now().toSec();
                     }
                 }
-                else if (ros::Time::now().toSec() - _last_collision_detection_activating >= 1.0)
-                {
-                    _last_collision_detection_activating = 0.0;
-                }
             }
+            else
+            {
+                _end_effector_fail_counter_read++;
+            }
+        }
+        else if (ros::Time::now().toSec() - _last_collision_detection_activating >= 1.0)
+        {
+            _last_collision_detection_activating = 0.0;
         }
     }
 
@@ -967,101 +1918,219 @@ bool TtlManager::readCollisionStatus()
 }
 
 /**
- * @brief TtlManager::readHardwareStatus
+ * @brief TtlManager::syncReadHardwareStatus : read the voltage, temperature and error state of the devices of a sample.
+ * Only the bus of the sample is used, the states are updated by applyHardwareStatus
+ * @param sample
+ * @return number of errors
  */
-bool TtlManager::readHardwareStatus()
+unsigned int TtlManager::syncReadHardwareStatus(HardwareStatusSample &sample)
 {
-    bool res = false;
-
     unsigned int hw_errors_increment = 0;
 
-    // take all hw status dedicated drivers
-    for (auto const &it : _driver_map)
+    // **********  voltage and Temperature
+    if (COMM_SUCCESS != sample.driver->syncReadPartialHwStatus(sample.ids, sample.hw_data_list, sample.hw_data_valid_list))
     {
-        auto type = it.first;
-        auto driver = it.second;
+        // this operation can fail, it is normal, so no error message
+        hw_errors_increment++;
+    }
 
-        if (driver && _ids_map.count(type) && !_ids_map.at(type).empty())
-        {
-            // we retrieve all the associated id for the type of the current driver
-            vector<uint8_t> ids_list = _ids_map.at(type);
+    if (sample.ids.size() != sample.hw_data_list.size() || sample.ids.size() != sample.hw_data_valid_list.size())
+    {
+        // however, if we have a mismatch here, it is not normal
+        ROS_ERROR("TtlManager::readHardwareStatusOptimized : syncReadHwStatus failed - "
+                  "vector mistmatch (id_list size %d, hw_data_list size %d)",
+                  static_cast<int>(sample.ids.size()), static_cast<int>(sample.hw_data_list.size()));
 
-            // 1. syncread for all motors
-            // **********  voltage and Temperature
-            vector<std::pair<double, uint8_t>> hw_data_list;
+        hw_errors_increment++;
+    }
 
-            if (COMM_SUCCESS != driver->syncReadHwStatus(ids_list, hw_data_list))
-            {
-                // this operation can fail, it is normal, so no error message
-                hw_errors_increment++;
-            }
-            else if (ids_list.size() != hw_data_list.size())
+    // **********  error state
+    if (COMM_SUCCESS != sample.driver->syncReadPartialHwErrorStatus(sample.ids, sample.hw_error_status_list, sample.hw_error_valid_list))
+    {
+        hw_errors_increment++;
+    }
+
+    if (sample.ids.size() != sample.hw_error_status_list.size() || sample.ids.size() != sample.hw_error_valid_list.size())
+    {
+        ROS_ERROR("TtlManager::readHardwareStatus : syncReadTemperature failed - "
+                  "vector mistmatch (id_list size %d, hw_status_list size %d)",
+                  static_cast<int>(sample.ids.size()), static_cast<int>(sample.hw_error_status_list.size()));
+
+        hw_errors_increment++;
+    }
+
+    return hw_errors_increment;
+}
+
+/**
+ * @brief TtlManager::applyHardwareStatus : set the states of the devices of a sample, with the values received
+ * @param sample
+ */
+void TtlManager::applyHardwareStatus(const HardwareStatusSample &sample)
+{
+    for (size_t i = 0; i < sample.ids.size(); ++i)
+    {
+        uint8_t id = sample.ids.at(i);
+
+        if (_state_map.count(id) && _state_map.at(id))
+        {
+            auto state = _state_map.at(id);
+
+            // **************  temperature and voltage
+            if (sample.hw_data_valid_list.size() > i && sample.hw_data_valid_list.at(i) && sample.hw_data_list.size() > i)
             {
-                // however, if we have a mismatch here, it is not normal
-                ROS_ERROR("TtlManager::readHardwareStatusOptimized : syncReadHwStatus failed - "
-                          "vector mistmatch (id_list size %d, hw_data_list size %d)",
-                          static_cast<int>(ids_list.size()), static_cast<int>(hw_data_list.size()));
+                double voltage = (sample.hw_data_list.at(i)).first;
+                uint8_t temperature = (sample.hw_data_list.at(i)).second;
 
-                hw_errors_increment++;
+                state->setTemperature(temperature);
+                state->setRawVoltage(voltage);
             }
 
             // **********  error state
-            vector<uint8_t> hw_error_status_list;
-
-            if (COMM_SUCCESS != driver->syncReadHwErrorStatus(ids_list, hw_error_status_list))
+            if (sample.hw_error_valid_list.size() > i && sample.hw_error_valid_list.at(i) && sample.hw_error_status_list.size() > i)
             {
-                hw_errors_increment++;
+                state->setHardwareError(sample.hw_error_status_list.at(i));
             }
-            else if (ids_list.size() != hw_error_status_list.size())
-            {
-                ROS_ERROR("TtlManager::readHardwareStatus : syncReadTemperature failed - "
-                          "vector mistmatch (id_list size %d, hw_status_list size %d)",
-                          static_cast<int>(ids_list.size()), static_cast<int>(hw_error_status_list.size()));
 
-                hw_errors_increment++;
+            // interpret any error code into message (even if not retrieved now)
+            string hardware_message = sample.driver->interpretErrorState(state->getHardwareError());
+            state->setHardwareError(hardware_message);
+        }
+    }  // for ids_list
+}
+
+/**
+ * @brief TtlManager::postHardwareStatusRead : read the hardware status and the conveyors of an extra port with its I/O thread.
+ * The job only uses the port and the given status, which must be kept until the port is waited for
+ * @param port
+ * @param status
+ */
+void TtlManager::postHardwareStatusRead(TtlPort &port, ExtraPortStatus &status)
+{
+    for (auto const &it : port.getIdsMap())
+    {
+        HardwareStatusSample sample;
+        sample.driver = port.getDriver(it.first);
+        sample.ids = getConnectedIds(it.second);
+        if (sample.driver && !sample.ids.empty())
+            status.hw_status.emplace_back(std::move(sample));
+    }
+
+    auto stepper_driver = std::dynamic_pointer_cast<AbstractStepperDriver>(port.getDriver(EHardwareType::STEPPER));
+    if (stepper_driver)
+    {
+        for (auto const id : getConnectedIds(_conveyor_list))
+        {
+            if (port.isAssigned(id))
+                status.conveyor_ids.emplace_back(id);
+        }
+    }
+
+    if (status.hw_status.empty() && status.conveyor_ids.empty())
+        return;
+
+    port.post(
+        [&status, stepper_driver]()
+        {
+            for (auto &sample : status.hw_status)
+                status.errors += syncReadHardwareStatus(sample);
+
+            if (!status.conveyor_ids.empty() && COMM_SUCCESS != stepper_driver->syncReadVelocity(status.conveyor_ids, status.conveyor_velocity_list))
+            {
+                status.conveyor_ids.clear();
+                status.errors++;
             }
+        });
+}
 
-            // 2. set motors states accordingly
-            for (size_t i = 0; i < ids_list.size(); ++i)
+/**
+ * @brief TtlManager::postPositionsRead : read the positions of the motors of an extra port with its I/O thread.
+ * The job only uses the port and the given samples, which must be kept until the port is waited for
+ * @param port
+ * @param samples
+ */
+void TtlManager::postPositionsRead(TtlPort &port, std::vector<PositionSample> &samples)
+{
+    for (auto const &it : port.getIdsMap())
+    {
+        PositionSample sample;
+        sample.driver = std::dynamic_pointer_cast<AbstractMotorDriver>(port.getDriver(it.first));
+        sample.ids = getConnectedIds(it.second);
+        if (sample.driver && !sample.ids.empty())
+            samples.emplace_back(std::move(sample));
+    }
+
+    if (samples.empty())
+        return;
+
+    port.post(
+        [&samples]()
+        {
+            for (auto &sample : samples)
             {
-                uint8_t id = ids_list.at(i);
+                // the positions of the motors which answered are kept
+                sample.driver->syncReadPartialPosition(sample.ids, sample.position_list, sample.valid_list);
+                sample.sample_time = common::model::AbstractMotorState::Clock::now();
+            }
+        });
+}
 
-                if (_state_map.count(id) && _state_map.at(id))
-                {
-                    auto state = _state_map.at(id);
+/**
+ * @brief TtlManager::readHardwareStatus : the extra ports are read by their own thread while the main bus is read,
+ * the states of their devices are updated afterwards
+ */
+bool TtlManager::readHardwareStatus()
+{
+    bool res = false;
 
-                    // **************  temperature and voltage
-                    if (hw_data_list.size() > i)
-                    {
-                        double voltage = (hw_data_list.at(i)).first;
-                        uint8_t temperature = (hw_data_list.at(i)).second;
+    unsigned int hw_errors_increment = 0;
+
+    vector<ExtraPortStatus> extra_status(_extra_ports.size());
+    for (size_t i = 0; i < _extra_ports.size(); ++i)
+        postHardwareStatusRead(*_extra_ports.at(i), extra_status.at(i));
+
+    // take all hw status dedicated drivers
+    for (auto const &it : _driver_map)
+    {
+        auto type = it.first;
 
-                        state->setTemperature(temperature);
-                        state->setRawVoltage(voltage);
-                    }
+        if (it.second && _ids_map.count(type) && !_ids_map.at(type).empty())
+        {
+            // we retrieve all the associated id for the type of the current driver, except the missing ones
+            HardwareStatusSample sample;
+            sample.driver = it.second;
+            sample.ids = getConnectedIds(type);
+            if (sample.ids.empty())
+                continue;
 
-                    // **********  error state
-                    if (hw_error_status_list.size() > i)
-                    {
-                        state->setHardwareError(hw_error_status_list.at(i));
-                    }
+            // 1. syncread for all motors
+            hw_errors_increment += syncReadHardwareStatus(sample);
 
-                    // interpret any error code into message (even if not retrieved now)
-                    string hardware_message = driver->interpretErrorState(state->getHardwareError());
-                    state->setHardwareError(hardware_message);
-                }
-            }  // for ids_list
-        }      // if driver
-    }          // for (auto it : _hw_status_driver_map)
+            // 2. set motors states accordingly
+            applyHardwareStatus(sample);
+        }  // if driver
+    }      // for (auto it : _hw_status_driver_map)
 
     // **********  steppers related informations (conveyor and calibration)
     hw_errors_increment += readSteppersStatus();
 
+    // **********  extra ports
+    for (size_t i = 0; i < _extra_ports.size(); ++i)
+    {
+        _extra_ports.at(i)->wait();
+
+        auto const &status = extra_status.at(i);
+        for (auto const &sample : status.hw_status)
+            applyHardwareStatus(sample);
+
+        hw_errors_increment += status.errors + applyConveyorsVelocity(status.conveyor_ids, status.conveyor_velocity_list);
+    }
+
     // we reset the global error variable only if no errors
     if (0 == hw_errors_increment)
     {
         _hw_fail_counter_read = 0;
-        _debug_error_message.clear();
+        setBusError(EBusError::NONE);
 
         res = true;
     }
@@ -1080,7 +2149,7 @@ bool TtlManager::readHardwareStatus()
         _hw_fail_counter_read = 0;
         res = false;
         _is_connection_ok = false;
-        _debug_error_message = "TtlManager - Connection problem with physical Bus.";
+        setBusError(EBusError::CONNECTION_PROBLEM);
     }
 
     return res;
@@ -1133,17 +2202,12 @@ uint8_t TtlManager::readSteppersStatus()
                     // max status need to be kept not converted into EStepperCalibrationStatus because max status is "in progress" in the enum
                     int max_status = -1;
 
-                    // debug only
-                    std::ostringstream ss_debug;
-                    ss_debug << "homing status : ";
-
                     bool still_in_progress = false;
 
                     // set states accordingly
                     for (size_t i = 0; i < homing_status_list.size(); ++i)
                     {
                         uint8_t id = stepper_id_list.at(i);
-                        ss_debug << static_cast<int>(homing_status_list.at(i)) << ", ";
 
                         if (_state_map.count(id))
                         {
@@ -1176,9 +2240,8 @@ uint8_t TtlManager::readSteppersStatus()
                         }
                     }  // for homing_status_list
 
-                    ss_debug << " => max_status: " << static_cast<int>(max_status);
-
-                    ROS_DEBUG_THROTTLE(2.0, "TtlManager::readCalibrationStatus : %s", ss_debug.str().c_str());
+                    HW_TRACE_THROTTLE(2.0, "TtlManager::readCalibrationStatus : %s => max_status: %d",
+                                      common::util::listToString(homing_status_list).c_str(), static_cast<int>(max_status));
 
                     // see truth table above
                     // timeout is here to prevent being stuck here if retrying calibration when already at the butee (then the system has no time to switch to "in progress"
@@ -1219,44 +2282,15 @@ uint8_t TtlManager::readSteppersStatus()
             }
         }  // if (_driver_map.count(hw_type) && _driver_map.at(hw_type))
 
-        // 2. read conveyors states if has
-        if (!_conveyor_list.empty())
+        // 2. read conveyors states if has, the ones of the extra ports are read by their port
+        vector<uint8_t> conveyor_list;
+        std::copy_if(_conveyor_list.begin(), _conveyor_list.end(), std::back_inserter(conveyor_list), [this](uint8_t id) { return !getExtraPort(id); });
+        if (!conveyor_list.empty())
         {
             std::vector<uint32_t> velocity_list;
-            if (COMM_SUCCESS == _default_stepper_driver->syncReadVelocity(_conveyor_list, velocity_list))
+            if (COMM_SUCCESS == _default_stepper_driver->syncReadVelocity(conveyor_list, velocity_list))
             {
-                if (_conveyor_list.size() == velocity_list.size())
-                {
-                    for (size_t i = 0; i < velocity_list.size(); ++i)
-                    {
-                        uint8_t conveyor_id = _conveyor_list.at(i);
-                        auto velocity = static_cast<int32_t>(velocity_list.at(i));
-
-                        if (_state_map.count(conveyor_id))
-                        {
-                            auto cState = std::dynamic_pointer_cast<common::model::ConveyorState>(_state_map.at(conveyor_id));
-                            if (cState && cState->isConveyor())
-                            {
-                                cState->setGoalDirection(cState->getDirection() * (velocity > 0 ? 1 : -1));
-                                // speed of ttl conveyor is in range 0 - 6000. Therefore, we convert this absolute value to percentage
-                                cState->setSpeed(static_cast<int16_t>(std::abs(velocity * 100 / 6000)));  // TODO(Thuc) avoid hardcoded 6000 here
-                                cState->setState(velocity);
-                            }
-                            else
-                            {
-                                hw_errors_increment++;
-                            }
-                        }
-                    }  // for velocity_list
-                }
-                else
-                {
-                    ROS_ERROR("TtlManager::readSteppersStatus : syncReadVelocity failed - "
-                              "vector mistmatch (_conveyor_list size %d, velocity_list size %d)",
-                              static_cast<int>(_conveyor_list.size()), static_cast<int>(velocity_list.size()));
-
-                    hw_errors_increment++;
-                }
+                hw_errors_increment += applyConveyorsVelocity(conveyor_list, velocity_list);
             }
             else
             {
@@ -1265,8 +2299,52 @@ uint8_t TtlManager::readSteppersStatus()
         }
     }
 
-    ROS_DEBUG_THROTTLE(2.0, "TtlManager::readCalibrationStatus: _calibration_status: %s", common::model::StepperCalibrationStatusEnum(_calibration_status).toString().c_str());
-    ROS_DEBUG_THROTTLE(2.0, "TtlManager::readCalibrationStatus: _calib_machine_state: %d", static_cast<int>(_calib_machine_state.status()));
+    HW_TRACE_THROTTLE(2.0, "TtlManager::readCalibrationStatus: _calibration_status: %s", common::model::StepperCalibrationStatusEnum(_calibration_status).toString());
+    HW_TRACE_THROTTLE(2.0, "TtlManager::readCalibrationStatus: _calib_machine_state: %d", static_cast<int>(_calib_machine_state.status()));
+
+    return hw_errors_increment;
+}
+
+/**
+ * @brief TtlManager::applyConveyorsVelocity : set the states of the conveyors with the velocities read
+ * @param conveyor_ids
+ * @param velocity_list : one velocity per conveyor
+ * @return number of errors
+ */
+unsigned int TtlManager::applyConveyorsVelocity(const std::vector<uint8_t> &conveyor_ids, const std::vector<uint32_t> &velocity_list)
+{
+    unsigned int hw_errors_increment = 0;
+
+    if (conveyor_ids.size() != velocity_list.size())
+    {
+        ROS_ERROR("TtlManager::readSteppersStatus : syncReadVelocity failed - "
+                  "vector mistmatch (_conveyor_list size %d, velocity_list size %d)",
+                  static_cast<int>(conveyor_ids.size()), static_cast<int>(velocity_list.size()));
+
+        return ++hw_errors_increment;
+    }
+
+    for (size_t i = 0; i < velocity_list.size(); ++i)
+    {
+        uint8_t conveyor_id = conveyor_ids.at(i);
+        auto velocity = static_cast<int32_t>(velocity_list.at(i));
+
+        if (_state_map.count(conveyor_id))
+        {
+            auto cState = std::dynamic_pointer_cast<common::model::ConveyorState>(_state_map.at(conveyor_id));
+            if (cState && cState->isConveyor())
+            {
+                cState->setGoalDirection(cState->getDirection() * (velocity > 0 ? 1 : -1));
+                // speed of ttl conveyor is in range 0 - 6000. Therefore, we convert this absolute value to percentage
+                cState->setSpeed(static_cast<int16_t>(std::abs(velocity * 100 / 6000)));  // TODO(Thuc) avoid hardcoded 6000 here
+                cState->setState(velocity);
+            }
+            else
+            {
+                hw_errors_increment++;
+            }
+        }
+    }  // for velocity_list
 
     return hw_errors_increment;
 }
@@ -1289,22 +2367,17 @@ int TtlManager::getAllIdsOnBus(vector<uint8_t> &id_list)
         result = _default_ttl_driver->scan(l_idList);
         id_list.insert(id_list.end(), l_idList.begin(), l_idList.end());
 
-        string ids_str;
-        for (auto const &id : l_idList)
-            ids_str += to_string(id) + " ";
-
-        ROS_DEBUG_THROTTLE(1, "TtlManager::getAllIdsOnTtlBus - Found ids (%s) on bus using default driver", ids_str.c_str());
+        ROS_DEBUG_THROTTLE(1, "TtlManager::getAllIdsOnTtlBus - Found ids (%s) on bus using default driver", common::util::listToString(l_idList).c_str());
 
         if (COMM_SUCCESS != result)
         {
             if (COMM_RX_TIMEOUT != result)
             {  // -3001
-                _debug_error_message = "TtlManager - No motor found. "
-                                       "Make sure that motors are correctly connected and powered on.";
+                setBusError(EBusError::NO_MOTOR_FOUND);
             }
             else
             {  // -3002 or other
-                _debug_error_message = "TtlManager - Failed to scan bus.";
+                setBusError(EBusError::SCAN_FAILED);
             }
             ROS_WARN_THROTTLE(1,
                               "TtlManager::getAllIdsOnTtlBus - Broadcast ping failed, "
@@ -1321,6 +2394,65 @@ int TtlManager::getAllIdsOnBus(vector<uint8_t> &id_list)
     return result;
 }
 
+/**
+ * @brief TtlManager::scanKnownIds : targeted scan on the bus of the given driver
+ * @param driver
+ * @param expected_ids
+ * @param id_list : ids of expected_ids found on the bus
+ * @return COMM_SUCCESS if the scan could be done, even if some ids are missing
+ */
+int TtlManager::scanKnownIds(const std::shared_ptr<AbstractTtlDriver> &driver, const std::vector<uint8_t> &expected_ids, std::vector<uint8_t> &id_list)
+{
+    int result = driver->scanKnownIds(expected_ids, id_list);
+
+    if (COMM_RX_TIMEOUT == result)
+    {
+        // a missing motor can prevent the next ones from answering the sync read, ping them one by one
+        for (auto const &id : expected_ids)
+        {
+            if (std::find(id_list.begin(), id_list.end(), id) == id_list.end() && COMM_SUCCESS == driver->ping(id))
+                id_list.emplace_back(id);
+        }
+        result = COMM_SUCCESS;
+    }
+
+    return result;
+}
+
+/**
+ * @brief TtlManager::getKnownIdsOnBus : fast check of the given ids, without waiting for a broadcast ping
+ * @param expected_ids
+ * @param id_list : ids of expected_ids found on the bus
+ * @return COMM_SUCCESS if the scan could be done, even if some ids are missing
+ */
+int TtlManager::getKnownIdsOnBus(const vector<uint8_t> &expected_ids, vector<uint8_t> &id_list)
+{
+    int result = COMM_RX_FAIL;
+
+    if (_default_ttl_driver)
+    {
+        vector<uint8_t> l_idList;
+        result = scanKnownIds(_default_ttl_driver, expected_ids, l_idList);
+
+        id_list.insert(id_list.end(), l_idList.begin(), l_idList.end());
+
+        HW_TRACE_THROTTLE(1, "TtlManager::getKnownIdsOnBus - Found ids (%s) on bus using default driver", common::util::listToString(l_idList).c_str());
+
+        if (COMM_SUCCESS != result)
+        {
+            setBusError(EBusError::SCAN_FAILED);
+            ROS_WARN_THROTTLE(1, "TtlManager::getKnownIdsOnBus - Targeted scan failed, result : %d", result);
+        }
+    }
+    else
+    {
+        // if no driver, no motors on bus, it is not a failure of scan
+        result = COMM_SUCCESS;
+    }
+
+    return result;
+}
+
 // ******************
 //  Write operations
 // ******************
@@ -1353,12 +2485,10 @@ int TtlManager::setLeds(int led)
             vector<uint8_t> command_led_value(id_list.size(), static_cast<uint8_t>(led));
             if (0 <= led && 7 >= led)
             {
-                int result = COMM_TX_FAIL;
-                for (int error_counter = 0; result != COMM_SUCCESS && error_counter < 5; ++error_counter)
-                {
-                    ros::Duration(TIME_TO_WAIT_IF_BUSY).sleep();
+                common::util::RetryPolicy retry(getRetryBudget(ERetryClass::LEDS));
+                int result = driver->syncWriteLed(id_list, command_led_value);
+                while (COMM_SUCCESS != result && common::util::RetryPolicy::EDecision::RETRY == retry.onFailure())
                     result = driver->syncWriteLed(id_list, command_led_value);
-                }
 
                 if (COMM_SUCCESS == result)
                     ret = niryo_robot_msgs::CommandStatus::SUCCESS;
@@ -1399,11 +2529,12 @@ int TtlManager::sendCustomCommand(uint8_t id, int reg_address, int value, int by
     if (_state_map.count(id) != 0 && _state_map.at(id))
     {
         EHardwareType motor_type = _state_map.at(id)->getHardwareType();
+        auto driver = getDriver(id);
 
-        if (_driver_map.count(motor_type) && _driver_map.at(motor_type))
+        if (driver)
         {
             int32_t value_conv = value;
-            result = _driver_map.at(motor_type)->writeCustom(static_cast<uint16_t>(reg_address), static_cast<uint8_t>(byte_number), id, static_cast<uint32_t>(value_conv));
+            result = driver->writeCustom(static_cast<uint16_t>(reg_address), static_cast<uint8_t>(byte_number), id, static_cast<uint32_t>(value_conv));
             if (result != COMM_SUCCESS)
             {
                 ROS_WARN("TtlManager::sendCustomCommand - Failed to write custom command: %d", result);
@@ -1413,7 +2544,7 @@ int TtlManager::sendCustomCommand(uint8_t id, int reg_address, int value, int by
         }
         else
         {
-            ROS_ERROR_THROTTLE(1, "TtlManager::sendCustomCommand - driver for motor %s not available", HardwareTypeEnum(motor_type).toString().c_str());
+            ROS_ERROR_THROTTLE(1, "TtlManager::sendCustomCommand - driver for motor %s not available", HardwareTypeEnum(motor_type).toString());
             result = niryo_robot_msgs::CommandStatus::WRONG_MOTOR_TYPE;
         }
     }
@@ -1443,11 +2574,12 @@ int TtlManager::readCustomCommand(uint8_t id, int32_t reg_address, int &value, i
     if (_state_map.count(id) != 0 && _state_map.at(id))
     {
         EHardwareType motor_type = _state_map.at(id)->getHardwareType();
+        auto driver = getDriver(id);
 
-        if (_driver_map.count(motor_type) && _driver_map.at(motor_type))
+        if (driver)
         {
             uint32_t data = 0;
-            result = _driver_map.at(motor_type)->readCustom(static_cast<uint16_t>(reg_address), static_cast<uint8_t>(byte_number), id, data);
+            result = driver->readCustom(static_cast<uint16_t>(reg_address), static_cast<uint8_t>(byte_number), id, data);
             auto data_conv = static_cast<int32_t>(data);
             value = data_conv;
 
@@ -1459,7 +2591,7 @@ int TtlManager::readCustomCommand(uint8_t id, int32_t reg_address, int &value, i
         }
         else
         {
-            ROS_ERROR_THROTTLE(1, "TtlManager::readCustomCommand - driver for motor %s not available", HardwareTypeEnum(motor_type).toString().c_str());
+            ROS_ERROR_THROTTLE(1, "TtlManager::readCustomCommand - driver for motor %s not available", HardwareTypeEnum(motor_type).toString());
             result = niryo_robot_msgs::CommandStatus::WRONG_MOTOR_TYPE;
         }
     }
@@ -1493,10 +2625,11 @@ int TtlManager::readMotorPID(uint8_t id, uint16_t &pos_p_gain, uint16_t &pos_i_g
     if (_state_map.count(id) != 0 && _state_map.at(id))
     {
         EHardwareType motor_type = _state_map.at(id)->getHardwareType();
+        auto bus_driver = getDriver(id);
 
-        if (_driver_map.count(motor_type))
+        if (bus_driver)
         {
-            auto driver = std::dynamic_pointer_cast<AbstractDxlDriver>(_driver_map.at(motor_type));
+            auto driver = std::dynamic_pointer_cast<AbstractDxlDriver>(bus_driver);
             if (driver)
             {
                 std::vector<uint16_t> data;
@@ -1522,7 +2655,7 @@ int TtlManager::readMotorPID(uint8_t id, uint16_t &pos_p_gain, uint16_t &pos_i_g
         }
         else
         {
-            ROS_ERROR_THROTTLE(1, "TtlManager::readMotorPID - driver for motor %s not available", HardwareTypeEnum(motor_type).toString().c_str());
+            ROS_ERROR_THROTTLE(1, "TtlManager::readMotorPID - driver for motor %s not available", HardwareTypeEnum(motor_type).toString());
             result = niryo_robot_msgs::CommandStatus::WRONG_MOTOR_TYPE;
         }
     }
@@ -1557,10 +2690,13 @@ int TtlManager::readVelocityProfile(uint8_t id, uint32_t &v_start, uint32_t &a_1
     {
         EHardwareType motor_type = _state_map.at(id)->getHardwareType();
 
-        if (_default_stepper_driver)
+        // the steppers of an extra port are read on their port
+        TtlPort *port = getExtraPort(id);
+        auto driver = port ? std::dynamic_pointer_cast<AbstractStepperDriver>(port->getDriver(motor_type)) : _default_stepper_driver;
+        if (driver)
         {
             std::vector<uint32_t> data;
-            result = _default_stepper_driver->readVelocityProfile(id, data);
+            result = driver->readVelocityProfile(id, data);
 
             if (COMM_SUCCESS == result)
             {
@@ -1582,7 +2718,7 @@ int TtlManager::readVelocityProfile(uint8_t id, uint32_t &v_start, uint32_t &a_1
         }
         else
         {
-            ROS_ERROR_THROTTLE(1, "TtlManager::readVelocityProfile - driver for motor %s not available", HardwareTypeEnum(motor_type).toString().c_str());
+            ROS_ERROR_THROTTLE(1, "TtlManager::readVelocityProfile - driver for motor %s not available", HardwareTypeEnum(motor_type).toString());
             result = niryo_robot_msgs::CommandStatus::WRONG_MOTOR_TYPE;
         }
     }
@@ -1609,10 +2745,11 @@ int TtlManager::readControlMode(uint8_t id, uint8_t &control_mode)
     if (_state_map.count(id) != 0 && _state_map.at(id))
     {
         EHardwareType motor_type = _state_map.at(id)->getHardwareType();
+        auto bus_driver = getDriver(id);
 
-        if (_driver_map.count(motor_type))
+        if (bus_driver)
         {
-            auto driver = std::dynamic_pointer_cast<AbstractDxlDriver>(_driver_map.at(motor_type));
+            auto driver = std::dynamic_pointer_cast<AbstractDxlDriver>(bus_driver);
             if (driver)
             {
                 result = driver->readControlMode(id, control_mode);
@@ -1620,7 +2757,7 @@ int TtlManager::readControlMode(uint8_t id, uint8_t &control_mode)
         }
         else
         {
-            ROS_ERROR_THROTTLE(1, "TtlManager::readControlMode - driver for motor %s not available", HardwareTypeEnum(motor_type).toString().c_str());
+            ROS_ERROR_THROTTLE(1, "TtlManager::readControlMode - driver for motor %s not available", HardwareTypeEnum(motor_type).toString());
             result = niryo_robot_msgs::CommandStatus::WRONG_MOTOR_TYPE;
         }
     }
@@ -1635,59 +2772,92 @@ int TtlManager::readControlMode(uint8_t id, uint8_t &control_mode)
 }
 
 /**
- * @brief TtlManager::writeSynchronizeCommand
+ * @brief TtlManager::getRetryBudget
+ * @param retry_class
+ * @return
+ */
+common::util::RetryPolicy::Budget TtlManager::getRetryBudget(ERetryClass retry_class)
+{
+    switch (retry_class)
+    {
+    case ERetryClass::SYNC_WRITE:
+        return SYNC_WRITE_RETRY_BUDGET;
+    case ERetryClass::SINGLE_WRITE:
+        return SINGLE_WRITE_RETRY_BUDGET;
+    case ERetryClass::LEDS:
+        return LEDS_RETRY_BUDGET;
+    case ERetryClass::REBOOT:
+        return REBOOT_RETRY_BUDGET;
+    case ERetryClass::ADD_COMPONENT:
+    default:
+        return ADD_COMPONENT_RETRY_BUDGET;
+    }
+}
+
+/**
+ * @brief TtlManager::writeSynchronizeCommand : retry until the command succeeds or its budget is spent
  * @param cmd
  * @return
  */
 int TtlManager::writeSynchronizeCommand(std::unique_ptr<common::model::AbstractTtlSynchronizeMotorCmd> &&cmd)  // NOLINT
+{
+    common::util::RetryPolicy retry(getRetryBudget(ERetryClass::SYNC_WRITE));
+    return writeSynchronizeCommand(cmd, retry);
+}
+
+/**
+ * @brief TtlManager::writeSynchronizeCommand
+ * @param cmd
+ * @param retry : attempts of the command, kept by the caller between two calls when the command is deferred
+ * @param deadline : no retry is waited for after it
+ * @return TTL_WRITE_DEFERRED if the command must be given again later, with the same retry policy
+ */
+int TtlManager::writeSynchronizeCommand(const std::unique_ptr<common::model::AbstractTtlSynchronizeMotorCmd> &cmd, common::util::RetryPolicy &retry,
+                                        common::util::RetryPolicy::Clock::time_point deadline)
 {
     int result = COMM_TX_ERROR;
-    ROS_DEBUG_THROTTLE(0.5, "TtlManager::writeSynchronizeCommand:  %s", cmd->str().c_str());
+    HW_TRACE_THROTTLE(0.5, "TtlManager::writeSynchronizeCommand:  %s", cmd->str().c_str());
 
     if (cmd->isValid())
     {
         std::set<EHardwareType> typesToProcess = cmd->getMotorTypes();
 
         // process all the motors using each successive drivers
-        for (uint32_t counter = 0; counter < MAX_HW_FAILURE; ++counter)
+        while (true)
         {
-            ROS_DEBUG_THROTTLE(0.5, "TtlManager::writeSynchronizeCommand: try to sync write (counter %d)", counter);
+            HW_TRACE_THROTTLE(0.5, "TtlManager::writeSynchronizeCommand: try to sync write (attempt %d)", retry.getAttempts());
 
-            for (auto const &it : _driver_map)
+            for (auto it = typesToProcess.begin(); it != typesToProcess.end();)
             {
-                if (typesToProcess.count(it.first) != 0)
-                {
-                    result = COMM_TX_ERROR;
-
-                    // syncwrite for this driver. The driver is responsible for sync write only to its associated motors
-                    auto driver = std::dynamic_pointer_cast<AbstractMotorDriver>(it.second);
-                    if (driver)
-                    {
-                        result = driver->writeSyncCmd(cmd->getCmdType(), cmd->getMotorsId(it.first), cmd->getParams(it.first));
-
-                        ros::Duration(0.05).sleep();
-                    }
+                // syncwrite for this type, on each bus
+                result = writeSyncCmd(*it, cmd->getCmdType(), cmd->getMotorsId(*it), cmd->getParams(*it));
 
-                    // if successful, don't process this driver in the next loop
-                    if (COMM_SUCCESS == result)
-                    {
-                        typesToProcess.erase(typesToProcess.find(it.first));
-                    }
-                    else
-                    {
-                        ROS_ERROR("TtlManager::writeSynchronizeCommand : unable to sync write function : %d", result);
-                    }
+                // if successful, don't process this type in the next loop
+                if (COMM_SUCCESS == result)
+                {
+                    it = typesToProcess.erase(it);
+                }
+                else
+                {
+                    ROS_ERROR("TtlManager::writeSynchronizeCommand : unable to sync write function : %d", result);
+                    ++it;
                 }
             }
 
-            // if all drivers are processed, go out of for loop
+            // if all drivers are processed, go out of the loop
             if (typesToProcess.empty())
             {
+                retry.reset();
                 result = COMM_SUCCESS;
                 break;
             }
 
-            ros::Duration(TIME_TO_WAIT_IF_BUSY).sleep();
+            auto decision = retry.onFailure(deadline);
+            // the drivers already written are written again with the next attempt, the commands being absolute
+            if (common::util::RetryPolicy::EDecision::RETRY_LATER == decision)
+                return TTL_WRITE_DEFERRED;
+            if (common::util::RetryPolicy::EDecision::GIVE_UP == decision)
+                break;
         }
     }
     else
@@ -1698,18 +2868,72 @@ int TtlManager::writeSynchronizeCommand(std::unique_ptr<common::model::AbstractT
     if (COMM_SUCCESS != result)
     {
         ROS_ERROR_THROTTLE(0.5, "TtlManager::writeSynchronizeCommand - Failed to write synchronize position");
-        _debug_error_message = "TtlManager - Failed to write synchronize position";
+        setBusError(EBusError::SYNC_WRITE_FAILED);
     }
 
     return result;
 }
 
 /**
- * @brief TtlManager::writeSingleCommand
+ * @brief TtlManager::writeSyncCmd : sync write of the devices of one type, with one instruction per bus
+ * @param type
+ * @param cmd_type
+ * @param ids
+ * @param params : one param per id
+ * @return COMM_SUCCESS if all the buses have been written
+ */
+int TtlManager::writeSyncCmd(EHardwareType type, int cmd_type, const std::vector<uint8_t> &ids, const std::vector<uint32_t> &params)
+{
+    auto main_driver = _driver_map.count(type) ? std::dynamic_pointer_cast<AbstractMotorDriver>(_driver_map.at(type)) : nullptr;
+
+    // the driver is responsible for sync write only to its associated motors
+    if (_extra_ports.empty())
+        return main_driver ? main_driver->writeSyncCmd(cmd_type, ids, params) : COMM_TX_ERROR;
+
+    if (ids.size() != params.size())
+        return COMM_TX_ERROR;
+
+    // split the devices by bus, nullptr being the main one
+    std::map<TtlPort *, std::pair<vector<uint8_t>, vector<uint32_t>>> cmd_by_port;
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+        auto &port_cmd = cmd_by_port[getExtraPort(ids.at(i))];
+        port_cmd.first.emplace_back(ids.at(i));
+        port_cmd.second.emplace_back(params.at(i));
+    }
+
+    int result = COMM_SUCCESS;
+    for (auto const &it : cmd_by_port)
+    {
+        auto driver = it.first ? std::dynamic_pointer_cast<AbstractMotorDriver>(it.first->getDriver(type)) : main_driver;
+        int res = driver ? driver->writeSyncCmd(cmd_type, it.second.first, it.second.second) : COMM_TX_ERROR;
+        if (COMM_SUCCESS != res)
+            result = res;
+    }
+
+    return result;
+}
+
+/**
+ * @brief TtlManager::writeSingleCommand : retry until the command succeeds or its budget is spent
  * @param cmd
  * @return
  */
 int TtlManager::writeSingleCommand(std::unique_ptr<common::model::AbstractTtlSingleMotorCmd> &&cmd)  // NOLINT
+{
+    common::util::RetryPolicy retry(getRetryBudget(ERetryClass::SINGLE_WRITE));
+    return writeSingleCommand(cmd, retry);
+}
+
+/**
+ * @brief TtlManager::writeSingleCommand
+ * @param cmd
+ * @param retry : attempts of the command, kept by the caller between two calls when the command is deferred
+ * @param deadline : no retry is waited for after it
+ * @return TTL_WRITE_DEFERRED if the command must be given again later, with the same retry policy
+ */
+int TtlManager::writeSingleCommand(const std::unique_ptr<common::model::AbstractTtlSingleMotorCmd> &cmd, common::util::RetryPolicy &retry,
+                                   common::util::RetryPolicy::Clock::time_point deadline)
 {
     int result = COMM_TX_ERROR;
 
@@ -1717,26 +2941,33 @@ int TtlManager::writeSingleCommand(std::unique_ptr<common::model::AbstractTtlSin
 
     if (cmd->isValid())
     {
-        int counter = 0;
-
-        ROS_DEBUG("TtlManager::writeSingleCommand:  %s", cmd->str().c_str());
+        HW_TRACE("TtlManager::writeSingleCommand:  %s", cmd->str().c_str());
 
         if (_state_map.count(id) && _state_map.at(id))
         {
             auto state = _state_map.at(id);
-            while ((COMM_SUCCESS != result) && (counter < 50))
+            // the driver of the device on its bus
+            auto driver = getDriver(id);
+            while (true)
             {
-                EHardwareType hardware_type = state->getHardwareType();
                 result = COMM_TX_ERROR;
-                if (_driver_map.count(hardware_type) && _driver_map.at(hardware_type))
+                if (driver)
                 {
-                    // writeSingleCmd is in a for loop, we cannot infer that this command will succeed. Thus we cannot move cmd in parameter
-                    result = _driver_map.at(hardware_type)->writeSingleCmd(cmd);
+                    // writeSingleCmd can be retried, we cannot infer that this command will succeed. Thus we cannot move cmd in parameter
+                    result = driver->writeSingleCmd(cmd);
                 }
 
-                counter += 1;
+                if (COMM_SUCCESS == result)
+                {
+                    retry.reset();
+                    break;
+                }
 
-                ros::Duration(TIME_TO_WAIT_IF_BUSY).sleep();
+                auto decision = retry.onFailure(deadline);
+                if (common::util::RetryPolicy::EDecision::RETRY_LATER == decision)
+                    return TTL_WRITE_DEFERRED;
+                if (common::util::RetryPolicy::EDecision::GIVE_UP == decision)
+                    break;
             }
         }
         else
@@ -1748,47 +2979,234 @@ int TtlManager::writeSingleCommand(std::unique_ptr<common::model::AbstractTtlSin
 
     if (result != COMM_SUCCESS)
     {
-        ROS_WARN("TtlManager::writeSingleCommand - Fail to write single command : %s", cmd->str().c_str());
-        _debug_error_message = "TtlManager - Failed to write a single command: " + cmd->str();
+        ROS_WARN("TtlManager::writeSingleCommand - Fail to write single command %s to motor %d", cmdTypeName(*cmd), static_cast<int>(id));
+        HW_TRACE("TtlManager::writeSingleCommand - failed command : %s", cmd->str().c_str());
+        setBusError(EBusError::SINGLE_WRITE_FAILED, id, cmdTypeName(*cmd));
     }
 
     return result;
 }
 
 /**
- * @brief TtlManager::executeJointTrajectoryCmd
- * @param cmd_vec
+ * @brief TtlManager::setJointTrajectoryLayout
+ * @param id_list : ids of the joints, in the order of the goals given to executeJointTrajectoryCmd
  */
-void TtlManager::executeJointTrajectoryCmd(std::vector<std::pair<uint8_t, uint32_t>> cmd_vec)
+void TtlManager::setJointTrajectoryLayout(const std::vector<uint8_t> &id_list)
 {
-    for (auto const &it : _driver_map)
+    _joint_trajectory_ids = id_list;
+    _joint_trajectory_layout_changed = true;
+}
+
+/**
+ * @brief TtlManager::updateJointTrajectoryLayout : group the slots of the trajectory by driver
+ */
+void TtlManager::updateJointTrajectoryLayout()
+{
+    _joint_trajectory_groups.clear();
+
+    // one group per driver : per hardware type and per bus
+    for (size_t slot = 0; slot < _joint_trajectory_ids.size(); ++slot)
+    {
+        auto driver = std::dynamic_pointer_cast<AbstractMotorDriver>(getDriver(_joint_trajectory_ids.at(slot)));
+        if (!driver)
+            continue;
+
+        auto group = std::find_if(_joint_trajectory_groups.begin(), _joint_trajectory_groups.end(),
+                                  [&driver](const JointTrajectoryGroup &g) { return g.driver == driver; });
+        if (group == _joint_trajectory_groups.end())
+        {
+            _joint_trajectory_groups.emplace_back();
+            group = std::prev(_joint_trajectory_groups.end());
+            group->driver = driver;
+        }
+        group->slots.emplace_back(slot);
+    }
+
+    for (auto &group : _joint_trajectory_groups)
     {
-        // build list of ids and params for this motor
-        std::vector<uint8_t> ids;
-        std::vector<uint32_t> params;
-        for (auto const &cmd : cmd_vec)
+        group.ids.reserve(group.slots.size());
+        group.params.reserve(group.slots.size());
+
+        group.stepper_driver = std::dynamic_pointer_cast<AbstractStepperDriver>(group.driver);
+        if (group.stepper_driver)
+        {
+            group.v_max.assign(group.slots.size(), 0);
+            group.goal_pending.assign(group.slots.size(), 0);
+            group.v_max_ids.reserve(group.slots.size());
+            group.v_max_params.reserve(group.slots.size());
+        }
+    }
+
+    _joint_trajectory_layout_changed = false;
+}
+
+/**
+ * @brief TtlManager::executeJointTrajectoryCmd : one sync write per driver, without allocation once the layout is built
+ * @param goals : one goal per joint, in the order given to setJointTrajectoryLayout
+ * @param mask : goals to write, reset to 0 for the goals which could not be written
+ * @return time at which the last goals have been written on the bus, epoch if none
+ */
+std::chrono::steady_clock::time_point TtlManager::executeJointTrajectoryCmd(const std::vector<uint32_t> &goals, std::vector<uint8_t> &mask)
+{
+    std::chrono::steady_clock::time_point write_time;
+
+    if (_joint_trajectory_layout_changed)
+        updateJointTrajectoryLayout();
+
+    for (auto &group : _joint_trajectory_groups)
+    {
+        group.ids.clear();
+        group.params.clear();
+        for (auto slot : group.slots)
         {
-            if (_state_map.count(cmd.first) && it.first == _state_map.at(cmd.first)->getHardwareType())
+            if (slot >= goals.size() || slot >= mask.size() || !mask[slot])
+                continue;
+
+            uint8_t id = _joint_trajectory_ids[slot];
+            if (std::find(_removed_motor_id_list.begin(), _removed_motor_id_list.end(), id) != _removed_motor_id_list.end())
             {
-                ids.emplace_back(cmd.first);
-                params.emplace_back(cmd.second);
+                mask[slot] = 0;
+                continue;
             }
+
+            group.ids.emplace_back(id);
+            group.params.emplace_back(goals[slot]);
         }
 
         // syncwrite for this driver. The driver is responsible for sync write only to its associated motors
-        auto driver = std::dynamic_pointer_cast<AbstractMotorDriver>(it.second);
-
-        if (driver)
+        if (!group.ids.empty())
         {
-            int err = driver->syncWritePositionGoal(ids, params);
+            int err = group.driver->syncWritePositionGoal(group.ids, group.params);
             if (err != COMM_SUCCESS)
             {
                 ROS_WARN("TtlManager::executeJointTrajectoryCmd - Failed to write position");
-                _debug_error_message = "TtlManager - Failed to write position";
+                setBusError(EBusError::POSITION_WRITE_FAILED);
+
+                for (auto slot : group.slots)
+                {
+                    if (slot < mask.size())
+                        mask[slot] = 0;
+                }
+            }
+            else
+            {
+                write_time = std::chrono::steady_clock::now();
+            }
+            ros::Duration(0.001).sleep();
+        }
+    }
+
+    return write_time;
+}
+
+/**
+ * @brief TtlManager::executeJointTrajectorySegment : let the steppers execute a segment of the trajectory by themselves.
+ * The max velocity of their profile is set so that they reach the end goals in the duration of the segment,
+ * then the end goals are written with one sync write per driver, so that the steppers start together.
+ * The steppers not moving during the segment get the max velocity of their configuration back.
+ * A goal whose write failed is written again at the next segment, even if the stepper does not move during it
+ * @param start_goals : goals at the start of the segment, one per joint, in the order given to setJointTrajectoryLayout
+ * @param end_goals : goals at the end of the segment
+ * @param slots : joints executing the segments, the other ones are ignored
+ * @param duration : duration of the segment, in seconds
+ * @return time at which the last goals have been written on the bus, epoch if none
+ */
+std::chrono::steady_clock::time_point TtlManager::executeJointTrajectorySegment(const std::vector<uint32_t> &start_goals, const std::vector<uint32_t> &end_goals,
+                                                                                const std::vector<uint8_t> &slots, double duration)
+{
+    std::chrono::steady_clock::time_point write_time;
+
+    if (duration <= 0.0)
+        return write_time;
+
+    if (_joint_trajectory_layout_changed)
+        updateJointTrajectoryLayout();
+
+    // 1. profiles, only the ones that changed are written
+    for (auto &group : _joint_trajectory_groups)
+    {
+        group.ids.clear();
+        group.params.clear();
+
+        if (!group.stepper_driver)
+            continue;
+
+        group.v_max_ids.clear();
+        group.v_max_params.clear();
+        for (size_t i = 0; i < group.slots.size(); ++i)
+        {
+            size_t slot = group.slots[i];
+            if (slot >= start_goals.size() || slot >= end_goals.size() || slot >= slots.size() || !slots[slot])
+                continue;
+
+            uint8_t id = _joint_trajectory_ids[slot];
+            if (std::find(_removed_motor_id_list.begin(), _removed_motor_id_list.end(), id) != _removed_motor_id_list.end())
+                continue;
+
+            auto state = _state_map.count(id) ? std::dynamic_pointer_cast<StepperMotorState>(_state_map.at(id)) : nullptr;
+            if (!state)
+                continue;
+
+            // the configured profile bounds the velocity, as when the goals are written at each cycle
+            auto profile = state->getVelocityProfile();
+            uint32_t v_max = profile.v_max;
+            if (start_goals[slot] != end_goals[slot])
+            {
+                double velocity = std::fabs(state->to_rad_pos(static_cast<int>(end_goals[slot])) - state->to_rad_pos(static_cast<int>(start_goals[slot]))) / duration;
+                v_max = static_cast<uint32_t>(std::min(velocity * RADIAN_PER_SECONDS_TO_RPM * 100, static_cast<double>(profile.v_max)));
+                v_max = std::max({v_max, profile.v_start, static_cast<uint32_t>(1)});
+                group.goal_pending[i] = 1;
+            }
+
+            // pending until its sync write succeeds
+            if (group.goal_pending[i])
+            {
+                group.ids.emplace_back(id);
+                group.params.emplace_back(end_goals[slot]);
+            }
+
+            if (v_max != group.v_max[i])
+            {
+                group.v_max_ids.emplace_back(id);
+                group.v_max_params.emplace_back(v_max);
+                group.v_max[i] = v_max;
+            }
+        }
+
+        if (!group.v_max_ids.empty())
+        {
+            int err = group.stepper_driver->syncWriteVelocityMax(group.v_max_ids, group.v_max_params);
+            if (COMM_SUCCESS != err)
+            {
+                // written again at the next segment
+                ROS_WARN("TtlManager::executeJointTrajectorySegment - Failed to write velocity profile");
+                std::fill(group.v_max.begin(), group.v_max.end(), 0);
             }
+            ros::Duration(0.001).sleep();
+        }
+    }
+
+    // 2. goals, right after one another
+    for (auto &group : _joint_trajectory_groups)
+    {
+        if (group.ids.empty())
+            continue;
+
+        int err = group.driver->syncWritePositionGoal(group.ids, group.params);
+        if (err != COMM_SUCCESS)
+        {
+            // written again at the next segment
+            ROS_WARN("TtlManager::executeJointTrajectorySegment - Failed to write position");
+            setBusError(EBusError::POSITION_WRITE_FAILED);
+        }
+        else
+        {
+            write_time = std::chrono::steady_clock::now();
+            std::fill(group.goal_pending.begin(), group.goal_pending.end(), 0);
         }
-        ros::Duration(0.001).sleep();
     }
+
+    return write_time;
 }
 
 // ******************
@@ -1871,16 +3289,56 @@ int32_t TtlManager::getCalibrationResult(uint8_t motor_id) const
 /**
  * @brief TtlManager::getBusState
  * @param connection_state
- * @param motor_id
+ * @param motor_id : registered motors found on the bus by the last scan, every device answering when none is registered yet
  * @param debug_msg
  */
 void TtlManager::getBusState(bool &connection_state, std::vector<uint8_t> &motor_id, std::string &debug_msg) const
 {
-    debug_msg = _debug_error_message;
-    motor_id = _all_ids_connected;
+    debug_msg = getErrorMessage();
+    motor_id = _connected_motor_id_list;
     connection_state = isConnectionOk();
 }
 
+/**
+ * @brief TtlManager::getErrorMessage
+ * @return the message of the last bus error, built from its error code
+ */
+std::string TtlManager::getErrorMessage() const
+{
+    std::lock_guard<std::mutex> lck(_sync_mutex);
+    switch (_bus_error)
+    {
+    case EBusError::NONE:
+        return "";
+    case EBusError::NOT_CONNECTED_YET:
+        return "TtlManager - No connection with TTL motors has been made yet";
+    case EBusError::SET_BAUDRATE_FAILED:
+        return "TtlManager - Failed to set baudrate for Dynamixel bus";
+    case EBusError::OPEN_PORT_FAILED:
+        return "TtlManager - Failed to open Uart port for Dynamixel bus";
+    case EBusError::MISSING_MOTORS:
+        return "Motor(s): " + common::util::listToString(_bus_error_missing_ids) + "do not seem to be connected";
+    case EBusError::BUS_TOO_BUSY:
+        return "TtlManager - Failed to scan motors, physical bus is too busy. Will retry...";
+    case EBusError::CONNECTION_PROBLEM:
+        return "TtlManager - Connection problem with physical Bus.";
+    case EBusError::DRIVER_NOT_FOUND:
+        return "TtlManager::getPosition - Driver not found for requested motor id";
+    case EBusError::NO_MOTOR_FOUND:
+        return "TtlManager - No motor found. Make sure that motors are correctly connected and powered on.";
+    case EBusError::SCAN_FAILED:
+        return "TtlManager - Failed to scan bus.";
+    case EBusError::SYNC_WRITE_FAILED:
+        return "TtlManager - Failed to write synchronize position";
+    case EBusError::SINGLE_WRITE_FAILED:
+        return "TtlManager - Failed to write a single command: " + string(_bus_error_cmd_type) + " Motor id: " + to_string(_bus_error_cmd_id);
+    case EBusError::POSITION_WRITE_FAILED:
+        return "TtlManager - Failed to write position";
+    }
+
+    return "";
+}
+
 /**
  * @brief TtlManager::getMotorsStates
  * @return only the joints states
@@ -1938,34 +3396,22 @@ void TtlManager::addHardwareDriver(EHardwareType hardware_type)
             _driver_map.insert(std::make_pair(hardware_type, std::make_shared<MockStepperDriver>(_fake_data)));
             _calibration_status = common::model::EStepperCalibrationStatus::UNINITIALIZED;
             break;
-        case EHardwareType::XL430:
-            _driver_map.insert(std::make_pair(hardware_type, std::make_shared<DxlDriver<XL430Reg>>(_portHandler, _packetHandler)));
-            break;
-        case EHardwareType::XC430:
-            _driver_map.insert(std::make_pair(hardware_type, std::make_shared<DxlDriver<XC430Reg>>(_portHandler, _packetHandler)));
-            break;
-        case EHardwareType::XM430:
-            _driver_map.insert(std::make_pair(hardware_type, std::make_shared<DxlDriver<XM430Reg>>(_portHandler, _packetHandler)));
-            break;
-        case EHardwareType::XL320:
-            _driver_map.insert(make_pair(hardware_type, std::make_shared<DxlDriver<XL320Reg>>(_portHandler, _packetHandler)));
-            break;
-        case EHardwareType::XL330:
-            _driver_map.insert(std::make_pair(hardware_type, std::make_shared<DxlDriver<XL330Reg>>(_portHandler, _packetHandler)));
-            break;
         case EHardwareType::FAKE_DXL_MOTOR:
             _driver_map.insert(std::make_pair(hardware_type, std::make_shared<MockDxlDriver>(_fake_data)));
             break;
-        case EHardwareType::END_EFFECTOR:
-            _driver_map.insert(std::make_pair(hardware_type, std::make_shared<EndEffectorDriver<EndEffectorReg>>(_portHandler, _packetHandler)));
-            break;
         case EHardwareType::FAKE_END_EFFECTOR:
             _driver_map.insert(std::make_pair(hardware_type, std::make_shared<MockEndEffectorDriver>(_fake_data)));
             break;
         default:
-            ROS_ERROR("TtlManager - Unable to instanciate driver, unknown type");
+        {
+            auto driver = makeTtlDriver(hardware_type, _portHandler, _packetHandler);
+            if (driver)
+                _driver_map.insert(std::make_pair(hardware_type, driver));
+            else
+                ROS_ERROR("TtlManager - Unable to instanciate driver, unknown type");
             break;
         }
+        }
     }
 }
 
@@ -0,0 +1,262 @@
+/*
+ttl_port.cpp
+Copyright (C) 2020 Niryo
+All rights reserved.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http:// www.gnu.org/licenses/>.
+*/
+
+#include "ttl_driver/ttl_port.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// ros
+#include "ros/ros.h"
+
+// niryo
+#include "dynamixel_sdk/packet_handler.h"
+#if defined(__linux__)
+#include "dynamixel_sdk/port_handler_linux.h"
+#endif
+#include "ttl_driver/stepper_driver.hpp"
+#include "ttl_driver/stepper_reg.hpp"
+
+namespace ttl_driver
+{
+
+namespace
+{
+// same protocol as the main bus
+constexpr float TTL_PORT_PROTOCOL_VERSION = 2.0;
+}  // namespace
+
+/**
+ * @brief TtlPort::TtlPort
+ * @param device_name
+ * @param baudrate
+ * @param assigned_ids : devices connected on this port
+ */
+TtlPort::TtlPort(std::string device_name, int baudrate, std::vector<uint8_t> assigned_ids)
+    : _device_name(std::move(device_name)), _baudrate(baudrate), _assigned_ids(std::move(assigned_ids))
+{
+    _io_thread = std::thread(&TtlPort::ioLoop, this);
+}
+
+/**
+ * @brief TtlPort::~TtlPort
+ */
+TtlPort::~TtlPort()
+{
+    {
+        std::lock_guard<std::mutex> lock(_job_mutex);
+        _stop = true;
+    }
+    _job_cv.notify_all();
+
+    if (_io_thread.joinable())
+        _io_thread.join();
+
+    if (_portHandler)
+    {
+        _portHandler->clearPort();
+        _portHandler->closePort();
+    }
+}
+
+/**
+ * @brief TtlPort::init : create the handlers of the port and its default driver
+ * @param direction_control : see TtlManager::init
+ * @return
+ */
+bool TtlPort::init(const std::string &direction_control)
+{
+    _portHandler.reset(dynamixel::PortHandler::getPortHandler(_device_name.c_str()));
+    // the packet handler is a singleton, shared with the main bus
+    _packetHandler.reset(dynamixel::PacketHandler::getPacketHandler(TTL_PORT_PROTOCOL_VERSION), [](dynamixel::PacketHandler *) {});
+
+    if (!_portHandler || !_packetHandler)
+        return false;
+
+#if defined(__linux__)
+    dynamixel::PortHandlerLinux::DirectionControl mode;
+    auto linux_port = std::dynamic_pointer_cast<dynamixel::PortHandlerLinux>(_portHandler);
+    if (linux_port && dynamixel::PortHandlerLinux::parseDirectionControl(direction_control, mode))
+        linux_port->setDirectionControl(mode);
+#else
+    (void)direction_control;
+#endif
+
+    _default_driver = std::make_shared<StepperDriver<StepperReg>>(_portHandler, _packetHandler);
+
+    return true;
+}
+
+/**
+ * @brief TtlPort::setupCommunication : open the port at its baudrate
+ * @return
+ */
+int TtlPort::setupCommunication()
+{
+    if (!_portHandler)
+        return COMM_NOT_AVAILABLE;
+
+    if (!_portHandler->openPort())
+    {
+        ROS_ERROR("TtlPort::setupCommunication - Failed to open Uart port %s", _device_name.c_str());
+        return COMM_PORT_BUSY;
+    }
+
+    if (!_portHandler->setBaudRate(_baudrate))
+    {
+        ROS_ERROR("TtlPort::setupCommunication - Failed to set baudrate %d for %s", _baudrate, _device_name.c_str());
+        return COMM_PORT_BUSY;
+    }
+
+    _portHandler->clearPort();
+
+    return COMM_SUCCESS;
+}
+
+/**
+ * @brief TtlPort::isAssigned
+ * @param id
+ * @return true if the device is connected on this port
+ */
+bool TtlPort::isAssigned(uint8_t id) const
+{
+    return std::find(_assigned_ids.begin(), _assigned_ids.end(), id) != _assigned_ids.end();
+}
+
+/**
+ * @brief TtlPort::addId : register a device of this port
+ * @param type
+ * @param id
+ */
+void TtlPort::addId(common::model::EHardwareType type, uint8_t id)
+{
+    auto &ids = _ids_map[type];
+    if (std::find(ids.begin(), ids.end(), id) == ids.end())
+        ids.emplace_back(id);
+}
+
+/**
+ * @brief TtlPort::removeId
+ * @param id
+ */
+void TtlPort::removeId(uint8_t id)
+{
+    for (auto it = _ids_map.begin(); it != _ids_map.end();)
+    {
+        auto &ids = it->second;
+        ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+        if (ids.empty())
+            it = _ids_map.erase(it);
+        else
+            ++it;
+    }
+}
+
+/**
+ * @brief TtlPort::getIds
+ * @return all the devices registered on this port
+ */
+std::vector<uint8_t> TtlPort::getIds() const
+{
+    std::vector<uint8_t> id_list;
+    for (auto const &it : _ids_map)
+        id_list.insert(id_list.end(), it.second.begin(), it.second.end());
+
+    return id_list;
+}
+
+/**
+ * @brief TtlPort::addDriver
+ * @param type
+ * @param driver : built on the handlers of this port
+ */
+void TtlPort::addDriver(common::model::EHardwareType type, std::shared_ptr<AbstractTtlDriver> driver)
+{
+    if (driver)
+        _driver_map[type] = std::move(driver);
+}
+
+/**
+ * @brief TtlPort::hasDriver
+ * @param type
+ * @return
+ */
+bool TtlPort::hasDriver(common::model::EHardwareType type) const
+{
+    return _driver_map.count(type) && _driver_map.at(type);
+}
+
+/**
+ * @brief TtlPort::getDriver
+ * @param type
+ * @return nullptr if there is no driver for this type on this port
+ */
+std::shared_ptr<AbstractTtlDriver> TtlPort::getDriver(common::model::EHardwareType type) const
+{
+    auto it = _driver_map.find(type);
+    return it != _driver_map.end() ? it->second : nullptr;
+}
+
+/**
+ * @brief TtlPort::post : run a job on the I/O thread of the port, once the previous one has ended
+ * @param job
+ */
+void TtlPort::post(std::function<void()> job)
+{
+    {
+        std::unique_lock<std::mutex> lock(_job_mutex);
+        _job_cv.wait(lock, [this]() { return !_job_pending; });
+        _job = std::move(job);
+        _job_pending = true;
+    }
+    _job_cv.notify_all();
+}
+
+/**
+ * @brief TtlPort::wait : wait for the end of the job posted, if any
+ */
+void TtlPort::wait()
+{
+    std::unique_lock<std::mutex> lock(_job_mutex);
+    _job_cv.wait(lock, [this]() { return !_job_pending; });
+}
+
+/**
+ * @brief TtlPort::ioLoop : run the jobs posted, one at a time. A job posted before the port is destroyed is still run
+ */
+void TtlPort::ioLoop()
+{
+    std::unique_lock<std::mutex> lock(_job_mutex);
+    while (true)
+    {
+        _job_cv.wait(lock, [this]() { return _job_pending || _stop; });
+        if (!_job_pending)
+            break;
+
+        auto job = std::move(_job);
+        lock.unlock();
+        job();
+        lock.lock();
+
+        _job_pending = false;
+        _job_cv.notify_all();
+    }
+}
+
+} // ttl_driver
@@ -27,16 +27,29 @@
 #include "common/model/synchronize_motor_cmd.hpp"
 #include "dynamixel_sdk/dynamixel_sdk.h"
 #include "ros/node_handle.h"
+#include "ttl_driver/dxl_driver.hpp"
+#include "ttl_driver/fake_ttl_data.hpp"
+#include "ttl_driver/mock_dxl_driver.hpp"
+#include "ttl_driver/replay_port_handler.hpp"
+#include "ttl_driver/sync_read_pipeline.hpp"
 #include "ttl_driver/ttl_interface_core.hpp"
 #include "ttl_driver/ttl_manager.hpp"
+#include "ttl_driver/ttl_port.hpp"
+#include "ttl_driver/xl430_reg.hpp"
 
 // Bring in gtest
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <gtest/gtest.h>
+#include <map>
 #include <memory>
 #include <ros/console.h>
 #include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
 using ::common::model::BusProtocolEnum;
 using ::common::model::DxlMotorState;
@@ -844,6 +857,640 @@ TEST_F(TtlManagerTestSuite, testSyncControlCmdsReturnHome)
 // Test driver scan motors
 TEST_F(TtlManagerTestSuite, scanTest) { EXPECT_EQ(ttl_drv->scanAndCheck(), COMM_SUCCESS); }
 
+// Test driver scan with a registered motor missing on the bus
+TEST_F(TtlManagerTestSuite, scanMissingMotorTest)
+{
+    uint8_t missing_id = 20;
+    auto state_motor = std::dynamic_pointer_cast<common::model::JointState>(ttl_drv->getHardwareState(5));
+    ASSERT_NE(state_motor, nullptr);
+
+    ttl_drv->addHardwareComponent(std::make_shared<DxlMotorState>(state_motor->getHardwareType(), common::model::EComponentType::JOINT, missing_id));
+
+    EXPECT_EQ(ttl_drv->scanAndCheck(), ttl_driver::TTL_SCAN_MISSING_MOTOR);
+    EXPECT_EQ(ttl_drv->getRemovedMotorList(), std::vector<uint8_t>{missing_id});
+    EXPECT_FALSE(ttl_drv->isConnectionOk());
+
+    // the connected motors keep being read while the missing one is probed
+    EXPECT_TRUE(ttl_drv->readJointsStatus());
+    EXPECT_EQ(ttl_drv->checkRemovedMotors(), ttl_driver::TTL_SCAN_MISSING_MOTOR);
+    EXPECT_FALSE(ttl_drv->isConnectionOk());
+
+    ttl_drv->removeHardwareComponent(missing_id);
+    EXPECT_EQ(ttl_drv->scanAndCheck(), COMM_SUCCESS);
+    EXPECT_TRUE(ttl_drv->isConnectionOk());
+}
+
+// Test the joints read again after the motors read have changed
+TEST_F(TtlManagerTestSuite, readJointsStatusLayoutChangeTest)
+{
+    EXPECT_TRUE(ttl_drv->readJointsStatus());
+
+    // a motor unregistered is not read anymore
+    ttl_drv->removeHardwareComponent(7);
+    EXPECT_TRUE(ttl_drv->readJointsStatus());
+
+    // then read again once registered back
+    std::shared_ptr<common::model::AbstractHardwareState> state = state_motor_7;
+    EXPECT_EQ(ttl_drv->addHardwareComponent(std::move(state)), niryo_robot_msgs::CommandStatus::SUCCESS);
+    EXPECT_TRUE(ttl_drv->readJointsStatus());
+    EXPECT_EQ(ttl_drv->getHardwareState(7), state_motor_7);
+}
+
+// Test a motor not answering the joints read : the others keep their positions, the read fails
+TEST_F(TtlManagerTestSuite, readJointsStatusMissingMotorTest)
+{
+    uint8_t missing_id = 20;
+
+    // the missing motor is read first
+    ttl_drv->removeHardwareComponent(5);
+    ttl_drv->removeHardwareComponent(6);
+    auto missing_state = std::make_shared<DxlMotorState>(state_motor_5->getHardwareType(), common::model::EComponentType::JOINT, missing_id);
+    missing_state->setPosition(1234);
+    ttl_drv->addHardwareComponent(missing_state);
+    std::shared_ptr<common::model::AbstractHardwareState> state = state_motor_5;
+    ASSERT_EQ(ttl_drv->addHardwareComponent(std::move(state)), niryo_robot_msgs::CommandStatus::SUCCESS);
+    state = state_motor_6;
+    ASSERT_EQ(ttl_drv->addHardwareComponent(std::move(state)), niryo_robot_msgs::CommandStatus::SUCCESS);
+
+    state_motor_5->setPosition(-1);
+    state_motor_6->setPosition(-1);
+
+    EXPECT_FALSE(ttl_drv->readJointsStatus());
+    EXPECT_NE(state_motor_5->getPosition(), -1);
+    EXPECT_NE(state_motor_6->getPosition(), -1);
+    EXPECT_EQ(missing_state->getPosition(), 1234);
+
+    ttl_drv->removeHardwareComponent(missing_id);
+    EXPECT_TRUE(ttl_drv->readJointsStatus());
+}
+
+// Test rebooting several motors, one of them missing on the bus : the others are rebooted
+TEST_F(TtlManagerTestSuite, rebootMissingMotorTest)
+{
+    uint8_t missing_id = 20;
+    ttl_drv->addHardwareComponent(std::make_shared<DxlMotorState>(state_motor_5->getHardwareType(), common::model::EComponentType::JOINT, missing_id));
+
+    std::vector<uint8_t> rebooted_ids;
+    ttl_drv->rebootHardware({5, missing_id, 6}, rebooted_ids);
+    std::sort(rebooted_ids.begin(), rebooted_ids.end());
+    EXPECT_EQ(rebooted_ids, std::vector<uint8_t>({5, 6}));
+
+    ttl_drv->removeHardwareComponent(missing_id);
+}
+
+// Test the torque state read back used to verify the batched init of the joints
+TEST_F(TtlManagerTestSuite, readTorqueEnableTest)
+{
+    std::vector<uint8_t> mismatch_id_list;
+
+    auto dynamixel_cmd = std::make_unique<common::model::DxlSyncCmd>(common::model::EDxlCommandType::CMD_TYPE_TORQUE);
+    dynamixel_cmd->addMotorParam(state_motor_5->getHardwareType(), 5, 1);
+    dynamixel_cmd->addMotorParam(state_motor_6->getHardwareType(), 6, 1);
+    EXPECT_EQ(ttl_drv->writeSynchronizeCommand(std::move(dynamixel_cmd)), COMM_SUCCESS);
+
+    EXPECT_EQ(ttl_drv->readTorqueEnable({5, 6}, true, mismatch_id_list), COMM_SUCCESS);
+    EXPECT_TRUE(mismatch_id_list.empty());
+
+    EXPECT_NE(ttl_drv->readTorqueEnable({5, 6}, false, mismatch_id_list), COMM_SUCCESS);
+    EXPECT_EQ(mismatch_id_list, std::vector<uint8_t>({5, 6}));
+
+    // unknown ids are reported as mismatching
+    EXPECT_NE(ttl_drv->readTorqueEnable({5, 20}, true, mismatch_id_list), COMM_SUCCESS);
+    EXPECT_EQ(mismatch_id_list, std::vector<uint8_t>{20});
+}
+
+/******************************************************/
+/*********** Tests of the sync read pipeline **********/
+/******************************************************/
+
+/**
+ * @brief The SyncReadPipelineTestSuite class : the pipeline runs on a replay port, answering
+ * the recorded status packets to each sync read
+ */
+class SyncReadPipelineTestSuite : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        port = std::make_shared<ttl_driver::ReplayPortHandler>();
+        ASSERT_TRUE(port->openPort());
+        ASSERT_TRUE(port->setBaudRate(1000000));
+
+        // the packet handler is a singleton, not owned by the test
+        auto packet_handler = std::shared_ptr<dynamixel::PacketHandler>(dynamixel::PacketHandler::getPacketHandler(2.0), [](dynamixel::PacketHandler *) {});
+        pipeline = std::make_unique<ttl_driver::SyncReadPipeline>(port, packet_handler);
+    }
+
+    // crc of the protocol 2.0
+    static uint16_t crc16(const std::vector<uint8_t> &data)
+    {
+        uint16_t crc = 0;
+        for (auto byte : data)
+        {
+            crc ^= static_cast<uint16_t>(byte << 8);
+            for (int bit = 0; bit < 8; ++bit)
+                crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x8005) : static_cast<uint16_t>(crc << 1);
+        }
+        return crc;
+    }
+
+    // any sync read instruction : the replay port matches it on its id and instruction
+    static common::util::CaptureRecord syncReadInstruction()
+    {
+        common::util::CaptureRecord record;
+        record.flags = common::util::CaptureRecord::TX;
+        record.id = BROADCAST_ID;
+        record.data = {0xFF, 0xFF, 0xFD, 0x00, BROADCAST_ID, 0x07, 0x00, INST_SYNC_READ, 0x00, 0x00};
+        return record;
+    }
+
+    static common::util::CaptureRecord status(uint8_t id, uint32_t value, uint8_t data_len)
+    {
+        common::util::CaptureRecord record;
+        record.flags = common::util::CaptureRecord::RX;
+        record.id = id;
+        record.data = {0xFF, 0xFF, 0xFD, 0x00, id, static_cast<uint8_t>(4 + data_len), 0x00, 0x55, 0x00};
+        for (uint8_t i = 0; i < data_len; ++i)
+            record.data.emplace_back(static_cast<uint8_t>(value >> (8 * i)));
+
+        uint16_t crc = crc16(record.data);
+        record.data.emplace_back(DXL_LOBYTE(crc));
+        record.data.emplace_back(DXL_HIBYTE(crc));
+        return record;
+    }
+
+    std::shared_ptr<ttl_driver::ReplayPortHandler> port;
+    std::unique_ptr<ttl_driver::SyncReadPipeline> pipeline;
+};
+
+// Test the values are given to their id, whatever the order of the status packets, and each stage in order
+TEST_F(SyncReadPipelineTestSuite, replyOrderingTest)
+{
+    ASSERT_TRUE(pipeline->addStage(132, 4, {2, 3, 4}));
+    ASSERT_TRUE(pipeline->addStage(37, 2, {5, 6}));
+    EXPECT_EQ(pipeline->size(), 2u);
+
+    port->setRecords({syncReadInstruction(), status(4, 4000, 4), status(2, 2000, 4), status(3, 3000, 4),
+                      syncReadInstruction(), status(6, 600, 2), status(5, 500, 2)});
+
+    std::vector<uint16_t> decoded_addresses;
+    int result = pipeline->run(
+        [&](const ttl_driver::SyncReadPipeline::Stage &stage, int stage_result)
+        {
+            EXPECT_EQ(stage_result, COMM_SUCCESS);
+            decoded_addresses.emplace_back(stage.address);
+
+            if (132 == stage.address)
+            {
+                EXPECT_EQ(stage.values, std::vector<uint32_t>({2000, 3000, 4000}));
+                EXPECT_EQ(stage.received, std::vector<uint8_t>({1, 1, 1}));
+            }
+            else
+            {
+                EXPECT_EQ(stage.values, std::vector<uint32_t>({500, 600}));
+                EXPECT_EQ(stage.received, std::vector<uint8_t>({1, 1}));
+            }
+        });
+
+    EXPECT_EQ(result, COMM_SUCCESS);
+    EXPECT_EQ(decoded_addresses, std::vector<uint16_t>({132, 37}));
+    EXPECT_EQ(port->getMatchedCount(), 2u);
+}
+
+// Test the stages built again for a new set of motors
+TEST_F(SyncReadPipelineTestSuite, layoutChangeTest)
+{
+    ASSERT_TRUE(pipeline->addStage(132, 4, {2, 3, 4}));
+    port->setRecords({syncReadInstruction(), status(2, 2000, 4), status(3, 3000, 4), status(4, 4000, 4)});
+    EXPECT_EQ(pipeline->run([](const ttl_driver::SyncReadPipeline::Stage &, int) {}), COMM_SUCCESS);
+
+    // a motor removed, another one read with a different register
+    pipeline->clear();
+    EXPECT_TRUE(pipeline->empty());
+    ASSERT_TRUE(pipeline->addStage(132, 4, {2, 4}));
+    ASSERT_TRUE(pipeline->addStage(37, 1, {7}));
+
+    port->setRecords({syncReadInstruction(), status(4, 4100, 4), status(2, 2100, 4), syncReadInstruction(), status(7, 70, 1)});
+
+    size_t nb_stages = 0;
+    int result = pipeline->run(
+        [&](const ttl_driver::SyncReadPipeline::Stage &stage, int stage_result)
+        {
+            EXPECT_EQ(stage_result, COMM_SUCCESS);
+            if (0 == nb_stages++)
+            {
+                EXPECT_EQ(stage.ids, std::vector<uint8_t>({2, 4}));
+                EXPECT_EQ(stage.values, std::vector<uint32_t>({2100, 4100}));
+            }
+            else
+            {
+                EXPECT_EQ(stage.ids, std::vector<uint8_t>{7});
+                EXPECT_EQ(stage.values, std::vector<uint32_t>{70});
+            }
+        });
+
+    EXPECT_EQ(result, COMM_SUCCESS);
+    EXPECT_EQ(nb_stages, 2u);
+
+    // invalid stages are refused
+    EXPECT_FALSE(pipeline->addStage(132, 3, {2}));
+    EXPECT_FALSE(pipeline->addStage(132, 4, {}));
+}
+
+// Test a motor not answering : the stage times out with the values of the others, and the next stage still runs
+TEST_F(SyncReadPipelineTestSuite, timeoutTest)
+{
+    ASSERT_TRUE(pipeline->addStage(132, 4, {2, 3, 4}));
+    ASSERT_TRUE(pipeline->addStage(37, 2, {5}));
+    ASSERT_TRUE(pipeline->addStage(132, 4, {6}));
+
+    port->setRecords({syncReadInstruction(), status(2, 2000, 4), status(4, 4000, 4),
+                      syncReadInstruction(),
+                      syncReadInstruction(), status(6, 6000, 4)});
+
+    std::vector<int> results;
+    int result = pipeline->run(
+        [&](const ttl_driver::SyncReadPipeline::Stage &stage, int stage_result)
+        {
+            results.emplace_back(stage_result);
+            if (1 == results.size())
+            {
+                EXPECT_EQ(stage.received, std::vector<uint8_t>({1, 0, 1}));
+                EXPECT_EQ(stage.values.at(0), 2000u);
+                EXPECT_EQ(stage.values.at(2), 4000u);
+            }
+            else if (2 == results.size())
+            {
+                EXPECT_EQ(stage.received, std::vector<uint8_t>{0});
+            }
+            else
+            {
+                EXPECT_EQ(stage.received, std::vector<uint8_t>{1});
+                EXPECT_EQ(stage.values, std::vector<uint32_t>{6000});
+            }
+        });
+
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_EQ(results.at(0), COMM_RX_CORRUPT);
+    EXPECT_EQ(results.at(1), COMM_RX_TIMEOUT);
+    EXPECT_EQ(results.at(2), COMM_SUCCESS);
+    EXPECT_NE(result, COMM_SUCCESS);
+}
+
+/******************************************************/
+/************ Tests of the partial sync reads *********/
+/******************************************************/
+
+/**
+ * @brief The PartialSyncReadTestSuite class : a driver reads the recorded status packets of the replay port,
+ * some motors not answering
+ */
+class PartialSyncReadTestSuite : public SyncReadPipelineTestSuite
+{
+  protected:
+    void SetUp() override
+    {
+        SyncReadPipelineTestSuite::SetUp();
+
+        auto packet_handler = std::shared_ptr<dynamixel::PacketHandler>(dynamixel::PacketHandler::getPacketHandler(2.0), [](dynamixel::PacketHandler *) {});
+        driver = std::make_shared<ttl_driver::DxlDriver<ttl_driver::XL430Reg>>(port, packet_handler);
+    }
+
+    std::shared_ptr<ttl_driver::DxlDriver<ttl_driver::XL430Reg>> driver;
+};
+
+// Test the positions of the motors which answered are kept, the missing one being flagged
+TEST_F(PartialSyncReadTestSuite, missingPositionTest)
+{
+    std::vector<uint32_t> position_list;
+    std::vector<uint8_t> valid_list;
+
+    port->setRecords({syncReadInstruction(), status(4, 4000, 4), status(2, 2000, 4)});
+    EXPECT_NE(driver->syncReadPartialPosition({2, 3, 4}, position_list, valid_list), COMM_SUCCESS);
+    EXPECT_EQ(valid_list, std::vector<uint8_t>({1, 0, 1}));
+    ASSERT_EQ(position_list.size(), 3u);
+    EXPECT_EQ(position_list.at(0), 2000u);
+    EXPECT_EQ(position_list.at(2), 4000u);
+
+    // the regular sync read only gives the positions received before the first missing one
+    port->setRecords({syncReadInstruction(), status(4, 4000, 4), status(2, 2000, 4)});
+    EXPECT_NE(driver->syncReadPosition({2, 3, 4}, position_list), COMM_SUCCESS);
+    EXPECT_EQ(position_list, std::vector<uint32_t>{2000});
+}
+
+// Test the voltage and temperature of the motors which answered are kept, the missing one being flagged
+TEST_F(PartialSyncReadTestSuite, missingHwStatusTest)
+{
+    std::vector<std::pair<double, uint8_t>> data_list;
+    std::vector<uint8_t> valid_list;
+
+    // voltage on 2 bytes then temperature
+    port->setRecords({syncReadInstruction(), status(2, 120 | (35 << 16), 3)});
+    EXPECT_NE(driver->syncReadPartialHwStatus({2, 3}, data_list, valid_list), COMM_SUCCESS);
+    EXPECT_EQ(valid_list, std::vector<uint8_t>({1, 0}));
+    ASSERT_EQ(data_list.size(), 2u);
+    EXPECT_DOUBLE_EQ(data_list.at(0).first, 120.0);
+    EXPECT_EQ(data_list.at(0).second, 35);
+}
+
+// Test the fake driver answers for the motors of its fake data only
+TEST(MockDriverPartialSyncReadTest, missingPositionTest)
+{
+    auto fake_data = std::make_shared<ttl_driver::FakeTtlData>();
+    fake_data->dxl_registers[2].position = 2000;
+    fake_data->dxl_registers[4].position = 4000;
+    fake_data->updateFullIdList();
+    ttl_driver::MockDxlDriver driver(fake_data);
+
+    std::vector<uint32_t> position_list;
+    std::vector<uint8_t> valid_list;
+    EXPECT_NE(driver.syncReadPartialPosition({3, 2, 4}, position_list, valid_list), COMM_SUCCESS);
+    EXPECT_EQ(valid_list, std::vector<uint8_t>({0, 1, 1}));
+    EXPECT_EQ(position_list.at(1), 2000u);
+    EXPECT_EQ(position_list.at(2), 4000u);
+
+    EXPECT_EQ(driver.syncReadPartialPosition({2, 4}, position_list, valid_list), COMM_SUCCESS);
+    EXPECT_EQ(valid_list, std::vector<uint8_t>({1, 1}));
+}
+
+/******************************************************/
+/************ Tests of the reboot of the motors *******/
+/******************************************************/
+
+/**
+ * @brief The RebootingDriver class : fake motors answering again after some scans, as after a reboot.
+ * As a real sync read, its scans are cut at the first motor not answering
+ */
+class RebootingDriver : public ttl_driver::MockDxlDriver
+{
+  public:
+    // number of scans before each motor answers, the others never answer
+    explicit RebootingDriver(std::map<uint8_t, int> boot_scans)
+        : ttl_driver::MockDxlDriver(std::make_shared<ttl_driver::FakeTtlData>()), _boot_scans(std::move(boot_scans))
+    {
+    }
+
+    int scanKnownIds(const std::vector<uint8_t> &expected_ids, std::vector<uint8_t> &found_ids) override
+    {
+        _nb_scans++;
+        found_ids.clear();
+        for (auto const id : expected_ids)
+        {
+            if (!isBooted(id))
+                return COMM_RX_TIMEOUT;
+            found_ids.emplace_back(id);
+        }
+        return COMM_SUCCESS;
+    }
+
+    int ping(uint8_t id) override { return isBooted(id) ? COMM_SUCCESS : COMM_RX_TIMEOUT; }
+
+  private:
+    bool isBooted(uint8_t id) const { return _boot_scans.count(id) && _nb_scans > _boot_scans.at(id); }
+
+    std::map<uint8_t, int> _boot_scans;
+    int _nb_scans{0};
+};
+
+// Test the motors rebooted after a motor which never comes back are still found
+TEST(TtlManagerRebootTest, partialRebootTest)
+{
+    // motor 3 cuts the scans of the first bus
+    auto first_bus = std::make_shared<RebootingDriver>(std::map<uint8_t, int>{{2, 1}, {4, 2}});
+    auto second_bus = std::make_shared<RebootingDriver>(std::map<uint8_t, int>{{5, 0}});
+    common::util::RetryPolicy retry({5, 0, 0});
+
+    auto rebooted_ids = ttl_driver::TtlManager::waitRebootedIds({{first_bus, {2, 3, 4}}, {second_bus, {5}}}, retry);
+    std::sort(rebooted_ids.begin(), rebooted_ids.end());
+    EXPECT_EQ(rebooted_ids, std::vector<uint8_t>({2, 4, 5}));
+}
+
+// Test a motor which never comes back, alone on its bus
+TEST(TtlManagerRebootTest, neverAnswersTest)
+{
+    auto driver = std::make_shared<RebootingDriver>(std::map<uint8_t, int>{});
+    common::util::RetryPolicy retry({3, 0, 0});
+
+    EXPECT_TRUE(ttl_driver::TtlManager::waitRebootedIds({{driver, {7}}}, retry).empty());
+}
+
+// Test the motors are found without waiting for all the retries once they answered
+TEST(TtlManagerRebootTest, bootingTest)
+{
+    auto driver = std::make_shared<RebootingDriver>(std::map<uint8_t, int>{{2, 2}, {3, 0}});
+    common::util::RetryPolicy retry({10, 0, 0});
+
+    EXPECT_EQ(ttl_driver::TtlManager::waitRebootedIds({{driver, {2, 3}}}, retry), std::vector<uint8_t>({2, 3}));
+    EXPECT_EQ(retry.getAttempts(), 3u);
+}
+
+/******************************************************/
+/********** Tests of the baudrate negotiation *********/
+/******************************************************/
+
+/**
+ * @brief The BaudrateNegotiationTestSuite class : the manager replays a capture of the bus, written by each test.
+ * The devices are XL430 motors, the bus starts at 1 Mbps and is switched to 2 Mbps at startup
+ */
+class BaudrateNegotiationTestSuite : public SyncReadPipelineTestSuite
+{
+  protected:
+    // only the status packets of SyncReadPipelineTestSuite are used, the manager creates its own port
+    void SetUp() override {}
+
+    std::shared_ptr<ttl_driver::TtlManager> startManager()
+    {
+        std::string capture_file = "/tmp/ttl_baudrate_negotiation_test.ncap";
+        common::util::BusCaptureWriter writer;
+        if (!writer.open(capture_file, EBusProtocol::TTL))
+            return nullptr;
+        for (auto const &record : records)
+            writer.write(record);
+        writer.close();
+
+        ros::NodeHandle nh("~baudrate_negotiation");
+        nh.setParam("simulation_mode", false);
+        nh.setParam("bus_params/uart_device_name", "/dev/null");
+        nh.setParam("bus_params/baudrate", 1000000);
+        nh.setParam("bus_params/target_baudrate", 2000000);
+        nh.setParam("bus_params/replay_file", capture_file);
+
+        return std::make_shared<ttl_driver::TtlManager>(nh);
+    }
+
+    // any instruction of this type for this id : the replay port matches it on its id and instruction
+    void instruction(uint8_t id, uint8_t instruction)
+    {
+        common::util::CaptureRecord record;
+        record.flags = common::util::CaptureRecord::TX;
+        record.id = id;
+        record.data = {0xFF, 0xFF, 0xFD, 0x00, id, 0x03, 0x00, instruction, 0x00, 0x00};
+        records.emplace_back(record);
+    }
+
+    // ping of each device, answered with its model number, as done before reading or writing its registers
+    void ping(const std::vector<uint8_t> &ids, const std::vector<uint8_t> &answering_ids)
+    {
+        for (auto const id : ids)
+        {
+            instruction(id, INST_PING);
+            if (std::find(answering_ids.begin(), answering_ids.end(), id) != answering_ids.end())
+                records.emplace_back(status(id, ttl_driver::XL430Reg::MODEL_NUMBER, 3));
+        }
+    }
+
+    void broadcastPing(const std::vector<uint8_t> &answering_ids)
+    {
+        instruction(BROADCAST_ID, INST_PING);
+        for (auto const id : answering_ids)
+            records.emplace_back(status(id, ttl_driver::XL430Reg::MODEL_NUMBER, 3));
+    }
+
+    // targeted scan of the devices, a missing device is pinged again
+    void scanKnownIds(const std::vector<uint8_t> &ids, const std::vector<uint8_t> &answering_ids)
+    {
+        instruction(BROADCAST_ID, INST_SYNC_READ);
+        for (auto const id : answering_ids)
+            records.emplace_back(status(id, ttl_driver::XL430Reg::MODEL_NUMBER, 2));
+
+        for (auto const id : ids)
+        {
+            if (std::find(answering_ids.begin(), answering_ids.end(), id) == answering_ids.end())
+                ping({id}, {});
+        }
+    }
+
+    void syncWrite(const std::vector<uint8_t> &ids)
+    {
+        ping(ids, ids);
+        instruction(BROADCAST_ID, INST_SYNC_WRITE);
+    }
+
+    // discovery of motors 2 and 3 and switch of their baudrate, the torque of motor 2 being on
+    void switchDevices()
+    {
+        broadcastPing({2, 3});
+        ping({2, 3}, {2, 3});
+
+        ping({2}, {2});
+        instruction(2, INST_READ);
+        records.emplace_back(status(2, 1, 1));
+        ping({3}, {3});
+        instruction(3, INST_READ);
+        records.emplace_back(status(3, 0, 1));
+
+        // torque off, then baudrate
+        syncWrite({2});
+        syncWrite({2, 3});
+    }
+
+    std::vector<common::util::CaptureRecord> records;
+};
+
+// Test all the devices are switched to the target baudrate at startup, their torque being restored
+TEST_F(BaudrateNegotiationTestSuite, negotiationTest)
+{
+    broadcastPing({2, 3});
+    switchDevices();
+    scanKnownIds({2, 3}, {2, 3});
+    syncWrite({2});
+
+    auto ttl_manager = startManager();
+    ASSERT_TRUE(ttl_manager);
+    EXPECT_EQ(ttl_manager->getBaudrate(), 2000000);
+}
+
+// Test the devices which switched go back to the previous baudrate when one of them is lost
+TEST_F(BaudrateNegotiationTestSuite, rollbackTest)
+{
+    broadcastPing({2, 3});
+    switchDevices();
+    // motor 3 does not answer at the new baudrate
+    scanKnownIds({2, 3}, {2});
+    syncWrite({2});
+    scanKnownIds({2, 3}, {2, 3});
+    syncWrite({2});
+
+    auto ttl_manager = startManager();
+    ASSERT_TRUE(ttl_manager);
+    EXPECT_EQ(ttl_manager->getBaudrate(), 1000000);
+
+    // a baudrate which does not exist is refused before any access to the bus
+    EXPECT_EQ(ttl_manager->changeBaudrate(1500000), ttl_driver::TTL_FAIL_BAUDRATE_NOT_SUPPORTED);
+}
+
+// Test a bus already switched during a previous session is found at the target baudrate
+TEST_F(BaudrateNegotiationTestSuite, alreadyAtTargetTest)
+{
+    broadcastPing({});
+    broadcastPing({2, 3});
+
+    auto ttl_manager = startManager();
+    ASSERT_TRUE(ttl_manager);
+    EXPECT_EQ(ttl_manager->getBaudrate(), 2000000);
+}
+
+/******************************************************/
+/**************** Tests of the TTL ports **************/
+/******************************************************/
+
+// Test the jobs posted on a port run on its own thread, one after the other, in the order they are posted
+TEST(TtlPortTestSuite, postWaitOrderingTest)
+{
+    ttl_driver::TtlPort port("/dev/null", 1000000, {12, 13});
+    EXPECT_TRUE(port.isAssigned(12));
+    EXPECT_FALSE(port.isAssigned(2));
+
+    // nothing to wait for
+    port.wait();
+
+    std::vector<int> jobs_done;
+    std::thread::id job_thread;
+    port.post(
+        [&]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            job_thread = std::this_thread::get_id();
+            jobs_done.emplace_back(1);
+        });
+    port.wait();
+    EXPECT_EQ(jobs_done, std::vector<int>{1});
+    EXPECT_NE(job_thread, std::this_thread::get_id());
+
+    // a job posted while the previous one runs starts once it has ended
+    port.post(
+        [&]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            jobs_done.emplace_back(2);
+        });
+    port.post([&]() { jobs_done.emplace_back(3); });
+    port.wait();
+    EXPECT_EQ(jobs_done, std::vector<int>({1, 2, 3}));
+}
+
+// Test a port destroyed with a job running or pending : the job ends before the I/O thread stops
+TEST(TtlPortTestSuite, shutdownTest)
+{
+    std::atomic<int> nb_jobs_done{0};
+    {
+        ttl_driver::TtlPort port("/dev/null", 1000000, {12});
+        port.post(
+            [&]()
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                nb_jobs_done++;
+            });
+        port.post([&]() { nb_jobs_done++; });
+    }
+    EXPECT_EQ(nb_jobs_done, 2);
+
+    // an idle port stops at once
+    {
+        ttl_driver::TtlPort port("/dev/null", 1000000, {12});
+    }
+}
+
 // Run all the tests that were declared with TEST()
 int main(int argc, char **argv)
 {
@@ -690,6 +690,24 @@ TEST_F(TtlManagerTestSuite, testSyncControlCmdsReturnHome)
 // Test driver scan motors
 TEST_F(TtlManagerTestSuite, scanTest) { EXPECT_EQ(ttl_drv->scanAndCheck(), COMM_SUCCESS); }
 
+// Test driver scan with a registered motor missing on the bus
+TEST_F(TtlManagerTestSuite, scanMissingMotorTest)
+{
+    uint8_t missing_id = 20;
+    auto state_motor = std::dynamic_pointer_cast<common::model::JointState>(ttl_drv->getHardwareState(5));
+    ASSERT_NE(state_motor, nullptr);
+
+    ttl_drv->addHardwareComponent(std::make_shared<DxlMotorState>(state_motor->getHardwareType(), common::model::EComponentType::JOINT, missing_id));
+
+    EXPECT_EQ(ttl_drv->scanAndCheck(), ttl_driver::TTL_SCAN_MISSING_MOTOR);
+    EXPECT_EQ(ttl_drv->getRemovedMotorList(), std::vector<uint8_t>{missing_id});
+    EXPECT_FALSE(ttl_drv->isConnectionOk());
+
+    ttl_drv->removeHardwareComponent(missing_id);
+    EXPECT_EQ(ttl_drv->scanAndCheck(), COMM_SUCCESS);
+    EXPECT_TRUE(ttl_drv->isConnectionOk());
+}
+
 // Run all the tests that were declared with TEST()
 int main(int argc, char **argv)
 {
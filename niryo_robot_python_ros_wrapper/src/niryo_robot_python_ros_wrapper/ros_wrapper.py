@@ -252,7 +252,8 @@ class NiryoRosWrapper(AbstractNiryoRosWrapper):
 
     def __calibrate(self, calib_type_int):
         """
-        Call service to calibrate motors then waits for its end. If failed, raises NiryoRosWrapperException
+        Call service to calibrate motors then waits for its end through the hardware status.
+        If failed, raises NiryoRosWrapperException
 
         :param calib_type_int: 1 for auto-calibration & 2 for manual calibration
         :return: status, message
@@ -266,12 +267,21 @@ class NiryoRosWrapper(AbstractNiryoRosWrapper):
         self._check_result_status(result)
         # Wait until calibration start
         rospy.sleep(0.2)
+        start_timeout = rospy.Time.now() + rospy.Duration(2.0)
+        calibration_started = False
         calibration_finished = False
         while not calibration_finished:
             try:
                 hw_status = self.__hw_status_ntv.wait_for_message()
+                if hw_status.calibration_in_progress:
+                    calibration_started = True
                 if not (hw_status.calibration_needed or hw_status.calibration_in_progress):
                     calibration_finished = True
+                elif hw_status.calibration_in_progress:
+                    rospy.sleep(0.1)
+                elif calibration_started or rospy.Time.now() > start_timeout:
+                    # the calibration ended (or never started) and the robot still needs one
+                    raise NiryoRosWrapperException("Calibration failed, please check the motors and try again")
                 else:
                     rospy.sleep(0.1)
             except rospy.ROSException as e: